@@ -3,6 +3,7 @@
 #include "../core/settings/setting.h"
 #include "../core/settings/session_manager.h"
 #include "../utils/metrics.h"
+#include "../utils/startup_profiler.h"
 #include <chrono>
 #include <thread>
 #include <iostream>
@@ -10,11 +11,25 @@
 #include <filesystem>
 #include <sstream>
 #include <iomanip>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QString>
-#include <QDateTime>
+#include <ctime>
+#include <cstdio>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+/// Keys processed per second over the current metrics period
+double keysPerSecond(const yamy::metrics::MetricStats& stats)
+{
+    if (stats.periodEnd <= stats.periodStart) {
+        return 0.0;
+    }
+    const uint64_t periodMs = stats.periodEnd - stats.periodStart;
+    return (stats.count * 1000.0) / periodMs;
+}
+
+} // namespace
 
 EngineAdapter::EngineAdapter(Engine* engine)
     : m_engine(engine)
@@ -109,12 +124,25 @@ void EngineAdapter::stop()
 }
 
 bool EngineAdapter::loadConfig(const std::string& path)
+{
+    return applyConfig(path, false);
+}
+
+bool EngineAdapter::reloadConfig(const std::string& path)
+{
+    return applyConfig(path, true);
+}
+
+bool EngineAdapter::applyConfig(const std::string& path, bool reload)
 {
     if (!m_engine) {
         std::cerr << "EngineAdapter::loadConfig() - No engine instance" << std::endl;
         return false;
     }
 
+    // Keeps m_configPath in the order the engine applied the configs
+    std::lock_guard<std::mutex> reloadLock(m_reloadMutex);
+
     // Validate file existence
     namespace fs = std::filesystem;
     if (!fs::exists(path)) {
@@ -139,10 +167,12 @@ bool EngineAdapter::loadConfig(const std::string& path)
     //     stop();  // ❌ BUG: Triggers glibc crash!
     // }
 
-    // Use Engine's switchConfiguration method which handles parsing and applying
+    // Use Engine's switchConfiguration method which handles parsing and applying;
+    // reloadConfiguration() also re-reads the active file
     bool success = false;
     try {
-        success = m_engine->switchConfiguration(path);
+        success = reload ? m_engine->reloadConfiguration(path)
+                         : m_engine->switchConfiguration(path);
     } catch (const std::exception& e) {
         std::cerr << "EngineAdapter::loadConfig() - Exception: " << e.what() << std::endl;
         success = false;
@@ -153,13 +183,16 @@ bool EngineAdapter::loadConfig(const std::string& path)
 
     // Save config path and loaded time on success
     if (success) {
-        m_configPath = path;
-        m_configLoadedTime = std::chrono::system_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_configMutex);
+            m_configPath = path;
+            m_configLoadedTime = std::chrono::system_clock::now();
+        }
 
         // Save session state after successful config load
         // This ensures config path is persisted immediately
         yamy::SessionManager& session = yamy::SessionManager::instance();
-        session.setActiveConfig(m_configPath);
+        session.setActiveConfig(path);
         session.setEngineRunning(wasRunning);  // Save the running state before we stopped for reload
         session.saveSession();
 
@@ -187,11 +220,20 @@ bool EngineAdapter::loadConfig(const std::string& path)
     return success;
 }
 
-const std::string& EngineAdapter::getConfigPath() const
+std::string EngineAdapter::getConfigPath() const
 {
+    std::lock_guard<std::mutex> lock(m_configMutex);
     return m_configPath;
 }
 
+void EngineAdapter::configSnapshot(std::string* path,
+                                   std::chrono::system_clock::time_point* loadedTime) const
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    *path = m_configPath;
+    *loadedTime = m_configLoadedTime;
+}
+
 uint64_t EngineAdapter::keyCount() const
 {
     // Get key count from metrics
@@ -202,7 +244,7 @@ uint64_t EngineAdapter::keyCount() const
 
 std::string EngineAdapter::getStatusJson() const
 {
-    QJsonObject obj;
+    json obj;
 
     if (!m_engine) {
         obj["state"] = "error";
@@ -210,7 +252,7 @@ std::string EngineAdapter::getStatusJson() const
         obj["config"] = "";
         obj["key_count"] = 0;
         obj["current_keymap"] = "none";
-        return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+        return obj.dump();
     }
 
     // Get state from engine
@@ -230,51 +272,62 @@ std::string EngineAdapter::getStatusJson() const
             stateStr = "error";
             break;
     }
-    obj["state"] = QString::fromStdString(stateStr);
+    obj["state"] = stateStr;
 
     // Calculate uptime in seconds
     auto now = std::chrono::steady_clock::now();
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - m_startTime).count();
-    obj["uptime"] = static_cast<qint64>(uptime);
+    obj["uptime"] = static_cast<int64_t>(uptime);
 
     // Config path
-    obj["config"] = QString::fromStdString(m_configPath);
+    obj["config"] = getConfigPath();
 
     // Key count from metrics
-    obj["key_count"] = static_cast<qint64>(keyCount());
+    obj["key_count"] = static_cast<int64_t>(keyCount());
 
-    // Current keymap - always "Global" since we removed per-window keymaps
-    obj["current_keymap"] = "Global";
+    // Global unless a prefix keymap is active
+    obj["current_keymap"] = m_engine->getCurrentKeymapName();
 
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+    return obj.dump();
 }
 
 std::string EngineAdapter::getConfigJson() const
 {
-    QJsonObject obj;
+    json obj;
+
+    std::string configPath;
+    std::chrono::system_clock::time_point loadedAt;
+    configSnapshot(&configPath, &loadedAt);
 
-    obj["config_path"] = QString::fromStdString(m_configPath);
+    obj["config_path"] = configPath;
 
     // Extract config name from path
-    std::string configName = m_configPath;
-    size_t lastSlash = m_configPath.find_last_of('/');
+    std::string configName = configPath;
+    size_t lastSlash = configPath.find_last_of('/');
     if (lastSlash != std::string::npos) {
-        configName = m_configPath.substr(lastSlash + 1);
+        configName = configPath.substr(lastSlash + 1);
     }
-    obj["config_name"] = QString::fromStdString(configName);
-
-    // Convert loaded time to ISO8601 format
-    auto time_t_val = std::chrono::system_clock::to_time_t(m_configLoadedTime);
-    QDateTime qdt = QDateTime::fromSecsSinceEpoch(time_t_val);
-    obj["loaded_time"] = qdt.toString(Qt::ISODate);
-
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+    obj["config_name"] = configName;
+
+    // Convert loaded time to ISO8601 format (local time, no offset)
+    auto time_t_val = std::chrono::system_clock::to_time_t(loadedAt);
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &time_t_val);
+#else
+    localtime_r(&time_t_val, &localTime);
+#endif
+    std::ostringstream loadedTime;
+    loadedTime << std::put_time(&localTime, "%Y-%m-%dT%H:%M:%S");
+    obj["loaded_time"] = loadedTime.str();
+
+    return obj.dump();
 }
 
 std::string EngineAdapter::getKeymapsJson() const
 {
-    QJsonObject obj;
-    QJsonArray keymapsArray;
+    json obj;
+    json keymapsArray = json::array();
 
     if (m_engine) {
         const Setting* setting = m_engine->getSetting();
@@ -282,20 +335,18 @@ std::string EngineAdapter::getKeymapsJson() const
             // Iterate through all keymaps (no window matching info since we removed per-window keymaps)
             const auto& keymapList = setting->m_keymaps.getKeymapList();
             for (const auto& keymap : keymapList) {
-                QJsonObject kmObj;
-                kmObj["name"] = QString::fromStdString(keymap.getName());
-                keymapsArray.append(kmObj);
+                keymapsArray.push_back(json{{"name", keymap.getName()}});
             }
         }
     }
 
-    obj["keymaps"] = keymapsArray;
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+    obj["keymaps"] = std::move(keymapsArray);
+    return obj.dump();
 }
 
 std::string EngineAdapter::getMetricsJson() const
 {
-    QJsonObject obj;
+    json obj;
 
     // Get metrics from the global PerformanceMetrics instance
     auto& metrics = yamy::metrics::PerformanceMetrics::instance();
@@ -304,25 +355,88 @@ std::string EngineAdapter::getMetricsJson() const
     auto keyProcStats = metrics.getStats(yamy::metrics::Operations::KEY_PROCESSING);
 
     // Populate JSON with metrics matching the expected format
-    obj["latency_avg_ns"] = static_cast<qint64>(keyProcStats.averageNs);
-    obj["latency_p99_ns"] = static_cast<qint64>(keyProcStats.p99Ns);
-    obj["latency_max_ns"] = static_cast<qint64>(keyProcStats.maxNs);
+    obj["latency_avg_ns"] = static_cast<int64_t>(keyProcStats.averageNs);
+    obj["latency_p99_ns"] = static_cast<int64_t>(keyProcStats.p99Ns);
+    obj["latency_max_ns"] = static_cast<int64_t>(keyProcStats.maxNs);
 
     // CPU usage - not currently tracked, return 0.0 for now
     // This could be enhanced later with actual CPU monitoring
     obj["cpu_usage_percent"] = 0.0;
 
-    // Keys per second calculation
-    double keysPerSecond = 0.0;
-    if (keyProcStats.periodEnd > keyProcStats.periodStart) {
-        uint64_t periodMs = keyProcStats.periodEnd - keyProcStats.periodStart;
-        if (periodMs > 0) {
-            keysPerSecond = (keyProcStats.count * 1000.0) / periodMs;
+    obj["keys_per_second"] = keysPerSecond(keyProcStats);
+
+    return obj.dump();
+}
+
+std::string EngineAdapter::getLocksJson() const
+{
+    json obj;
+    json active = json::array();
+
+    if (m_engine) {
+        uint32_t lockBits[8];
+        m_engine->getLockBits(lockBits);
+        for (int i = 0; i < 256; ++i) {
+            if (lockBits[i / 32] & (1u << (i % 32))) {
+                char name[4];
+                std::snprintf(name, sizeof(name), "L%02X", i);
+                active.push_back(name);
+            }
         }
     }
-    obj["keys_per_second"] = keysPerSecond;
+    obj["count"] = static_cast<int64_t>(active.size());
+    obj["active"] = std::move(active);
+
+    return obj.dump();
+}
+
+std::string EngineAdapter::getWatchTopicJson(const std::string& topic) const
+{
+    if (topic == "metrics") {
+        return getMetricsJson();
+    }
+    if (topic == "config") {
+        return getConfigJson();
+    }
+    if (topic == "locks") {
+        return getLocksJson();
+    }
+    if (topic == "keys") {
+        json obj;
+        auto& metrics = yamy::metrics::PerformanceMetrics::instance();
+        const auto keyProcStats = metrics.getStats(yamy::metrics::Operations::KEY_PROCESSING);
+        obj["key_count"] = static_cast<int64_t>(keyProcStats.count);
+        obj["keys_per_second"] = keysPerSecond(keyProcStats);
+        obj["current_keymap"] = m_engine ? m_engine->getCurrentKeymapName() : std::string("none");
+        return obj.dump();
+    }
+    return "";
+}
+
+std::string EngineAdapter::getStartupJson() const
+{
+    json obj;
+    auto& profiler = yamy::metrics::StartupProfiler::instance();
+
+    json phasesArray = json::array();
+    for (const auto& phase : profiler.phases()) {
+        phasesArray.push_back(json{
+            {"name", phase.name},
+            {"start_us", phase.startUs},
+            {"wall_us", phase.wallUs},
+            {"cpu_us", phase.cpuUs},
+            {"deferred", phase.isDeferred},
+        });
+    }
+    obj["phases"] = std::move(phasesArray);
+
+    json milestonesArray = json::array();
+    for (const auto& milestone : profiler.milestones()) {
+        milestonesArray.push_back(json{{"name", milestone.name}, {"at_us", milestone.atUs}});
+    }
+    obj["milestones"] = std::move(milestonesArray);
 
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+    return obj.dump();
 }
 
 void EngineAdapter::setNotificationCallback(NotificationCallback callback)
@@ -4,6 +4,7 @@
 #include <thread>
 #include <memory>
 #include <functional>
+#include <mutex>
 #include <chrono>
 #include "core/platform/ipc_defs.h"
 
@@ -53,9 +54,14 @@ public:
     /// @return true if configuration loaded successfully, false on error
     bool loadConfig(const std::string& path);
 
+    /// Load configuration, re-reading it even if it is the active one
+    /// @param path Path to the configuration file
+    /// @return true if configuration loaded successfully, false on error
+    bool reloadConfig(const std::string& path);
+
     /// Get current configuration file path
     /// @return Path to the currently loaded configuration file
-    const std::string& getConfigPath() const;
+    std::string getConfigPath() const;
 
     /// Get total number of keys processed
     /// @return Key count
@@ -84,6 +90,22 @@ public:
     /// @return JSON string with performance metrics
     std::string getMetricsJson() const;
 
+    /// Get startup trace as JSON string
+    /// Format: {"phases": [{"name": "...", "start_us": N, "wall_us": N, "cpu_us": N,
+    ///          "deferred": bool}], "milestones": [{"name": "...", "at_us": N}]}
+    /// @return JSON string with the startup trace
+    std::string getStartupJson() const;
+
+    /// Get active locks as JSON string
+    /// Format: {"active": ["L00", ...], "count": N}
+    /// @return JSON string with active locks
+    std::string getLocksJson() const;
+
+    /// Get the state of a yamy-ctl watch topic as JSON string
+    /// @param topic "metrics", "locks", "keys" or "config"
+    /// @return JSON object string, or empty string for an unknown topic
+    std::string getWatchTopicJson(const std::string& topic) const;
+
     /// Callback type for engine notifications
     /// @param type Notification message type (ConfigLoaded, ConfigError, etc.)
     /// @param data Additional data associated with the notification (e.g., error message)
@@ -94,7 +116,15 @@ public:
     void setNotificationCallback(NotificationCallback callback);
 
 private:
+    /// Shared body of loadConfig() and reloadConfig()
+    bool applyConfig(const std::string& path, bool reload);
+
+    /// m_configPath and m_configLoadedTime, read together
+    void configSnapshot(std::string* path, std::chrono::system_clock::time_point* loadedTime) const;
+
     Engine* m_engine;                           ///< Real Engine instance (owned)
+    std::mutex m_reloadMutex;                   ///< One applyConfig() at a time (watcher and IPC threads)
+    mutable std::mutex m_configMutex;           ///< Guards m_configPath and m_configLoadedTime
     std::string m_configPath;                   ///< Path to loaded configuration
     std::thread m_engineThread;                 ///< Thread running the engine
     std::chrono::steady_clock::time_point m_startTime;  ///< Time when engine was started
@@ -1,3 +1,4 @@
+#if defined(QT_CORE_LIB)
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QStandardPaths>
@@ -5,6 +6,14 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QTimer>
+#else
+#include <getopt.h>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#endif
 #include <iostream>
 #include <fstream>
 #include <sys/stat.h>
@@ -19,18 +28,26 @@
 #include "core/engine/engine.h"
 #include "core/settings/session_manager.h"
 #include "core/settings/config_manager.h"
+#include "core/settings/inotify_config_watcher.h"
 #include "core/plugin_manager.h"
 #include "core/platform/input_hook_interface.h"
 #include "core/platform/input_injector_interface.h"
 #include "core/platform/window_system_interface.h"
 #include "core/platform/input_driver_interface.h"
 #include "utils/msgstream.h"
+#include "utils/startup_profiler.h"
+
+#if defined(QT_CORE_LIB)
 #include "utils/qsettings_config_store.h"
+#else
+#include "core/platform/linux/event_loop.h"
+#endif
 
 #ifdef _WIN32
 #include "platform/windows/ipc_control_server.h"
 #else
 #include "platform/linux/ipc_control_server.h"
+#include "platform/linux/input_hook_linux.h"
 #endif
 
 struct CommandLineOptions {
@@ -39,6 +56,7 @@ struct CommandLineOptions {
 
 static std::ofstream* g_logStream = nullptr;
 
+#if defined(QT_CORE_LIB)
 static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg) {
     if (!g_logStream) {
         return;
@@ -85,6 +103,42 @@ static CommandLineOptions parseCommandLine(const QCoreApplication& app) {
 
     return options;
 }
+#else
+static CommandLineOptions parseCommandLine(int argc, char* argv[]) {
+    CommandLineOptions options;
+
+    static const option longOptions[] = {
+        {"no-restore", no_argument, nullptr, 'n'},
+        {"help",       no_argument, nullptr, 'h'},
+        {"version",    no_argument, nullptr, 'v'},
+        {nullptr,      0,           nullptr, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "hv", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'n':
+                options.noRestore = true;
+                break;
+            case 'h':
+                std::cout << "Usage: " << argv[0] << " [options]\n"
+                          << "YAMY - Keyboard Remapper (headless daemon)\n\n"
+                          << "Options:\n"
+                          << "  -h, --help     Displays help on commandline options.\n"
+                          << "  -v, --version  Displays version information.\n"
+                          << "  --no-restore   Skip session restoration (do not restore previous config and engine state)\n";
+                std::exit(0);
+            case 'v':
+                std::cout << "YAMY 0.04" << std::endl;
+                std::exit(0);
+            default:
+                std::exit(1);
+        }
+    }
+
+    return options;
+}
+#endif
 
 static bool restoreSessionState(EngineAdapter* engine, const CommandLineOptions& options) {
     if (options.noRestore) {
@@ -142,6 +196,7 @@ static bool restoreSessionState(EngineAdapter* engine, const CommandLineOptions&
     return restored;
 }
 
+#if defined(QT_CORE_LIB)
 static std::string initLogFile() {
     QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     if (logDir.isEmpty()) {
@@ -168,72 +223,172 @@ static std::string initLogFile() {
 
     return logPath.toStdString();
 }
+#else
+static std::string initLogFile() {
+    namespace fs = std::filesystem;
+
+    // Same directory QStandardPaths::AppDataLocation gives the Qt build
+    fs::path logDir;
+    if (const char* dataHome = std::getenv("XDG_DATA_HOME"); dataHome && *dataHome) {
+        logDir = fs::path(dataHome) / "YAMY" / "YAMY";
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        logDir = fs::path(home) / ".local" / "share" / "YAMY" / "YAMY";
+    } else {
+        logDir = fs::temp_directory_path();
+    }
+
+    std::error_code ec;
+    fs::create_directories(logDir, ec);
+
+    const std::string logPath = (logDir / "yamy-daemon.log").string();
+    g_logStream = new std::ofstream(logPath, std::ios::app);
+    if (g_logStream->is_open()) {
+        const std::time_t now = std::time(nullptr);
+        std::tm localTime{};
+        localtime_r(&now, &localTime);
+        (*g_logStream) << "----- YAMY headless daemon start: "
+                       << std::put_time(&localTime, "%Y-%m-%dT%H:%M:%S")
+                       << " -----" << std::endl;
+    } else {
+        delete g_logStream;
+        g_logStream = nullptr;
+        std::cerr << "Warning: Failed to open log file at " << logPath << std::endl;
+    }
+
+    return logPath;
+}
+#endif
 
 int main(int argc, char* argv[]) {
+    // Startup trace times are relative to this call
+    yamy::metrics::StartupProfiler& profiler = yamy::metrics::StartupProfiler::instance();
+
 #ifndef _WIN32
-    yamy::CrashHandler::install();
-    yamy::CrashHandler::setVersion("0.04");
+    {
+        STARTUP_PHASE("crash_handler");
+        yamy::CrashHandler::install();
+        yamy::CrashHandler::setVersion("0.04");
+        // Keyboards grabbed in exclusive mode must not stay dead while the report is written
+        yamy::CrashHandler::setEmergencyHandler(&yamy::platform::InputHookLinux::releaseGrabs);
+    }
 #endif
 
+#if defined(QT_CORE_LIB)
+    // The application object lives for all of main(), so it is timed by hand
+    const uint64_t qtInitUs = profiler.nowUs();
+    const uint64_t qtInitCpuUs = yamy::metrics::StartupProfiler::threadCpuUs();
     QCoreApplication app(argc, argv);
+    profiler.record("qt_core_init", qtInitUs, profiler.nowUs() - qtInitUs,
+                    yamy::metrics::StartupProfiler::threadCpuUs() - qtInitCpuUs);
     QCoreApplication::setApplicationName("YAMY");
     QCoreApplication::setApplicationVersion("0.04");
     QCoreApplication::setOrganizationName("YAMY");
+#else
+    yamy::platform::EventLoop& loop = yamy::platform::EventLoop::instance();
+    {
+        STARTUP_PHASE("event_loop_init");
+        // SIGINT/SIGTERM end the loop so the session is saved. The signals
+        // are blocked here, before the engine and watcher threads inherit
+        // the signal mask.
+        loop.handleSignals({SIGINT, SIGTERM}, [&loop](int signo) {
+            std::cout << "Received signal " << signo << ", shutting down" << std::endl;
+            loop.quit(0);
+        });
+    }
+#endif
 
-    std::string logPath = initLogFile();
+    std::string logPath;
+    {
+        STARTUP_PHASE("log_init");
+        logPath = initLogFile();
+    }
 
+#if defined(QT_CORE_LIB)
     CommandLineOptions cmdOptions = parseCommandLine(app);
+#else
+    CommandLineOptions cmdOptions = parseCommandLine(argc, argv);
+#endif
 
     std::cout << "Starting YAMY headless daemon" << std::endl;
     if (!logPath.empty()) {
         std::cout << "Log: " << logPath << std::endl;
     }
 
-    yamy::platform::IWindowSystem* windowSystem = yamy::platform::createWindowSystem();
-    yamy::platform::IInputInjector* inputInjector = yamy::platform::createInputInjector(windowSystem);
-    yamy::platform::IInputHook* inputHook = yamy::platform::createInputHook();
-    yamy::platform::IInputDriver* inputDriver = yamy::platform::createInputDriver();
+    yamy::platform::IWindowSystem* windowSystem = nullptr;
+    yamy::platform::IInputInjector* inputInjector = nullptr;
+    yamy::platform::IInputHook* inputHook = nullptr;
+    yamy::platform::IInputDriver* inputDriver = nullptr;
+    {
+        STARTUP_PHASE("platform_create");
+        windowSystem = yamy::platform::createWindowSystem();
+        inputInjector = yamy::platform::createInputInjector(windowSystem);
+        inputHook = yamy::platform::createInputHook();
+        inputDriver = yamy::platform::createInputDriver();
+    }
 
+#if defined(QT_CORE_LIB)
     // Use QSettingsConfigStore for persistence
     // This allows the engine to save its configuration list
     ConfigStore* configStore = new QSettingsConfigStore("YAMY", "YAMY");
+#else
+    // No config store without Qt; the engine only needs one to switch
+    // between saved configurations
+    ConfigStore* configStore = nullptr;
+#endif
 
     static tomsgstream logStream(0, nullptr);
 
-    Engine* realEngine = new Engine(
-        logStream,
-        windowSystem,
-        configStore,
-        inputInjector,
-        inputHook,
-        inputDriver
-    );
+    Engine* realEngine = nullptr;
+    {
+        STARTUP_PHASE("engine_create");
+        realEngine = new Engine(
+            logStream,
+            windowSystem,
+            configStore,
+            inputInjector,
+            inputHook,
+            inputDriver
+        );
+    }
 
     EngineAdapter* engine = new EngineAdapter(realEngine);
 
-    bool sessionRestored = restoreSessionState(engine, cmdOptions);
+    // Config load and engine start; the hook goes live in here
+    bool sessionRestored = false;
+    {
+        STARTUP_PHASE("session_restore");
+        sessionRestored = restoreSessionState(engine, cmdOptions);
+    }
     if (!sessionRestored) {
         std::cout << "No session restored; starting engine with defaults" << std::endl;
+        STARTUP_PHASE("engine_start");
         engine->start();
         engine->enable();
     }
 
     yamy::core::PluginManager& pluginManager = yamy::core::PluginManager::instance();
-    if (pluginManager.initialize(realEngine)) {
-        auto loadedPlugins = pluginManager.getLoadedPlugins();
-        if (loadedPlugins.empty()) {
-            std::cout << "No plugins loaded (plugin directory: "
-                      << yamy::core::PluginManager::getPluginDirectory() << ")" << std::endl;
-        } else {
-            std::cout << "Loaded " << loadedPlugins.size() << " plugin(s)" << std::endl;
+
+    // Edits to the config or its includes are applied without the Qt event
+    // loop; the callback runs on the watcher thread
+    yamy::settings::InotifyConfigWatcher configWatcher;
+    configWatcher.setDependencyResolver(&ConfigManager::getDependencies);
+    configWatcher.setChangeCallback([engine](const std::string& path) {
+        std::cout << "Config changed on disk, reloading: " << path << std::endl;
+        if (!engine->reloadConfig(path)) {
+            std::cerr << "Warning: Failed to reload configuration: " << path << std::endl;
+        }
+    });
+    configWatcher.setConfigPath(engine->getConfigPath());
+    {
+        STARTUP_PHASE("config_watcher_start");
+        if (!engine->getConfigPath().empty() && !configWatcher.start()) {
+            std::cerr << "Warning: Failed to watch configuration for changes" << std::endl;
         }
-    } else {
-        std::cerr << "Warning: Plugin system initialization failed" << std::endl;
     }
 
     yamy::platform::IPCControlServer controlServer;
     controlServer.setCommandCallback(
-        [engine](yamy::platform::ControlCommand cmd, const std::string& data)
+        [engine, &configWatcher](yamy::platform::ControlCommand cmd, const std::string& data)
             -> yamy::platform::ControlResult {
         yamy::platform::ControlResult result;
 
@@ -251,11 +406,11 @@ int main(int argc, char* argv[]) {
 
                     if (!data.empty()) {
                         configPath = data;
-                        loadSuccess = engine->loadConfig(data);
+                        loadSuccess = engine->reloadConfig(data);
                     } else {
                         configPath = engine->getConfigPath();
                         if (!configPath.empty()) {
-                            loadSuccess = engine->loadConfig(configPath);
+                            loadSuccess = engine->reloadConfig(configPath);
                         } else {
                             result.success = false;
                             result.message = "No configuration loaded. Provide a config path to load.";
@@ -268,6 +423,11 @@ int main(int argc, char* argv[]) {
                         configMgr.addConfig(configPath);
                         configMgr.setActiveConfig(configPath);
 
+                        configWatcher.setConfigPath(configPath);
+                        if (!configWatcher.isWatching()) {
+                            configWatcher.start();
+                        }
+
                         result.success = true;
                         result.message = "Configuration loaded successfully: " + configPath;
                     } else {
@@ -301,7 +461,8 @@ int main(int argc, char* argv[]) {
             case yamy::platform::ControlCommand::GetStatus: {
                 std::cout << "IPC: Received status command" << std::endl;
                 result.success = true;
-                result.message = engine->getStatusJson();
+                result.message = (data == "startup") ? engine->getStartupJson()
+                                                     : engine->getStatusJson();
                 break;
             }
 
@@ -334,22 +495,59 @@ int main(int argc, char* argv[]) {
 
         return result;
     });
+    controlServer.setTopicCallback([engine](const std::string& topic) {
+        return engine->getWatchTopicJson(topic);
+    });
 
-    if (controlServer.start()) {
+    bool isControlServerStarted = false;
+    {
+        STARTUP_PHASE("control_server_start");
+        isControlServerStarted = controlServer.start();
+    }
+    if (isControlServerStarted) {
         std::cout << "IPC control server started at: " << controlServer.socketPath() << std::endl;
     } else {
         std::cerr << "Warning: Failed to start IPC control server" << std::endl;
     }
 
     // Initialize IPC channel AFTER event loop starts to avoid Qt threading issues
-    // QTimer::singleShot(0, ...) schedules execution on next event loop iteration
-    QTimer::singleShot(0, [realEngine]() {
-        realEngine->initializeIPC();
-    });
+    // QTimer::singleShot(0, ...) / EventLoop::post() schedule execution on the
+    // next event loop iteration. Plugins are loaded there too: keys are
+    // already remapped by then, and plugins only observe the engine.
+    auto deferredInit = [realEngine, &pluginManager, &profiler]() {
+        {
+            STARTUP_PHASE("ipc_init");
+            realEngine->initializeIPC();
+        }
 
+        {
+            STARTUP_PHASE("plugins_load");
+            if (pluginManager.initialize(realEngine)) {
+                auto loadedPlugins = pluginManager.getLoadedPlugins();
+                if (loadedPlugins.empty()) {
+                    std::cout << "No plugins loaded (plugin directory: "
+                              << yamy::core::PluginManager::getPluginDirectory() << ")" << std::endl;
+                } else {
+                    std::cout << "Loaded " << loadedPlugins.size() << " plugin(s)" << std::endl;
+                }
+            } else {
+                std::cerr << "Warning: Plugin system initialization failed" << std::endl;
+            }
+        }
+
+        profiler.mark(yamy::metrics::Milestones::STARTUP_COMPLETE);
+    };
+
+#if defined(QT_CORE_LIB)
+    QTimer::singleShot(0, deferredInit);
     int result = app.exec();
+#else
+    loop.post(deferredInit);
+    int result = loop.run();
+#endif
 
     controlServer.stop();
+    configWatcher.stop();
 
     std::cout << "Saving session state..." << std::endl;
     yamy::SessionManager& session = yamy::SessionManager::instance();
@@ -6,19 +6,24 @@
 //   yamy-ctl stop                    - Stop the engine
 //   yamy-ctl start                   - Start the engine
 //   yamy-ctl status [--json]         - Get engine status
+//   yamy-ctl status --startup        - Get the daemon's startup trace
 //   yamy-ctl config [--json]         - Get configuration details
 //   yamy-ctl keymaps [--json]        - List loaded keymaps
 //   yamy-ctl metrics [--json]        - Get performance metrics
+//   yamy-ctl watch TOPIC [--interval MS] [--json]
+//                                    - Stream changes to metrics, locks, keys or config
 //   yamy-ctl --help                  - Show help
 //
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <string>
 #include <cstring>
 #include <cstdlib>
 #include <cstdint>
 #include <cctype>
+#include <ctime>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -56,7 +61,10 @@ enum MessageType : uint32_t {
     RspStatus = 0x2102,
     RspConfig = 0x2103,
     RspKeymaps = 0x2104,
-    RspMetrics = 0x2105
+    RspMetrics = 0x2105,
+    CmdSubscribe = 0x2008,
+    CmdUnsubscribe = 0x2009,
+    NtfWatchEvent = 0x2106
 };
 
 /// Wire protocol message header
@@ -161,6 +169,23 @@ double jsonGetDouble(const std::string& json, const std::string& key) {
     return std::strtod(numStr.c_str(), nullptr);
 }
 
+/// Extract a boolean value from a JSON object (simple parser)
+bool jsonGetBool(const std::string& json, const std::string& key) {
+    std::string searchKey = "\"" + key + "\":";
+    size_t pos = json.find(searchKey);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += searchKey.length();
+
+    // Skip whitespace
+    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) {
+        ++pos;
+    }
+
+    return json.compare(pos, 4, "true") == 0;
+}
+
 /// Format uptime seconds into human readable string
 std::string formatUptime(int64_t seconds) {
     if (seconds < 60) {
@@ -176,6 +201,13 @@ std::string formatUptime(int64_t seconds) {
     return std::to_string(mins) + "m";
 }
 
+/// Format microseconds as milliseconds with one decimal
+std::string formatMs(int64_t us) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << (static_cast<double>(us) / 1000.0);
+    return out.str();
+}
+
 /// Format nanoseconds into human readable string
 std::string formatLatency(int64_t ns) {
     if (ns >= 1000000) {
@@ -238,6 +270,71 @@ std::string jsonGetArrayObject(const std::string& json, const std::string& array
     return json.substr(start, offset - start);
 }
 
+/// End of the JSON value starting at start (simple parser: skips nested
+/// objects, arrays and strings; stops at the ',' or '}' that follows it)
+size_t jsonValueEnd(const std::string& json, size_t start) {
+    int depth = 0;
+    bool inString = false;
+    size_t pos = start;
+    for (; pos < json.length(); ++pos) {
+        char c = json[pos];
+        if (inString) {
+            if (c == '\\') {
+                ++pos;
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                break;
+            }
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            break;
+        }
+    }
+    return pos;
+}
+
+/// Extract any value (object, array, ...) from a JSON object as raw JSON text
+std::string jsonGetRaw(const std::string& json, const std::string& key) {
+    std::string searchKey = "\"" + key + "\":";
+    size_t pos = json.find(searchKey);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos += searchKey.length();
+    return json.substr(pos, jsonValueEnd(json, pos) - pos);
+}
+
+/// Flatten a JSON object to "key=value key=value" for one-line output
+std::string formatFields(const std::string& json) {
+    std::string out;
+    size_t pos = json.find('"');
+    while (pos != std::string::npos) {
+        size_t keyEnd = json.find("\":", pos + 1);
+        if (keyEnd == std::string::npos) {
+            break;
+        }
+        size_t valueStart = keyEnd + 2;
+        size_t valueEnd = jsonValueEnd(json, valueStart);
+        std::string value = json.substr(valueStart, valueEnd - valueStart);
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        if (!out.empty()) {
+            out += ' ';
+        }
+        out += json.substr(pos + 1, keyEnd - pos - 1) + "=" + value;
+        pos = valueEnd < json.length() && json[valueEnd] == ',' ? json.find('"', valueEnd) : std::string::npos;
+    }
+    return out;
+}
+
 /// Print usage information
 void printUsage(const char* progName) {
     std::cout << "Usage: " << progName << " <command> [options]\n"
@@ -246,14 +343,17 @@ void printUsage(const char* progName) {
               << "  reload [--config NAME]  Reload configuration (optionally switch to NAME)\n"
               << "  stop                    Stop the key remapping engine\n"
               << "  start                   Start the key remapping engine\n"
-              << "  status                  Show engine status\n"
+              << "  status [--startup]      Show engine status, or the daemon's startup trace\n"
               << "  config                  Show configuration details\n"
               << "  keymaps                 List loaded keymaps\n"
               << "  metrics                 Show performance metrics\n"
+              << "  watch TOPIC             Stream changes to metrics, locks, keys or config\n"
               << "\n"
               << "Options:\n"
               << "  -c, --config NAME       Specify configuration name for reload\n"
               << "  -j, --json              Output raw JSON (for status, config, keymaps, metrics)\n"
+              << "      --startup           Show startup phases and milestones (for status)\n"
+              << "  -i, --interval MS       Update rate for watch (default: 1000, min: 50)\n"
               << "  -s, --socket PATH       Use custom socket path (default: " << DEFAULT_SOCKET_PATH << ")\n"
               << "  -t, --timeout MS        Response timeout in milliseconds (default: " << DEFAULT_TIMEOUT_MS << ")\n"
               << "  -h, --help              Show this help message\n"
@@ -267,9 +367,12 @@ void printUsage(const char* progName) {
               << "Examples:\n"
               << "  " << progName << " status\n"
               << "  " << progName << " status --json\n"
+              << "  " << progName << " status --startup\n"
               << "  " << progName << " config\n"
               << "  " << progName << " keymaps\n"
               << "  " << progName << " metrics\n"
+              << "  " << progName << " watch locks\n"
+              << "  " << progName << " watch metrics --interval 200 --json\n"
               << "  " << progName << " reload\n"
               << "  " << progName << " reload --config work\n"
               << "  " << progName << " stop\n";
@@ -522,6 +625,76 @@ int cmdStatus(int sock, int timeoutMs, bool rawJson) {
     return COMMAND_FAILED;
 }
 
+/// Execute status --startup command
+/// Lists startup phases (start, wall and CPU time in ms since daemon start)
+/// and milestones such as the hook going live and the first key
+int cmdStartup(int sock, int timeoutMs, bool rawJson) {
+    if (!sendMessage(sock, MessageType::CmdGetStatus, "startup")) {
+        return COMMAND_FAILED;
+    }
+
+    MessageType respType;
+    std::string respData;
+    if (!receiveResponse(sock, timeoutMs, respType, respData)) {
+        return COMMAND_FAILED;
+    }
+
+    if (respType == MessageType::RspStatus || respType == MessageType::RspOk) {
+        if (respData.find("\"phases\"") == std::string::npos) {
+            std::cerr << "Error: Engine does not report a startup trace\n";
+            return COMMAND_FAILED;
+        }
+
+        if (rawJson) {
+            std::cout << respData << "\n";
+            return SUCCESS;
+        }
+
+        std::cout << "Startup trace (ms since daemon start):\n";
+        std::cout << "  " << std::left << std::setw(24) << "Phase"
+                  << std::right << std::setw(10) << "Start"
+                  << std::setw(10) << "Wall"
+                  << std::setw(10) << "CPU" << "\n";
+
+        size_t offset = 0;
+        bool hasDeferred = false;
+        std::string obj;
+        while (!(obj = jsonGetArrayObject(respData, "phases", offset)).empty()) {
+            std::string name = jsonGetString(obj, "name");
+            if (jsonGetBool(obj, "deferred")) {
+                name += " *";
+                hasDeferred = true;
+            }
+            std::cout << "  " << std::left << std::setw(24) << name
+                      << std::right << std::setw(10) << formatMs(jsonGetInt(obj, "start_us"))
+                      << std::setw(10) << formatMs(jsonGetInt(obj, "wall_us"))
+                      << std::setw(10) << formatMs(jsonGetInt(obj, "cpu_us")) << "\n";
+        }
+        if (hasDeferred) {
+            std::cout << "  (* started after the input hook was live)\n";
+        }
+
+        std::cout << "Milestones:\n";
+        offset = 0;
+        int count = 0;
+        while (!(obj = jsonGetArrayObject(respData, "milestones", offset)).empty()) {
+            ++count;
+            std::cout << "  " << std::left << std::setw(24) << jsonGetString(obj, "name")
+                      << std::right << std::setw(10) << formatMs(jsonGetInt(obj, "at_us")) << "\n";
+        }
+        if (count == 0) {
+            std::cout << "  (none yet)\n";
+        }
+        return SUCCESS;
+    } else if (respType == MessageType::RspError) {
+        std::cerr << "Error: " << (respData.empty() ? "Failed to get startup trace" : respData) << "\n";
+        return COMMAND_FAILED;
+    }
+
+    std::cerr << "Error: Unexpected response from engine\n";
+    return COMMAND_FAILED;
+}
+
 /// Execute config command
 /// Shows configuration details: path, name, and when it was loaded
 int cmdConfig(int sock, int timeoutMs, bool rawJson) {
@@ -686,6 +859,47 @@ int cmdMetrics(int sock, int timeoutMs, bool rawJson) {
     return COMMAND_FAILED;
 }
 
+/// Execute watch command: subscribe and print events until the engine goes away
+int cmdWatch(int sock, int timeoutMs, const std::string& topic, int intervalMs, bool rawJson) {
+    if (!sendMessage(sock, MessageType::CmdSubscribe, topic + " " + std::to_string(intervalMs))) {
+        return COMMAND_FAILED;
+    }
+
+    MessageType respType;
+    std::string respData;
+    if (!receiveResponse(sock, timeoutMs, respType, respData)) {
+        return COMMAND_FAILED;
+    }
+    if (respType == MessageType::RspError) {
+        std::cerr << "Error: " << (respData.empty() ? "Failed to watch " + topic : respData) << "\n";
+        return COMMAND_FAILED;
+    }
+    if (respType != MessageType::RspOk) {
+        std::cerr << "Error: Unexpected response from engine\n";
+        return COMMAND_FAILED;
+    }
+    if (!rawJson) {
+        std::cout << respData << " (Ctrl+C to stop)" << std::endl;
+    }
+
+    // Runs until interrupted or the engine closes the connection
+    while (receiveResponse(sock, -1, respType, respData)) {
+        if (respType != MessageType::NtfWatchEvent) {
+            continue;
+        }
+        if (rawJson) {
+            std::cout << respData << std::endl;
+            continue;
+        }
+        std::time_t now = std::time(nullptr);
+        std::tm localTime{};
+        localtime_r(&now, &localTime);
+        std::cout << std::put_time(&localTime, "%H:%M:%S") << " " << topic << " "
+                  << formatFields(jsonGetRaw(respData, "data")) << std::endl;
+    }
+    return COMMAND_FAILED;
+}
+
 } // anonymous namespace
 
 int main(int argc, char* argv[]) {
@@ -693,11 +907,15 @@ int main(int argc, char* argv[]) {
     int timeoutMs = DEFAULT_TIMEOUT_MS;
     std::string configName;
     bool rawJson = false;
+    bool startup = false;
+    int intervalMs = 1000;
 
     // Long options
     static struct option longOpts[] = {
         {"config",  required_argument, nullptr, 'c'},
         {"json",    no_argument,       nullptr, 'j'},
+        {"startup", no_argument,       nullptr, 'S'},
+        {"interval", required_argument, nullptr, 'i'},
         {"socket",  required_argument, nullptr, 's'},
         {"timeout", required_argument, nullptr, 't'},
         {"help",    no_argument,       nullptr, 'h'},
@@ -706,7 +924,7 @@ int main(int argc, char* argv[]) {
 
     // Parse options
     int opt;
-    while ((opt = getopt_long(argc, argv, "c:js:t:h", longOpts, nullptr)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:ji:s:t:h", longOpts, nullptr)) != -1) {
         switch (opt) {
             case 'c':
                 configName = optarg;
@@ -714,6 +932,16 @@ int main(int argc, char* argv[]) {
             case 'j':
                 rawJson = true;
                 break;
+            case 'S':
+                startup = true;
+                break;
+            case 'i':
+                intervalMs = std::atoi(optarg);
+                if (intervalMs <= 0) {
+                    std::cerr << "Error: Invalid interval value\n";
+                    return INVALID_ARGS;
+                }
+                break;
             case 's':
                 socketPath = optarg;
                 break;
@@ -745,12 +973,22 @@ int main(int argc, char* argv[]) {
     // Validate command
     if (command != "reload" && command != "stop" && command != "start" &&
         command != "status" && command != "config" && command != "keymaps" &&
-        command != "metrics") {
+        command != "metrics" && command != "watch") {
         std::cerr << "Error: Unknown command: " << command << "\n\n";
         printUsage(argv[0]);
         return INVALID_ARGS;
     }
 
+    std::string topic;
+    if (command == "watch") {
+        if (optind + 1 >= argc) {
+            std::cerr << "Error: watch needs a topic (metrics, locks, keys, config)\n\n";
+            printUsage(argv[0]);
+            return INVALID_ARGS;
+        }
+        topic = argv[optind + 1];
+    }
+
     // Connect to engine
     int sock = connectToEngine(socketPath);
     if (sock < 0) {
@@ -766,13 +1004,16 @@ int main(int argc, char* argv[]) {
     } else if (command == "start") {
         result = cmdStart(sock, timeoutMs);
     } else if (command == "status") {
-        result = cmdStatus(sock, timeoutMs, rawJson);
+        result = startup ? cmdStartup(sock, timeoutMs, rawJson)
+                         : cmdStatus(sock, timeoutMs, rawJson);
     } else if (command == "config") {
         result = cmdConfig(sock, timeoutMs, rawJson);
     } else if (command == "keymaps") {
         result = cmdKeymaps(sock, timeoutMs, rawJson);
     } else if (command == "metrics") {
         result = cmdMetrics(sock, timeoutMs, rawJson);
+    } else if (command == "watch") {
+        result = cmdWatch(sock, timeoutMs, topic, intervalMs, rawJson);
     } else {
         result = INVALID_ARGS;
     }
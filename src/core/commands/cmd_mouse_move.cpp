@@ -17,6 +17,14 @@ void Command_MouseMove::exec(Engine *i_engine, FunctionParam *i_param) const
 {
     if (!i_param->m_isPressed)
         return;
+#ifndef _WIN32
+    // Relative motion on the uinput device: no round trips to the X server,
+    // and it works without X
+    if (i_engine->m_inputInjector) {
+        i_engine->m_inputInjector->mouseMove(m_dx, m_dy);
+        return;
+    }
+#endif
     yamy::platform::Point pt;
     i_engine->getWindowSystem()->getCursorPos(&pt);
     yamy::platform::Point newPt;
@@ -5,12 +5,13 @@
 
 void Command_Toggle::exec(Engine *i_engine, FunctionParam *i_param) const
 {
-    ModifierLockType i_lock = getArg<0>();
-    ToggleType i_toggle = getArg<1>();
-
     if (i_param->m_isPressed)            // ignore PRESS
         return;
+    apply(i_engine, getArg<0>(), getArg<1>());
+}
 
+void Command_Toggle::apply(Engine *i_engine, ModifierLockType i_lock, ToggleType i_toggle)
+{
     Modifier::Type mt = static_cast<Modifier::Type>(i_lock);
     switch (i_toggle) {
     case ToggleType_toggle:
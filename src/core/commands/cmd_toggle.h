@@ -18,6 +18,8 @@ public:
     }
 
     virtual void exec(Engine *i_engine, FunctionParam *i_param) const override;
+    /// change the lock state (also used by compiled action programs)
+    static void apply(Engine *i_engine, ModifierLockType i_lock, ToggleType i_toggle);
 };
 
 #endif // _CMD_TOGGLE_H
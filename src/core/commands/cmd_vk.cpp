@@ -5,14 +5,18 @@
 #include "../input/input_injector.h" // For InjectionContext
 
 void Command_VK::exec(Engine *i_engine, FunctionParam *i_param) const
+{
+    inject(i_engine, std::get<0>(m_args), i_param->m_isPressed);
+}
+
+void Command_VK::inject(Engine *i_engine, VKey i_vkey, bool i_isPressed)
 {
     // Logic from Engine::funcVK
-    VKey i_vkey = std::get<0>(m_args);
     long key = static_cast<long>(i_vkey);
     BYTE vkey = static_cast<BYTE>(i_vkey);
     bool isExtended = !!(key & VKey_extended);
-    bool isUp       = !i_param->m_isPressed && !!(key & VKey_released);
-    bool isDown     = i_param->m_isPressed && !!(key & VKey_pressed);
+    bool isUp       = !i_isPressed && !!(key & VKey_released);
+    bool isDown     = i_isPressed && !!(key & VKey_pressed);
 
     if (!isUp && !isDown)
         return;
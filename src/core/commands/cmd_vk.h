@@ -13,6 +13,8 @@ public:
     Command_VK() = default;
 
     virtual void exec(Engine *i_engine, FunctionParam *i_param) const override;
+    /// inject i_vkey for one edge (also used by compiled action programs)
+    static void inject(Engine *i_engine, VKey i_vkey, bool i_isPressed);
 };
 
 #endif // _CMD_VK_H
@@ -5,10 +5,14 @@
 
 void Command_Wait::exec(Engine *i_engine, FunctionParam *i_param) const
 {
-    // Logic from Engine::funcWait
-    int milliSecond = std::get<0>(m_args);
     if (!i_param->m_isPressed)
         return;
+    wait(i_engine, std::get<0>(m_args));
+}
+
+void Command_Wait::wait(Engine *i_engine, int milliSecond)
+{
+    // Logic from Engine::funcWait
     if (milliSecond < 0 || 5000 < milliSecond)    // too long wait
         return;
 
@@ -12,6 +12,8 @@ public:
     Command_Wait() = default;
 
     virtual void exec(Engine *i_engine, FunctionParam *i_param) const override;
+    /// sleep with the engine lock released (also used by compiled action programs)
+    static void wait(Engine *i_engine, int i_milliSecond);
 };
 
 #endif // _CMD_WAIT_H
@@ -0,0 +1,129 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// action_program.cpp - Compiled key sequence bytecode interpreter
+
+#include "action_program.h"
+#include <algorithm>
+
+namespace yamy::engine {
+
+uint32_t ActionProgramTable::addProgram(const std::vector<ActionStepCode>& steps)
+{
+    Program program;
+    program.firstStep = static_cast<uint32_t>(m_steps.size());
+    program.stepCount = static_cast<uint32_t>(steps.size());
+
+    for (const auto& code : steps) {
+        Step step;
+        step.press.begin = static_cast<uint32_t>(m_code.size());
+        m_code.insert(m_code.end(), code.press.begin(), code.press.end());
+        step.press.end = static_cast<uint32_t>(m_code.size());
+
+        step.release.begin = step.press.end;
+        m_code.insert(m_code.end(), code.release.begin(), code.release.end());
+        step.release.end = static_cast<uint32_t>(m_code.size());
+
+        m_steps.push_back(step);
+    }
+
+    m_programs.push_back(program);
+    return static_cast<uint32_t>(m_programs.size() - 1);
+}
+
+void ActionProgramTable::clear()
+{
+    m_code.clear();
+    m_steps.clear();
+    m_programs.clear();
+}
+
+bool ActionProgramTable::run(uint32_t program, ActionPart part, int& io_variable, ActionFrame& frame) const
+{
+    return runProgram(program, part, io_variable, frame, 0);
+}
+
+bool ActionProgramTable::runProgram(uint32_t program, ActionPart part, int& io_variable,
+                                    ActionFrame& frame, int depth) const
+{
+    if (program >= m_programs.size()) {
+        return true;
+    }
+    if (depth >= MAX_DEPTH) {
+        return false;
+    }
+
+    const Program& p = m_programs[program];
+    if (p.stepCount == 0) {
+        return true;
+    }
+    const Step* steps = m_steps.data() + p.firstStep;
+    const Step& last = steps[p.stepCount - 1];
+
+    // Same walk as Engine::generateKeySeqEvents()
+    if (part == ActionPart::Up) {
+        return runBlock(last.release, io_variable, frame, depth);
+    }
+    for (uint32_t i = 0; i + 1 < p.stepCount; ++i) {
+        if (!runBlock(steps[i].press, io_variable, frame, depth) ||
+            !runBlock(steps[i].release, io_variable, frame, depth)) {
+            return false;
+        }
+    }
+    if (!runBlock(last.press, io_variable, frame, depth)) {
+        return false;
+    }
+    if (part == ActionPart::All) {
+        return runBlock(last.release, io_variable, frame, depth);
+    }
+    return true;
+}
+
+bool ActionProgramTable::runBlock(const Block& block, int& io_variable, ActionFrame& frame, int depth) const
+{
+    for (uint32_t pc = block.begin; pc < block.end; ++pc) {
+        const ActionInstr& instr = m_code[pc];
+        switch (instr.op) {
+            case ActionOp::Variable:
+                io_variable = io_variable * instr.arg0 + instr.arg1;
+                break;
+
+            case ActionOp::Sequence:
+                if (!runProgram(static_cast<uint32_t>(instr.arg0),
+                                instr.isPressed ? ActionPart::Down : ActionPart::Up,
+                                io_variable, frame, depth + 1)) {
+                    return false;
+                }
+                break;
+
+            case ActionOp::Repeat: {
+                // Same as Command_Repeat: min(variable, max) - 1 full runs, then a press
+                const uint32_t body = static_cast<uint32_t>(instr.arg0);
+                if (!instr.isPressed) {
+                    if (!runProgram(body, ActionPart::Up, io_variable, frame, depth + 1)) {
+                        return false;
+                    }
+                    break;
+                }
+                const int end = std::min(io_variable, instr.arg1);
+                for (int i = 0; i < end - 1; ++i) {
+                    if (!runProgram(body, ActionPart::All, io_variable, frame, depth + 1)) {
+                        return false;
+                    }
+                }
+                if (0 < end && !runProgram(body, ActionPart::Down, io_variable, frame, depth + 1)) {
+                    return false;
+                }
+                break;
+            }
+
+            default:
+                if (frame.size() >= MAX_FRAME_SIZE) {
+                    return false;
+                }
+                frame.push_back(instr);
+                break;
+        }
+    }
+    return true;
+}
+
+} // namespace yamy::engine
@@ -0,0 +1,133 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// action_program.h - Compiled key sequence bytecode
+//
+// A KeySeq is compiled once at setting load into a flat instruction array.
+// Each action of the sequence becomes one step with a press block and a
+// release block, so the Part_all / Part_down / Part_up walk of the legacy
+// generateKeySeqEvents() becomes index arithmetic over the steps.
+//
+// Running a program resolves control instructions (nested sequences, Repeat,
+// Variable) and appends the remaining effect instructions to an output frame,
+// which the Engine applies in one pass.
+
+#ifndef _ACTION_PROGRAM_H
+#define _ACTION_PROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Key;
+class Modifier;
+class Keymap;
+class ActionFunction;
+
+namespace yamy::engine {
+
+/// Bytecode operations
+enum class ActionOp : uint8_t {
+    // Effect instructions, copied into the output frame
+    KeyPress,     ///< key(): press modifier() (merged with input modifiers), then the key
+    KeyRelease,   ///< key(): release the key
+    Wait,         ///< arg0: milliseconds
+    VirtualKey,   ///< arg0: VKey value including VKey_pressed/VKey_released flags
+    Toggle,       ///< arg0: ModifierLockType, arg1: ToggleType
+    Keymap,       ///< keymap(): re-run the current key in another keymap
+    Call,         ///< function(): any other function (&Prefix, ...), run through FunctionData::exec
+
+    // Control instructions, resolved by the interpreter
+    Variable,     ///< variable = variable * arg0 + arg1
+    Repeat,       ///< arg0: program, arg1: maximum count
+    Sequence,     ///< arg0: program of a nested KeySeq
+};
+
+/// One bytecode instruction
+struct ActionInstr {
+    ActionOp op = ActionOp::Call;
+    bool isPressed = true;        ///< Edge this instruction belongs to
+    int32_t arg0 = 0;
+    int32_t arg1 = 0;
+    const void* ptr = nullptr;    ///< Key, Keymap or ActionFunction, depending on op
+    const Modifier* modifier = nullptr; ///< KeyPress only
+
+    const Key* key() const { return static_cast<const Key*>(ptr); }
+    const Keymap* keymap() const { return static_cast<const Keymap*>(ptr); }
+    const ActionFunction* function() const { return static_cast<const ActionFunction*>(ptr); }
+};
+
+/// Which part of a sequence to run (mirrors Engine::Part)
+enum class ActionPart : uint8_t {
+    All,    ///< Every action pressed and released
+    Down,   ///< Every action pressed and released, the last one only pressed
+    Up,     ///< Release of the last action
+};
+
+/// Instructions of one action, before they are added to a table
+struct ActionStepCode {
+    std::vector<ActionInstr> press;
+    std::vector<ActionInstr> release;
+};
+
+/// Output of one program run; capacity is kept between events
+using ActionFrame = std::vector<ActionInstr>;
+
+/// Storage for all compiled programs of one setting
+class ActionProgramTable {
+public:
+    static constexpr uint32_t NO_PROGRAM = std::numeric_limits<uint32_t>::max();
+
+    /// Nesting depth of Sequence/Repeat before a run is aborted (same as the legacy recursion guard)
+    static constexpr int MAX_DEPTH = 64;
+
+    /// Upper bound on frame size; Repeat of nested sequences cannot grow past this
+    static constexpr size_t MAX_FRAME_SIZE = 4096;
+
+    /// Append a program and return its id
+    uint32_t addProgram(const std::vector<ActionStepCode>& steps);
+
+    /**
+     * @brief Run a program and append its effect instructions to frame
+     *
+     * @param program Id returned by addProgram()
+     * @param part Part of the sequence to run
+     * @param io_variable Engine variable used by Variable and Repeat
+     * @param frame Output; not cleared first
+     * @return false if the run was cut short by MAX_DEPTH or MAX_FRAME_SIZE
+     */
+    bool run(uint32_t program, ActionPart part, int& io_variable, ActionFrame& frame) const;
+
+    void clear();
+
+    size_t programCount() const { return m_programs.size(); }
+    size_t instructionCount() const { return m_code.size(); }
+
+private:
+    struct Block {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct Step {
+        Block press;
+        Block release;
+    };
+
+    struct Program {
+        uint32_t firstStep;
+        uint32_t stepCount;
+    };
+
+    bool runProgram(uint32_t program, ActionPart part, int& io_variable,
+                    ActionFrame& frame, int depth) const;
+    bool runBlock(const Block& block, int& io_variable, ActionFrame& frame, int depth) const;
+
+    std::vector<ActionInstr> m_code;
+    std::vector<Step> m_steps;
+    std::vector<Program> m_programs;
+};
+
+} // namespace yamy::engine
+
+#endif // _ACTION_PROGRAM_H
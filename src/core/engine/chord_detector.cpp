@@ -0,0 +1,227 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// chord_detector.cpp - Simultaneous-press chords (J+K -> Escape)
+
+#include "chord_detector.h"
+
+#include <algorithm>
+
+namespace yamy::engine {
+
+//=============================================================================
+// ChordTable
+//=============================================================================
+
+bool ChordTable::addChord(const uint16_t* scans, size_t count, uint32_t id)
+{
+    if (count < 2 || count > MAX_CHORD_SIZE || id == NO_CHORD) {
+        return false;
+    }
+
+    // Validate before assigning any bits so a rejected chord leaves no trace
+    size_t newKeys = 0;
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (scans[i] == scans[j]) return false;
+        }
+        if (!isChordKey(scans[i])) ++newKeys;
+    }
+    if (m_keys.size() + newKeys > MAX_KEYS) {
+        return false;
+    }
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (isChordKey(scans[i])) mask |= bitOf(scans[i]);
+    }
+    if (newKeys == 0) {
+        const Node* existing = find(mask);
+        if (existing && existing->chord != NO_CHORD) return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!isChordKey(scans[i])) {
+            m_isChordKey.set(scans[i]);
+            m_keys.push_back(scans[i]);
+        }
+        mask |= bitOf(scans[i]);
+    }
+
+    // Every non-empty subset of the chord is a node on the way to it
+    for (uint64_t sub = mask; sub != 0; sub = (sub - 1) & mask) {
+        auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), sub,
+                                   [](const Node& n, uint64_t m) { return n.mask < m; });
+        if (it == m_nodes.end() || it->mask != sub) {
+            it = m_nodes.insert(it, Node{sub, NO_CHORD, false});
+        }
+        if (sub == mask) {
+            it->chord = id;
+        } else {
+            it->isPrefix = true;
+        }
+    }
+
+    ++m_chordCount;
+    return true;
+}
+
+uint64_t ChordTable::bitOf(uint16_t scan) const
+{
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        if (m_keys[i] == scan) return uint64_t(1) << i;
+    }
+    return 0;
+}
+
+const ChordTable::Node* ChordTable::find(uint64_t mask) const
+{
+    auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), mask,
+                               [](const Node& n, uint64_t m) { return n.mask < m; });
+    if (it == m_nodes.end() || it->mask != mask) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+//=============================================================================
+// ChordDetector
+//=============================================================================
+
+ChordDetector::ChordDetector(const ChordTable& table, uint32_t windowMs)
+    : m_table(table)
+    , m_windowMs(windowMs)
+    , m_windowId(0)
+    , m_held()
+    , m_heldCount(0)
+    , m_heldMask(0)
+    , m_activeChord(ChordTable::NO_CHORD)
+    , m_activeMask(0)
+    , m_isActiveReleased(false)
+{
+}
+
+void ChordDetector::onKey(const ChordKeyEvent& event, ChordSteps& out)
+{
+    // The event happened after the window closed; its timer tick is still
+    // on the way, so close the window here to keep the original order
+    if (m_heldCount > 0 && m_held[0].timestampUs != 0 &&
+            event.timestampUs >= m_held[0].timestampUs + uint64_t(m_windowMs) * 1000) {
+        onTimeout(out);
+    }
+
+    if (!m_table.isChordKey(event.scan)) {
+        if (m_heldCount > 0) flush(out);
+        ChordStep pass;
+        pass.key = event;
+        out.push(pass);
+        return;
+    }
+
+    const uint64_t bit = m_table.bitOf(event.scan);
+
+    if (m_activeMask & bit) {
+        // Kernel repeats of a key of the active chord have no output
+        if (event.isPressed) return;
+
+        ChordStep step;
+        step.kind = m_isActiveReleased ? ChordStep::Kind::ChordKeyRelease : ChordStep::Kind::ChordRelease;
+        step.chord = m_activeChord;
+        step.key = event;
+        out.push(step);
+        m_isActiveReleased = true;
+        m_activeMask &= ~bit;
+        if (m_activeMask == 0) m_activeChord = ChordTable::NO_CHORD;
+        return;
+    }
+
+    if (m_heldCount > 0) {
+        // Still waiting for the window; the held press stands for the key
+        if (event.isAutoRepeat && (m_heldMask & bit)) return;
+        if (event.isPressed && !event.isAutoRepeat && !(m_heldMask & bit)) {
+            if (const ChordTable::Node* node = m_table.find(m_heldMask | bit)) {
+                m_held[m_heldCount++] = event;
+                m_heldMask |= bit;
+                // Complete at once unless a longer chord could still follow
+                if (node->chord != ChordTable::NO_CHORD && !node->isPrefix) {
+                    complete(node->chord, out);
+                }
+                return;
+            }
+        }
+        flush(out);
+    }
+
+    onIdleKey(event, out);
+}
+
+void ChordDetector::onIdleKey(const ChordKeyEvent& event, ChordSteps& out)
+{
+    // One chord at a time: while one is held, other chord keys type normally.
+    // A repeat belongs to a key that is already down as output, so it never
+    // starts a chord
+    if (event.isPressed && !event.isAutoRepeat && m_activeMask == 0) {
+        const uint64_t bit = m_table.bitOf(event.scan);
+        const ChordTable::Node* node = m_table.find(bit);
+        if (node && node->isPrefix) {
+            m_held[0] = event;
+            m_heldCount = 1;
+            m_heldMask = bit;
+            ++m_windowId;
+            return;
+        }
+    }
+
+    ChordStep pass;
+    pass.key = event;
+    out.push(pass);
+}
+
+void ChordDetector::onTimeout(ChordSteps& out)
+{
+    if (m_heldCount == 0) return;
+
+    const ChordTable::Node* node = m_table.find(m_heldMask);
+    if (node && node->chord != ChordTable::NO_CHORD) {
+        complete(node->chord, out);
+    } else {
+        flush(out);
+    }
+}
+
+void ChordDetector::flush(ChordSteps& out)
+{
+    for (size_t i = 0; i < m_heldCount; ++i) {
+        ChordStep replay;
+        replay.kind = ChordStep::Kind::Replay;
+        replay.key = m_held[i];
+        out.push(replay);
+    }
+    m_heldCount = 0;
+    m_heldMask = 0;
+}
+
+void ChordDetector::complete(uint32_t chord, ChordSteps& out)
+{
+    ChordStep press;
+    press.kind = ChordStep::Kind::ChordPress;
+    press.chord = chord;
+    press.key = m_held[0];
+    out.push(press);
+
+    m_activeChord = chord;
+    m_activeMask = m_heldMask;
+    m_isActiveReleased = false;
+    m_heldCount = 0;
+    m_heldMask = 0;
+}
+
+void ChordDetector::reset()
+{
+    m_heldCount = 0;
+    m_heldMask = 0;
+    m_activeChord = ChordTable::NO_CHORD;
+    m_activeMask = 0;
+    m_isActiveReleased = false;
+    ++m_windowId;
+}
+
+} // namespace yamy::engine
@@ -0,0 +1,177 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// chord_detector.h - Simultaneous-press chords (J+K -> Escape)
+//
+// ChordTable is built once per setting. Every scan code that takes part in a
+// chord gets a bit, and every subset of a chord's bits becomes a trie node:
+// a node is a prefix if some chord contains it, and terminal if it is a
+// chord itself. The set of keys held so far is one uint64_t, so extending a
+// candidate is one OR and one node lookup.
+//
+// ChordDetector runs in the keyboard handler ahead of the per-key pipeline.
+// A press of a chord key opens a window and is held back; further chord keys
+// extend the held set while it stays a prefix. The held keys become the chord
+// when the set is a complete chord that no longer chord contains, or when the
+// window closes on a complete chord. Anything else - a key outside the trie,
+// a release, a closed window on an incomplete set - replays the held events
+// in their original order. Keys not in any chord are passed on at the cost of
+// one bit test. Kernel repeats never open a window: repeats of held keys or
+// of the active chord have no output, any other repeat is passed on.
+//
+// The detector is allocation-free after construction: held events live in a
+// fixed array and results are written to a caller-owned ChordSteps.
+
+#ifndef _CHORD_DETECTOR_H
+#define _CHORD_DETECTOR_H
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace yamy::engine {
+
+/// Compiled chords of one setting
+class ChordTable {
+public:
+    /// Distinct scan codes over all chords
+    static constexpr size_t MAX_KEYS = 64;
+    /// Keys of one chord
+    static constexpr size_t MAX_CHORD_SIZE = 8;
+    static constexpr uint32_t NO_CHORD = std::numeric_limits<uint32_t>::max();
+
+    /// Trie node for one set of held keys
+    struct Node {
+        uint64_t mask;
+        uint32_t chord;     ///< Chord id if the set is a chord, else NO_CHORD
+        bool isPrefix;      ///< Some larger chord contains the set
+    };
+
+    /**
+     * @brief Add a chord
+     * @param scans Scan codes of the chord keys
+     * @param count Number of keys, 2..MAX_CHORD_SIZE
+     * @param id Value reported when the chord completes
+     * @return false if the key count is out of range, a key repeats, the
+     *         same key set is already a chord, or MAX_KEYS would be exceeded
+     */
+    bool addChord(const uint16_t* scans, size_t count, uint32_t id);
+
+    /// Is the scan code part of any chord?
+    bool isChordKey(uint16_t scan) const { return m_isChordKey.test(scan); }
+
+    /// Bit of a chord key in held-key masks; isChordKey() must be true
+    uint64_t bitOf(uint16_t scan) const;
+
+    /// Node for a held-key mask, or nullptr if no chord contains it
+    const Node* find(uint64_t mask) const;
+
+    bool empty() const { return m_chordCount == 0; }
+    size_t chordCount() const { return m_chordCount; }
+    size_t nodeCount() const { return m_nodes.size(); }
+
+private:
+    std::bitset<0x10000> m_isChordKey;
+    std::vector<uint16_t> m_keys;       ///< Scan code of each bit
+    std::vector<Node> m_nodes;          ///< Sorted by mask
+    size_t m_chordCount = 0;
+};
+
+/// One key event as seen by the detector
+struct ChordKeyEvent {
+    uint16_t scan = 0;
+    bool isPressed = false;
+    bool isAutoRepeat = false;  ///< Kernel repeat of a held key
+    uint64_t timestampUs = 0;   ///< Kernel time, 0 if unknown
+};
+
+/// Something the engine must do, in order
+struct ChordStep {
+    enum class Kind : uint8_t {
+        Pass,               ///< Process the event just fed as usual
+        Replay,             ///< Process the held event in key as usual
+        ChordPress,         ///< Chord completed: run its press
+        ChordRelease,       ///< First chord key released (key): run the chord's release
+        ChordKeyRelease,    ///< Later chord key released (key): nothing to output
+    };
+
+    Kind kind = Kind::Pass;
+    uint32_t chord = ChordTable::NO_CHORD;
+    ChordKeyEvent key;
+};
+
+/// Fixed-capacity output of one detector call
+class ChordSteps {
+public:
+    /// Held events, plus the fed event, plus a chord step
+    static constexpr size_t CAPACITY = ChordTable::MAX_CHORD_SIZE + 2;
+
+    void clear() { m_count = 0; }
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const ChordStep& operator[](size_t i) const { return m_steps[i]; }
+    const ChordStep* begin() const { return m_steps.data(); }
+    const ChordStep* end() const { return m_steps.data() + m_count; }
+
+    void push(const ChordStep& step) {
+        if (m_count < CAPACITY) m_steps[m_count++] = step;
+    }
+
+private:
+    std::array<ChordStep, CAPACITY> m_steps;
+    size_t m_count = 0;
+};
+
+/// Runtime chord state of the keyboard handler
+class ChordDetector {
+public:
+    /// @param table Chords to detect; must outlive the detector
+    /// @param windowMs Time after the first held press to complete a chord
+    ChordDetector(const ChordTable& table, uint32_t windowMs);
+
+    /// Feed one key event; steps are appended to out
+    void onKey(const ChordKeyEvent& event, ChordSteps& out);
+
+    /// The window of the held keys closed; steps are appended to out
+    void onTimeout(ChordSteps& out);
+
+    /// Drop all state without output (setting change)
+    void reset();
+
+    /// Keys are held back waiting for the window
+    bool isBuffering() const { return m_heldCount > 0; }
+
+    /// Nothing held back and no chord active
+    bool isIdle() const { return m_heldCount == 0 && m_activeMask == 0; }
+
+    /// Changes each time a new window opens; lets the engine drop stale timer ticks
+    uint32_t windowId() const { return m_windowId; }
+
+    uint32_t windowMs() const { return m_windowMs; }
+
+private:
+    /// Feed an event with no window open
+    void onIdleKey(const ChordKeyEvent& event, ChordSteps& out);
+    /// Replay the held events and close the window
+    void flush(ChordSteps& out);
+    /// Turn the held events into their chord
+    void complete(uint32_t chord, ChordSteps& out);
+
+    const ChordTable& m_table;
+    uint32_t m_windowMs;
+    uint32_t m_windowId;
+
+    std::array<ChordKeyEvent, ChordTable::MAX_CHORD_SIZE> m_held;
+    size_t m_heldCount;
+    uint64_t m_heldMask;
+
+    uint32_t m_activeChord;         ///< Completed chord still held
+    uint64_t m_activeMask;          ///< Its keys not yet released
+    bool m_isActiveReleased;        ///< Its release step was emitted
+};
+
+} // namespace yamy::engine
+
+#endif // _CHORD_DETECTOR_H
@@ -1,6 +1,9 @@
 #pragma once
+#include <array>
 #include <bitset>
+#include <cstdint>
 #include "../input/modifier_state.h" // For ModifierState::TOTAL_BITS
+#include "action_program.h"
 
 namespace yamy::engine {
 
@@ -11,23 +14,79 @@ struct CompiledRule {
     // Bitmask of modifiers that MUST be inactive (0)
     std::bitset<yamy::input::ModifierState::TOTAL_BITS> requiredOff;
 
-    // The output scan code (or action ID)
+    // "At least one of" groups over the standard modifier bits (below
+    // ModifierState::VIRTUAL_OFFSET). A generic Shift/Ctrl/Alt/Win requirement
+    // is one group {L, R}, so C-A-S-W-x compiles to one rule rather than 16
+    // left/right expansions. Only the first anyOfCount entries are used.
+    static constexpr size_t MAX_ANY_OF_GROUPS = 4;
+    std::array<uint16_t, MAX_ANY_OF_GROUPS> anyOf{};
+    uint8_t anyOfCount = 0;
+
+    // Key edges the rule applies to. D-/U- assignments match one edge only,
+    // so D-x and U-x rules of one key do not shadow each other.
+    enum Edge : uint8_t {
+        EDGE_PRESS = 1,
+        EDGE_RELEASE = 2,
+        EDGE_BOTH = EDGE_PRESS | EDGE_RELEASE,
+    };
+    uint8_t edges = EDGE_BOTH;
+
+    // The output scan code (plain substitution, used when program is NO_PROGRAM)
     uint16_t outputScanCode; 
-    
-    // Future: Action abstraction (e.g., KeySeq*, FunctionData*)
-    // void* actionData; 
+
+    // How a compiled program maps onto key edges
+    enum class ProgramMode : uint8_t {
+        Split,          // Press runs ActionPart::Down, release runs ActionPart::Up
+        AllOnPress,     // Assignment written with D-: whole sequence on press only
+        AllOnRelease,   // Assignment written with U-: whole sequence on release only
+    };
+
+    // Compiled KeySeq in the owning ActionProgramTable, or NO_PROGRAM
+    uint32_t program = ActionProgramTable::NO_PROGRAM;
+    ProgramMode programMode = ProgramMode::Split;
+
+    bool hasProgram() const { return program != ActionProgramTable::NO_PROGRAM; }
+
+    // Add an "at least one of" group; returns false if all groups are in use
+    bool addAnyOf(uint16_t stdMask) {
+        if (anyOfCount >= MAX_ANY_OF_GROUPS) return false;
+        anyOf[anyOfCount++] = stdMask;
+        return true;
+    }
+
+    // Pack the standard modifier bits of a state into one word for anyOf checks
+    static uint16_t stdBits(const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& state) {
+        uint16_t bits = 0;
+        for (size_t i = 0; i < yamy::input::ModifierState::STD_MOD_COUNT; ++i) {
+            if (state[yamy::input::ModifierState::STD_OFFSET + i]) bits |= static_cast<uint16_t>(1u << i);
+        }
+        return bits;
+    }
 
     // Helper to check if this rule matches the current state
-    bool matches(const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& currentState) const {
-        // 1. Check ON requirements: (State & OnMask) == OnMask
+    // stdState is stdBits(currentState), computed once per lookup by the caller
+    bool matches(const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& currentState, uint16_t stdState) const {
+        // 1. Check anyOf groups: (StdState & Group) != 0 for every group
+        for (uint8_t i = 0; i < anyOfCount; ++i) {
+            if ((stdState & anyOf[i]) == 0) return false;
+        }
+
+        // 2. Check ON requirements: (State & OnMask) == OnMask
         if ((currentState & requiredOn) != requiredOn) return false;
 
-        // 2. Check OFF requirements: (~State & OffMask) == OffMask
+        // 3. Check OFF requirements: (~State & OffMask) == OffMask
         //    Equivalently: (State & OffMask) == 0
         if ((currentState & requiredOff).any()) return false;
 
         return true;
     }
+
+    bool matches(const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& currentState) const {
+        return matches(currentState, stdBits(currentState));
+    }
+
+    // Does the rule apply to an event on this edge (EDGE_PRESS or EDGE_RELEASE)?
+    bool appliesTo(Edge edge) const { return (edges & edge) != 0; }
 };
 
 } // namespace yamy::engine
\ No newline at end of file
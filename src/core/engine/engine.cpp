@@ -3,6 +3,12 @@
 
 #include "misc.h"
 #include "engine.h"
+#include "../commands/cmd_keymap.h"
+#include "../commands/cmd_repeat.h"
+#include "../commands/cmd_toggle.h"
+#include "../commands/cmd_variable.h"
+#include "../commands/cmd_vk.h"
+#include "../commands/cmd_wait.h"
 #include <algorithm>
 #include <cstring>
 
@@ -130,129 +136,270 @@ void Engine::addKeymapEntry(
     m_virtualKeymap.push_back(entry);
 }
 
-std::vector<yamy::engine::CompiledRule> Engine::compileSubstitute(const Keyboard::Substitute& sub) {
+/// Compile the input conditions of a ModifiedKey into a rule.
+/// Generic Shift/Ctrl/Alt/Win become "at least one of {L, R}" groups, so the
+/// result is always a single rule regardless of how many generic modifiers
+/// the mapping uses. D-/U- restrict the rule to the press or release edge.
+static void compileInputConditions(const ModifiedKey& fromKey, yamy::engine::CompiledRule& rule) {
     using namespace yamy::input;
+    using yamy::engine::CompiledRule;
 
-    std::vector<yamy::engine::CompiledRule> rules;
-    yamy::engine::CompiledRule base_rule;
-
-    // --- Compile Output ---
-    const Key* toKey = sub.m_mkeyTo.m_key;
-    if (toKey && toKey->getScanCodesSize() > 0) {
-        base_rule.outputScanCode = toKey->getScanCodes()[0].m_scan;
-    } else {
-        base_rule.outputScanCode = 0;
-    }
-
-    // --- Compile Input Conditions ---
-    const Modifier& fromMod = sub.m_mkeyFrom.m_modifier;
-    std::vector<std::pair<size_t, size_t>> generic_modifiers;
+    const Modifier& fromMod = fromKey.m_modifier;
 
     // --- Handle Generic Modifiers (Shift, Ctrl, Alt, Win) ---
-    if (fromMod.isOn(Modifier::Type_Shift)) {
-        generic_modifiers.push_back({ModifierState::LSHIFT, ModifierState::RSHIFT});
-    } else if (!fromMod.isDontcare(Modifier::Type_Shift)) {
-        base_rule.requiredOff.set(ModifierState::LSHIFT);
-        base_rule.requiredOff.set(ModifierState::RSHIFT);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Control)) {
-        generic_modifiers.push_back({ModifierState::LCTRL, ModifierState::RCTRL});
-    } else if (!fromMod.isDontcare(Modifier::Type_Control)) {
-        base_rule.requiredOff.set(ModifierState::LCTRL);
-        base_rule.requiredOff.set(ModifierState::RCTRL);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Alt)) {
-        generic_modifiers.push_back({ModifierState::LALT, ModifierState::RALT});
-    } else if (!fromMod.isDontcare(Modifier::Type_Alt)) {
-        base_rule.requiredOff.set(ModifierState::LALT);
-        base_rule.requiredOff.set(ModifierState::RALT);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Windows)) {
-        generic_modifiers.push_back({ModifierState::LWIN, ModifierState::RWIN});
-    } else if (!fromMod.isDontcare(Modifier::Type_Windows)) {
-        base_rule.requiredOff.set(ModifierState::LWIN);
-        base_rule.requiredOff.set(ModifierState::RWIN);
+    static const struct {
+        Modifier::Type type;
+        ModifierState::StdModifier left;
+        ModifierState::StdModifier right;
+    } genericModifiers[] = {
+        {Modifier::Type_Shift, ModifierState::LSHIFT, ModifierState::RSHIFT},
+        {Modifier::Type_Control, ModifierState::LCTRL, ModifierState::RCTRL},
+        {Modifier::Type_Alt, ModifierState::LALT, ModifierState::RALT},
+        {Modifier::Type_Windows, ModifierState::LWIN, ModifierState::RWIN},
+    };
+    for (const auto& generic : genericModifiers) {
+        if (fromMod.isOn(generic.type)) {
+            rule.addAnyOf(static_cast<uint16_t>((1u << generic.left) | (1u << generic.right)));
+        } else if (!fromMod.isDontcare(generic.type)) {
+            rule.requiredOff.set(generic.left);
+            rule.requiredOff.set(generic.right);
+        }
     }
 
     // --- Handle Specific State Modifiers ---
-    if (fromMod.isOn(Modifier::Type_CapsLock)) {
-        base_rule.requiredOn.set(ModifierState::CAPSLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_CapsLock)) {
-        base_rule.requiredOff.set(ModifierState::CAPSLOCK);
-    }
-    if (fromMod.isOn(Modifier::Type_NumLock)) {
-        base_rule.requiredOn.set(ModifierState::NUMLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_NumLock)) {
-        base_rule.requiredOff.set(ModifierState::NUMLOCK);
+    static const struct {
+        Modifier::Type type;
+        ModifierState::StdModifier bit;
+    } stateModifiers[] = {
+        {Modifier::Type_CapsLock, ModifierState::CAPSLOCK},
+        {Modifier::Type_NumLock, ModifierState::NUMLOCK},
+        {Modifier::Type_ScrollLock, ModifierState::SCROLLLOCK},
+    };
+    for (const auto& state : stateModifiers) {
+        if (fromMod.isOn(state.type)) {
+            rule.requiredOn.set(state.bit);
+        } else if (!fromMod.isDontcare(state.type)) {
+            rule.requiredOff.set(state.bit);
+        }
     }
-    if (fromMod.isOn(Modifier::Type_ScrollLock)) {
-        base_rule.requiredOn.set(ModifierState::SCROLLLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_ScrollLock)) {
-        base_rule.requiredOff.set(ModifierState::SCROLLLOCK);
+
+    // --- Handle Key Edge (D-/U-, ~D-/~U-) ---
+    // The edge is not modifier state: the lookup is told which edge it serves
+    if (!fromMod.isDontcare(Modifier::Type_Down)) {
+        rule.edges &= fromMod.isOn(Modifier::Type_Down) ? CompiledRule::EDGE_PRESS
+                                                        : CompiledRule::EDGE_RELEASE;
     }
-     if (fromMod.isOn(Modifier::Type_Up)) {
-        base_rule.requiredOn.set(ModifierState::UP);
-    } else if (!fromMod.isDontcare(Modifier::Type_Up)) {
-        base_rule.requiredOff.set(ModifierState::UP);
+    if (!fromMod.isDontcare(Modifier::Type_Up)) {
+        rule.edges &= fromMod.isOn(Modifier::Type_Up) ? CompiledRule::EDGE_RELEASE
+                                                      : CompiledRule::EDGE_PRESS;
     }
 
     // --- Handle Virtual Modifiers (M00-MFF) ---
     for (int i = 0; i < 256; ++i) {
-        if (sub.m_mkeyFrom.isVirtualModActive(i)) {
-            base_rule.requiredOn.set(ModifierState::VIRTUAL_OFFSET + i);
+        if (fromKey.isVirtualModActive(i)) {
+            rule.requiredOn.set(ModifierState::VIRTUAL_OFFSET + i);
         }
     }
-    
+
     // --- Handle Lock Modifiers (L00-LFF) ---
     for (int i = 0; i < 10; ++i) {
         Modifier::Type lockType = static_cast<Modifier::Type>(Modifier::Type_Lock0 + i);
         if (fromMod.isOn(lockType)) {
-            base_rule.requiredOn.set(ModifierState::LOCK_OFFSET + i);
+            rule.requiredOn.set(ModifierState::LOCK_OFFSET + i);
         } else if (!fromMod.isDontcare(lockType)) {
-            base_rule.requiredOff.set(ModifierState::LOCK_OFFSET + i);
+            rule.requiredOff.set(ModifierState::LOCK_OFFSET + i);
         }
     }
+}
+
+std::optional<yamy::engine::CompiledRule> Engine::compileSubstitute(const Keyboard::Substitute& sub) {
+    yamy::engine::CompiledRule rule;
 
-    // --- Expand Generic Modifiers ---
-    if (generic_modifiers.empty()) {
-        rules.push_back(base_rule);
+    // --- Compile Output ---
+    const Key* toKey = sub.m_mkeyTo.m_key;
+    if (toKey && toKey->getScanCodesSize() > 0) {
+        rule.outputScanCode = toKey->getScanCodes()[0].m_scan;
     } else {
-        size_t num_expansions = 1 << generic_modifiers.size();
-        for (size_t i = 0; i < num_expansions; ++i) {
-            yamy::engine::CompiledRule new_rule = base_rule;
-            for (size_t j = 0; j < generic_modifiers.size(); ++j) {
-                if ((i >> j) & 1) {
-                    new_rule.requiredOn.set(generic_modifiers[j].second); // e.g., RSHIFT
-                } else {
-                    new_rule.requiredOn.set(generic_modifiers[j].first);  // e.g., LSHIFT
-                }
-            }
-            rules.push_back(new_rule);
+        rule.outputScanCode = 0;
+    }
+
+    // --- Compile Input Conditions ---
+    compileInputConditions(sub.m_mkeyFrom, rule);
+
+    return rule;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Action Program Compilation
+
+using yamy::engine::ActionInstr;
+using yamy::engine::ActionOp;
+using yamy::engine::ActionProgramTable;
+using yamy::engine::ActionStepCode;
+
+/// Same Up/Down filter generateActionEvents() applies before running an action
+static bool runsOnEdge(const Modifier& mod, bool doPress) {
+    const Modifier::Type edge = doPress ? Modifier::Type_Down : Modifier::Type_Up;
+    return mod.isOn(edge) || mod.isDontcare(edge);
+}
+
+/// A target key that can be emitted as a plain substitution: no modifiers to
+/// press and no explicit Up/Down restriction
+static bool isPlainKey(const ModifiedKey& mkey) {
+    for (int i = Modifier::Type_begin; i < Modifier::Type_BASIC; ++i) {
+        if (mkey.m_modifier.isPressed(static_cast<Modifier::Type>(i))) {
+            return false;
         }
     }
+    return mkey.m_modifier.isDontcare(Modifier::Type_Up) &&
+           mkey.m_modifier.isDontcare(Modifier::Type_Down);
+}
 
-    return rules;
+static uint32_t compileKeySeqProgram(const KeySeq* keySeq, ActionProgramTable& programs, int depth);
+
+/// Compile a function action. Commands with a dedicated opcode are decoded
+/// here once; everything else becomes a Call through FunctionData::exec.
+static void compileFunctionAction(const ActionFunction* af, ActionStepCode& step,
+                                  ActionProgramTable& programs, int depth) {
+    const FunctionData* fd = af->m_functionData;
+
+    // Nested programs are compiled once, not per edge
+    uint32_t repeatBody = ActionProgramTable::NO_PROGRAM;
+    const auto* repeat = dynamic_cast<const Command_Repeat*>(fd);
+    if (repeat) {
+        repeatBody = compileKeySeqProgram(repeat->getArg<0>(), programs, depth + 1);
+    }
+
+    for (bool doPress : {true, false}) {
+        if (!runsOnEdge(af->m_modifier, doPress)) {
+            continue;
+        }
+
+        ActionInstr instr;
+        instr.isPressed = doPress;
+        if (const auto* vk = dynamic_cast<const Command_VK*>(fd)) {
+            instr.op = ActionOp::VirtualKey;
+            instr.arg0 = static_cast<int32_t>(vk->getArg<0>());
+        } else if (const auto* wait = dynamic_cast<const Command_Wait*>(fd)) {
+            if (!doPress) continue;
+            instr.op = ActionOp::Wait;
+            instr.arg0 = wait->getArg<0>();
+        } else if (const auto* toggle = dynamic_cast<const Command_Toggle*>(fd)) {
+            if (doPress) continue;
+            instr.op = ActionOp::Toggle;
+            instr.arg0 = static_cast<int32_t>(toggle->getArg<0>());
+            instr.arg1 = static_cast<int32_t>(toggle->getArg<1>());
+        } else if (const auto* variable = dynamic_cast<const Command_Variable*>(fd)) {
+            if (!doPress) continue;
+            instr.op = ActionOp::Variable;
+            instr.arg0 = variable->getArg<0>();
+            instr.arg1 = variable->getArg<1>();
+        } else if (repeat) {
+            if (repeatBody == ActionProgramTable::NO_PROGRAM) continue;
+            instr.op = ActionOp::Repeat;
+            instr.arg0 = static_cast<int32_t>(repeatBody);
+            instr.arg1 = repeat->getArg<1>();
+        } else if (const auto* keymap = dynamic_cast<const Command_Keymap*>(fd)) {
+            instr.op = ActionOp::Keymap;
+            instr.ptr = keymap->getArg<0>();
+        } else {
+            instr.op = ActionOp::Call;
+            instr.ptr = af;
+        }
+        (doPress ? step.press : step.release).push_back(instr);
+    }
 }
 
-std::vector<yamy::engine::CompiledRule> Engine::compileKeyAssignment(const Keymap::KeyAssignment& assignment) {
-    using namespace yamy::input;
+/// Compile a KeySeq into programs; returns NO_PROGRAM when nested too deep
+static uint32_t compileKeySeqProgram(const KeySeq* keySeq, ActionProgramTable& programs, int depth) {
+    if (!keySeq || depth >= ActionProgramTable::MAX_DEPTH) {
+        return ActionProgramTable::NO_PROGRAM;
+    }
 
-    std::vector<yamy::engine::CompiledRule> rules;
-    yamy::engine::CompiledRule base_rule;
+    std::vector<ActionStepCode> steps;
+    steps.reserve(keySeq->getActions().size());
+    for (const auto& action : keySeq->getActions()) {
+        ActionStepCode step;
+        switch (action->getType()) {
+        case Action::Type_key: {
+            const ModifiedKey& mkey = static_cast<const ActionKey*>(action.get())->m_modifiedKey;
+            if (runsOnEdge(mkey.m_modifier, true)) {
+                ActionInstr press;
+                press.op = ActionOp::KeyPress;
+                press.isPressed = true;
+                press.ptr = mkey.m_key;
+                press.modifier = &mkey.m_modifier;
+                step.press.push_back(press);
+            }
+            if (runsOnEdge(mkey.m_modifier, false)) {
+                ActionInstr release;
+                release.op = ActionOp::KeyRelease;
+                release.isPressed = false;
+                release.ptr = mkey.m_key;
+                step.release.push_back(release);
+            }
+            break;
+        }
+        case Action::Type_keySeq: {
+            const KeySeq* nested = static_cast<const ActionKeySeq*>(action.get())->m_keySeq;
+            uint32_t body = compileKeySeqProgram(nested, programs, depth + 1);
+            if (body == ActionProgramTable::NO_PROGRAM) {
+                return ActionProgramTable::NO_PROGRAM;
+            }
+            ActionInstr instr;
+            instr.op = ActionOp::Sequence;
+            instr.arg0 = static_cast<int32_t>(body);
+            instr.isPressed = true;
+            step.press.push_back(instr);
+            instr.isPressed = false;
+            step.release.push_back(instr);
+            break;
+        }
+        case Action::Type_function:
+            compileFunctionAction(static_cast<const ActionFunction*>(action.get()), step, programs, depth);
+            break;
+        }
+        steps.push_back(std::move(step));
+    }
+    return programs.addProgram(steps);
+}
 
-    // --- Get the "to" key from the KeySeq ---
-    // For now, only support simple single-key mappings (not sequences)
+std::optional<yamy::engine::CompiledRule> Engine::compileKeyAssignment(const Keymap::KeyAssignment& assignment,
+                                                                       ActionProgramTable& programs) {
     if (!assignment.m_keySeq || assignment.m_keySeq->getActions().empty()) {
-        return rules; // Empty - skip this assignment
+        return std::nullopt; // Skip this assignment
     }
 
-    const Action* firstAction = assignment.m_keySeq->getActions().front().get();
-    if (firstAction->getType() != Action::Type_key) {
-        // Skip non-key actions (sequences, functions) for now
-        return rules;
+    // A plain substitution follows the source key's edges, so a D-/U- source
+    // (whole target on one edge, Part_all) always runs as a program
+    const Modifier& fromMod = assignment.m_modifiedKey.m_modifier;
+    const bool isEdgeSource = fromMod.isOn(Modifier::Type_Down) ||
+                              fromMod.isOn(Modifier::Type_Up);
+
+    const KeySeq::Actions& actions = assignment.m_keySeq->getActions();
+    const Action* firstAction = actions.front().get();
+    if (isEdgeSource || actions.size() != 1 || firstAction->getType() != Action::Type_key ||
+        !isPlainKey(static_cast<const ActionKey*>(firstAction)->m_modifiedKey)) {
+        // Sequences, modified keys and functions run as an action program
+        yamy::engine::CompiledRule rule;
+        rule.outputScanCode = 0;
+        rule.program = compileKeySeqProgram(assignment.m_keySeq, programs, 0);
+        if (!rule.hasProgram()) {
+            Acquire a(&m_log, 0);
+            m_log << "warning: key sequence " << assignment.m_keySeq->getName()
+                  << " is nested too deeply to compile" << std::endl;
+            return std::nullopt;
+        }
+
+        // D-/U- assignments run the whole sequence on their edge (Part_all)
+        if (fromMod.isOn(Modifier::Type_Down)) {
+            rule.programMode = yamy::engine::CompiledRule::ProgramMode::AllOnPress;
+        } else if (fromMod.isOn(Modifier::Type_Up)) {
+            rule.programMode = yamy::engine::CompiledRule::ProgramMode::AllOnRelease;
+        }
+
+        compileInputConditions(assignment.m_modifiedKey, rule);
+        return rule;
     }
 
     const ActionKey* actionKey = static_cast<const ActionKey*>(firstAction);
@@ -270,105 +417,19 @@ std::vector<yamy::engine::CompiledRule> Engine::compileKeyAssignment(const Keyma
         }
     }
 
+    yamy::engine::CompiledRule rule;
+
     // --- Compile Output ---
     if (toKey.m_key && toKey.m_key->getScanCodesSize() > 0) {
-        base_rule.outputScanCode = toKey.m_key->getScanCodes()[0].m_scan;
+        rule.outputScanCode = toKey.m_key->getScanCodes()[0].m_scan;
     } else {
-        base_rule.outputScanCode = 0;
+        rule.outputScanCode = 0;
     }
 
     // --- Compile Input Conditions (from assignment.m_modifiedKey) ---
-    const ModifiedKey& fromKey = assignment.m_modifiedKey;
-    const Modifier& fromMod = fromKey.m_modifier;
-    std::vector<std::pair<size_t, size_t>> generic_modifiers;
-
-    // --- Handle Generic Modifiers (Shift, Ctrl, Alt, Win) ---
-    if (fromMod.isOn(Modifier::Type_Shift)) {
-        generic_modifiers.push_back({ModifierState::LSHIFT, ModifierState::RSHIFT});
-    } else if (!fromMod.isDontcare(Modifier::Type_Shift)) {
-        base_rule.requiredOff.set(ModifierState::LSHIFT);
-        base_rule.requiredOff.set(ModifierState::RSHIFT);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Control)) {
-        generic_modifiers.push_back({ModifierState::LCTRL, ModifierState::RCTRL});
-    } else if (!fromMod.isDontcare(Modifier::Type_Control)) {
-        base_rule.requiredOff.set(ModifierState::LCTRL);
-        base_rule.requiredOff.set(ModifierState::RCTRL);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Alt)) {
-        generic_modifiers.push_back({ModifierState::LALT, ModifierState::RALT});
-    } else if (!fromMod.isDontcare(Modifier::Type_Alt)) {
-        base_rule.requiredOff.set(ModifierState::LALT);
-        base_rule.requiredOff.set(ModifierState::RALT);
-    }
-
-    if (fromMod.isOn(Modifier::Type_Windows)) {
-        generic_modifiers.push_back({ModifierState::LWIN, ModifierState::RWIN});
-    } else if (!fromMod.isDontcare(Modifier::Type_Windows)) {
-        base_rule.requiredOff.set(ModifierState::LWIN);
-        base_rule.requiredOff.set(ModifierState::RWIN);
-    }
-
-    // --- Handle Specific State Modifiers ---
-    if (fromMod.isOn(Modifier::Type_CapsLock)) {
-        base_rule.requiredOn.set(ModifierState::CAPSLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_CapsLock)) {
-        base_rule.requiredOff.set(ModifierState::CAPSLOCK);
-    }
-    if (fromMod.isOn(Modifier::Type_NumLock)) {
-        base_rule.requiredOn.set(ModifierState::NUMLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_NumLock)) {
-        base_rule.requiredOff.set(ModifierState::NUMLOCK);
-    }
-    if (fromMod.isOn(Modifier::Type_ScrollLock)) {
-        base_rule.requiredOn.set(ModifierState::SCROLLLOCK);
-    } else if (!fromMod.isDontcare(Modifier::Type_ScrollLock)) {
-        base_rule.requiredOff.set(ModifierState::SCROLLLOCK);
-    }
-    if (fromMod.isOn(Modifier::Type_Up)) {
-        base_rule.requiredOn.set(ModifierState::UP);
-    } else if (!fromMod.isDontcare(Modifier::Type_Up)) {
-        base_rule.requiredOff.set(ModifierState::UP);
-    }
-
-    // --- Handle Virtual Modifiers (M00-MFF) ---
-    for (int i = 0; i < 256; ++i) {
-        if (fromKey.isVirtualModActive(i)) {
-            base_rule.requiredOn.set(ModifierState::VIRTUAL_OFFSET + i);
-        }
-    }
-
-    // --- Handle Lock Modifiers (L00-LFF) ---
-    for (int i = 0; i < 10; ++i) {
-        Modifier::Type lockType = static_cast<Modifier::Type>(Modifier::Type_Lock0 + i);
-        if (fromMod.isOn(lockType)) {
-            base_rule.requiredOn.set(ModifierState::LOCK_OFFSET + i);
-        } else if (!fromMod.isDontcare(lockType)) {
-            base_rule.requiredOff.set(ModifierState::LOCK_OFFSET + i);
-        }
-    }
-
-    // --- Expand Generic Modifiers ---
-    if (generic_modifiers.empty()) {
-        rules.push_back(base_rule);
-    } else {
-        size_t num_expansions = 1 << generic_modifiers.size();
-        for (size_t i = 0; i < num_expansions; ++i) {
-            yamy::engine::CompiledRule new_rule = base_rule;
-            for (size_t j = 0; j < generic_modifiers.size(); ++j) {
-                if ((i >> j) & 1) {
-                    new_rule.requiredOn.set(generic_modifiers[j].second); // e.g., RSHIFT
-                } else {
-                    new_rule.requiredOn.set(generic_modifiers[j].first);  // e.g., LSHIFT
-                }
-            }
-            rules.push_back(new_rule);
-        }
-    }
+    compileInputConditions(assignment.m_modifiedKey, rule);
 
-    return rules;
+    return rule;
 }
 
 // Query keymap status for window (simplified - always returns Global keymap)
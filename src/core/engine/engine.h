@@ -29,7 +29,16 @@
 #  include "../platform/message_constants.h"
 #  include "engine_event_processor.h" // For unified 3-layer event processing
 #  include "compiled_rule.h" // For CompiledRule
+#  include "engine_clock.h" // For EventTimeClock
+#  include "passthrough_map.h" // For PassthroughMap
+#  include "tick_timer.h" // For TickTimer
+#  include "chord_detector.h" // For ChordDetector
+#  include "mouse_keys.h" // For MouseKeys
+#  include "../logger/journey_feed.h" // For JourneyFeed
+#  include <atomic>
 #  include <functional>
+#  include <mutex>
+#  include <optional>
 #  include <gsl/gsl>
 
 enum {
@@ -49,6 +58,14 @@ enum EngineNotify {
 };
 
 
+namespace yamy::test {
+class MicroBenchAccess;
+}
+
+namespace yamy::settings {
+class JsonConfigLoader;
+}
+
 /// Callback type for configuration switch notifications
 using ConfigSwitchCallback = std::function<void(bool success, const std::string& configPath)>;
 
@@ -59,6 +76,9 @@ private:
     enum {
         MAX_GENERATE_KEYBOARD_EVENTS_RECURSION_COUNT = 64, ///
         MAX_KEYMAP_PREFIX_HISTORY = 64, ///
+        MIN_COMPACTED_ACTION_INSTRUCTIONS = 1024, /** patched program code
+                                                    below twice this is never
+                                                    rebuilt */
     };
 
     typedef Keymaps::KeymapPtrList KeymapPtrList;    ///
@@ -84,6 +104,7 @@ private:
     };
 
     friend class FunctionParam;
+    friend class yamy::test::MicroBenchAccess; /// stage microbenchmarks
 
 #include "../functions/function_friends.h"
 
@@ -159,7 +180,16 @@ private:
     yamy::platform::WindowHandle m_hwndAssocWindow;            /** associated window (we post
                                                     message to it) */
     Setting * volatile m_setting;            /// setting
-    std::string m_currentConfigPath;        /// currently loaded config path (guard against reload loops)
+    std::string m_currentConfigPath;        /** currently loaded config path
+                                                    (guard against reload loops,
+                                                    m_reloadMutex) */
+    std::mutex m_reloadMutex;            /** one switch / reload at a time:
+                                                    the config watcher and IPC
+                                                    reload from their own
+                                                    threads */
+    std::unique_ptr<yamy::settings::JsonConfigLoader> m_configLoader; /** loader
+                                                    of m_setting, kept to patch
+                                                    it on reload (m_cs) */
     yamy::platform::IWindowSystem *m_windowSystem;            /// window system abstraction
     ConfigStore *m_configStore;            /// config store abstraction
     ConfigSwitchCallback m_configSwitchCallback; /// config switch notification callback
@@ -168,14 +198,59 @@ private:
     yamy::platform::IInputDriver *m_inputDriver;            /// input driver abstraction
     std::unique_ptr<yamy::platform::IIPCChannel> m_ipcChannel; /// IPC channel for UI communication
 #if defined(QT_CORE_LIB)
-    std::unique_ptr<yamy::audio::SoundManager> m_soundManager;
+    std::unique_ptr<yamy::audio::SoundManager> m_soundManager; /// created by the first playSound()
+    std::once_flag m_soundManagerOnce;
 #endif
+    std::unique_ptr<yamy::logger::JourneyFeed> m_journeyFeed; /** investigate
+                                                    mode live log, sent in
+                                                    batches from its own
+                                                    thread; declared after
+                                                    m_ipcChannel so it stops
+                                                    first */
 
     // engine thread state
     yamy::platform::ThreadHandle m_threadHandle;
     unsigned m_threadId;
     std::deque<yamy::platform::KeyEvent> *m_inputQueue;
     yamy::platform::MutexHandle m_queueMutex;
+    /// keys pushInputEvent() may inject directly (written under m_cs and
+    /// m_queueMutex)
+    std::shared_ptr<const yamy::engine::PassthroughMap> m_passthroughKeys;
+    bool m_isHandlingInput;            /** keyboard handler is processing a
+                                                    dequeued event (m_queueMutex) */
+    bool m_isPassthroughOpen;            /** engine state allows passthrough
+                                                    (m_queueMutex) */
+    int m_heldRuleKeyCount;            /** physically pressed keys not in
+                                                    m_passthroughKeys */
+
+    // engine-generated autorepeat (Setting::m_engineAutoRepeat)
+    std::unique_ptr<yamy::engine::TickTimer> m_autoRepeatTimer;
+    std::atomic<bool> m_isEngineAutoRepeat;    /** drop kernel repeats in
+                                                    pushInputEvent() */
+    std::atomic<bool> m_isAutoRepeatTickQueued; /// a tick is in m_inputQueue
+    std::atomic<uint32_t> m_autoRepeatGeneration; /** bumped on every start /
+                                                    stop; stale ticks are
+                                                    ignored */
+    Key *m_autoRepeatSourceKey;            /// physical key being held
+    yamy::platform::KeyEvent m_autoRepeatEvent; /** its press, replayed on
+                                                    every tick */
+    uint32_t m_autoRepeatChord;            /** chord being held, or
+                                                    ChordTable::NO_CHORD */
+
+    // simultaneous-press chords (Setting::m_chords, m_cs)
+    std::unique_ptr<yamy::engine::ChordTable> m_chordTable;
+    std::unique_ptr<yamy::engine::ChordDetector> m_chordDetector; /** null
+                                                    if the setting has no
+                                                    chords */
+    std::unique_ptr<yamy::engine::TickTimer> m_chordTimer;
+    std::atomic<uint32_t> m_chordTimerWindow;    /** detector window the
+                                                    timer is armed for */
+
+    // mouse keys (Setting::m_mouseKeys); the timer thread injects the motion
+    std::shared_ptr<yamy::engine::MouseKeys> m_mouseKeys; /** null if no key
+                                                    is bound; std::atomic_load
+                                                    on the timer thread */
+    std::unique_ptr<yamy::engine::TickTimer> m_mouseKeysTimer;
 
     yamy::platform::EventHandle m_readEvent;                /** reading from mayu device
                                                     has been completed */
@@ -199,7 +274,12 @@ private:
                                                     phisically ? */
     int m_currentKeyPressCountOnWin32;        /** how many keys are pressed
                                                     on win32 ? */
+    uint64_t m_pressedModifierSlots;        /** modifier keys pressed
+                                                    phisically, by
+                                                    Key::m_modifierSlot */
     Key *m_lastGeneratedKey;            /// last generated key
+    uint32_t m_generatedKeyDownCount;        /** key presses generated so
+                                                    far (wraps) */
     Key *m_lastPressedKey[2];            /// last pressed key
     ModifiedKey m_oneShotKey;            /// one shot key
     unsigned int m_oneShotRepeatableRepeatCount; /// repeat count of one shot key
@@ -243,6 +323,9 @@ private:
 
     // Event processing
     std::shared_ptr<yamy::EventProcessor> m_eventProcessor; /// Unified 3-layer event processor
+    size_t m_builtActionInstructions;    /** action program instructions
+                                                    of the last full build */
+    std::shared_ptr<yamy::engine::EventTimeClock> m_eventClock; /// Engine time, advanced by kernel event timestamps
     yamy::input::ModifierState m_modifierState; /// Modal and hardware modifier state tracking
 
     /// Keymap entry for virtual modifier/lock-based key matching
@@ -275,6 +358,15 @@ public:
     /// Convert KeyEvent to KEYBOARD_INPUT_DATA (for legacy code)
     static KEYBOARD_INPUT_DATA keyEventToKID(const yamy::platform::KeyEvent &event);
 
+    /// KeyEvent::flags bit set by pushInputEvent() on events it already injected
+    static constexpr uint32_t KEY_EVENT_PASSED_THROUGH = 0x80000000u;
+
+    /// KeyEvent::extraInfo of autorepeat ticks; flags carries the generation
+    static constexpr uintptr_t KEY_EVENT_AUTO_REPEAT_TICK = 0x59414D52u;
+
+    /// KeyEvent::extraInfo of chord window timeouts; flags carries the window
+    static constexpr uintptr_t KEY_EVENT_CHORD_TIMEOUT = 0x59414D43u;
+
     /// Get current setting (Thread Safe - check for nullptr)
     const Setting *getSetting() const { return m_setting; }
 
@@ -294,12 +386,60 @@ private:
     static void* keyboardHandler(void *i_this);
     /// keyboard handler thread (instance method)
     void keyboardHandler();
+    /// run one dequeued key event through chords and per-key processing
+    void handleKeyEvent(const yamy::platform::KeyEvent &i_event);
+    /// per-key processing of one key event (m_cs held)
+    void processKeyEvent(const yamy::platform::KeyEvent &i_event);
 
     /// performance metrics thread (static entry point)
     static void* perfMetricsHandler(void *i_this);
     /// performance metrics thread (instance method)
     void perfMetricsHandler();
 
+    /// set physical key state and update press count and modifier slots
+    void setPhysicallyPressed(Key *i_key, bool i_isPressed);
+    /// rebuild m_pressedModifierSlots from the keys of m_setting
+    void resetPressedModifierSlots();
+    /// is i_key forwarded unchanged by the engine in any state ?
+    bool isPassthroughKey(const Key *i_key) const;
+    /// may pushInputEvent() inject passthrough keys itself ? (keyboard
+    /// handler thread only)
+    bool canPassThrough() const;
+    /// update output state for a key pushInputEvent() already injected
+    void recordPassthroughKeyEvent(Key *i_key, bool i_isPressed);
+    /// queue an autorepeat tick (timer thread)
+    void pushAutoRepeatTick();
+    /// start or stop autorepeat after i_key was pressed or released by
+    /// i_event, or by chord i_chord (keyboard handler thread, m_cs held);
+    /// i_keyDownsBefore is m_generatedKeyDownCount before the press
+    void updateAutoRepeat(Key *i_key, bool i_isPressed,
+                          uint32_t i_keyDownsBefore,
+                          const yamy::platform::KeyEvent *i_event,
+                          uint32_t i_chord = yamy::engine::ChordTable::NO_CHORD);
+    /// is i_key a modifier or lock key, which never autorepeat ?
+    bool isAutoRepeatModifier(const Key *i_key) const;
+    /// run the held key or chord through the keymaps again, or stop if it
+    /// is no longer held (keyboard handler thread)
+    void handleAutoRepeatTick(uint32_t i_generation);
+    /// stop repeating
+    void stopAutoRepeat();
+    /// rebuild m_chordTable and m_chordDetector from m_setting (m_cs held)
+    void buildChordDetector();
+    /// carry out detector output; i_current is the event just fed, or
+    /// nullptr on timeout (m_cs held)
+    void runChordSteps(const yamy::engine::ChordSteps &i_steps,
+                       const yamy::platform::KeyEvent *i_current);
+    /// queue a chord window timeout (timer thread)
+    void pushChordTimeout();
+    /// close the chord window if it is still i_window (keyboard handler thread)
+    void handleChordTimeout(uint32_t i_window);
+    /// rebuild m_mouseKeys from m_setting (m_cs held)
+    void buildMouseKeys();
+    /// feed a key bound to mouse keys; false if i_event's key is not bound
+    /// (keyboard handler thread, m_cs held)
+    bool handleMouseKey(const yamy::platform::KeyEvent &i_event);
+    /// inject the pointer motion since the previous tick (timer thread)
+    void handleMouseKeysTick();
     /// is modifier pressed ?
     bool isPressed(Modifier::Type i_mt);
     /// fix modifier key
@@ -323,6 +463,12 @@ private:
     ///
     void generateKeySeqEvents(const Current &i_c, const KeySeq *i_keySeq,
                               Part i_part);
+    /// run a function action for one edge
+    void execFunctionAction(const Current &i_c, const ActionFunction *i_af,
+                            bool i_doPress);
+    /// apply the output frame of a compiled action program
+    void applyActionFrame(const Current &i_c,
+                          const yamy::engine::ActionFrame &i_frame);
     ///
     void generateKeyboardEvents(const Current &i_c);
     ///
@@ -363,6 +509,18 @@ private:
     /// @param keyboard Reference to Keyboard object with substitution mappings
     void buildSubstitutionTable(const Keyboard &keyboard);
 
+    /// Recompile the rules of i_keys in the live EventProcessor after their
+    /// Global keymap assignments were patched (m_cs held); rebuilds the whole
+    /// table once replaced action programs make up most of it
+    void patchSubstitutionTable(const std::vector<Key *> &i_keys);
+
+    /// Parse a configuration file into a new setting and apply it
+    /// (m_reloadMutex held)
+    bool loadConfiguration(const std::string& configPath);
+
+    /// Build m_passthroughKeys from the rules of i_processor and m_setting
+    void buildPassthroughMap(const yamy::EventProcessor &i_processor);
+
     /// Lookup keymap entry with modifier/lock matching and specificity priority
     /// @param key Input YAMY scan code to match
     /// @param mods Active modifier state (M00-MFF)
@@ -382,10 +540,15 @@ private:
                         const uint32_t required_locks[8]);
 
     /// Compile a legacy Substitute rule into the new format for the O(1) lookup table
-    std::vector<yamy::engine::CompiledRule> compileSubstitute(const Keyboard::Substitute& sub);
+    /// Each substitute compiles to exactly one rule (generic modifiers use anyOf groups)
+    std::optional<yamy::engine::CompiledRule> compileSubstitute(const Keyboard::Substitute& sub);
 
     /// Compile a Keymap::KeyAssignment rule into the new format for the O(1) lookup table
-    std::vector<yamy::engine::CompiledRule> compileKeyAssignment(const Keymap::KeyAssignment& assignment);
+    /// A single plain key compiles to a substitution; sequences, keys with modifiers and
+    /// functions compile to an action program stored in @p programs
+    /// @return std::nullopt for assignments with an empty KeySeq
+    std::optional<yamy::engine::CompiledRule> compileKeyAssignment(const Keymap::KeyAssignment& assignment,
+                                                                   yamy::engine::ActionProgramTable& programs);
 
     /** open mayu device
         @return true if mayu device successfully is opened
@@ -498,6 +661,17 @@ public:
      */
     bool switchConfiguration(const std::string& configPath);
 
+    /**
+     * @brief Re-read a configuration file, even if it is the active one
+     * @param configPath Path to the JSON configuration file
+     * @return true if the file was applied, false on parse errors
+     *
+     * When only the "mappings" of the active file changed, the rules of the
+     * affected keys are recompiled in place instead of loading a new
+     * setting; any other edit falls back to a full load.
+     */
+    bool reloadConfiguration(const std::string& configPath);
+
     /// Set callback for configuration switch notifications
     void setConfigSwitchCallback(ConfigSwitchCallback callback) {
         m_configSwitchCallback = callback;
@@ -553,6 +727,19 @@ public:
         return m_state;
     }
 
+    /// Name of the keymap keys are currently looked up in (prefix keymaps
+    /// included), or "" before a setting is loaded
+    std::string getCurrentKeymapName() {
+        Acquire a(&m_cs);
+        return m_currentKeymap ? m_currentKeymap->getName() : std::string();
+    }
+
+    /// Active locks (L00-LFF) as a bitmask: bit (n % 32) of o_lockBits[n / 32] is L<n>
+    /// @note Read without synchronization, like the GUI lock status request
+    void getLockBits(uint32_t o_lockBits[8]) const {
+        m_modifierState.getLockBits(o_lockBits);
+    }
+
 #if defined(QT_CORE_LIB)
     /// Play a notification sound
     void playSound(yamy::audio::NotificationType type);
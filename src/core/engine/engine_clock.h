@@ -0,0 +1,102 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// engine_clock.h - Pluggable time source for engine timing decisions
+//
+// Hold/tap detection and other timing decisions ask an IClock for "now"
+// instead of calling std::chrono::steady_clock directly. In production the
+// engine uses an EventTimeClock that is advanced with the kernel timestamp of
+// each input event, so decisions reflect when keys were physically pressed
+// rather than when the event was dequeued. Tests and replay use ManualClock to
+// drive time deterministically without sleeping.
+//
+// All clocks share the CLOCK_MONOTONIC time base (steady_clock on Linux) and
+// report microseconds.
+
+#ifndef _ENGINE_CLOCK_H
+#define _ENGINE_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace yamy::engine {
+
+/// Engine time point: microseconds since the CLOCK_MONOTONIC epoch
+using ClockTime = std::chrono::microseconds;
+
+/// Abstract time source used by timing-sensitive engine components
+class IClock {
+public:
+    virtual ~IClock() = default;
+
+    /// Current engine time
+    virtual ClockTime now() const = 0;
+};
+
+/// Wall-clock time source backed by std::chrono::steady_clock
+class SteadyClock final : public IClock {
+public:
+    ClockTime now() const override {
+        return std::chrono::duration_cast<ClockTime>(
+            std::chrono::steady_clock::now().time_since_epoch());
+    }
+};
+
+/// Time source driven by kernel input event timestamps
+///
+/// The reader thread stamps each event with its input_event time; the engine
+/// thread calls advanceTo() before processing it. Time never moves backwards,
+/// and events without a timestamp (0) leave the clock where it is. Until the
+/// first timestamped event arrives the clock falls back to steady_clock.
+///
+/// Thread safety: advanceTo() is called from the engine thread only; now()
+/// may be read from any thread.
+class EventTimeClock final : public IClock {
+public:
+    EventTimeClock() : m_lastEventUs(0) {}
+
+    ClockTime now() const override {
+        int64_t us = m_lastEventUs.load(std::memory_order_acquire);
+        if (us == 0) {
+            return m_fallback.now();
+        }
+        return ClockTime(us);
+    }
+
+    /// Advance to an event timestamp (microseconds, CLOCK_MONOTONIC)
+    /// @param timestamp_us Kernel event timestamp, or 0 if unknown
+    void advanceTo(uint64_t timestamp_us) {
+        int64_t us = static_cast<int64_t>(timestamp_us);
+        if (us > m_lastEventUs.load(std::memory_order_relaxed)) {
+            m_lastEventUs.store(us, std::memory_order_release);
+        }
+    }
+
+private:
+    std::atomic<int64_t> m_lastEventUs;
+    SteadyClock m_fallback;
+};
+
+/// Manually driven time source for tests and deterministic replay
+class ManualClock final : public IClock {
+public:
+    explicit ManualClock(ClockTime start = ClockTime(1000000)) : m_now(start) {}
+
+    ClockTime now() const override { return m_now; }
+
+    /// Set absolute time
+    void set(ClockTime t) { m_now = t; }
+
+    /// Advance time by a duration
+    template <typename Rep, typename Period>
+    void advance(std::chrono::duration<Rep, Period> d) {
+        m_now += std::chrono::duration_cast<ClockTime>(d);
+    }
+
+private:
+    ClockTime m_now;
+};
+
+} // namespace yamy::engine
+
+#endif // _ENGINE_CLOCK_H
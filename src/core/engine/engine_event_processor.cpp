@@ -20,6 +20,8 @@ EventProcessor::EventProcessor()
     , m_modifierHandler(std::make_unique<engine::ModifierKeyHandler>())
     , m_currentEventIsTap(false)
     , m_lookupTable(std::make_unique<engine::RuleLookupTable>())
+    , m_actionPrograms(std::make_unique<engine::ActionProgramTable>())
+    , m_currentEventHasFrame(false)
 {
     // Check for debug logging environment variable
     const char* debug_env = std::getenv("YAMY_DEBUG_KEYCODE");
@@ -34,10 +36,12 @@ EventProcessor::EventProcessor()
 
 EventProcessor::~EventProcessor() = default;
 
-EventProcessor::ProcessedEvent EventProcessor::processEvent(uint16_t input_evdev, EventType type, input::ModifierState* io_modState)
+EventProcessor::ProcessedEvent EventProcessor::processEvent(uint16_t input_evdev, EventType type, input::ModifierState* io_modState,
+                                                           int* io_variable)
 {
-    // Reset TAP flag for this event
+    // Reset TAP and frame flags for this event
     m_currentEventIsTap = false;
+    m_currentEventHasFrame = false;
 
     // Check all WAITING virtual modifiers and activate those that exceeded threshold
     // This ensures that if a modifier key is held while another key is pressed,
@@ -80,7 +84,7 @@ EventProcessor::ProcessedEvent EventProcessor::processEvent(uint16_t input_evdev
     }
 
     // Layer 2: Apply substitution (with number modifier and lock support)
-    uint16_t yamy_l2 = layer2_applySubstitution(yamy_l1, type, io_modState);
+    uint16_t yamy_l2 = layer2_applySubstitution(yamy_l1, type, io_modState, io_variable);
 
     if (yamy::logger::JourneyLogger::isEnabled() || m_journeyCallback) {
         journey.yamy_output = yamy_l2;
@@ -88,6 +92,28 @@ EventProcessor::ProcessedEvent EventProcessor::processEvent(uint16_t input_evdev
         // Number modifier info will be filled by layer2 if applicable
     }
 
+    // A compiled action program replaces Layer 3: the frame holds the whole output
+    if (m_currentEventHasFrame) {
+        if (yamy::logger::JourneyLogger::isEnabled() || m_journeyCallback) {
+            journey.was_substituted = true;
+            journey.output_key_name = "(action)";
+            journey.end_time = std::chrono::steady_clock::now();
+            journey.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                journey.end_time - journey.start_time).count();
+            journey.valid = true;
+            if (yamy::logger::JourneyLogger::isEnabled()) {
+                yamy::logger::JourneyLogger::logJourney(journey);
+            }
+            if (m_journeyCallback) {
+                m_journeyCallback(journey);
+            }
+        }
+
+        ProcessedEvent result(0, 0, type, true);
+        result.frame = &m_frame;
+        return result;
+    }
+
     // Layer 3: YAMY scan code → evdev
     uint16_t output_evdev = layer3_yamyToEvdev(yamy_l2);
     if (output_evdev == 0) {
@@ -146,7 +172,8 @@ uint16_t EventProcessor::layer1_evdevToYamy(uint16_t evdev)
     return yamy;
 }
 
-uint16_t EventProcessor::layer2_applySubstitution(uint16_t yamy_in, EventType type, input::ModifierState* io_modState)
+uint16_t EventProcessor::layer2_applySubstitution(uint16_t yamy_in, EventType type, input::ModifierState* io_modState,
+                                                  int* io_variable)
 {
     if (m_debugLogging) {
         LOG_DEBUG("[TEST] [LAYER2] Processing yamy 0x{:04X} modHandler={} modState={}",
@@ -226,7 +253,17 @@ uint16_t EventProcessor::layer2_applySubstitution(uint16_t yamy_in, EventType ty
     // Step 1: Apply substitution using the new RuleLookupTable
     if (io_modState && m_lookupTable) {
         const auto& state = io_modState->getFullState();
-        if (const auto* match = m_lookupTable->findMatch(yamy_in, state)) {
+        const auto edge = (type == EventType::PRESS) ? engine::CompiledRule::EDGE_PRESS
+                                                     : engine::CompiledRule::EDGE_RELEASE;
+        if (const auto* match = m_lookupTable->findMatch(yamy_in, state, edge)) {
+            if (match->hasProgram()) {
+                runProgram(*match, type, io_variable);
+                if (m_debugLogging) {
+                    LOG_DEBUG("[TEST] [LAYER2] RULE MATCH: yamy 0x{:04X} → program {} ({} output ops)",
+                              yamy_in, match->program, m_frame.size());
+                }
+                return 0;
+            }
             if (m_debugLogging) {
                 LOG_DEBUG("[TEST] [LAYER2] RULE MATCH: yamy 0x{:04X} → 0x{:04X}",
                           yamy_in, match->outputScanCode);
@@ -243,6 +280,38 @@ uint16_t EventProcessor::layer2_applySubstitution(uint16_t yamy_in, EventType ty
     return yamy_in;
 }
 
+void EventProcessor::runProgram(const engine::CompiledRule& rule, EventType type, int* io_variable)
+{
+    using Mode = engine::CompiledRule::ProgramMode;
+
+    m_frame.clear();
+    m_currentEventHasFrame = true;
+
+    const bool isPress = (type == EventType::PRESS);
+    engine::ActionPart part;
+    switch (rule.programMode) {
+        case Mode::AllOnPress:
+            if (!isPress) return;
+            part = engine::ActionPart::All;
+            break;
+        case Mode::AllOnRelease:
+            if (isPress) return;
+            part = engine::ActionPart::All;
+            break;
+        case Mode::Split:
+        default:
+            part = isPress ? engine::ActionPart::Down : engine::ActionPart::Up;
+            break;
+    }
+
+    int localVariable = 0;
+    int& variable = io_variable ? *io_variable : localVariable;
+    if (!m_actionPrograms->run(rule.program, part, variable, m_frame)) {
+        LOG_WARN("[EventProcessor] Action program {} exceeded depth/size limit; output truncated to {} ops",
+                 rule.program, m_frame.size());
+    }
+}
+
 uint16_t EventProcessor::layer3_yamyToEvdev(uint16_t yamy)
 {
     if (m_debugLogging) {
@@ -285,6 +354,13 @@ void EventProcessor::setModifierHandler(std::unique_ptr<engine::ModifierKeyHandl
     m_modifierHandler = std::move(handler);
 }
 
+void EventProcessor::setClock(std::shared_ptr<const engine::IClock> clock)
+{
+    if (m_modifierHandler) {
+        m_modifierHandler->setClock(std::move(clock));
+    }
+}
+
 void EventProcessor::registerVirtualModifiers(const std::unordered_map<uint8_t, uint16_t>& mod_tap_actions)
 {
     if (m_modifierHandler) {
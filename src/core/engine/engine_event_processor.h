@@ -11,6 +11,8 @@
 #include <functional>
 #include <string>
 #include "lookup_table.h"
+#include "action_program.h"
+#include "engine_clock.h"
 
 namespace yamy {
 
@@ -29,6 +31,11 @@ namespace engine {
 class ModifierKeyHandler;
 }
 
+// Forward declaration for benchmark access to the individual layers
+namespace test {
+class MicroBenchAccess;
+}
+
 /// Event type enumeration for key events
 enum class EventType {
     RELEASE = 0,  // Key released
@@ -49,12 +56,15 @@ public:
         EventType type;         ///< Event type (PRESS/RELEASE)
         bool valid;             ///< false if unmapped at any layer
         bool is_tap;            ///< true if this is a TAP event that needs PRESS+RELEASE output
+        /// Output of a compiled action program, or nullptr for a single-key result.
+        /// Owned by the EventProcessor and valid until the next processEvent() call.
+        const engine::ActionFrame* frame;
 
         ProcessedEvent()
-            : output_evdev(0), output_yamy(0), type(EventType::RELEASE), valid(false), is_tap(false) {}
+            : output_evdev(0), output_yamy(0), type(EventType::RELEASE), valid(false), is_tap(false), frame(nullptr) {}
 
         ProcessedEvent(uint16_t evdev, uint16_t yamy, EventType t, bool v, bool tap = false)
-            : output_evdev(evdev), output_yamy(yamy), type(t), valid(v), is_tap(tap) {}
+            : output_evdev(evdev), output_yamy(yamy), type(t), valid(v), is_tap(tap), frame(nullptr) {}
     };
 
     /// Constructor
@@ -67,9 +77,11 @@ public:
     /// @param input_evdev Input evdev code from hardware
     /// @param type Event type (PRESS or RELEASE)
     /// @param io_modState Pointer to modifier state (input/output) - updated during processing (optional)
-    /// @return Processed event with output evdev code and validity
+    /// @param io_variable Engine variable read and written by compiled &Variable/&Repeat (optional)
+    /// @return Processed event with output evdev code and validity, or an action frame
     /// @note Event type is ALWAYS preserved: PRESS in = PRESS out
-    ProcessedEvent processEvent(uint16_t input_evdev, EventType type, input::ModifierState* io_modState = nullptr);
+    ProcessedEvent processEvent(uint16_t input_evdev, EventType type, input::ModifierState* io_modState = nullptr,
+                                int* io_variable = nullptr);
 
     /// Enable or disable debug logging
     /// @param enabled true to enable debug logging
@@ -92,6 +104,10 @@ public:
     /// @return Pointer to handler, or nullptr if not set
     engine::ModifierKeyHandler* getModifierHandler() { return m_modifierHandler.get(); }
 
+    /// Set the time source used for hold/tap decisions
+    /// @param clock Shared clock (typically the engine's EventTimeClock); forwarded to the modifier handler
+    void setClock(std::shared_ptr<const engine::IClock> clock);
+
     /// Register virtual modifiers (M00-MFF) with tap actions
     /// @param mod_tap_actions Map of modifier number (0x00-0xFF) to tap output keycode
     void registerVirtualModifiers(const std::unordered_map<uint8_t, uint16_t>& mod_tap_actions);
@@ -116,13 +132,28 @@ public:
     engine::RuleLookupTable* getLookupTable() {
         return m_lookupTable.get();
     }
+    const engine::RuleLookupTable* getLookupTable() const {
+        return m_lookupTable.get();
+    }
+
+    /// Get the table holding action programs referenced by CompiledRule::program
+    engine::ActionProgramTable* getActionPrograms() {
+        return m_actionPrograms.get();
+    }
 
 private:
+    friend class test::MicroBenchAccess;
+
     /// Layer 1: Map evdev code to YAMY scan code
     uint16_t layer1_evdevToYamy(uint16_t evdev);
 
     /// Layer 2: Apply substitution from .mayu configuration
-    uint16_t layer2_applySubstitution(uint16_t yamy_in, EventType type, input::ModifierState* io_modState);
+    /// Sets m_currentEventHasFrame when the matched rule ran an action program into m_frame
+    uint16_t layer2_applySubstitution(uint16_t yamy_in, EventType type, input::ModifierState* io_modState,
+                                      int* io_variable = nullptr);
+
+    /// Run a matched rule's program for this edge into m_frame
+    void runProgram(const engine::CompiledRule& rule, EventType type, int* io_variable);
 
     /// Layer 3: Map YAMY scan code to output evdev code
     uint16_t layer3_yamyToEvdev(uint16_t yamy);
@@ -132,6 +163,9 @@ private:
     JourneyEventCallback m_journeyCallback;         ///< Callback for journey event notifications
     bool m_currentEventIsTap;                       ///< Set by layer2 when TAP detected on RELEASE
     std::unique_ptr<engine::RuleLookupTable> m_lookupTable; ///< New bucket-based lookup table
+    std::unique_ptr<engine::ActionProgramTable> m_actionPrograms; ///< Compiled KeySeq programs
+    engine::ActionFrame m_frame;                    ///< Output of the last program run (reused)
+    bool m_currentEventHasFrame;                    ///< Set by layer2 when a program ran
 };
 
 } // namespace yamy
@@ -11,6 +11,9 @@
 #include "stringtool.h"
 #include "windowstool.h"
 #include "../../utils/platform_logger.h"
+#include "../commands/cmd_toggle.h"
+#include "../commands/cmd_vk.h"
+#include "../commands/cmd_wait.h"
 
 #include <iomanip>
 
@@ -54,6 +57,8 @@ void Engine::generateKeyEvent(Key *i_key, bool i_doPress, bool i_isByAssign)
             }
 
             m_lastGeneratedKey = i_doPress ? i_key : nullptr;
+            if (i_doPress)
+                ++ m_generatedKeyDownCount;
         }
     }
 
@@ -206,29 +211,86 @@ void Engine::generateActionEvents(const Current &i_c, const Action *i_a,
         if (!is_down && !is_up)
             break;
 
-        {
-            Acquire a(&m_log, 1);
-            m_log << "\t\t     >\t" << af->m_functionData;
-        }
+        execFunctionAction(i_c, af, i_doPress);
+        break;
+    }
+    }
+}
 
-        FunctionParam param;
-        param.m_isPressed = i_doPress;
-        param.m_hwnd = m_windowSystem->getForegroundWindow();
-        param.m_c = i_c;
-        param.m_doesNeedEndl = true;
-        param.m_af = af;
 
-        param.m_c.m_mkey.m_modifier.on(Modifier::Type_Up, !i_doPress);
-        param.m_c.m_mkey.m_modifier.on(Modifier::Type_Down, i_doPress);
+// run a function action for one edge
+void Engine::execFunctionAction(const Current &i_c, const ActionFunction *i_af,
+                                bool i_doPress)
+{
+    {
+        Acquire a(&m_log, 1);
+        m_log << "\t\t     >\t" << i_af->m_functionData;
+    }
 
-        af->m_functionData->exec(this, &param);
+    FunctionParam param;
+    param.m_isPressed = i_doPress;
+    param.m_hwnd = m_windowSystem->getForegroundWindow();
+    param.m_c = i_c;
+    param.m_doesNeedEndl = true;
+    param.m_af = i_af;
 
-        if (param.m_doesNeedEndl) {
-            Acquire a(&m_log, 1);
-            m_log << std::endl;
-        }
-        break;
+    param.m_c.m_mkey.m_modifier.on(Modifier::Type_Up, !i_doPress);
+    param.m_c.m_mkey.m_modifier.on(Modifier::Type_Down, i_doPress);
+
+    i_af->m_functionData->exec(this, &param);
+
+    if (param.m_doesNeedEndl) {
+        Acquire a(&m_log, 1);
+        m_log << std::endl;
     }
+}
+
+
+// apply the output frame of a compiled action program
+// Instructions were filtered by edge at compile time and control flow was
+// resolved by the interpreter, so this is a single pass over effects.
+void Engine::applyActionFrame(const Current &i_c,
+                              const yamy::engine::ActionFrame &i_frame)
+{
+    using yamy::engine::ActionOp;
+
+    for (const yamy::engine::ActionInstr &instr : i_frame) {
+        switch (instr.op) {
+        case ActionOp::KeyPress: {
+            Modifier modifier = *instr.modifier;
+            modifier.add(i_c.m_mkey.m_modifier);
+            generateModifierEvents(modifier);
+            generateKeyEvent(const_cast<Key *>(instr.key()), true, true);
+            break;
+        }
+        case ActionOp::KeyRelease:
+            generateKeyEvent(const_cast<Key *>(instr.key()), false, true);
+            break;
+        case ActionOp::Wait:
+            Command_Wait::wait(this, instr.arg0);
+            break;
+        case ActionOp::VirtualKey:
+            Command_VK::inject(this, static_cast<VKey>(instr.arg0), instr.isPressed);
+            break;
+        case ActionOp::Toggle:
+            Command_Toggle::apply(this, static_cast<ModifierLockType>(instr.arg0),
+                                  static_cast<ToggleType>(instr.arg1));
+            break;
+        case ActionOp::Keymap: {
+            Current c(i_c);
+            c.m_keymap = instr.keymap();
+            c.m_mkey.m_modifier.on(Modifier::Type_Up, !instr.isPressed);
+            c.m_mkey.m_modifier.on(Modifier::Type_Down, instr.isPressed);
+            generateKeyboardEvents(c);
+            break;
+        }
+        case ActionOp::Call:
+            execFunctionAction(i_c, instr.function(), instr.isPressed);
+            break;
+        default:
+            // Control instructions never reach a frame
+            break;
+        }
     }
 }
 
@@ -363,16 +425,27 @@ void Engine::beginGeneratingKeyboardEvents(
     // Take a thread-safe shared_ptr copy to prevent use-after-free if
     // setSetting() replaces m_eventProcessor on the main thread while the
     // keyboard handler thread is processing an event.
+    // A prefix keymap is only known to the legacy keymap walk below
     auto eventProcessor = std::atomic_load(&m_eventProcessor);
-    if (eventProcessor && i_c.m_evdev_code != 0) {
+    const bool isEventProcessed =
+        eventProcessor && i_c.m_evdev_code != 0 && !m_isPrefix;
+    yamy::EventProcessor::ProcessedEvent result;
+    if (isEventProcessed) {
         // Determine event type from modifier state
         yamy::EventType event_type = isPhysicallyPressed ? yamy::EventType::PRESS : yamy::EventType::RELEASE;
 
         // Process through all 3 layers
         // Pass ModifierState to track and update modal modifier state (mod0-mod19)
         // LockState is now integrated into ModifierState
-        yamy::EventProcessor::ProcessedEvent result = eventProcessor->processEvent(i_c.m_evdev_code, event_type, &m_modifierState);
+        result = eventProcessor->processEvent(i_c.m_evdev_code, event_type,
+                                              &m_modifierState, &m_variable);
+    }
 
+    if (result.frame) {
+        // Compiled action program (key sequence, modified key or function):
+        // the frame replaces generateKeyboardEvents() below, and the event
+        // keymaps, kill-line and prefix bookkeeping still run around it
+    } else if (isEventProcessed) {
         // CRITICAL: Check if event was suppressed at Layer 3 (virtual key, lock key, etc.)
         // If output_evdev is 0, the event should NOT be generated/output
         if (result.output_evdev == 0) {
@@ -545,9 +618,13 @@ void Engine::beginGeneratingKeyboardEvents(
     if (isPhysicallyPressed)
         generateEvents(cnew, cnew.m_keymap, &Event::before_key_down);
 
-    std::cerr << "[GEN] Calling generateKeyboardEvents..." << std::endl;
-    generateKeyboardEvents(cnew);
-    std::cerr << "[GEN] generateKeyboardEvents returned" << std::endl;
+    if (result.frame) {
+        applyActionFrame(i_c, *result.frame);
+    } else {
+        std::cerr << "[GEN] Calling generateKeyboardEvents..." << std::endl;
+        generateKeyboardEvents(cnew);
+        std::cerr << "[GEN] generateKeyboardEvents returned" << std::endl;
+    }
     if (!isPhysicallyPressed)
         generateEvents(cnew, cnew.m_keymap, &Event::after_key_up);
 
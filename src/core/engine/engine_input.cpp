@@ -9,10 +9,25 @@
 #include "hook.h"
 #include "mayurc.h"
 #include "windowstool.h"
+#include "../platform/sync.h"
+#include "../../platform/linux/keycode_mapping.h"
 
+#include <chrono>
 #include <iomanip>
 
 
+namespace {
+
+/// Clock shared by mouse key events and mouse keys ticks
+uint64_t mouseKeysNowUs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+
 unsigned int Engine::injectInput(const KEYBOARD_INPUT_DATA *i_kid, const void *i_kidRaw)
 {
     if (i_kid->ExtraInformation == 0x59414D59) {
@@ -51,3 +66,305 @@ void Engine::keyboardResetOnWin32()
             generateKeyEvent((*i), false, true);
     }
 }
+
+
+bool Engine::isPassthroughKey(const Key *i_key) const
+{
+    if (!m_passthroughKeys || i_key->getScanCodesSize() != 1)
+        return false;
+    const ScanCode &sc = i_key->getScanCodes()[0];
+    return sc.m_flags == 0 && m_passthroughKeys->test(sc.m_scan);
+}
+
+
+bool Engine::canPassThrough() const
+{
+    // Conservative: any state that could make the engine treat a key
+    // differently than "forward it unchanged" closes the fast path
+    return m_setting && m_isEnabled && !m_isLogMode && !m_isInvestigateMode &&
+        !m_isPrefix && m_currentKeymap == m_globalKeymap &&
+        !m_oneShotKey.m_key && m_heldRuleKeyCount == 0 &&
+        (!m_chordDetector || m_chordDetector->isIdle()) &&
+        !hasActiveVirtualModifiers();
+}
+
+
+void Engine::recordPassthroughKeyEvent(Key *i_key, bool i_isPressed)
+{
+    // same bookkeeping as generateKeyEvent(), without injecting
+    if (i_isPressed && !i_key->m_isPressedOnWin32)
+        ++ m_currentKeyPressCountOnWin32;
+    else if (!i_isPressed && i_key->m_isPressedOnWin32)
+        -- m_currentKeyPressCountOnWin32;
+    i_key->m_isPressedOnWin32 = i_isPressed;
+    m_lastGeneratedKey = i_isPressed ? i_key : nullptr;
+    if (i_isPressed)
+        ++ m_generatedKeyDownCount;
+}
+
+
+void Engine::pushAutoRepeatTick()
+{
+    // At most one tick waits in the queue; a slow handler gets one repeat
+    // when it catches up, not a burst
+    if (m_isAutoRepeatTickQueued.exchange(true))
+        return;
+
+    yamy::platform::KeyEvent tick = {};
+    tick.extraInfo = KEY_EVENT_AUTO_REPEAT_TICK;
+    tick.flags = m_autoRepeatGeneration.load();
+
+    yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
+    if (m_inputQueue) {
+        m_inputQueue->push_back(tick);
+        yamy::platform::setEvent(m_readEvent);
+    } else {
+        m_isAutoRepeatTickQueued = false;
+    }
+    yamy::platform::releaseMutex(m_queueMutex);
+}
+
+
+void Engine::updateAutoRepeat(Key *i_key, bool i_isPressed,
+                              uint32_t i_keyDownsBefore,
+                              const yamy::platform::KeyEvent *i_event,
+                              uint32_t i_chord)
+{
+    if (!m_isEngineAutoRepeat || !m_autoRepeatTimer)
+        return;
+    // Our own repeats must not restart the delay
+    if (i_event && i_event->isAutoRepeat)
+        return;
+
+    if (!i_isPressed) {
+        if (i_key == m_autoRepeatSourceKey)
+            stopAutoRepeat();
+        return;
+    }
+
+    // Like kernel autorepeat, a new press takes over from the key repeating
+    // so far. Modifier keys, and keys whose press output a modifier, do not
+    // repeat.
+    stopAutoRepeat();
+    // Mouse buttons (no event) never repeat
+    if (!i_event && i_chord == yamy::engine::ChordTable::NO_CHORD)
+        return;
+    Key *output = m_generatedKeyDownCount != i_keyDownsBefore ?
+                  m_lastGeneratedKey : nullptr;
+    if (isAutoRepeatModifier(i_key) || (output && isAutoRepeatModifier(output)))
+        return;
+
+    // Per-key timing is looked up by the key the press output, if any
+    Setting::AutoRepeatTiming timing = m_setting->m_autoRepeat;
+    if (output && output->getScanCodesSize() != 0) {
+        Setting::AutoRepeatTimings::const_iterator found =
+            m_setting->m_autoRepeatKeys.find(output->getScanCodes()[0].m_scan);
+        if (found != m_setting->m_autoRepeatKeys.end())
+            timing = found->second;
+    }
+    if (timing.m_interval == 0)
+        return;
+
+    m_autoRepeatSourceKey = i_key;
+    m_autoRepeatChord = i_chord;
+    m_autoRepeatEvent = {};
+    if (i_event) {
+        m_autoRepeatEvent = *i_event;
+        m_autoRepeatEvent.flags &= ~KEY_EVENT_PASSED_THROUGH;
+        m_autoRepeatEvent.isAutoRepeat = true;
+    }
+    m_autoRepeatTimer->arm(timing.m_delay, timing.m_interval);
+}
+
+
+bool Engine::isAutoRepeatModifier(const Key *i_key) const
+{
+    if (0 <= i_key->m_modifierSlot)
+        return true;
+    if (i_key->getScanCodesSize() != 0 &&
+            yamy::platform::isModifierKey(
+                yamy::platform::yamyToEvdevKeyCode(i_key->getScanCodes()[0].m_scan)))
+        return true;
+    for (int i = Modifier::Type_begin; i != Modifier::Type_BASIC; ++ i) {
+        const Keyboard::Mods &mods =
+            m_setting->m_keyboard.getModifiers(static_cast<Modifier::Type>(i));
+        for (Keyboard::Mods::const_iterator j = mods.begin(); j != mods.end(); ++ j)
+            if (*j == i_key)
+                return true;
+    }
+    return false;
+}
+
+
+void Engine::handleAutoRepeatTick(uint32_t i_generation)
+{
+    Acquire a(&m_cs);
+    m_isAutoRepeatTickQueued = false;
+    if (i_generation != m_autoRepeatGeneration.load() || !m_autoRepeatSourceKey)
+        return;
+
+    // Anything that released the source ends the repeat, even if no release
+    // event reached updateAutoRepeat()
+    if (!m_setting || !m_isEnabled || !m_autoRepeatSourceKey->m_isPressed) {
+        stopAutoRepeat();
+        return;
+    }
+
+    // The held key goes through the keymaps again, as a kernel repeat would,
+    // so key sequences and functions bound to it repeat too
+    if (m_autoRepeatChord == yamy::engine::ChordTable::NO_CHORD) {
+        processKeyEvent(m_autoRepeatEvent);
+        return;
+    }
+    const Setting::Chord &chord = m_setting->m_chords[m_autoRepeatChord];
+    Current c;
+    c.m_keymap = m_currentKeymap;
+    c.m_mkey.m_key = chord.m_keys.front();
+    c.m_mkey.m_modifier = getCurrentModifiers(c.m_mkey.m_key, true);
+    generateKeySeqEvents(c, chord.m_keySeq, Part_down);
+    if (m_currentKeyPressCount <= 0)
+        generateModifierEvents(Modifier());
+}
+
+
+void Engine::stopAutoRepeat()
+{
+    ++ m_autoRepeatGeneration;
+    m_autoRepeatSourceKey = nullptr;
+    m_autoRepeatChord = yamy::engine::ChordTable::NO_CHORD;
+    if (m_autoRepeatTimer)
+        m_autoRepeatTimer->disarm();
+}
+
+
+void Engine::runChordSteps(const yamy::engine::ChordSteps &i_steps,
+                           const yamy::platform::KeyEvent *i_current)
+{
+    using yamy::engine::ChordStep;
+
+    for (const ChordStep &step : i_steps) {
+        if (step.kind == ChordStep::Kind::Pass) {
+            if (i_current)
+                processKeyEvent(*i_current);
+            continue;
+        }
+        if (step.kind == ChordStep::Kind::Replay) {
+            yamy::platform::KeyEvent replay = {};
+            replay.scanCode = step.key.scan;
+            replay.isKeyDown = step.key.isPressed;
+            replay.timestampUs = step.key.timestampUs;
+            processKeyEvent(replay);
+            continue;
+        }
+
+        // The chord keys are pressed from the first press to their own
+        // release, but only the chord's key sequence is output
+        const Setting::Chord &chord = m_setting->m_chords[step.chord];
+        if (step.kind == ChordStep::Kind::ChordPress) {
+            for (Key *chordKey : chord.m_keys)
+                setPhysicallyPressed(chordKey, true);
+        } else {
+            Key scanKey;
+            scanKey.addScanCode(ScanCode(step.key.scan, 0));
+            if (Key *key = m_setting->m_keyboard.searchKey(scanKey))
+                setPhysicallyPressed(key, false);
+        }
+
+        if (step.kind != ChordStep::Kind::ChordKeyRelease) {
+            const bool isPressed = step.kind == ChordStep::Kind::ChordPress;
+            const uint32_t keyDownsBefore = m_generatedKeyDownCount;
+            Current c;
+            c.m_keymap = m_currentKeymap;
+            c.m_mkey.m_key = chord.m_keys.front();
+            c.m_mkey.m_modifier = getCurrentModifiers(c.m_mkey.m_key, isPressed);
+            {
+                Acquire b(&m_log, 1);
+                m_log << "* chord " << *chord.m_keySeq
+                      << (isPressed ? " pressed" : " released") << std::endl;
+            }
+            generateKeySeqEvents(c, chord.m_keySeq, isPressed ? Part_down : Part_up);
+            // The chord repeats as long as it is held, like a single key
+            if (!m_isLogMode)
+                updateAutoRepeat(c.m_mkey.m_key, isPressed, keyDownsBefore,
+                                 nullptr, step.chord);
+        }
+
+        if (m_currentKeyPressCount <= 0)
+            generateModifierEvents(Modifier());
+    }
+
+    if (m_chordDetector->isBuffering() &&
+            m_chordDetector->windowId() != m_chordTimerWindow.load()) {
+        m_chordTimerWindow = m_chordDetector->windowId();
+        m_chordTimer->arm(m_chordDetector->windowMs(), 0);
+    }
+}
+
+
+void Engine::pushChordTimeout()
+{
+    yamy::platform::KeyEvent tick = {};
+    tick.extraInfo = KEY_EVENT_CHORD_TIMEOUT;
+    tick.flags = m_chordTimerWindow.load();
+
+    yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
+    if (m_inputQueue) {
+        m_inputQueue->push_back(tick);
+        yamy::platform::setEvent(m_readEvent);
+    }
+    yamy::platform::releaseMutex(m_queueMutex);
+}
+
+
+void Engine::handleChordTimeout(uint32_t i_window)
+{
+    Acquire a(&m_cs);
+    // A later event may already have closed the window, or a new one opened
+    if (!m_setting || !m_chordDetector || !m_chordDetector->isBuffering() ||
+            m_chordDetector->windowId() != i_window)
+        return;
+
+    yamy::engine::ChordSteps steps;
+    m_chordDetector->onTimeout(steps);
+    runChordSteps(steps, nullptr);
+}
+
+
+bool Engine::handleMouseKey(const yamy::platform::KeyEvent &i_event)
+{
+    const uint16_t scan = static_cast<uint16_t>(i_event.scanCode);
+    if (!m_mouseKeys->isBound(scan))
+        return false;
+
+    // Only the start and end of motion touch the timer; key repeats and
+    // further keys change what the running ticks produce
+    if (m_mouseKeys->onKey(scan, i_event.isKeyDown, mouseKeysNowUs())) {
+        if (m_mouseKeys->isActive())
+            m_mouseKeysTimer->arm(1000 / m_setting->m_mouseKeysRate,
+                                  1000 / m_setting->m_mouseKeysRate);
+        else
+            m_mouseKeysTimer->disarm();
+    }
+    return true;
+}
+
+
+void Engine::handleMouseKeysTick()
+{
+    std::shared_ptr<yamy::engine::MouseKeys> mouseKeys = std::atomic_load(&m_mouseKeys);
+    if (!mouseKeys || !m_inputInjector)
+        return;
+
+    // Disabling the engine also drops the keys it will not see released
+    if (!m_isEnabled) {
+        mouseKeys->reset();
+        m_mouseKeysTimer->disarm();
+        return;
+    }
+
+    const yamy::engine::MouseKeysStep step = mouseKeys->tick(mouseKeysNowUs());
+    if (step.dx != 0 || step.dy != 0)
+        m_inputInjector->mouseMove(step.dx, step.dy);
+    if (step.wheel != 0)
+        m_inputInjector->mouseWheel(step.wheel);
+}
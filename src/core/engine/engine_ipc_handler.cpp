@@ -80,15 +80,7 @@ void Engine::handleIpcMessage(const yamy::ipc::Message& message)
 
         // Send current lock state to GUI
         yamy::ipc::LockStatusMessage msg;
-        std::memset(msg.lockBits, 0, sizeof(msg.lockBits));
-        
-        const auto& state = m_modifierState.getFullState();
-        // Locks are at LOCK_OFFSET in ModifierState
-        for (int i = 0; i < 256; ++i) {
-            if (state.test(yamy::input::ModifierState::LOCK_OFFSET + i)) {
-                msg.lockBits[i / 32] |= (1U << (i % 32));
-            }
-        }
+        getLockBits(msg.lockBits);
 
         yamy::ipc::Message response;
         response.type = toIpcType(yamy::MessageType::LockStatusUpdate);
@@ -180,7 +172,7 @@ void Engine::handleIpcMessage(const yamy::ipc::Message& message)
         }
 
         if (error.empty()) {
-            if (switchConfiguration(targetPath)) {
+            if (reloadConfiguration(targetPath)) {
                 ConfigManager::instance().setActiveConfig(targetPath);
             } else {
                 error = "Failed to reload config: " + targetPath;
@@ -244,23 +236,35 @@ void Engine::handleIpcMessage(const yamy::ipc::Message& message)
         case yamy::ipc::CmdEnableInvestigateMode:
             m_isInvestigateMode = true;
 
-            if (m_eventProcessor) {
-                m_eventProcessor->setJourneyEventCallback(
-                    [this](const yamy::logger::JourneyEvent& journey) {
-                        if (m_ipcChannel && m_ipcChannel->isConnected()) {
-                            std::string formattedLine = yamy::logger::JourneyLogger::formatJourneyLine(journey);
+            // The engine thread only queues a record; the feed thread
+            // formats and sends the live log lines in batches
+            if (!m_journeyFeed) {
+                m_journeyFeed = std::make_unique<yamy::logger::JourneyFeed>(
+                    [this](const std::string& lines, uint32_t count, uint32_t dropped) {
+                        if (!m_ipcChannel || !m_ipcChannel->isConnected()) {
+                            return;
+                        }
 
-                            yamy::ipc::KeyEventNotification notification;
-                            strncpy(notification.keyEvent, formattedLine.c_str(), sizeof(notification.keyEvent) - 1);
-                            notification.keyEvent[sizeof(notification.keyEvent) - 1] = '\0';
+                        const yamy::ipc::KeyEventBatchHeader header{count, dropped};
+                        std::string payload(sizeof(header), '\0');
+                        std::memcpy(payload.data(), &header, sizeof(header));
+                        payload += lines;
 
-                            yamy::ipc::Message msg;
-                            msg.type = yamy::ipc::NtfKeyEvent;
-                            msg.data = &notification;
-                            msg.size = sizeof(notification);
+                        yamy::ipc::Message msg;
+                        msg.type = yamy::ipc::NtfKeyEventBatch;
+                        msg.data = payload.data();
+                        msg.size = payload.size();
 
-                            m_ipcChannel->send(msg);
-                        }
+                        m_ipcChannel->send(msg);
+                    });
+            }
+            m_journeyFeed->start();
+
+            if (m_eventProcessor) {
+                yamy::logger::JourneyFeed* feed = m_journeyFeed.get();
+                m_eventProcessor->setJourneyEventCallback(
+                    [feed](const yamy::logger::JourneyEvent& journey) {
+                        feed->push(journey);
                     }
                 );
             }
@@ -272,6 +276,9 @@ void Engine::handleIpcMessage(const yamy::ipc::Message& message)
             if (m_eventProcessor) {
                 m_eventProcessor->setJourneyEventCallback(nullptr);
             }
+            if (m_journeyFeed) {
+                m_journeyFeed->stop();
+            }
             break;
         case yamy::ipc::CmdInvestigateWindow:
         {
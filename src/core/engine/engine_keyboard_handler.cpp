@@ -8,6 +8,8 @@
 #include "../platform/sync.h"
 #include "core/logging/logger.h"
 #include "../../utils/metrics.h"
+#include "../../utils/startup_profiler.h"
+#include "../plugin_event_bus.h"
 
 #ifdef _WIN32
 // keyboard handler thread - Windows static entry point
@@ -45,10 +47,15 @@ void Engine::keyboardHandler()
         }
         ReleaseMutex(m_queueMutex);
 
-        yamy::logging::Logger::getInstance().log(
+        m_eventClock->advanceTo(event.timestampUs);
+        yamy::core::PluginEventBus::instance().publishKey(
+            static_cast<uint16_t>(event.scanCode), event.isKeyDown,
+            event.isExtended, event.timestampUs);
+
+        yamy::logging::Logger::getInstance().logf(
             yamy::logging::LogLevel::Trace, "Engine",
-            "Processing key event: scancode=" + std::to_string(event.scanCode) +
-                ", isKeyDown=" + std::to_string(event.isKeyDown));
+            "Processing key event: scancode={}, isKeyDown={}",
+            event.scanCode, event.isKeyDown);
         auto keyProcessingStart = std::chrono::high_resolution_clock::now();
 
         KEYBOARD_INPUT_DATA kid = keyEventToKID(event);
@@ -108,13 +115,8 @@ void Engine::keyboardHandler()
             }
         }
 
-        if (c.m_mkey.m_key) {
-            if (!c.m_mkey.m_key->m_isPressed && isPhysicallyPressed)
-                ++ m_currentKeyPressCount;
-            else if (c.m_mkey.m_key->m_isPressed && !isPhysicallyPressed)
-                -- m_currentKeyPressCount;
-            c.m_mkey.m_key->m_isPressed = isPhysicallyPressed;
-        }
+        if (c.m_mkey.m_key)
+            setPhysicallyPressed(c.m_mkey.m_key, isPhysicallyPressed);
 
         c.m_mkey.m_modifier = getCurrentModifiers(c.m_mkey.m_key,
                               isPhysicallyPressed);
@@ -232,11 +234,19 @@ void Engine::keyboardHandler()
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine",
         "Keyboard handler thread started, waiting for events...");
 
-    Key key;
     while (1) {
         yamy::platform::KeyEvent event;
 
-        yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
+        m_inputHook->inputProcessed();
+
+        {
+            // The previous event is done: let pushInputEvent() inject
+            // rule-less keys itself until the next one is dequeued
+            Acquire a(&m_cs);
+            yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
+            m_isHandlingInput = false;
+            m_isPassthroughOpen = canPassThrough();
+        }
 
         while (true) {
             if (m_inputQueue == nullptr) {
@@ -260,174 +270,244 @@ void Engine::keyboardHandler()
             if (m_inputQueue->empty()) {
                 yamy::platform::resetEvent(m_readEvent);
             }
+            m_isHandlingInput = true;
 
             break;
         }
         yamy::platform::releaseMutex(m_queueMutex);
 
+        if (event.extraInfo == KEY_EVENT_AUTO_REPEAT_TICK) {
+            handleAutoRepeatTick(event.flags);
+            continue;
+        }
+        if (event.extraInfo == KEY_EVENT_CHORD_TIMEOUT) {
+            handleChordTimeout(event.flags);
+            continue;
+        }
+
+        // Engine time follows the kernel timestamp of the event being processed,
+        // so hold/tap decisions are unaffected by time spent in the queue.
+        m_eventClock->advanceTo(event.timestampUs);
+
+        // Plugins observe raw input on their own threads; this only writes a ring slot
+        yamy::core::PluginEventBus::instance().publishKey(
+            static_cast<uint16_t>(event.scanCode), event.isKeyDown,
+            event.isExtended, event.timestampUs);
+
         auto keyProcessingStart = std::chrono::high_resolution_clock::now();
 
-        KEYBOARD_INPUT_DATA kid = keyEventToKID(event);
-        std::cerr << "[HANDLER:DEBUG] Processing event: scan=" << std::hex << kid.MakeCode << std::dec << std::endl;
-        bool isPhysicallyPressed = event.isKeyDown;
+        handleKeyEvent(event);
 
-        if (!m_setting || !m_isEnabled) {
-            if (m_isLogMode) {
-                Key logKey;
-                logKey.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
-                outputToLog(&logKey, ModifiedKey(), 0);
-                if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
-                    injectInput(&kid, nullptr);
-                }
-            } else {
+        auto keyProcessingEnd = std::chrono::high_resolution_clock::now();
+        auto durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            keyProcessingEnd - keyProcessingStart).count();
+        yamy::metrics::PerformanceMetrics::instance().recordLatency(
+            yamy::metrics::Operations::KEY_PROCESSING, static_cast<uint64_t>(durationNs));
+        if (m_setting) {
+            yamy::metrics::StartupProfiler::instance().noteFirstKey();
+        }
+    }
+}
+
+void Engine::handleKeyEvent(const yamy::platform::KeyEvent &event)
+{
+    KEYBOARD_INPUT_DATA kid = keyEventToKID(event);
+    std::cerr << "[HANDLER:DEBUG] Processing event: scan=" << std::hex << kid.MakeCode << std::dec << std::endl;
+
+    if (!m_setting || !m_isEnabled) {
+        if (event.flags & KEY_EVENT_PASSED_THROUGH) {
+            // disabled after pushInputEvent() injected it
+        } else if (m_isLogMode) {
+            Key logKey;
+            logKey.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
+            outputToLog(&logKey, ModifiedKey(), 0);
+            if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
                 injectInput(&kid, nullptr);
             }
-            updateLastPressedKey(nullptr);
-            continue;
+        } else {
+            injectInput(&kid, nullptr);
         }
+        updateLastPressedKey(nullptr);
+        return;
+    }
 
-        Acquire a(&m_cs);
+    Acquire a(&m_cs);
+
+    // Mouse keys are consumed here and move the pointer from their own timer
+    const uint32_t MOUSE_EVENT_MARKER = 0x59414D59;
+    if (m_mouseKeys && m_mouseKeysTimer && !(event.flags & KEY_EVENT_PASSED_THROUGH) &&
+            event.extraInfo != MOUSE_EVENT_MARKER && handleMouseKey(event))
+        return;
+
+    // Chord keys are held back until the chord completes or its window
+    // closes; every other key costs one bit test here
+    if (m_chordDetector && m_chordTimer && !(event.flags & KEY_EVENT_PASSED_THROUGH) &&
+            event.extraInfo != MOUSE_EVENT_MARKER) {
+        yamy::engine::ChordKeyEvent chordKey;
+        chordKey.scan = static_cast<uint16_t>(event.scanCode);
+        chordKey.isPressed = event.isKeyDown;
+        chordKey.isAutoRepeat = event.isAutoRepeat;
+        chordKey.timestampUs = event.timestampUs;
+        yamy::engine::ChordSteps steps;
+        m_chordDetector->onKey(chordKey, steps);
+        runChordSteps(steps, &event);
+        return;
+    }
 
-        if (!m_currentKeymap) {
+    processKeyEvent(event);
+}
+
+void Engine::processKeyEvent(const yamy::platform::KeyEvent &event)
+{
+    KEYBOARD_INPUT_DATA kid = keyEventToKID(event);
+    bool isPhysicallyPressed = event.isKeyDown;
+    const uint32_t keyDownsBefore = m_generatedKeyDownCount;
+
+    if (!m_currentKeymap) {
+        if (!(event.flags & KEY_EVENT_PASSED_THROUGH))
             injectInput(&kid, nullptr);
-            Acquire b(&m_log, 0);
-            m_log << "internal error: m_currentKeymap == nullptr"
-                << std::endl;
-            updateLastPressedKey(nullptr);
-            continue;
-        }
+        Acquire b(&m_log, 0);
+        m_log << "internal error: m_currentKeymap == nullptr"
+            << std::endl;
+        updateLastPressedKey(nullptr);
+        return;
+    }
 
-        Current c;
-        c.m_keymap = m_currentKeymap;
-        c.m_evdev_code = static_cast<uint16_t>(event.scanCode);
+    const uint32_t MOUSE_EVENT_MARKER = 0x59414D59;
+    bool isMouseEvent = (event.extraInfo == MOUSE_EVENT_MARKER);
 
-        const uint32_t MOUSE_EVENT_MARKER = 0x59414D59;
-        bool isMouseEvent = (event.extraInfo == MOUSE_EVENT_MARKER);
+    Current c;
+    c.m_keymap = m_currentKeymap;
+    // Mouse button codes are not evdev key codes; they only match keymaps
+    c.m_evdev_code = isMouseEvent ? 0 : static_cast<uint16_t>(event.scanCode);
 
-        // IMPORTANT: Clear key object for each new event to avoid accumulation
-        key = Key();
-        Key mouseKey;
-        Key *pProcessingKey = &key;
+    Key key;
+    Key mouseKey;
+    Key *pProcessingKey = &key;
+
+    if (isMouseEvent) {
+        mouseKey.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
+        pProcessingKey = &mouseKey;
+    } else {
+        key.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
+    }
 
-        if (isMouseEvent) {
-            mouseKey.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
-            pProcessingKey = &mouseKey;
-        } else {
-            key.addScanCode(ScanCode(kid.MakeCode, kid.Flags));
-        }
+    c.m_mkey = m_setting->m_keyboard.searchKey(*pProcessingKey);
+    if (c.m_mkey.m_key) {
+         std::cerr << "[HANDLER:DEBUG] Key found: " << c.m_mkey.m_key->getName() << std::endl;
+    } else {
+         std::cerr << "[HANDLER:DEBUG] Key NOT found for scan=" << std::hex << kid.MakeCode << std::dec << std::endl;
+    }
 
-        c.m_mkey = m_setting->m_keyboard.searchKey(*pProcessingKey);
-        if (c.m_mkey.m_key) {
-             std::cerr << "[HANDLER:DEBUG] Key found: " << c.m_mkey.m_key->getName() << std::endl;
-        } else {
-             std::cerr << "[HANDLER:DEBUG] Key NOT found for scan=" << std::hex << kid.MakeCode << std::dec << std::endl;
+    if (!c.m_mkey.m_key) {
+        if (!isMouseEvent) {
+            c.m_mkey.m_key = m_setting->m_keyboard.searchPrefixKey(*pProcessingKey);
+            if (c.m_mkey.m_key)
+                return;
         }
+    }
 
-        if (!c.m_mkey.m_key) {
-            if (!isMouseEvent) {
-                c.m_mkey.m_key = m_setting->m_keyboard.searchPrefixKey(*pProcessingKey);
-                if (c.m_mkey.m_key)
-                    continue;
-            }
-        }
+    if (c.m_mkey.m_key)
+        setPhysicallyPressed(c.m_mkey.m_key, isPhysicallyPressed);
 
+    if (event.flags & KEY_EVENT_PASSED_THROUGH) {
+        // Already injected by pushInputEvent(); only track the output
         if (c.m_mkey.m_key) {
-            if (!c.m_mkey.m_key->m_isPressed && isPhysicallyPressed)
-                ++ m_currentKeyPressCount;
-            else if (c.m_mkey.m_key->m_isPressed && !isPhysicallyPressed)
-                -- m_currentKeyPressCount;
-            c.m_mkey.m_key->m_isPressed = isPhysicallyPressed;
+            recordPassthroughKeyEvent(c.m_mkey.m_key, isPhysicallyPressed);
+            updateAutoRepeat(c.m_mkey.m_key, isPhysicallyPressed,
+                             keyDownsBefore, isMouseEvent ? nullptr : &event);
         }
+        if (m_currentKeyPressCount <= 0)
+            generateModifierEvents(Modifier());
+        return;
+    }
 
-        c.m_mkey.m_modifier = getCurrentModifiers(c.m_mkey.m_key,
-                              isPhysicallyPressed);
-        Keymap::AssignMode am;
-        bool isModifier = fixModifierKey(&c.m_mkey, &am);
-        if (m_isPrefix) {
-            if (isModifier && m_doesIgnoreModifierForPrefix)
-                am = Keymap::AM_true;
-            if (m_doesEditNextModifier) {
-                Modifier modifier = m_modifierForNextKey;
-                modifier.add(c.m_mkey.m_modifier);
-                c.m_mkey.m_modifier = modifier;
-            }
+    c.m_mkey.m_modifier = getCurrentModifiers(c.m_mkey.m_key,
+                          isPhysicallyPressed);
+    Keymap::AssignMode am;
+    bool isModifier = fixModifierKey(&c.m_mkey, &am);
+    if (m_isPrefix) {
+        if (isModifier && m_doesIgnoreModifierForPrefix)
+            am = Keymap::AM_true;
+        if (m_doesEditNextModifier) {
+            Modifier modifier = m_modifierForNextKey;
+            modifier.add(c.m_mkey.m_modifier);
+            c.m_mkey.m_modifier = modifier;
         }
+    }
 
-        if (m_isLogMode) {
-            outputToLog(pProcessingKey, c.m_mkey, 0);
-            if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
-                injectInput(&kid, nullptr);
-            }
-        } else if (am == Keymap::AM_true) {
-            {
-                Acquire b(&m_log, 1);
-                m_log << "* true modifier" << std::endl;
-            }
-            outputToLog(pProcessingKey, c.m_mkey, 1);
-        } else if (am == Keymap::AM_oneShot || am == Keymap::AM_oneShotRepeatable) {
-            {
-                Acquire b(&m_log, 1);
-                if (am == Keymap::AM_oneShot)
-                    m_log << "* one shot modifier" << std::endl;
-                else
-                    m_log << "* one shot repeatable modifier" << std::endl;
-            }
-            outputToLog(pProcessingKey, c.m_mkey, 1);
-            if (isPhysicallyPressed) {
-                if (am == Keymap::AM_oneShotRepeatable &&
-                        m_oneShotKey.m_key == c.m_mkey.m_key) {
-                    if (m_oneShotRepeatableRepeatCount <
-                            m_setting->m_oneShotRepeatableDelay) {
-                    } else {
-                        Current cnew = c;
-                        beginGeneratingKeyboardEvents(cnew, false);
-                    }
-                    ++ m_oneShotRepeatableRepeatCount;
+    if (m_isLogMode) {
+        outputToLog(pProcessingKey, c.m_mkey, 0);
+        if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
+            injectInput(&kid, nullptr);
+        }
+    } else if (am == Keymap::AM_true) {
+        {
+            Acquire b(&m_log, 1);
+            m_log << "* true modifier" << std::endl;
+        }
+        outputToLog(pProcessingKey, c.m_mkey, 1);
+    } else if (am == Keymap::AM_oneShot || am == Keymap::AM_oneShotRepeatable) {
+        {
+            Acquire b(&m_log, 1);
+            if (am == Keymap::AM_oneShot)
+                m_log << "* one shot modifier" << std::endl;
+            else
+                m_log << "* one shot repeatable modifier" << std::endl;
+        }
+        outputToLog(pProcessingKey, c.m_mkey, 1);
+        if (isPhysicallyPressed) {
+            if (am == Keymap::AM_oneShotRepeatable &&
+                    m_oneShotKey.m_key == c.m_mkey.m_key) {
+                if (m_oneShotRepeatableRepeatCount <
+                        m_setting->m_oneShotRepeatableDelay) {
                 } else {
-                    m_oneShotKey = c.m_mkey;
-                    m_oneShotRepeatableRepeatCount = 0;
-                }
-            } else {
-                if (m_oneShotKey.m_key) {
                     Current cnew = c;
-                    cnew.m_mkey.m_modifier = m_oneShotKey.m_modifier;
-                    cnew.m_mkey.m_modifier.off(Modifier::Type_Up);
-                    cnew.m_mkey.m_modifier.on(Modifier::Type_Down);
-                    beginGeneratingKeyboardEvents(cnew, false);
-
-                    cnew = c;
-                    cnew.m_mkey.m_modifier = m_oneShotKey.m_modifier;
-                    cnew.m_mkey.m_modifier.on(Modifier::Type_Up);
-                    cnew.m_mkey.m_modifier.off(Modifier::Type_Down);
                     beginGeneratingKeyboardEvents(cnew, false);
                 }
-                m_oneShotKey.m_key = nullptr;
+                ++ m_oneShotRepeatableRepeatCount;
+            } else {
+                m_oneShotKey = c.m_mkey;
                 m_oneShotRepeatableRepeatCount = 0;
             }
-        } else if (c.m_mkey.m_key) {
-            outputToLog(pProcessingKey, c.m_mkey, 1);
-            if (isPhysicallyPressed)
-                m_oneShotKey.m_key = nullptr;
-            beginGeneratingKeyboardEvents(c, isModifier);
         } else {
-            if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
-                injectInput(&kid, nullptr);
+            if (m_oneShotKey.m_key) {
+                Current cnew = c;
+                cnew.m_mkey.m_modifier = m_oneShotKey.m_modifier;
+                cnew.m_mkey.m_modifier.off(Modifier::Type_Up);
+                cnew.m_mkey.m_modifier.on(Modifier::Type_Down);
+                beginGeneratingKeyboardEvents(cnew, false);
+
+                cnew = c;
+                cnew.m_mkey.m_modifier = m_oneShotKey.m_modifier;
+                cnew.m_mkey.m_modifier.on(Modifier::Type_Up);
+                cnew.m_mkey.m_modifier.off(Modifier::Type_Down);
+                beginGeneratingKeyboardEvents(cnew, false);
             }
+            m_oneShotKey.m_key = nullptr;
+            m_oneShotRepeatableRepeatCount = 0;
         }
-
-        if (m_currentKeyPressCount <= 0) {
-            {
-                Acquire b(&m_log, 1);
-                m_log << "* No key is pressed" << std::endl;
-            }
-            generateModifierEvents(Modifier());
+    } else if (c.m_mkey.m_key) {
+        outputToLog(pProcessingKey, c.m_mkey, 1);
+        if (isPhysicallyPressed)
+            m_oneShotKey.m_key = nullptr;
+        beginGeneratingKeyboardEvents(c, isModifier);
+    } else {
+        if (kid.Flags & KEYBOARD_INPUT_DATA::E1) {
+            injectInput(&kid, nullptr);
         }
+    }
 
-        auto keyProcessingEnd = std::chrono::high_resolution_clock::now();
-        auto durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            keyProcessingEnd - keyProcessingStart).count();
-        yamy::metrics::PerformanceMetrics::instance().recordLatency(
-            yamy::metrics::Operations::KEY_PROCESSING, static_cast<uint64_t>(durationNs));
+    if (c.m_mkey.m_key && !m_isLogMode)
+        updateAutoRepeat(c.m_mkey.m_key, isPhysicallyPressed,
+                         keyDownsBefore, isMouseEvent ? nullptr : &event);
+
+    if (m_currentKeyPressCount <= 0) {
+        {
+            Acquire b(&m_log, 1);
+            m_log << "* No key is pressed" << std::endl;
+        }
+        generateModifierEvents(Modifier());
     }
 }
 
@@ -14,6 +14,7 @@
 #include "../platform/thread.h"
 #include "core/logging/logger.h"
 #include "../../utils/metrics.h"
+#include "../../utils/startup_profiler.h"
 #ifdef _WIN32
 #include "../../utils/debug_console.h"
 #endif
@@ -24,22 +25,24 @@
 #include <thread>
 #include "../platform/ipc_defs.h"
 #include "../notification_dispatcher.h"
+#include "../settings/json_config_loader.h" // For ~unique_ptr<JsonConfigLoader>
+#include "../plugin_event_bus.h"
 #include <gsl/gsl>
 
 #if defined(QT_CORE_LIB)
 void Engine::playSound(yamy::audio::NotificationType type)
 {
-    if (m_soundManager) {
-        m_soundManager->playSound(type);
-    }
+    // Loading the sound effects is left out of startup; most sessions never
+    // play one
+    std::call_once(m_soundManagerOnce, [this]() {
+        m_soundManager = std::make_unique<yamy::audio::SoundManager>();
+    });
+    m_soundManager->playSound(type);
 }
 #endif
 
 Engine::Engine(tomsgstream &i_log, yamy::platform::IWindowSystem *i_windowSystem, ConfigStore *i_configStore, yamy::platform::IInputInjector *i_inputInjector, yamy::platform::IInputHook *i_inputHook, yamy::platform::IInputDriver *i_inputDriver)
         : m_hwndAssocWindow(nullptr),
-#if defined(QT_CORE_LIB)
-        m_soundManager(std::make_unique<yamy::audio::SoundManager>()),
-#endif
         m_setting(nullptr),
         m_currentConfigPath(),
         m_windowSystem(i_windowSystem),
@@ -50,6 +53,16 @@ Engine::Engine(tomsgstream &i_log, yamy::platform::IWindowSystem *i_windowSystem
         m_inputDriver(i_inputDriver),
         m_inputQueue(nullptr),
         m_queueMutex(nullptr),
+        m_isHandlingInput(false),
+        m_isPassthroughOpen(false),
+        m_heldRuleKeyCount(0),
+        m_isEngineAutoRepeat(false),
+        m_isAutoRepeatTickQueued(false),
+        m_autoRepeatGeneration(0),
+        m_autoRepeatSourceKey(nullptr),
+        m_autoRepeatEvent(),
+        m_autoRepeatChord(yamy::engine::ChordTable::NO_CHORD),
+        m_chordTimerWindow(0),
         m_readEvent(nullptr),
         m_ol(nullptr),
         m_sts4mayu(nullptr),
@@ -62,7 +75,9 @@ Engine::Engine(tomsgstream &i_log, yamy::platform::IWindowSystem *i_windowSystem
         m_generateKeyboardEventsRecursionGuard(0),
         m_currentKeyPressCount(0),
         m_currentKeyPressCountOnWin32(0),
+        m_pressedModifierSlots(0),
         m_lastGeneratedKey(nullptr),
+        m_generatedKeyDownCount(0),
         m_oneShotRepeatableRepeatCount(0),
         m_isPrefix(false),
         m_currentKeymap(nullptr),
@@ -71,7 +86,9 @@ Engine::Engine(tomsgstream &i_log, yamy::platform::IWindowSystem *i_windowSystem
         m_variable(0),
         m_log(i_log),
         m_perfThreadHandle(nullptr),
-        m_isPerfThreadRunning(false) {
+        m_isPerfThreadRunning(false),
+        m_builtActionInstructions(0),
+        m_eventClock(std::make_shared<yamy::engine::EventTimeClock>()) {
     // Preconditions
     Expects(i_windowSystem != nullptr);
     // Note: i_configStore can be nullptr - only needed for config switching (Engine::switchConfiguration)
@@ -94,6 +111,10 @@ Engine::Engine(tomsgstream &i_log, yamy::platform::IWindowSystem *i_windowSystem
                          [this](const yamy::ipc::Message& msg) {
                              this->handleIpcMessage(msg);
                          });
+#else
+        m_ipcChannel->setMessageCallback([this](const yamy::ipc::Message& msg) {
+            this->handleIpcMessage(msg);
+        });
 #endif
         // NOTE: listen() will be called later via initializeIPC() after event loop starts
     }
@@ -150,41 +171,13 @@ void Engine::start() {
     notifyGUI(yamy::MessageType::EngineStarting);
 
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Starting engine...");
-#ifdef _WIN32
-    yamy::debug::DebugConsole::LogInfo("Engine: Starting performance metrics...");
-#endif
-    yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Starting performance metrics...");
-    // Start performance metrics collection with 60-second reporting interval
-    yamy::metrics::PerformanceMetrics::instance().startPeriodicLogging(60);
-
-#ifdef _WIN32
-    yamy::debug::DebugConsole::LogInfo("Engine: Installing input hook...");
-#endif
-    yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Installing input hook...");
-    std::cerr << "[DEBUG] Engine: About to call m_inputHook->install(), m_inputHook=" << m_inputHook << std::endl;
-    if (!m_inputHook) {
-        std::cerr << "[DEBUG] Engine: ERROR - m_inputHook is NULL!" << std::endl;
-    }
-    m_inputHook->install(
-        [this](const yamy::platform::KeyEvent& event) {
-            // Pass KeyEvent directly to the queue
-            this->pushInputEvent(event);
-            // Only block events if we have a configuration loaded
-            // Otherwise pass through to allow normal keyboard operation
-            return (this->m_setting != nullptr);
-        },
-        [this](const yamy::platform::MouseEvent& e) {
-            // Mouse event handler (currently unused)
-            // Pass through - we don't remap mouse events
-            return false;
-        }
-    );
-
 #ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Creating input queue and synchronization objects...");
     yamy::debug::DebugConsole::LogInfo("Engine: Creating input queue (deque)...");
 #endif
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Creating input queue and synchronization objects...");
+    // The queue exists before the hook is installed, so no event of the
+    // first keystrokes is dropped while the handler thread starts
     CHECK_TRUE( m_inputQueue = new std::deque<yamy::platform::KeyEvent> );
 #ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Creating mutex...");
@@ -194,6 +187,33 @@ void Engine::start() {
     yamy::debug::DebugConsole::LogInfo("Engine: Creating event...");
 #endif
     CHECK_TRUE( m_readEvent = yamy::platform::createEvent(true, false) );
+    // a tick pending when the last stop() deleted the queue never ran
+    m_isAutoRepeatTickQueued = false;
+    m_autoRepeatTimer = std::make_unique<yamy::engine::TickTimer>(
+        [this]() { this->pushAutoRepeatTick(); });
+    if (!m_autoRepeatTimer->start()) {
+        yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine",
+            "Engine autorepeat unavailable; kernel repeats are passed on");
+        m_autoRepeatTimer.reset();
+    }
+    m_chordTimer = std::make_unique<yamy::engine::TickTimer>(
+        [this]() { this->pushChordTimeout(); });
+    if (!m_chordTimer->start()) {
+        yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine",
+            "Chord timer unavailable; chords are disabled");
+        m_chordTimer.reset();
+    }
+    m_mouseKeysTimer = std::make_unique<yamy::engine::TickTimer>(
+        [this]() { this->handleMouseKeysTick(); });
+    if (!m_mouseKeysTimer->start()) {
+        yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine",
+            "Mouse keys timer unavailable; mouse keys are disabled");
+        m_mouseKeysTimer.reset();
+    }
+    {
+        Acquire a(&m_cs);
+        m_isEngineAutoRepeat = m_setting && m_setting->m_engineAutoRepeat && m_autoRepeatTimer;
+    }
 #ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Synchronization objects created successfully!");
     yamy::debug::DebugConsole::LogInfo("Engine: Allocating OVERLAPPED structure...");
@@ -209,10 +229,44 @@ void Engine::start() {
         yamy::debug::DebugConsole::LogError("Engine: Failed to allocate OVERLAPPED structure!");
     }
 
+    yamy::debug::DebugConsole::LogInfo("Engine: Installing input hook...");
+#endif
+    yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Installing input hook...");
+    std::cerr << "[DEBUG] Engine: About to call m_inputHook->install(), m_inputHook=" << m_inputHook << std::endl;
+    if (!m_inputHook) {
+        std::cerr << "[DEBUG] Engine: ERROR - m_inputHook is NULL!" << std::endl;
+    }
+    {
+        STARTUP_PHASE("input_hook_install");
+        m_inputHook->install(
+            [this](const yamy::platform::KeyEvent& event) {
+                // Pass KeyEvent directly to the queue
+                this->pushInputEvent(event);
+                // Only block events if we have a configuration loaded
+                // Otherwise pass through to allow normal keyboard operation
+                return (this->m_setting != nullptr);
+            },
+            [this](const yamy::platform::MouseEvent& e) {
+                // Relative motion of a grabbed mouse (Linux mouse lane) goes
+                // straight to the output device from the reader thread; it
+                // never enters the input queue. Buttons arrive as key events.
+                if (e.dx != 0 || e.dy != 0 || e.wheel != 0 || e.hwheel != 0) {
+                    m_inputInjector->mouseFrame(e.dx, e.dy, e.wheel, e.hwheel);
+                    return true;
+                }
+                return false;
+            }
+        );
+    }
+
+#ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Opening input driver...");
 #endif
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Opening input driver...");
-    m_inputDriver->open(m_readEvent);
+    {
+        STARTUP_PHASE("input_driver_open");
+        m_inputDriver->open(m_readEvent);
+    }
 #ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Input driver opened successfully!");
 #endif
@@ -222,10 +276,16 @@ void Engine::start() {
 #endif
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Creating keyboard handler thread...");
     CHECK_TRUE( m_threadHandle = yamy::platform::createThread(keyboardHandler, this) );
+    yamy::metrics::StartupProfiler::instance().mark(yamy::metrics::Milestones::HOOK_LIVE);
+
+    // Keys are remapped from here on; nothing below is needed for that
 #ifdef _WIN32
     yamy::debug::DebugConsole::LogInfo("Engine: Keyboard handler thread created!");
     yamy::debug::DebugConsole::LogInfo("Engine: Creating performance metrics thread...");
 #endif
+    yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Starting performance metrics...");
+    // Start performance metrics collection with 60-second reporting interval
+    yamy::metrics::PerformanceMetrics::instance().startPeriodicLogging(60);
     yamy::logging::Logger::getInstance().log(yamy::logging::LogLevel::Info, "Engine", "Creating performance metrics thread...");
     m_isPerfThreadRunning = true;
     CHECK_TRUE( m_perfThreadHandle = yamy::platform::createThread(perfMetricsHandler, this) );
@@ -280,6 +340,8 @@ void Engine::stop() {
     m_inputHook->uninstall();
     m_inputDriver->close();
 
+    m_isEngineAutoRepeat = false;
+
     yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
     delete m_inputQueue;
     m_inputQueue = nullptr;
@@ -293,6 +355,23 @@ void Engine::stop() {
     CHECK_TRUE( yamy::platform::destroyThread(m_threadHandle) );
     m_threadHandle = nullptr;
 
+    // the timer thread pushes ticks under m_queueMutex
+    if (m_autoRepeatTimer) {
+        m_autoRepeatTimer->stop();
+        m_autoRepeatTimer.reset();
+    }
+    // a tick queued above was deleted with the queue and never cleared this
+    m_isAutoRepeatTickQueued = false;
+    if (m_chordTimer) {
+        m_chordTimer->stop();
+        m_chordTimer.reset();
+    }
+    // the mouse keys timer thread injects through m_inputInjector
+    if (m_mouseKeysTimer) {
+        m_mouseKeysTimer->stop();
+        m_mouseKeysTimer.reset();
+    }
+
     CHECK_TRUE( yamy::platform::destroyEvent(m_readEvent) );
     m_readEvent = nullptr;
 
@@ -368,7 +447,26 @@ void Engine::pushInputEvent(const yamy::platform::KeyEvent &event)
 
     yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
     if (m_inputQueue) {
-        m_inputQueue->push_back(event);
+        // The engine repeats held keys itself when the setting asks for it
+        if (event.isAutoRepeat && m_isEngineAutoRepeat) {
+            yamy::platform::releaseMutex(m_queueMutex);
+            return;
+        }
+
+        // Keys without any rule are injected right here when nothing is
+        // queued or being processed, so they cannot overtake earlier events.
+        // The event is still queued so the handler keeps key state current.
+        yamy::platform::KeyEvent queued = event;
+        if (m_isPassthroughOpen && !m_isHandlingInput && m_inputQueue->empty() &&
+                !event.isExtended && event.extraInfo == 0 && m_passthroughKeys &&
+                m_passthroughKeys->test(static_cast<uint16_t>(event.scanCode))) {
+            KEYBOARD_INPUT_DATA kid = keyEventToKID(event);
+            injectInput(&kid, nullptr);
+            queued.flags |= KEY_EVENT_PASSED_THROUGH;
+        }
+        // Before the push, so the watchdog cannot miss the event's completion
+        m_inputHook->inputQueued();
+        m_inputQueue->push_back(queued);
         yamy::platform::setEvent(m_readEvent);
     }
     yamy::platform::releaseMutex(m_queueMutex);
@@ -383,6 +481,8 @@ KEYBOARD_INPUT_DATA Engine::keyEventToKID(const yamy::platform::KeyEvent &event)
     kid.Flags = 0;
     if (!event.isKeyDown) kid.Flags |= KEYBOARD_INPUT_DATA::BREAK;
     if (event.isExtended) kid.Flags |= KEYBOARD_INPUT_DATA::E0;
+    // Mouse buttons match the E1 keys of the keyboard definition
+    if (event.extraInfo == yamy::platform::MOUSE_EVENT_MARKER) kid.Flags |= KEYBOARD_INPUT_DATA::E1;
     kid.Reserved = 0;
     kid.ExtraInformation = static_cast<unsigned long>(event.extraInfo);
     return kid;
@@ -400,6 +500,7 @@ void Engine::notifyGUI(yamy::MessageType i_type, const std::string &i_data)
 {
     // Dispatch to registered callbacks (plugin/extension support)
     yamy::core::NotificationDispatcher::instance().dispatch(i_type, i_data);
+    yamy::core::PluginEventBus::instance().publishNotification(i_type, i_data);
 
     if (!m_windowSystem || !m_hwndAssocWindow)
         return;
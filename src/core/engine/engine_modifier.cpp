@@ -14,9 +14,48 @@
 #include <gsl/gsl>
 
 
+void Engine::setPhysicallyPressed(Key *i_key, bool i_isPressed)
+{
+    if (i_key->m_isPressed != i_isPressed && !isPassthroughKey(i_key)) {
+        if (i_isPressed)
+            ++ m_heldRuleKeyCount;
+        else if (0 < m_heldRuleKeyCount)
+            -- m_heldRuleKeyCount;
+    }
+
+    if (!i_key->m_isPressed && i_isPressed)
+        ++ m_currentKeyPressCount;
+    else if (i_key->m_isPressed && !i_isPressed)
+        -- m_currentKeyPressCount;
+    i_key->m_isPressed = i_isPressed;
+
+    if (0 <= i_key->m_modifierSlot) {
+        const uint64_t bit = uint64_t(1) << i_key->m_modifierSlot;
+        if (i_isPressed)
+            m_pressedModifierSlots |= bit;
+        else
+            m_pressedModifierSlots &= ~bit;
+    }
+}
+
+
+void Engine::resetPressedModifierSlots()
+{
+    m_pressedModifierSlots = 0;
+    for (Keyboard::KeyIterator i = m_setting->m_keyboard.getKeyIterator();
+            *i; ++ i)
+        if ((*i)->m_isPressed && 0 <= (*i)->m_modifierSlot)
+            m_pressedModifierSlots |= uint64_t(1) << (*i)->m_modifierSlot;
+}
+
+
 bool Engine::isPressed(Modifier::Type i_mt)
 {
     // For hardware modifiers, check physical key press state
+    if (m_currentKeymap->hasModifierRoles())
+        return (m_pressedModifierSlots &
+                m_currentKeymap->getModifierSlotMask(i_mt)) != 0;
+
     const Keymap::ModAssignments &ma = m_currentKeymap->getModAssignments(i_mt);
     for (Keymap::ModAssignments::const_iterator i = ma.begin();
             i != ma.end(); ++ i)
@@ -28,6 +67,24 @@ bool Engine::isPressed(Modifier::Type i_mt)
 
 bool Engine::fixModifierKey(ModifiedKey *io_mkey, Keymap::AssignMode *o_am)
 {
+    if (m_currentKeymap->hasModifierRoles()) {
+        const int slot = io_mkey->m_key->m_modifierSlot;
+        const Keymap::ModifierRole *role =
+            0 <= slot ? &m_currentKeymap->getModifierRole(slot) : nullptr;
+        if (role && role->m_type != Modifier::Type_end) {
+            {
+                Acquire a(&m_log, 1);
+                m_log << "* Modifier Key" << std::endl;
+            }
+            io_mkey->m_modifier.dontcare(role->m_type);
+            *o_am = role->m_assignMode;
+            Ensures(*o_am >= Keymap::AM_normal && *o_am <= Keymap::AM_oneShotRepeatable);
+            return true;
+        }
+        *o_am = Keymap::AM_notModifier;
+        return false;
+    }
+
     for (int i = Modifier::Type_begin; i != Modifier::Type_end; ++ i) {
         const Keymap::ModAssignments &ma =
             m_currentKeymap->getModAssignments(static_cast<Modifier::Type>(i));
@@ -7,6 +7,7 @@
 #include "engine.h"
 #include "errormessage.h"
 #include "../platform/hook_interface.h"
+#include "../platform/sync.h"
 #include "mayurc.h"
 #include "../settings/json_config_loader.h"
 #include "stringtool.h"
@@ -16,7 +17,9 @@
 #include "compiled_rule.h"
 #include "lookup_table.h"
 #include "engine_event_processor.h"
+#include "../../platform/linux/keycode_mapping.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <string>
 #include <filesystem>
@@ -27,6 +30,15 @@
 // manageTs4mayu removed (moved to InputDriver)
 
 
+// Mouse buttons (E1) share scan codes with keys; the keymap walk matches
+// them, never the evdev-keyed lookup table
+static bool isLookupTableKey(const Key *i_key)
+{
+    return i_key && i_key->getScanCodesSize() != 0 &&
+        !(i_key->getScanCodes()[0].m_flags & ScanCode::E1);
+}
+
+
 
 // set m_setting
 bool Engine::setSetting(Setting *i_setting) {
@@ -55,7 +67,17 @@ bool Engine::setSetting(Setting *i_setting) {
                     i_setting->m_keyboard.searchKey(*m_lastPressedKey[i]);
     }
 
+    // the held keys belong to the old setting
+    stopAutoRepeat();
+    // so does the document the loader would patch
+    m_configLoader.reset();
+
+    i_setting->m_keymaps.compileModifierRoles(i_setting->m_keyboard);
     m_setting = i_setting;
+    m_isEngineAutoRepeat = m_setting->m_engineAutoRepeat && m_autoRepeatTimer;
+    resetPressedModifierSlots();
+    buildChordDetector();
+    buildMouseKeys();
 
     m_inputDriver->manageExtension("sts4mayu.dll", "SynCOM.dll",
                   m_setting->m_sts4mayu, (void**)&m_sts4mayu);
@@ -94,13 +116,94 @@ bool Engine::setSetting(Setting *i_setting) {
 
 
 // Switch to a different configuration file
-// Properly handles string conversions via to_tstring() for cross-platform compatibility
 bool Engine::switchConfiguration(const std::string& configPath) {
+    std::lock_guard<std::mutex> reloadLock(m_reloadMutex);
     // GUARD: Prevent reloading the same config (fixes reload loop bug)
     if (m_currentConfigPath == configPath) {
         return true;  // Already loaded, consider this success
     }
+    return loadConfiguration(configPath);
+}
+
+
+// Re-read a configuration file; edits to the mappings of the active file
+// are patched into the running setting
+bool Engine::reloadConfiguration(const std::string& configPath) {
+    // Overlapping reloads would both take m_setting as the setting to delete
+    std::lock_guard<std::mutex> reloadLock(m_reloadMutex);
+#ifndef _WIN32
+    if (m_currentConfigPath == configPath) {
+        using PatchResult = yamy::settings::JsonConfigLoader::PatchResult;
+
+        notifyGUI(yamy::MessageType::ConfigLoading, configPath);
+
+        // File I/O and parsing stay outside m_cs
+        nlohmann::json config;
+        yamy::settings::JsonConfigLoader reader(&m_log);
+        bool readSuccess = false;
+        try {
+            readSuccess = reader.read(configPath, config);
+        } catch (const std::exception& e) {
+            Acquire a(&m_log, 0);
+            m_log << "reloadConfiguration: parse exception: " << e.what() << std::endl;
+        }
+        if (!readSuccess) {
+            if (m_configSwitchCallback) {
+                m_configSwitchCallback(false, configPath);
+            }
+            notifyGUI(yamy::MessageType::ConfigError, "Failed to parse config");
+            return false;
+        }
+
+        // Keymap and rules change in the same critical section that
+        // processes keys, so no event sees half of the patch
+        const auto start = std::chrono::steady_clock::now();
+        PatchResult result = PatchResult::NeedsFullLoad;
+        std::vector<Key *> changedKeys;
+        {
+            Acquire a(&m_cs);
+            if (m_configLoader && m_setting && !m_isSynchronizing) {
+                result = m_configLoader->patch(m_setting, std::move(config), &changedKeys);
+                if (result == PatchResult::Patched && !changedKeys.empty())
+                    patchSubstitutionTable(changedKeys);
+            }
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        if (result == PatchResult::Failed) {
+            Acquire a(&m_log, 0);
+            m_log << "reloadConfiguration: invalid mappings, keeping current setting: "
+                  << to_tstring(configPath) << std::endl;
+            if (m_configSwitchCallback) {
+                m_configSwitchCallback(false, configPath);
+            }
+            notifyGUI(yamy::MessageType::ConfigError, "Failed to parse config");
+            return false;
+        }
+        if (result == PatchResult::Patched) {
+            {
+                Acquire a(&m_log, 0);
+                m_log << "reloadConfiguration: patched " << changedKeys.size()
+                      << " keys in " << elapsed.count() << "us: "
+                      << to_tstring(configPath) << std::endl;
+            }
+            if (m_configSwitchCallback) {
+                m_configSwitchCallback(true, configPath);
+            }
+            notifyGUI(yamy::MessageType::ConfigLoaded, configPath);
+            return true;
+        }
+        // NeedsFullLoad: load into a new setting below
+    }
+#endif // !_WIN32
+    return loadConfiguration(configPath);
+}
 
+
+// Parse a configuration file into a new setting and apply it
+// Properly handles string conversions via to_tstring() for cross-platform compatibility
+bool Engine::loadConfiguration(const std::string& configPath) {
 #ifdef _WIN32
     // Windows stub - not yet implemented due to wide stream incompatibility
     // JsonConfigLoader expects std::ostream* but m_log is std::wostream-based on Windows
@@ -132,10 +235,11 @@ bool Engine::switchConfiguration(const std::string& configPath) {
     Setting* newSetting = new Setting;
 
     // Try to parse the new config file
+    // The loader is kept with the setting for reloadConfiguration()
+    auto loader = std::make_unique<yamy::settings::JsonConfigLoader>(&m_log);
     bool parseSuccess = false;
     try {
-        yamy::settings::JsonConfigLoader loader(&m_log);
-        parseSuccess = loader.load(newSetting, configPath);
+        parseSuccess = loader->load(newSetting, configPath);
     } catch (const std::exception& e) {
         Acquire a(&m_log, 0);
         m_log << "switchConfiguration: parse exception: " << e.what() << std::endl;
@@ -187,6 +291,11 @@ bool Engine::switchConfiguration(const std::string& configPath) {
         return false;
     }
 
+    {
+        Acquire a(&m_cs);
+        m_configLoader = std::move(loader);
+    }
+
     // Clean up old setting
     delete oldSetting;
 
@@ -229,37 +338,36 @@ void Engine::buildSubstitutionTable(const Keyboard &keyboard) {
     // Get the new lookup table and compile rules into it
     int total_rules = 0;
     int keymap_rules = 0;
+    auto* actionPrograms = newProcessor->getActionPrograms();
     if (auto* lookupTable = newProcessor->getLookupTable()) {
         lookupTable->clear();
 
         // Compile rules from legacy Keyboard::Substitutes (old .mayu system)
         for (const auto& substitute : keyboard.getSubstitutes()) {
             const Key* fromKey = substitute.m_mkeyFrom.m_key;
-            if (!fromKey || fromKey->getScanCodesSize() == 0) {
+            if (!isLookupTableKey(fromKey)) {
                 continue;
             }
             uint16_t inputScanCode = fromKey->getScanCodes()[0].m_scan;
-            std::vector<yamy::engine::CompiledRule> rules = this->compileSubstitute(substitute);
-            for (const auto& rule : rules) {
-                lookupTable->addRule(inputScanCode, rule);
+            if (auto rule = this->compileSubstitute(substitute)) {
+                lookupTable->addRule(inputScanCode, *rule);
+                ++total_rules;
             }
-            total_rules += rules.size();
         }
 
         // Compile rules from Keymap::Assignments (new JSON system)
         if (m_globalKeymap) {
             m_globalKeymap->forEachAssignment([&](const Keymap::KeyAssignment& assignment) {
                 const Key* fromKey = assignment.m_modifiedKey.m_key;
-                if (!fromKey || fromKey->getScanCodesSize() == 0) {
+                if (!isLookupTableKey(fromKey)) {
                     return;
                 }
                 uint16_t inputScanCode = fromKey->getScanCodes()[0].m_scan;
-                std::vector<yamy::engine::CompiledRule> rules = this->compileKeyAssignment(assignment);
-                for (const auto& rule : rules) {
-                    lookupTable->addRule(inputScanCode, rule);
+                if (auto rule = this->compileKeyAssignment(assignment, *actionPrograms)) {
+                    lookupTable->addRule(inputScanCode, *rule);
+                    ++keymap_rules;
+                    ++total_rules;
                 }
-                keymap_rules += rules.size();
-                total_rules += rules.size();
             });
         }
     }
@@ -269,11 +377,16 @@ void Engine::buildSubstitutionTable(const Keyboard &keyboard) {
         Acquire a(&m_log, 0);
         m_log << "Built new rule lookup table with " << total_rules
               << " compiled rules (" << keyboard.getSubstitutes().size()
-              << " from substitutes, " << keymap_rules << " from keymap assignments)." << std::endl;
+              << " from substitutes, " << keymap_rules << " from keymap assignments; "
+              << actionPrograms->programCount() << " action programs, "
+              << actionPrograms->instructionCount() << " instructions)." << std::endl;
     }
 
     newProcessor->setDebugLogging(true);
 
+    // Hold/tap timing follows kernel event timestamps, not dequeue time
+    newProcessor->setClock(m_eventClock);
+
     // Register number modifiers
     for (const auto& numberMod : keyboard.getNumberModifiers()) {
         if (!numberMod.m_numberKey || !numberMod.m_modifierKey || numberMod.m_numberKey->getScanCodesSize() == 0 || numberMod.m_modifierKey->getScanCodesSize() == 0) {
@@ -303,7 +416,227 @@ void Engine::buildSubstitutionTable(const Keyboard &keyboard) {
         newProcessor->setDebugLogging(true);
     }
 
+    buildPassthroughMap(*newProcessor);
+    m_builtActionInstructions = actionPrograms->instructionCount();
+
     // Atomically publish the fully-initialized processor so the keyboard
     // handler thread sees a complete object (or the old one, never a partial).
     std::atomic_store(&m_eventProcessor, std::move(newProcessor));
 }
+
+
+// Recompile the rules of patched keys in the live EventProcessor
+void Engine::patchSubstitutionTable(const std::vector<Key *> &i_keys) {
+    if (!m_eventProcessor)
+        return;
+    yamy::engine::RuleLookupTable *lookupTable = m_eventProcessor->getLookupTable();
+    yamy::engine::ActionProgramTable *actionPrograms = m_eventProcessor->getActionPrograms();
+    if (!lookupTable || !actionPrograms)
+        return;
+
+    yamy::engine::PassthroughMap scans;
+    for (const Key *key : i_keys)
+        if (isLookupTableKey(key)) {
+            scans.set(key->getScanCodes()[0].m_scan);
+            lookupTable->removeRules(key->getScanCodes()[0].m_scan);
+        }
+
+    // Same order as buildSubstitutionTable(), so each bucket ends up as a
+    // full rebuild would leave it. Programs of the replaced rules stay in
+    // actionPrograms until then.
+    const size_t instructionsBefore = actionPrograms->instructionCount();
+    int rules = 0;
+    for (const auto &substitute : m_setting->m_keyboard.getSubstitutes()) {
+        const Key *fromKey = substitute.m_mkeyFrom.m_key;
+        if (!isLookupTableKey(fromKey) || !scans.test(fromKey->getScanCodes()[0].m_scan))
+            continue;
+        if (auto rule = compileSubstitute(substitute)) {
+            lookupTable->addRule(fromKey->getScanCodes()[0].m_scan, *rule);
+            ++ rules;
+        }
+    }
+    if (m_globalKeymap)
+        m_globalKeymap->forEachAssignment([&](const Keymap::KeyAssignment &assignment) {
+            const Key *fromKey = assignment.m_modifiedKey.m_key;
+            if (!isLookupTableKey(fromKey) || !scans.test(fromKey->getScanCodes()[0].m_scan))
+                return;
+            if (auto rule = compileKeyAssignment(assignment, *actionPrograms)) {
+                lookupTable->addRule(fromKey->getScanCodes()[0].m_scan, *rule);
+                ++ rules;
+            }
+        });
+
+    {
+        Acquire a(&m_log, 0);
+        m_log << "Patched rule lookup table: " << rules << " compiled rules for "
+              << i_keys.size() << " keys." << std::endl;
+    }
+
+    // Once patches have doubled the program code, most of it belongs to
+    // replaced rules; a full build leaves only the live programs
+    if (actionPrograms->instructionCount() != instructionsBefore &&
+            actionPrograms->instructionCount() >
+            2 * std::max<size_t>(m_builtActionInstructions, MIN_COMPACTED_ACTION_INSTRUCTIONS)) {
+        buildSubstitutionTable(m_setting->m_keyboard);
+        return;
+    }
+
+    // A key may have gained or lost its last rule
+    buildPassthroughMap(*m_eventProcessor);
+}
+
+
+// Rebuild the chord table and detector for m_setting
+void Engine::buildChordDetector()
+{
+    static_assert(Setting::Chord::MAX_KEYS == yamy::engine::ChordTable::MAX_CHORD_SIZE,
+                  "chord size limits of Setting and ChordTable differ");
+
+    // The old detector refers to keys and the table of the old setting
+    m_chordDetector.reset();
+    m_chordTable.reset();
+    m_chordTimerWindow = 0;    // windowId() of a new detector
+    if (m_chordTimer)
+        m_chordTimer->disarm();
+    if (!m_setting || m_setting->m_chords.empty())
+        return;
+
+    auto table = std::make_unique<yamy::engine::ChordTable>();
+    for (size_t i = 0; i < m_setting->m_chords.size(); ++ i) {
+        const Setting::Chord &chord = m_setting->m_chords[i];
+        uint16_t scans[yamy::engine::ChordTable::MAX_CHORD_SIZE];
+        size_t count = 0;
+        // The detector sees the scan code of the raw event, as processKeyEvent() does
+        for (const Key *key : chord.m_keys)
+            if (count < NUMBER_OF(scans) && key->getScanCodesSize() == 1 &&
+                    key->getScanCodes()[0].m_flags == 0)
+                scans[count ++] = key->getScanCodes()[0].m_scan;
+        if (count != chord.m_keys.size() ||
+                !table->addChord(scans, count, static_cast<uint32_t>(i))) {
+            Acquire a(&m_log, 0);
+            m_log << "Warning: chord " << i << " ignored (keys without a single scan code, "
+                  << "duplicate of another chord, or more than "
+                  << yamy::engine::ChordTable::MAX_KEYS << " chord keys)" << std::endl;
+        }
+    }
+    if (table->empty())
+        return;
+
+    m_chordTable = std::move(table);
+    m_chordDetector = std::make_unique<yamy::engine::ChordDetector>(
+        *m_chordTable, m_setting->m_chordTimeout);
+}
+
+
+// Rebuild the mouse keys bindings for m_setting
+void Engine::buildMouseKeys()
+{
+    // Keys held under the old setting stop moving the pointer
+    std::atomic_store(&m_mouseKeys, std::shared_ptr<yamy::engine::MouseKeys>());
+    if (m_mouseKeysTimer)
+        m_mouseKeysTimer->disarm();
+    if (!m_setting || m_setting->m_mouseKeys.empty())
+        return;
+
+    std::vector<yamy::engine::MouseKeysBinding> bindings;
+    for (const Setting::MouseKey &mouseKey : m_setting->m_mouseKeys) {
+        // The raw event's scan code, as for chords
+        const Key *key = mouseKey.m_key;
+        if (key->getScanCodesSize() != 1 || key->getScanCodes()[0].m_flags != 0) {
+            Acquire a(&m_log, 0);
+            m_log << "Warning: mouse key " << key->getName()
+                  << " ignored (not a single scan code)" << std::endl;
+            continue;
+        }
+        bindings.push_back({key->getScanCodes()[0].m_scan, mouseKey.m_action,
+                            mouseKey.m_profile});
+    }
+    std::atomic_store(&m_mouseKeys, std::make_shared<yamy::engine::MouseKeys>(
+        m_setting->m_mouseKeysProfiles, bindings));
+}
+
+
+// Collect the keys the engine forwards unchanged, for pushInputEvent()
+void Engine::buildPassthroughMap(const yamy::EventProcessor &i_processor)
+{
+    auto passthrough = std::make_shared<yamy::engine::PassthroughMap>();
+
+    if (m_setting) {
+        // Scan codes some rule reacts to, under any modifier state
+        yamy::engine::PassthroughMap blocked;
+        auto block = [&blocked](const Key *key) {
+            if (!key)
+                return;
+            // Mouse buttons never take the passthrough path
+            for (size_t i = 0; i < key->getScanCodesSize(); ++ i)
+                if (!(key->getScanCodes()[i].m_flags & ScanCode::E1))
+                    blocked.set(key->getScanCodes()[i].m_scan);
+        };
+
+        const yamy::engine::RuleLookupTable *lookupTable = i_processor.getLookupTable();
+        for (const auto &keymap : m_setting->m_keymaps.getKeymapList())
+            keymap.forEachAssignment([&](const Keymap::KeyAssignment &assignment) {
+                block(assignment.m_modifiedKey.m_key);
+            });
+        for (const auto &numberMod : m_setting->m_keyboard.getNumberModifiers()) {
+            block(numberMod.m_numberKey);
+            block(numberMod.m_modifierKey);
+        }
+        for (const auto &[trigger, modNum] : m_setting->m_virtualModTriggers)
+            blocked.set(trigger);
+        block(m_setting->m_keyboard.getSyncKey());
+        for (const Setting::Chord &chord : m_setting->m_chords)
+            for (const Key *key : chord.m_keys)
+                block(key);
+        for (const Setting::MouseKey &mouseKey : m_setting->m_mouseKeys)
+            block(mouseKey.m_key);
+
+        for (Keyboard::KeyIterator it = m_setting->m_keyboard.getKeyIterator(); *it; ++ it) {
+            const Key *key = *it;
+            if (key->m_modifierSlot >= 0 ||
+                    key->getScanCodesSize() != 1 || key->getScanCodes()[0].m_flags != 0) {
+                block(key);
+                continue;
+            }
+            const uint16_t scan = key->getScanCodes()[0].m_scan;
+            // Layer 1 and 3 must map the key onto itself, as they do for
+            // the plain keys that make up most typing
+            if (scan == 0 || (lookupTable && lookupTable->hasRules(scan)) ||
+                    yamy::platform::evdevToYamyKeyCode(scan, -1) != scan ||
+                    yamy::platform::yamyToEvdevKeyCode(scan) == 0) {
+                blocked.set(scan);
+                continue;
+            }
+            passthrough->set(scan);
+        }
+        for (Keyboard::KeyIterator it = m_setting->m_keyboard.getKeyIterator(); *it; ++ it)
+            for (size_t i = 0; i < (*it)->getScanCodesSize(); ++ i)
+                if (blocked.test((*it)->getScanCodes()[i].m_scan))
+                    passthrough->reset((*it)->getScanCodes()[i].m_scan);
+    }
+
+    // Keys already held keep the fast path closed until they are released
+    int heldRuleKeyCount = 0;
+    if (m_setting)
+        for (Keyboard::KeyIterator it = m_setting->m_keyboard.getKeyIterator(); *it; ++ it) {
+            const Key *key = *it;
+            if (key->m_isPressed &&
+                    !(key->getScanCodesSize() == 1 && key->getScanCodes()[0].m_flags == 0 &&
+                      passthrough->test(key->getScanCodes()[0].m_scan)))
+                ++ heldRuleKeyCount;
+        }
+
+    {
+        Acquire a(&m_log, 0);
+        m_log << "Passthrough keys: " << passthrough->count() << std::endl;
+    }
+
+    if (m_queueMutex)
+        yamy::platform::acquireMutex(m_queueMutex, yamy::platform::WAIT_INFINITE);
+    m_passthroughKeys = std::move(passthrough);
+    m_heldRuleKeyCount = heldRuleKeyCount;
+    // reopened by the keyboard handler once it has seen the new setting
+    m_isPassthroughOpen = false;
+    if (m_queueMutex)
+        yamy::platform::releaseMutex(m_queueMutex);
+}
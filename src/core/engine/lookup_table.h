@@ -13,11 +13,19 @@ public:
         m_buckets[inputScanCode].push_back(rule);
     }
 
+    // Drop the rules of one scan code, to recompile them after a config patch
+    void removeRules(uint16_t inputScanCode) { m_buckets.erase(inputScanCode); }
+
     // clear table
     void clear() { m_buckets.clear(); }
 
-    // Find the first matching rule
-    const CompiledRule* findMatch(uint16_t scanCode, const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& state) const {
+    // Does any rule take this scan code as input?
+    bool hasRules(uint16_t scanCode) const { return m_buckets.count(scanCode) != 0; }
+
+    // Find the first matching rule for an event on edge; EDGE_BOTH accepts
+    // rules of either edge
+    const CompiledRule* findMatch(uint16_t scanCode, const std::bitset<yamy::input::ModifierState::TOTAL_BITS>& state,
+                                  CompiledRule::Edge edge = CompiledRule::EDGE_BOTH) const {
         auto it = m_buckets.find(scanCode);
         if (it == m_buckets.end()) {
             // DEBUG: No rules for this scan code
@@ -38,14 +46,18 @@ public:
             }
         }
 
+        const uint16_t stdState = CompiledRule::stdBits(state);
         for (const auto& rule : rules) {
-            if (rule.matches(state)) {
+            if (rule.appliesTo(edge) && rule.matches(state, stdState)) {
                 return &rule;
             } else if (scanCode == 0x23 || scanCode == 0x24 || scanCode == 0x25 || scanCode == 0x26) {
                 std::cerr << "[LOOKUP-DEBUG] Rule didn't match. Required ON bits: ";
                 for (size_t i = 0; i < rule.requiredOn.size(); i++) {
                     if (rule.requiredOn.test(i)) std::cerr << i << " ";
                 }
+                for (uint8_t g = 0; g < rule.anyOfCount; g++) {
+                    std::cerr << "anyOf(0x" << std::hex << rule.anyOf[g] << std::dec << ") ";
+                }
                 std::cerr << std::endl;
             }
         }
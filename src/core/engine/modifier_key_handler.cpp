@@ -11,8 +11,9 @@
 namespace yamy {
 namespace engine {
 
-ModifierKeyHandler::ModifierKeyHandler(uint32_t hold_threshold_ms)
+ModifierKeyHandler::ModifierKeyHandler(uint32_t hold_threshold_ms, std::shared_ptr<const IClock> clock)
     : m_hold_threshold_ms(hold_threshold_ms)
+    , m_clock(clock ? std::move(clock) : std::make_shared<SteadyClock>())
     , m_debugLogging(false)
 {
     // Check for debug logging environment variable
@@ -24,6 +25,11 @@ ModifierKeyHandler::ModifierKeyHandler(uint32_t hold_threshold_ms)
     LOG_INFO("[ModifierKeyHandler] [MODIFIER] initialized with threshold {}ms", hold_threshold_ms);
 }
 
+void ModifierKeyHandler::setClock(std::shared_ptr<const IClock> clock)
+{
+    m_clock = clock ? std::move(clock) : std::make_shared<SteadyClock>();
+}
+
 void ModifierKeyHandler::registerNumberModifier(uint16_t yamy_scancode, HardwareModifier modifier)
 {
     m_number_to_modifier[yamy_scancode] = modifier;
@@ -103,7 +109,7 @@ NumberKeyResult ModifierKeyHandler::processNumberKey(uint16_t yamy_scancode, Eve
             case NumberKeyState::IDLE:
                 // Start waiting period
                 state.state = NumberKeyState::WAITING;
-                state.press_time = std::chrono::steady_clock::now();
+                state.press_time = m_clock->now();
 
                 if (m_debugLogging) {
                     LOG_DEBUG("[TEST] [ModifierKeyHandler] State: IDLE → WAITING for key 0x{:04X} ({})",
@@ -126,7 +132,7 @@ NumberKeyResult ModifierKeyHandler::processNumberKey(uint16_t yamy_scancode, Eve
                 if (hasExceededThreshold(state.press_time)) {
                     // Hold detected - activate modifier
                     state.state = NumberKeyState::MODIFIER_ACTIVE;
-                    auto elapsed = std::chrono::steady_clock::now() - state.press_time;
+                    auto elapsed = m_clock->now() - state.press_time;
                     auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
 
                     if (is_virtual) {
@@ -164,7 +170,7 @@ NumberKeyResult ModifierKeyHandler::processNumberKey(uint16_t yamy_scancode, Eve
                 // This shouldn't happen (TAP transitions back to IDLE on RELEASE)
                 // Treat as new PRESS
                 state.state = NumberKeyState::WAITING;
-                state.press_time = std::chrono::steady_clock::now();
+                state.press_time = m_clock->now();
                 return NumberKeyResult(ProcessingAction::WAITING_FOR_THRESHOLD, 0, false);
         }
     }
@@ -179,7 +185,7 @@ NumberKeyResult ModifierKeyHandler::processNumberKey(uint16_t yamy_scancode, Eve
 
             case NumberKeyState::WAITING: {
                 // Check if threshold was exceeded during the hold
-                auto elapsed = std::chrono::steady_clock::now() - state.press_time;
+                auto elapsed = m_clock->now() - state.press_time;
                 auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
 
                 // If threshold exceeded, treat as HOLD (even though we're at RELEASE now)
@@ -313,7 +319,7 @@ std::vector<std::pair<uint16_t, uint8_t>> ModifierKeyHandler::checkAndActivateWa
         if (hasExceededThreshold(state.press_time)) {
             // Activate this modifier
             state.state = NumberKeyState::MODIFIER_ACTIVE;
-            auto elapsed = std::chrono::steady_clock::now() - state.press_time;
+            auto elapsed = m_clock->now() - state.press_time;
             auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
 
             if (state.is_virtual) {
@@ -357,18 +363,16 @@ uint16_t ModifierKeyHandler::getModifierVKCode(HardwareModifier modifier)
     }
 }
 
-bool ModifierKeyHandler::hasExceededThreshold(const std::chrono::steady_clock::time_point& press_time) const
+bool ModifierKeyHandler::hasExceededThreshold(ClockTime press_time) const
 {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = now - press_time;
+    auto elapsed = m_clock->now() - press_time;
     auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
     return elapsed_ms >= m_hold_threshold_ms;
 }
 
-bool ModifierKeyHandler::hasExceededMaximum(const std::chrono::steady_clock::time_point& press_time) const
+bool ModifierKeyHandler::hasExceededMaximum(ClockTime press_time) const
 {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = now - press_time;
+    auto elapsed = m_clock->now() - press_time;
     auto elapsed_sec = std::chrono::duration_cast<std::chrono::seconds>(elapsed).count();
     // Maximum threshold: 5 seconds (handles system suspend/resume edge case)
     return elapsed_sec > 5;
@@ -7,6 +7,7 @@
 // - TAP (<200ms): Apply normal substitution
 //
 // Design: Passive timestamp-based detection (no timer threads)
+// Time source: injectable IClock (kernel event time in production)
 // Integration: Layer 2 of EventProcessor (before substitution lookup)
 
 #ifndef _MODIFIER_KEY_HANDLER_H
@@ -16,6 +17,8 @@
 #include <unordered_map>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include "engine_clock.h"
 
 namespace yamy {
 
@@ -84,7 +87,13 @@ class ModifierKeyHandler {
 public:
     /// Constructor
     /// @param hold_threshold_ms Hold detection threshold in milliseconds (default: 200)
-    explicit ModifierKeyHandler(uint32_t hold_threshold_ms = 200);
+    /// @param clock Time source for hold/tap decisions (nullptr = steady_clock)
+    explicit ModifierKeyHandler(uint32_t hold_threshold_ms = 200,
+                                std::shared_ptr<const IClock> clock = nullptr);
+
+    /// Replace the time source used for hold/tap decisions
+    /// @param clock New time source (nullptr = steady_clock)
+    void setClock(std::shared_ptr<const IClock> clock);
 
     /// Register a number key as a hardware modifier
     /// @param yamy_scancode YAMY scan code for number key (e.g., 0x0002 for _1)
@@ -135,7 +144,7 @@ public:
     /// Per-key state tracking structure (public for testing)
     struct KeyState {
         NumberKeyState state;
-        std::chrono::steady_clock::time_point press_time;
+        ClockTime press_time;                 // Clock time when key was pressed
         HardwareModifier target_modifier;     // For number modifiers (hardware)
         bool is_virtual;                      // true if virtual modifier (M00-MFF)
         uint8_t virtual_mod_num;              // Virtual modifier number (0x00-0xFF for M00-MFF)
@@ -177,6 +186,9 @@ private:
     /// Hold threshold in milliseconds
     uint32_t m_hold_threshold_ms;
 
+    /// Time source for hold/tap decisions
+    std::shared_ptr<const IClock> m_clock;
+
     /// Debug logging flag (set by YAMY_DEBUG_KEYCODE environment variable)
     bool m_debugLogging;
 
@@ -188,12 +200,12 @@ private:
     /// Check if hold threshold has been exceeded
     /// @param press_time Timestamp when key was pressed
     /// @return true if elapsed time >= threshold, false otherwise
-    bool hasExceededThreshold(const std::chrono::steady_clock::time_point& press_time) const;
+    bool hasExceededThreshold(ClockTime press_time) const;
 
     /// Check if elapsed time exceeds maximum (for handling system suspend/resume)
     /// @param press_time Timestamp when key was pressed
     /// @return true if elapsed time > 5 seconds (treat as IDLE)
-    bool hasExceededMaximum(const std::chrono::steady_clock::time_point& press_time) const;
+    bool hasExceededMaximum(ClockTime press_time) const;
 };
 
 } // namespace engine
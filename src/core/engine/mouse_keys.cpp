@@ -0,0 +1,162 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// mouse_keys.cpp - Pointer motion and scrolling from held keys
+
+#include "mouse_keys.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace yamy::engine {
+
+namespace {
+
+/// Each axis of a diagonal gets 1/sqrt(2) of the speed
+constexpr double DIAGONAL_SCALE = 0.70710678118654752;
+
+} // namespace
+
+MouseKeys::MouseKeys(std::vector<MouseKeysProfile> profiles,
+                     const std::vector<MouseKeysBinding>& bindings)
+    : m_profiles(std::move(profiles))
+{
+    if (m_profiles.empty()) {
+        m_profiles.emplace_back();
+    }
+    if (m_profiles.size() > MAX_PROFILES) {
+        m_profiles.resize(MAX_PROFILES);
+    }
+    m_bindingOf.fill(NO_BINDING);
+    for (const MouseKeysBinding& binding : bindings) {
+        if (m_bindings.size() == MAX_BINDINGS || binding.scan >= MAX_SCAN ||
+                binding.profile >= m_profiles.size() || isBound(binding.scan)) {
+            continue;
+        }
+        m_bindingOf[binding.scan] = static_cast<uint8_t>(m_bindings.size());
+        m_bindings.push_back(binding);
+    }
+}
+
+bool MouseKeys::onKey(uint16_t scan, bool isPressed, uint64_t nowUs)
+{
+    if (!isBound(scan)) {
+        return false;
+    }
+    const uint8_t index = m_bindingOf[scan];
+    const uint64_t bit = uint64_t(1) << index;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool wasActive = isActiveLocked();
+    if (isPressed) {
+        if (m_held & bit) {
+            return false;   // Key repeat: keep accelerating
+        }
+        m_held |= bit;
+        m_pressOrder[index] = ++m_pressCount;
+    } else {
+        m_held &= ~bit;
+    }
+
+    const bool isNowActive = isActiveLocked();
+    if (isNowActive && !wasActive) {
+        m_motionStartUs = nowUs;
+        m_lastTickUs = nowUs;
+        m_remainderX = m_remainderY = m_remainderWheel = 0;
+    }
+    return isNowActive != wasActive;
+}
+
+MouseKeysStep MouseKeys::tick(uint64_t nowUs)
+{
+    MouseKeysStep step;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!isActiveLocked() || nowUs <= m_lastTickUs) {
+        return step;
+    }
+
+    int x = 0;
+    int y = 0;
+    int wheel = 0;
+    for (size_t i = 0; i < m_bindings.size(); ++i) {
+        if (!(m_held & (uint64_t(1) << i))) {
+            continue;
+        }
+        switch (m_bindings[i].action) {
+            case MouseKeysAction::Left:      x -= 1; break;
+            case MouseKeysAction::Right:     x += 1; break;
+            case MouseKeysAction::Up:        y -= 1; break;
+            case MouseKeysAction::Down:      y += 1; break;
+            case MouseKeysAction::WheelUp:   wheel += 1; break;
+            case MouseKeysAction::WheelDown: wheel -= 1; break;
+            case MouseKeysAction::None:      break;
+        }
+    }
+    x = std::clamp(x, -1, 1);
+    y = std::clamp(y, -1, 1);
+    wheel = std::clamp(wheel, -1, 1);
+
+    const MouseKeysProfile& profile = activeProfileLocked();
+    const double seconds = (nowUs - m_lastTickUs) / 1e6;
+    m_lastTickUs = nowUs;
+
+    // Diagonals move at the same speed as straight lines
+    const double distance = speedAt(profile, nowUs - m_motionStartUs) * seconds;
+    const double scale = (x != 0 && y != 0) ? distance * DIAGONAL_SCALE : distance;
+    m_remainderX += x * scale;
+    m_remainderY += y * scale;
+    m_remainderWheel += wheel * profile.wheelSpeed * WHEEL_NOTCH * seconds;
+
+    step.dx = static_cast<int32_t>(std::trunc(m_remainderX));
+    step.dy = static_cast<int32_t>(std::trunc(m_remainderY));
+    step.wheel = static_cast<int32_t>(std::trunc(m_remainderWheel));
+    m_remainderX -= step.dx;
+    m_remainderY -= step.dy;
+    m_remainderWheel -= step.wheel;
+    return step;
+}
+
+bool MouseKeys::isActive() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return isActiveLocked();
+}
+
+void MouseKeys::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_held = 0;
+}
+
+double MouseKeys::speedAt(const MouseKeysProfile& profile, uint64_t t)
+{
+    if (profile.accelerationMs == 0 || profile.maxSpeed <= profile.initialSpeed) {
+        return std::max(profile.initialSpeed, profile.maxSpeed);
+    }
+    const double ramp = std::min(1.0, t / (profile.accelerationMs * 1000.0));
+    return profile.initialSpeed +
+           (profile.maxSpeed - profile.initialSpeed) * std::pow(ramp, profile.curve);
+}
+
+const MouseKeysProfile& MouseKeys::activeProfileLocked() const
+{
+    size_t latest = 0;
+    uint32_t latestOrder = 0;
+    for (size_t index = 0; index < m_bindings.size(); ++index) {
+        if ((m_held & (uint64_t(1) << index)) && m_pressOrder[index] >= latestOrder) {
+            latestOrder = m_pressOrder[index];
+            latest = m_bindings[index].profile;
+        }
+    }
+    return m_profiles[latest];
+}
+
+bool MouseKeys::isActiveLocked() const
+{
+    for (size_t i = 0; i < m_bindings.size(); ++i) {
+        if ((m_held & (uint64_t(1) << i)) && m_bindings[i].action != MouseKeysAction::None) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace yamy::engine
@@ -0,0 +1,131 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// mouse_keys.h - Pointer motion and scrolling from held keys
+//
+// MouseKeys is built once per setting from its mouseKeys bindings. The
+// keyboard handler reports presses and releases of bound keys; while a move
+// or wheel key is held, a periodic tick (a TickTimer at the configured rate)
+// asks for the motion since the previous tick and sends it to the uinput
+// device as relative events. Nothing is queried from or warped through the
+// window system, and the keyboard handler never waits for the motion.
+//
+// Speed follows the profile of the most recently pressed held binding: it
+// starts at initialSpeed when the pointer starts moving and ramps to maxSpeed
+// over accelerationMs along (t / accelerationMs)^curve. A binding without a
+// direction only selects its profile, e.g. a key held for precise motion.
+// Sub-pixel and sub-notch remainders carry over to the next tick, so slow
+// speeds at high rates still move smoothly.
+//
+// onKey() runs on the keyboard handler thread and tick() on the timer
+// thread; both take a short lock.
+
+#ifndef _MOUSE_KEYS_H
+#define _MOUSE_KEYS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace yamy::engine {
+
+/// What a bound key does while held
+enum class MouseKeysAction : uint8_t {
+    Left,
+    Right,
+    Up,
+    Down,
+    WheelUp,
+    WheelDown,
+    None,       ///< Only selects the binding's profile
+};
+
+/// Speed and acceleration of the pointer while a profile is selected
+struct MouseKeysProfile {
+    double initialSpeed = 200.0;        ///< px/s when motion starts
+    double maxSpeed = 1600.0;           ///< px/s once accelerated
+    uint32_t accelerationMs = 600;      ///< Time from initialSpeed to maxSpeed
+    double curve = 2.0;                 ///< Exponent of the ramp; 1 is linear
+    double wheelSpeed = 10.0;           ///< Wheel notches/s
+};
+
+/// A key bound to a mouse-keys action
+struct MouseKeysBinding {
+    uint16_t scan;
+    MouseKeysAction action;
+    uint8_t profile;                    ///< Index into the profiles
+};
+
+/// Motion produced by one tick
+struct MouseKeysStep {
+    int32_t dx = 0;                     ///< Pixels
+    int32_t dy = 0;
+    int32_t wheel = 0;                  ///< 1/120 notch, positive is up
+};
+
+class MouseKeys {
+public:
+    static constexpr size_t MAX_BINDINGS = 64;
+    static constexpr size_t MAX_PROFILES = 16;
+    static constexpr uint32_t MAX_SCAN = 0x300;
+    static constexpr int32_t WHEEL_NOTCH = 120;
+
+    /**
+     * @param profiles Profiles, at least one (bindings refer to them by index)
+     * @param bindings Bound keys; entries with an unknown profile or scan
+     *        code, and those beyond MAX_BINDINGS, are dropped
+     */
+    MouseKeys(std::vector<MouseKeysProfile> profiles,
+              const std::vector<MouseKeysBinding>& bindings);
+
+    /// Is the scan code bound? One table lookup.
+    bool isBound(uint16_t scan) const {
+        return scan < MAX_SCAN && m_bindingOf[scan] != NO_BINDING;
+    }
+
+    /**
+     * @brief Report a press or release of a bound key
+     * @param nowUs Monotonic time in microseconds, the same clock as tick()
+     * @return true if motion started or stopped, i.e. the tick timer must
+     *         be armed (isActive()) or disarmed
+     */
+    bool onKey(uint16_t scan, bool isPressed, uint64_t nowUs);
+
+    /// Motion since the previous tick; all zero if nothing moves
+    MouseKeysStep tick(uint64_t nowUs);
+
+    /// Is a move or wheel key held?
+    bool isActive() const;
+
+    /// Release every key, e.g. when the engine is disabled
+    void reset();
+
+    /// Pointer speed in px/s, t microseconds after motion started
+    static double speedAt(const MouseKeysProfile& profile, uint64_t t);
+
+private:
+    static constexpr uint8_t NO_BINDING = 0xff;
+
+    /// Profile of the most recently pressed held binding (m_mutex held)
+    const MouseKeysProfile& activeProfileLocked() const;
+    bool isActiveLocked() const;
+
+    std::vector<MouseKeysProfile> m_profiles;
+    std::vector<MouseKeysBinding> m_bindings;
+    std::array<uint8_t, MAX_SCAN> m_bindingOf;     ///< Binding index by scan code
+
+    mutable std::mutex m_mutex;
+    uint64_t m_held = 0;                            ///< Bit per held binding
+    std::array<uint32_t, MAX_BINDINGS> m_pressOrder{};
+    uint32_t m_pressCount = 0;
+    uint64_t m_motionStartUs = 0;
+    uint64_t m_lastTickUs = 0;
+    double m_remainderX = 0;
+    double m_remainderY = 0;
+    double m_remainderWheel = 0;
+};
+
+} // namespace yamy::engine
+
+#endif // _MOUSE_KEYS_H
@@ -0,0 +1,38 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// passthrough_map.h - Scan codes the engine would forward unchanged
+//
+// Built once per setting by Engine::buildSubstitutionTable(). A key is in the
+// map only if no substitution, keymap assignment, modifier role, number
+// modifier or virtual modifier trigger refers to it, so the engine's only
+// output for it would be the same key. Such events may be injected by the
+// input thread directly (see Engine::pushInputEvent) while the engine is
+// otherwise idle.
+
+#ifndef _PASSTHROUGH_MAP_H
+#define _PASSTHROUGH_MAP_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace yamy::engine {
+
+/// Bitmap over all 16-bit YAMY scan codes
+class PassthroughMap {
+public:
+    void set(uint16_t scanCode) { m_bits.set(scanCode); }
+    void reset(uint16_t scanCode) { m_bits.reset(scanCode); }
+    bool test(uint16_t scanCode) const { return m_bits.test(scanCode); }
+    void clear() { m_bits.reset(); }
+
+    /// Number of scan codes in the map
+    size_t count() const { return m_bits.count(); }
+
+private:
+    std::bitset<0x10000> m_bits;
+};
+
+} // namespace yamy::engine
+
+#endif // _PASSTHROUGH_MAP_H
@@ -0,0 +1,154 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// tick_timer.cpp - Timer thread for engine-scheduled key events
+
+#include "tick_timer.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace yamy::engine {
+
+TickTimer::TickTimer(TickCallback onTick)
+    : m_onTick(std::move(onTick))
+    , m_timerFd(-1)
+    , m_wakeFd(-1)
+    , m_running(false)
+{
+}
+
+TickTimer::~TickTimer()
+{
+    stop();
+}
+
+#ifndef _WIN32
+
+bool TickTimer::start()
+{
+    if (m_running) return true;
+
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_timerFd < 0) {
+        return false;
+    }
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        close(m_timerFd);
+        m_timerFd = -1;
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&TickTimer::run, this);
+    return true;
+}
+
+void TickTimer::stop()
+{
+    if (m_running) {
+        m_running = false;
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+    if (m_timerFd >= 0) {
+        close(m_timerFd);
+        m_timerFd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+static timespec toTimespec(uint32_t ms)
+{
+    timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = static_cast<long>(ms % 1000) * 1000000L;
+    return ts;
+}
+
+void TickTimer::arm(uint32_t delayMs, uint32_t intervalMs)
+{
+    if (m_timerFd < 0) return;
+
+    itimerspec spec;
+    // A zero it_value disarms, so the first tick is at least 1ms out
+    spec.it_value = toTimespec(delayMs > 0 ? delayMs : 1);
+    spec.it_interval = toTimespec(intervalMs);
+    timerfd_settime(m_timerFd, 0, &spec, nullptr);
+}
+
+void TickTimer::disarm()
+{
+    if (m_timerFd < 0) return;
+
+    itimerspec spec = {};
+    timerfd_settime(m_timerFd, 0, &spec, nullptr);
+}
+
+void TickTimer::run()
+{
+    pollfd fds[2];
+    fds[0].fd = m_timerFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+
+    while (m_running) {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            // Missed expirations collapse into one tick; a busy engine should
+            // not receive a burst of repeats once it catches up
+            uint64_t expirations = 0;
+            if (read(m_timerFd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+                expirations > 0 && m_onTick) {
+                m_onTick();
+            }
+        }
+    }
+}
+
+#else // _WIN32
+
+bool TickTimer::start()
+{
+    return false;
+}
+
+void TickTimer::stop()
+{
+}
+
+void TickTimer::arm(uint32_t, uint32_t)
+{
+}
+
+void TickTimer::disarm()
+{
+}
+
+void TickTimer::run()
+{
+}
+
+#endif // _WIN32
+
+} // namespace yamy::engine
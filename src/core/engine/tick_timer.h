@@ -0,0 +1,58 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// tick_timer.h - Timer thread for engine-scheduled key events
+//
+// Supplies the ticks for engine autorepeat (periodic) and the chord window
+// (one-shot): arm() starts a timerfd, and every expiry calls the tick
+// callback on the timer thread. The callback only queues work for the
+// keyboard handler; it must not touch engine state itself.
+
+#ifndef _TICK_TIMER_H
+#define _TICK_TIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace yamy::engine {
+
+class TickTimer {
+public:
+    using TickCallback = std::function<void()>;
+
+    explicit TickTimer(TickCallback onTick);
+    ~TickTimer();
+
+    TickTimer(const TickTimer&) = delete;
+    TickTimer& operator=(const TickTimer&) = delete;
+
+    /// Create the timer and start its thread
+    /// @return false if timers are unavailable on this platform
+    bool start();
+
+    /// Stop the thread and release the timer
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+    /// Fire first after delayMs, then every intervalMs until disarmed or
+    /// re-armed; intervalMs 0 fires once
+    void arm(uint32_t delayMs, uint32_t intervalMs);
+
+    /// Stop firing
+    void disarm();
+
+private:
+    void run();
+
+    TickCallback m_onTick;
+    int m_timerFd;
+    int m_wakeFd;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace yamy::engine
+
+#endif // _TICK_TIMER_H
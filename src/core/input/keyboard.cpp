@@ -33,6 +33,7 @@ Key &Key::initialize()
     m_isPressed = false;
     m_isPressedOnWin32 = false;
     m_isPressedByAssign = false;
+    m_modifierSlot = -1;
     m_scanCodes.clear();
     return *this;
 }
@@ -266,6 +267,18 @@ Key *Keyboard::KeyIterator::operator *()
 // Keyboard
 
 
+Keyboard::Keyboard(std::pmr::memory_resource *i_mr)
+        : m_hashedKeys(makeArrayWithResource<Keys>(
+                           i_mr, std::make_index_sequence<HASHED_KEYS_SIZE>())),
+        m_aliases(i_mr),
+        m_substitutes(i_mr),
+        m_numberModifiers(i_mr),
+        m_mods(makeArrayWithResource<Mods>(
+                   i_mr, std::make_index_sequence<Modifier::Type_BASIC>()))
+{
+}
+
+
 Keyboard::Keys &Keyboard::getKeys(const Key &i_key)
 {
     ASSERT(1 <= i_key.getScanCodesSize());
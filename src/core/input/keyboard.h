@@ -13,10 +13,30 @@
 #  include <list>
 #  include <map>
 #  include <array>
+#  include <memory_resource>
 #  include <ostream>
+#  include <utility>
 #  include <gsl/gsl>
 
 
+/// std::array of containers that all allocate from i_mr
+template <class T, size_t... I>
+std::array<T, sizeof...(I)>
+makeArrayWithResource(std::pmr::memory_resource *i_mr, std::index_sequence<I...>)
+{
+    return {{ ((void)I, T(i_mr))... }};
+}
+
+/// copy of i_other whose containers allocate from i_mr
+template <class T, size_t N, size_t... I>
+std::array<T, N>
+copyArrayWithResource(const std::array<T, N> &i_other,
+                      std::pmr::memory_resource *i_mr, std::index_sequence<I...>)
+{
+    return {{ T(i_other[I], i_mr)... }};
+}
+
+
 /// a scan code with flags
 class ScanCode
 {
@@ -71,6 +91,9 @@ public:
     bool m_isPressedOnWin32;
     /// if this key pressed by assign
     bool m_isPressedByAssign;
+    /// bit of this key in the modifier role tables, -1 if no keymap uses it
+    /// as a modifier (set by Keymaps::compileModifierRoles())
+    int m_modifierSlot;
 
 private:
     /// key name
@@ -83,13 +106,15 @@ public:
     Key()
             : m_isPressed(false),
             m_isPressedOnWin32(false),
-            m_isPressedByAssign(false) { }
+            m_isPressedByAssign(false),
+            m_modifierSlot(-1) { }
 
     /// for Event::* only
     Key(const std::string &i_name)
             : m_isPressed(false),
             m_isPressedOnWin32(false),
-            m_isPressedByAssign(false) {
+            m_isPressedByAssign(false),
+            m_modifierSlot(-1) {
         addName(i_name);
         addScanCode(ScanCode());
     }
@@ -362,7 +387,15 @@ class Keyboard
 {
 public:
     /// keyboard modifiers (pointer into Keys)
-    typedef std::list<Key *> Mods;
+    typedef std::pmr::list<Key *> Mods;
+    // Use std::less<> for default case-sensitive comparison (std::string)
+    // or a custom comparator if case-insensitive logic is required.
+    // Based on legacy `tstringi`, this map likely needs case-insensitive behavior.
+    struct CaseInsensitiveCompare {
+        bool operator()(const std::string& a, const std::string& b) const {
+             return strcasecmp_utf8(a.c_str(), b.c_str()) < 0;
+        }
+    };
 
 private:
     /** keyboard keys (hashed by first scan code).
@@ -372,16 +405,8 @@ private:
     enum {
         HASHED_KEYS_SIZE = 128,            ///
     };
-    typedef std::list<Key> Keys;            ///
-    // Use std::less<> for default case-sensitive comparison (std::string)
-    // or a custom comparator if case-insensitive logic is required.
-    // Based on legacy `tstringi`, this map likely needs case-insensitive behavior.
-    struct CaseInsensitiveCompare {
-        bool operator()(const std::string& a, const std::string& b) const {
-             return strcasecmp_utf8(a.c_str(), b.c_str()) < 0;
-        }
-    };
-    typedef std::map<std::string, Key *, CaseInsensitiveCompare> Aliases;    /// key name aliases
+    typedef std::pmr::list<Key> Keys;            ///
+    typedef std::pmr::map<std::string, Key *, CaseInsensitiveCompare> Aliases;    /// key name aliases
 public:
     ///
     class Substitute
@@ -395,7 +420,7 @@ public:
                 : m_mkeyFrom(i_mkeyFrom), m_mkeyTo(i_mkeyTo) {
         }
     };
-    typedef std::list<Substitute> Substitutes;    /// substitutes
+    typedef std::pmr::list<Substitute> Substitutes;    /// substitutes
 
     /// Number modifier mapping: number key -> hardware modifier key
     class NumberModifier
@@ -408,7 +433,7 @@ public:
                 : m_numberKey(i_numberKey), m_modifierKey(i_modifierKey) {
         }
     };
-    typedef std::list<NumberModifier> NumberModifiers;    /// number modifiers
+    typedef std::pmr::list<NumberModifier> NumberModifiers;    /// number modifiers
 
 private:
     std::array<Keys, HASHED_KEYS_SIZE> m_hashedKeys;        ///
@@ -419,7 +444,7 @@ private:
 
 private:
     ///
-    Mods m_mods[Modifier::Type_BASIC];
+    std::array<Mods, Modifier::Type_BASIC> m_mods;
 
 public:
     ///
@@ -449,6 +474,10 @@ private:
     Keys &getKeys(const Key &i_key);
 
 public:
+    /// i_mr: where keys, aliases, substitutes and modifier lists allocate
+    explicit Keyboard(std::pmr::memory_resource *i_mr =
+                          std::pmr::get_default_resource());
+
     /// add a key
     void addKey(const Key &i_key);
 
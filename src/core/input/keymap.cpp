@@ -240,14 +240,40 @@ Keymap::getKeyAssignments(const ModifiedKey &i_mk) const
 
 Keymap::Keymap(const std::string &i_name,
                KeySeq *i_defaultKeySeq,
-               Keymap *i_parentKeymap)
-        : m_name(i_name),
+               Keymap *i_parentKeymap,
+               std::pmr::memory_resource *i_mr)
+        : m_hashedKeyAssignments(makeArrayWithResource<KeyAssignments>(
+                                     i_mr, std::make_index_sequence<HASHED_KEY_ASSIGNMENT_SIZE>())),
+        m_modAssignments(makeArrayWithResource<ModAssignments>(
+                             i_mr, std::make_index_sequence<Modifier::Type_ASSIGN>())),
+        m_modifierSlotMasks(),
+        m_hasModifierRoles(false),
+        m_name(i_name),
         m_defaultKeySeq(i_defaultKeySeq),
         m_parentKeymap(i_parentKeymap)
 {
 }
 
 
+Keymap::Keymap(const Keymap &i_keymap, std::pmr::memory_resource *i_mr)
+        : m_hashedKeyAssignments(copyArrayWithResource(
+                                     i_keymap.m_hashedKeyAssignments, i_mr,
+                                     std::make_index_sequence<HASHED_KEY_ASSIGNMENT_SIZE>())),
+        m_modAssignments(copyArrayWithResource(
+                             i_keymap.m_modAssignments, i_mr,
+                             std::make_index_sequence<Modifier::Type_ASSIGN>())),
+        m_hasModifierRoles(i_keymap.m_hasModifierRoles),
+        m_name(i_keymap.m_name),
+        m_defaultKeySeq(i_keymap.m_defaultKeySeq),
+        m_parentKeymap(i_keymap.m_parentKeymap)
+{
+    std::copy(std::begin(i_keymap.m_modifierRoles), std::end(i_keymap.m_modifierRoles),
+              std::begin(m_modifierRoles));
+    std::copy(std::begin(i_keymap.m_modifierSlotMasks), std::end(i_keymap.m_modifierSlotMasks),
+              std::begin(m_modifierSlotMasks));
+}
+
+
 void Keymap::addAssignment(const ModifiedKey &i_mk, KeySeq *i_keySeq)
 {
     KeyAssignments &ka = getKeyAssignments(i_mk);
@@ -260,6 +286,13 @@ void Keymap::addAssignment(const ModifiedKey &i_mk, KeySeq *i_keySeq)
 }
 
 
+void Keymap::removeAssignments(Key *i_key)
+{
+    getKeyAssignments(ModifiedKey(i_key)).remove_if(
+        [i_key](const KeyAssignment &i_ka) { return i_ka.m_modifiedKey.m_key == i_key; });
+}
+
+
 void Keymap::addModifier(Modifier::Type i_mt, AssignOperator i_ao,
                          AssignMode i_am, Key *i_key)
 {
@@ -323,7 +356,7 @@ Keymap::searchAssignment(const ModifiedKey &i_mk) const
 
 void Keymap::adjustModifier(Keyboard &i_keyboard)
 {
-    for (size_t i = 0; i < NUMBER_OF(m_modAssignments); ++ i) {
+    for (size_t i = 0; i < m_modAssignments.size(); ++ i) {
         ModAssignments mos;
         if (m_parentKeymap)
             mos = m_parentKeymap->m_modAssignments[i];
@@ -394,6 +427,35 @@ void Keymap::adjustModifier(Keyboard &i_keyboard)
 }
 
 
+void Keymap::compileModifierRoles(bool i_slotsAssigned)
+{
+    for (size_t i = 0; i < NUMBER_OF(m_modifierRoles); ++ i) {
+        m_modifierRoles[i].m_type = Modifier::Type_end;
+        m_modifierRoles[i].m_assignMode = AM_notModifier;
+    }
+    for (size_t i = 0; i < NUMBER_OF(m_modifierSlotMasks); ++ i)
+        m_modifierSlotMasks[i] = 0;
+    m_hasModifierRoles = i_slotsAssigned;
+    if (!m_hasModifierRoles)
+        return;
+
+    // types in ascending order, so a key listed under several types keeps
+    // the first one like the list walk in Engine::fixModifierKey
+    for (int i = Modifier::Type_begin; i != Modifier::Type_end; ++ i) {
+        const ModAssignments &ma = m_modAssignments[i];
+        for (ModAssignments::const_iterator j = ma.begin(); j != ma.end(); ++ j) {
+            const int slot = (*j).m_key->m_modifierSlot;
+            m_modifierSlotMasks[i] |= uint64_t(1) << slot;
+            ModifierRole &role = m_modifierRoles[slot];
+            if (role.m_type == Modifier::Type_end) {
+                role.m_type = static_cast<Modifier::Type>(i);
+                role.m_assignMode = (*j).m_assignMode;
+            }
+        }
+    }
+}
+
+
 // describe
 void Keymap::describe(tostream &i_ost, DescribeParam *i_dp) const
 {
@@ -500,7 +562,8 @@ extern tostream &operator<<(tostream &i_ost, const Keymap *i_keymap)
 // Keymaps
 
 
-Keymaps::Keymaps()
+Keymaps::Keymaps(std::pmr::memory_resource *i_mr)
+        : m_keymapList(i_mr)
 {
 }
 
@@ -532,7 +595,7 @@ Keymap *Keymaps::add(const Keymap &i_keymap)
 {
     if (Keymap *k = searchByName(i_keymap.getName()))
         return k;
-    m_keymapList.push_front(i_keymap);
+    m_keymapList.emplace_front(i_keymap, m_keymapList.get_allocator().resource());
     Keymap *result = &m_keymapList.front();
     Ensures(result != nullptr);
     return result;
@@ -548,6 +611,34 @@ void Keymaps::adjustModifier(Keyboard &i_keyboard)
 }
 
 
+void Keymaps::compileModifierRoles(Keyboard &i_keyboard)
+{
+    // give every key used as a modifier by any keymap its own slot
+    for (Keyboard::KeyIterator i = i_keyboard.getKeyIterator(); *i; ++ i)
+        (*i)->m_modifierSlot = -1;
+    int slotCount = 0;
+    for (KeymapList::iterator i = m_keymapList.begin();
+            i != m_keymapList.end(); ++ i)
+        for (int t = Modifier::Type_begin; t != Modifier::Type_end; ++ t) {
+            const Keymap::ModAssignments &ma =
+                (*i).getModAssignments(static_cast<Modifier::Type>(t));
+            for (Keymap::ModAssignments::const_iterator
+                    j = ma.begin(); j != ma.end(); ++ j)
+                if ((*j).m_key->m_modifierSlot < 0) {
+                    if (slotCount < Keymap::MAX_MODIFIER_SLOTS)
+                        (*j).m_key->m_modifierSlot = slotCount;
+                    ++ slotCount;
+                }
+        }
+
+    // too many modifier keys: the engine falls back to the list walk
+    const bool slotsAssigned = slotCount <= Keymap::MAX_MODIFIER_SLOTS;
+    for (KeymapList::iterator i = m_keymapList.begin();
+            i != m_keymapList.end(); ++ i)
+        (*i).compileModifierRoles(slotsAssigned);
+}
+
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // KeySeqs
 
@@ -563,6 +654,8 @@ KeySeq *KeySeqs::add(const KeySeq &i_keySeq)
     m_keySeqList.push_front(i_keySeq);
     KeySeq *result = &m_keySeqList.front();
     Ensures(result != nullptr);
+    if (!result->getName().empty())
+        m_names.emplace(result->getName(), result);
     return result;
 }
 
@@ -570,13 +663,7 @@ KeySeq *KeySeqs::add(const KeySeq &i_keySeq)
 // search by name
 KeySeq *KeySeqs::searchByName(const std::string &i_name)
 {
-    for (KeySeqList::iterator
-            i = m_keySeqList.begin(); i != m_keySeqList.end(); ++ i)
-        // Perform case-insensitive comparison
-        if (strcasecmp_utf8(i_name.c_str(), (*i).getName().c_str()) == 0) {
-            KeySeq *result = &*i;
-            Ensures(result != nullptr);
-            return result;
-        }
-    return nullptr;
+    // Case-insensitive, as the names of keys are
+    Names::iterator i = m_names.find(i_name);
+    return i != m_names.end() ? i->second : nullptr;
 }
@@ -10,6 +10,7 @@
 #  include "../functions/function.h"
 #  include <vector>
 #  include <memory>
+#  include <cstdint>
 
 
 ///
@@ -231,7 +232,19 @@ public:
         AssignMode m_assignMode;        ///
         Key *m_key;                ///
     };
-    typedef std::list<ModAssignment> ModAssignments; ///
+    typedef std::pmr::list<ModAssignment> ModAssignments; ///
+
+    /// compiled modifier role of one modifier slot (see Key::m_modifierSlot)
+    class ModifierRole
+    {
+    public:
+        Modifier::Type m_type;            /// Type_end if not a modifier here
+        AssignMode m_assignMode;        ///
+    };
+
+    enum {
+        MAX_MODIFIER_SLOTS = 64,        /// bits of a modifier slot mask
+    };
 
     /// parameter for describe();
     class DescribeParam
@@ -252,16 +265,23 @@ public:
 
 private:
     /// key assignments (hashed by first scan code)
-    typedef std::list<KeyAssignment> KeyAssignments;
+    typedef std::pmr::list<KeyAssignment> KeyAssignments;
     enum {
         HASHED_KEY_ASSIGNMENT_SIZE = 32,    ///
     };
 
 private:
-    KeyAssignments m_hashedKeyAssignments[HASHED_KEY_ASSIGNMENT_SIZE];    ///
+    std::array<KeyAssignments, HASHED_KEY_ASSIGNMENT_SIZE> m_hashedKeyAssignments;    ///
 
     /// modifier assignments
-    ModAssignments m_modAssignments[Modifier::Type_ASSIGN];
+    std::array<ModAssignments, Modifier::Type_ASSIGN> m_modAssignments;
+
+    /// m_modAssignments compiled by modifier slot; valid if m_hasModifierRoles
+    ModifierRole m_modifierRoles[MAX_MODIFIER_SLOTS];
+    /// modifier slots assigned to each modifier type
+    uint64_t m_modifierSlotMasks[Modifier::Type_ASSIGN];
+    /// false if the setting has more modifier keys than MAX_MODIFIER_SLOTS
+    bool m_hasModifierRoles;
 
     std::string m_name;                /// keymap name
 
@@ -278,12 +298,20 @@ public:
     ///
     Keymap(const std::string &i_name,
            KeySeq *i_defaultKeySeq,
-           Keymap *i_parentKeymap);
+           Keymap *i_parentKeymap,
+           std::pmr::memory_resource *i_mr = std::pmr::get_default_resource());
+    /// copy whose assignment lists allocate from i_mr
+    Keymap(const Keymap &i_keymap, std::pmr::memory_resource *i_mr);
+    ///
+    Keymap(const Keymap &i_keymap) = default;
 
 
     /// add a key assignment;
     void addAssignment(const ModifiedKey &i_mk, KeySeq *i_keySeq);
 
+    /// remove every key assignment of i_key, whatever its modifiers
+    void removeAssignments(Key *i_key);
+
     /// add modifier
     void addModifier(Modifier::Type i_mt, AssignOperator i_ao,
                      AssignMode i_am, Key *i_key);
@@ -312,6 +340,26 @@ public:
         return m_modAssignments[i_mt];
     }
 
+    /// build the modifier role table from m_modAssignments (called by
+    /// Keymaps::compileModifierRoles() once modifier slots are assigned)
+    void compileModifierRoles(bool i_slotsAssigned);
+
+    /// are getModifierRole() and getModifierSlotMask() usable ?
+    bool hasModifierRoles() const {
+        return m_hasModifierRoles;
+    }
+
+    /// get the role of a modifier slot (first matching type, as in
+    /// Engine::fixModifierKey)
+    const ModifierRole &getModifierRole(int i_slot) const {
+        return m_modifierRoles[i_slot];
+    }
+
+    /// get the modifier slots assigned to a modifier type
+    uint64_t getModifierSlotMask(Modifier::Type i_mt) const {
+        return m_modifierSlotMasks[i_mt];
+    }
+
     /// describe
     void describe(tostream &i_ost, DescribeParam *i_dp) const;
 
@@ -342,15 +390,16 @@ public:
     typedef std::list<Keymap *> KeymapPtrList;    ///
 
 private:
-    typedef std::list<Keymap> KeymapList;        ///
+    typedef std::pmr::list<Keymap> KeymapList;        ///
 
 private:
     KeymapList m_keymapList;            /** pointer into keymaps may
                                                     exist */
 
 public:
-    ///
-    Keymaps();
+    /// i_mr: where the keymaps and their assignment lists allocate
+    explicit Keymaps(std::pmr::memory_resource *i_mr =
+                         std::pmr::get_default_resource());
 
     /// search by name
     Keymap *searchByName(const std::string &i_name);
@@ -364,6 +413,10 @@ public:
     /// adjust modifier
     void adjustModifier(Keyboard &i_keyboard);
 
+    /// assign modifier slots to the keys of i_keyboard and build the
+    /// modifier role table of every keymap
+    void compileModifierRoles(Keyboard &i_keyboard);
+
     /// get const reference to keymap list (for iteration)
     const KeymapList& getKeymapList() const {
         return m_keymapList;
@@ -375,12 +428,22 @@ public:
 class KeySeqs
 {
 private:
-    typedef std::list<KeySeq> KeySeqList;        ///
+    typedef std::pmr::list<KeySeq> KeySeqList;        ///
+    typedef std::pmr::map<std::string, KeySeq *,
+                          Keyboard::CaseInsensitiveCompare> Names; ///
 
 private:
     KeySeqList m_keySeqList;            ///
+    Names m_names;                /// named keyseqs of m_keySeqList
 
 public:
+    /// i_mr: where the list and index nodes allocate
+    explicit KeySeqs(std::pmr::memory_resource *i_mr =
+                         std::pmr::get_default_resource())
+            : m_keySeqList(i_mr), m_names(i_mr) { }
+    KeySeqs(const KeySeqs &) = delete;
+    KeySeqs &operator=(const KeySeqs &) = delete;
+
     /// add a named keyseq (name can be empty)
     KeySeq *add(const KeySeq &i_keySeq);
 
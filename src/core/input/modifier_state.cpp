@@ -105,14 +105,21 @@ bool ModifierState::isLockActive(uint8_t lock_num) const {
     return m_state[LOCK_OFFSET + lock_num];
 }
 
+void ModifierState::getLockBits(uint32_t o_lockBits[8]) const {
+    for (int i = 0; i < 8; ++i) {
+        o_lockBits[i] = 0;
+    }
+    for (int i = 0; i < 256; ++i) {
+        if (isLockActive(i)) {
+            o_lockBits[i / 32] |= (1u << (i % 32));
+        }
+    }
+}
+
 void ModifierState::notifyGUILocks() {
     if (m_notifyCallback) {
-        uint32_t lock_bits[8] = {0};
-        for (int i = 0; i < 256; ++i) {
-            if (isLockActive(i)) {
-                lock_bits[i / 32] |= (1u << (i % 32));
-            }
-        }
+        uint32_t lock_bits[8];
+        getLockBits(lock_bits);
         m_notifyCallback(lock_bits);
     }
 }
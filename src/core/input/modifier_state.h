@@ -64,6 +64,8 @@ public:
     // --- Lock (L00-LFF) Methods ---
     void toggleLock(uint8_t lock_num);
     bool isLockActive(uint8_t lock_num) const;
+    /// Active locks as a bitmask: bit (n % 32) of o_lockBits[n / 32] is L<n>
+    void getLockBits(uint32_t o_lockBits[8]) const;
     void setNotificationCallback(LockStateChangeCallback callback) { m_notifyCallback = callback; }
 
     /// Convert internal state to legacy Modifier object for engine compatibility
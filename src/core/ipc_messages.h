@@ -24,6 +24,9 @@ enum MessageType : uint32_t {
     // Notification of a key event for the live log
     NtfKeyEvent = 0x1005,
 
+    // Notification of a batch of key events for the live log
+    NtfKeyEventBatch = 0x1006,
+
     // Control commands from yamy-ctl
     CmdReload = 0x2001,           // Reload configuration (data = config name or empty for current)
     CmdStop = 0x2002,             // Stop the engine
@@ -32,6 +35,8 @@ enum MessageType : uint32_t {
     CmdGetConfig = 0x2005,        // Get configuration details
     CmdGetKeymaps = 0x2006,       // Get loaded keymaps list
     CmdGetMetrics = 0x2007,       // Get performance metrics
+    CmdSubscribe = 0x2008,        // Watch a topic (data = "metrics|locks|keys|config [interval_ms]")
+    CmdUnsubscribe = 0x2009,      // Stop watching (data = topic, or empty for all)
 
     // Response to control commands
     RspOk = 0x2100,               // Command succeeded (data may contain details)
@@ -40,6 +45,7 @@ enum MessageType : uint32_t {
     RspConfig = 0x2103,           // Config response (data contains JSON config)
     RspKeymaps = 0x2104,          // Keymaps response (data contains JSON keymaps)
     RspMetrics = 0x2105,          // Metrics response (data contains JSON metrics)
+    NtfWatchEvent = 0x2106,       // Subscribed topic changed (data = {"topic","seq","data": changed fields})
 
     // Lock status notifications
     LockStatusUpdate = 0x0200,    // Lock state changed (L00-LFF status update)
@@ -64,6 +70,13 @@ struct KeyEventNotification {
     char keyEvent[256];
 };
 
+// Data for NtfKeyEventBatch notification: the header is followed by `count`
+// live log lines, each ending in '\n' (message size = header + text)
+struct KeyEventBatchHeader {
+    uint32_t count;    // Lines in the batch
+    uint32_t dropped;  // Events dropped before this batch (engine side buffer full)
+};
+
 // Data for LockStatusUpdate notification
 // Sent from engine to GUI when any L00-LFF lock state changes
 struct LockStatusMessage {
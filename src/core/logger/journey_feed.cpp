@@ -0,0 +1,180 @@
+#include "journey_feed.h"
+#include "../../platform/linux/keycode_mapping.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace yamy {
+namespace logger {
+
+JourneyRecord JourneyRecord::fromEvent(const JourneyEvent& event) {
+    JourneyRecord record;
+    record.evdevInput = event.evdev_input;
+    record.yamyInput = event.yamy_input;
+    record.yamyOutput = event.yamy_output;
+    record.evdevOutput = event.evdev_output;
+    record.deviceEventNumber = static_cast<int16_t>(
+        std::clamp(event.device_event_number, -1,
+                   static_cast<int>(std::numeric_limits<int16_t>::max())));
+    record.flags = 0;
+    if (event.is_key_down) record.flags |= PRESSED;
+    if (event.was_substituted) record.flags |= SUBSTITUTED;
+    if (event.was_number_modifier) record.flags |= NUMBER_MODIFIER;
+    if (event.output_key_name == "(action)") record.flags |= ACTION;
+    if (event.valid) record.flags |= VALID;
+
+    record.modifierAction = ModifierAction::None;
+    if (event.modifier_action == "HOLD") {
+        record.modifierAction = ModifierAction::Hold;
+    } else if (event.modifier_action == "TAP") {
+        record.modifierAction = ModifierAction::Tap;
+    } else if (event.modifier_action == "WAIT") {
+        record.modifierAction = ModifierAction::Wait;
+    }
+
+    record.latencyNs = static_cast<uint32_t>(
+        std::min<uint64_t>(event.latency_ns, std::numeric_limits<uint32_t>::max()));
+    return record;
+}
+
+JourneyEvent JourneyRecord::toEvent() const {
+    static const char* const MODIFIER_ACTIONS[] = {"", "HOLD", "TAP", "WAIT"};
+
+    JourneyEvent event;
+    event.device_event_number = deviceEventNumber;
+    event.evdev_input = evdevInput;
+    event.input_key_name = yamy::platform::getKeyName(evdevInput);
+    event.yamy_input = yamyInput;
+    event.yamy_output = yamyOutput;
+    event.output_key_name = (flags & ACTION) ? "(action)"
+                                             : yamy::platform::getKeyName(evdevOutput);
+    event.was_substituted = (flags & SUBSTITUTED) != 0;
+    event.was_number_modifier = (flags & NUMBER_MODIFIER) != 0;
+    event.modifier_action = MODIFIER_ACTIONS[static_cast<size_t>(modifierAction)];
+    event.evdev_output = evdevOutput;
+    event.latency_ns = latencyNs;
+    event.is_key_down = (flags & PRESSED) != 0;
+    event.valid = (flags & VALID) != 0;
+    return event;
+}
+
+JourneyFeed::JourneyFeed(BatchSink sink, std::chrono::milliseconds interval)
+    : m_sink(std::move(sink))
+    , m_interval(interval)
+    , m_ring()
+    , m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+    , m_running(false)
+{
+}
+
+JourneyFeed::~JourneyFeed() {
+    stop();
+}
+
+void JourneyFeed::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_thread = std::thread(&JourneyFeed::run, this);
+}
+
+void JourneyFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool JourneyFeed::isRunning() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running;
+}
+
+void JourneyFeed::push(const JourneyEvent& event) {
+    const JourneyRecord record = JourneyRecord::fromEvent(event);
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        if (m_tail - m_head == CAPACITY) {
+            ++m_dropped;
+            return;
+        }
+        m_ring[m_tail % CAPACITY] = record;
+        ++m_tail;
+
+        // Wake the feed thread to start the interval, and again for a full batch
+        const uint64_t pending = m_tail - m_head;
+        wake = pending == 1 || pending == BATCH_SIZE;
+    }
+    if (wake) {
+        m_wake.notify_one();
+    }
+}
+
+void JourneyFeed::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return !m_running || m_tail != m_head; });
+        if (!m_running) {
+            break;
+        }
+
+        // Give the batch one interval to fill up
+        m_wake.wait_for(lock, m_interval, [this] {
+            return !m_running || m_tail - m_head >= BATCH_SIZE;
+        });
+
+        lock.unlock();
+        while (flushBatch()) {
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    while (flushBatch()) {
+    }
+}
+
+bool JourneyFeed::flushBatch() {
+    std::array<JourneyRecord, BATCH_SIZE> batch;
+    size_t count;
+    uint32_t dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        count = static_cast<size_t>(std::min<uint64_t>(m_tail - m_head, BATCH_SIZE));
+        for (size_t i = 0; i < count; ++i) {
+            batch[i] = m_ring[(m_head + i) % CAPACITY];
+        }
+        m_head += count;
+        dropped = m_dropped;
+        m_dropped = 0;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    m_lines.clear();
+    for (size_t i = 0; i < count; ++i) {
+        m_lines += JourneyLogger::formatJourneyLine(batch[i].toEvent());
+        m_lines += '\n';
+    }
+    if (m_sink) {
+        m_sink(m_lines, static_cast<uint32_t>(count), dropped);
+    }
+    return true;
+}
+
+} // namespace logger
+} // namespace yamy
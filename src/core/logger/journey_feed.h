@@ -0,0 +1,115 @@
+#pragma once
+
+#include "journey_logger.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace yamy {
+namespace logger {
+
+/**
+ * @brief Compact copy of a JourneyEvent, without names or time points
+ *
+ * Key names are looked up again from the evdev codes when the record is
+ * formatted.
+ */
+struct JourneyRecord {
+    enum Flags : uint8_t {
+        PRESSED = 0x01,
+        SUBSTITUTED = 0x02,
+        NUMBER_MODIFIER = 0x04,
+        ACTION = 0x08,          // An action program produced the output
+        VALID = 0x10,
+    };
+
+    enum class ModifierAction : uint8_t { None, Hold, Tap, Wait };
+
+    uint16_t evdevInput;
+    uint16_t yamyInput;
+    uint16_t yamyOutput;
+    uint16_t evdevOutput;
+    int16_t deviceEventNumber;      // -1 if unknown
+    uint8_t flags;
+    ModifierAction modifierAction;
+    uint32_t latencyNs;             // Saturates at UINT32_MAX
+
+    static JourneyRecord fromEvent(const JourneyEvent& event);
+    JourneyEvent toEvent() const;
+};
+
+/**
+ * @brief Batches investigate-mode journey events off the engine thread
+ *
+ * push() only copies a JourneyRecord into a ring under a short lock. A
+ * feed thread formats the records with JourneyLogger::formatJourneyLine()
+ * and hands them to the sink as one batch every flush interval, or as soon
+ * as BATCH_SIZE records are waiting. When the ring is full new events are
+ * dropped and counted; the count goes out with the next batch.
+ *
+ * @code
+ * JourneyFeed feed([](const std::string& lines, uint32_t count, uint32_t dropped) {
+ *     // send to the GUI
+ * });
+ * feed.start();
+ * processor->setJourneyEventCallback([&feed](const JourneyEvent& e) { feed.push(e); });
+ * @endcode
+ */
+class JourneyFeed {
+public:
+    static constexpr size_t BATCH_SIZE = 64;
+    static constexpr size_t CAPACITY = 1024;    // Ring size, power of two
+    static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{16};
+
+    /// Receives `count` lines, each ending in '\n', on the feed thread
+    using BatchSink = std::function<void(const std::string& lines, uint32_t count,
+                                         uint32_t dropped)>;
+
+    explicit JourneyFeed(BatchSink sink,
+                         std::chrono::milliseconds interval = DEFAULT_INTERVAL);
+    ~JourneyFeed();
+
+    JourneyFeed(const JourneyFeed&) = delete;
+    JourneyFeed& operator=(const JourneyFeed&) = delete;
+
+    /// Start the feed thread; no-op if running
+    void start();
+
+    /// Flush what is buffered and join the feed thread
+    void stop();
+
+    bool isRunning() const;
+
+    /// Queue an event; called on the engine thread. Ignored while stopped.
+    void push(const JourneyEvent& event);
+
+private:
+    void run();
+
+    /// Format up to BATCH_SIZE records and pass them to the sink
+    /// @return false if nothing was buffered
+    bool flushBatch();
+
+    BatchSink m_sink;
+    std::chrono::milliseconds m_interval;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::array<JourneyRecord, CAPACITY> m_ring;
+    uint64_t m_head;        // Next record to flush (m_mutex)
+    uint64_t m_tail;        // Next free slot (m_mutex)
+    uint32_t m_dropped;     // Since the last batch (m_mutex)
+    bool m_running;         // (m_mutex)
+    std::thread m_thread;
+
+    std::string m_lines;    // Batch text, reused (feed thread)
+};
+
+} // namespace logger
+} // namespace yamy
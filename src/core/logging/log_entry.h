@@ -10,6 +10,7 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
 
 namespace yamy {
 namespace logging {
@@ -70,5 +71,13 @@ struct LogEntry {
   const std::string message;         ///< Log message text
 };
 
+/**
+ * @brief Format a log line the way LogEntry::format() does.
+ *
+ * Shared by LogEntry and LogRecord so both render identically.
+ */
+std::string formatLogLine(LogEntry::clock::time_point timestamp, LogLevel level,
+                          std::string_view category, std::string_view message);
+
 } // namespace logging
 } // namespace yamy
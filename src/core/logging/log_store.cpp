@@ -0,0 +1,530 @@
+﻿#include "log_store.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace yamy {
+namespace logging {
+
+namespace {
+
+/// Append messageTemplate with each "{}" replaced by the next argument
+void appendFormatted(std::string &out, std::string_view messageTemplate,
+                     const LogArg *args, size_t argCount) {
+  size_t next = 0;
+  size_t pos = 0;
+  while (next < argCount) {
+    const size_t hole = messageTemplate.find("{}", pos);
+    if (hole == std::string_view::npos) {
+      break;
+    }
+    out.append(messageTemplate.data() + pos, hole - pos);
+    args[next++].appendTo(out);
+    pos = hole + 2;
+  }
+  out.append(messageTemplate.data() + pos, messageTemplate.size() - pos);
+}
+
+// Argument encoding: a tag byte holding the type, and for bools the value,
+// followed by a varint (zigzag for signed), 8 raw bytes for a double, or
+// the string's position in the string ring
+constexpr uint8_t TYPE_MASK = 0x07;
+constexpr uint8_t BOOL_TRUE = 0x08;
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+size_t putVarint(uint8_t *out, uint64_t value) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+uint64_t getVarint(const uint8_t *in, size_t &pos) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    const uint8_t byte = in[pos++];
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  return value;
+}
+
+size_t roundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace
+
+// LogDictionary
+
+LogDictionary::LogDictionary() : m_size(0) {
+  intern(""); // Id 0 stands for "no text"
+}
+
+LogDictionary::~LogDictionary() = default;
+
+uint32_t LogDictionary::intern(std::string_view text) {
+  // Callers mostly pass the same literals over and over: remember their
+  // ids per thread by address, checked against the text, to skip the lock
+  struct CacheSlot {
+    const LogDictionary *dictionary;
+    const char *data;
+    uint32_t id;
+  };
+  static thread_local CacheSlot cache[64];
+  CacheSlot &cached =
+      cache[(reinterpret_cast<uintptr_t>(text.data()) >> 3) % 64];
+  if (cached.dictionary == this && cached.data == text.data() &&
+      this->text(cached.id) == text) {
+    return cached.id;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(text);
+  if (it != m_index.end()) {
+    cached = CacheSlot{this, text.data(), it->second};
+    return it->second;
+  }
+
+  const uint32_t id = m_size.load(std::memory_order_relaxed);
+  if (id >= CAPACITY) {
+    return NONE;
+  }
+  auto &chunk = m_chunks[id / CHUNK];
+  if (!chunk) {
+    chunk.reset(new std::string[CHUNK]);
+  }
+  std::string &stored = chunk[id % CHUNK];
+  stored.assign(text.data(), text.size());
+  m_index.emplace(std::string_view(stored), id);
+  // Publishes the string to lock-free readers of text()
+  m_size.store(id + 1, std::memory_order_release);
+  cached = CacheSlot{this, text.data(), id};
+  return id;
+}
+
+uint32_t LogDictionary::find(std::string_view text) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(text);
+  return it != m_index.end() ? it->second : NONE;
+}
+
+std::string_view LogDictionary::text(uint32_t id) const {
+  if (id >= size()) {
+    return std::string_view();
+  }
+  return m_chunks[id / CHUNK][id % CHUNK];
+}
+
+// LogArg
+
+void LogArg::appendTo(std::string &out) const {
+  char buffer[24];
+  std::to_chars_result result{buffer, std::errc()};
+  switch (type) {
+  case Type::Int:
+    result = std::to_chars(buffer, buffer + sizeof(buffer), i);
+    break;
+  case Type::UInt:
+    result = std::to_chars(buffer, buffer + sizeof(buffer), u);
+    break;
+  case Type::Double:
+    out += std::to_string(d);
+    return;
+  case Type::Bool:
+    out += b ? '1' : '0'; // As std::to_string(bool) printed it
+    return;
+  case Type::String:
+    out.append(s.data(), s.size());
+    return;
+  }
+  out.append(buffer, result.ptr);
+}
+
+// LogRecord
+
+int64_t LogRecord::timeUs() const {
+  return m_store->m_timesUs[m_store->slot(m_sequence)];
+}
+
+LogEntry::clock::time_point LogRecord::timestamp() const {
+  return LogEntry::clock::time_point(std::chrono::duration_cast<LogEntry::clock::duration>(
+      std::chrono::microseconds(timeUs())));
+}
+
+LogLevel LogRecord::level() const {
+  return static_cast<LogLevel>(m_store->m_levels[m_store->slot(m_sequence)]);
+}
+
+uint16_t LogRecord::categoryId() const {
+  return m_store->m_categoryIds[m_store->slot(m_sequence)];
+}
+
+uint16_t LogRecord::templateId() const {
+  return m_store->m_templateIds[m_store->slot(m_sequence)];
+}
+
+std::string_view LogRecord::category() const {
+  return m_store->m_categories.text(categoryId());
+}
+
+std::string_view LogRecord::messageTemplate() const {
+  return m_store->m_templates.text(templateId());
+}
+
+size_t LogRecord::argCount() const {
+  if (m_store->m_argSizes[m_store->slot(m_sequence)] == 0) {
+    return 0;
+  }
+  LogArg args[LogStore::MAX_ARGS];
+  return m_store->decodeArgs(m_sequence, args);
+}
+
+LogArg LogRecord::arg(size_t index) const {
+  LogArg args[LogStore::MAX_ARGS];
+  const size_t count = m_store->decodeArgs(m_sequence, args);
+  return index < count ? args[index] : LogArg();
+}
+
+std::string LogRecord::message() const {
+  std::string out;
+  appendMessage(out);
+  return out;
+}
+
+void LogRecord::appendMessage(std::string &out) const {
+  LogArg args[LogStore::MAX_ARGS];
+  const size_t count = m_store->decodeArgs(m_sequence, args);
+  appendFormatted(out, messageTemplate(), args, count);
+}
+
+std::string LogRecord::format() const {
+  return formatLogLine(timestamp(), level(), category(), message());
+}
+
+// LogStore
+
+LogStore::LogStore(LogDictionary &categories, LogDictionary &templates, size_t capacity)
+    : m_categories(categories), m_templates(templates),
+      m_textTemplate(templates.intern("{}")),
+      m_capacity(std::max<size_t>(capacity, 1)),
+      m_byteCapacity(roundUpToPowerOfTwo(std::max(m_capacity * 4, 2 * MAX_ARG_BYTES))),
+      m_stringCapacity(std::max(m_capacity, MAX_ARGS)),
+      m_first(0), m_end(0), m_byteTail(0), m_byteHead(0), m_stringTail(0),
+      m_stringHead(0) {}
+
+uint64_t LogStore::append(int64_t timeUs, LogLevel level, std::string_view category,
+                          std::string_view messageTemplate, const LogArg *args,
+                          size_t argCount) {
+  uint32_t categoryId = m_categories.intern(category);
+  if (categoryId == LogDictionary::NONE) {
+    categoryId = 0;
+  }
+
+  const uint32_t templateId = m_templates.intern(messageTemplate);
+  if (templateId == LogDictionary::NONE) {
+    // No room for new templates: keep the text, formatted now
+    std::string text;
+    appendFormatted(text, messageTemplate, args, argCount);
+    LogArg textArg = toLogArg(text);
+    return appendIds(timeUs, level, categoryId, m_textTemplate, &textArg, 1);
+  }
+  return appendIds(timeUs, level, categoryId, templateId, args, argCount);
+}
+
+uint64_t LogStore::appendText(int64_t timeUs, LogLevel level, std::string_view category,
+                              std::string_view message) {
+  uint32_t categoryId = m_categories.intern(category);
+  if (categoryId == LogDictionary::NONE) {
+    categoryId = 0;
+  }
+
+  uint32_t templateId = m_templates.find(message);
+  if (templateId == LogDictionary::NONE && m_templates.size() < TEXT_TEMPLATE_LIMIT) {
+    templateId = m_templates.intern(message);
+  }
+  if (templateId != LogDictionary::NONE) {
+    return appendIds(timeUs, level, categoryId, templateId, nullptr, 0);
+  }
+
+  LogArg textArg = toLogArg(message);
+  return appendIds(timeUs, level, categoryId, m_textTemplate, &textArg, 1);
+}
+
+uint64_t LogStore::append(const LogRecord &record) {
+  const LogStore &source = record.store();
+  LogArg args[MAX_ARGS];
+  const size_t count = source.decodeArgs(record.sequence(), args);
+  const size_t s = source.slot(record.sequence());
+  return appendIds(source.m_timesUs[s], static_cast<LogLevel>(source.m_levels[s]),
+                   source.m_categoryIds[s], source.m_templateIds[s], args, count);
+}
+
+uint64_t LogStore::fittingTail(const LogStore &source, uint64_t from) const {
+  from = std::max(from, source.m_first);
+  size_t records = 0;
+  size_t bytes = 0;
+  size_t strings = 0;
+  uint64_t seq = source.m_end;
+  while (seq > from) {
+    const size_t recordBytes = source.m_argSizes[source.slot(seq - 1)];
+    const size_t recordStrings = recordBytes ? source.stringCount(seq - 1) : 0;
+    if (records + 1 > m_capacity || bytes + recordBytes > m_byteCapacity ||
+        strings + recordStrings > m_stringCapacity) {
+      break;
+    }
+    ++records;
+    bytes += recordBytes;
+    strings += recordStrings;
+    --seq;
+  }
+  return seq;
+}
+
+size_t LogStore::evictionsToFit(const LogStore &source, uint64_t from) const {
+  from = std::max(from, source.m_first);
+  size_t records = 0;
+  size_t bytes = 0;
+  size_t strings = 0;
+  for (uint64_t seq = from; seq < source.m_end; ++seq) {
+    const size_t recordBytes = source.m_argSizes[source.slot(seq)];
+    ++records;
+    bytes += recordBytes;
+    strings += recordBytes ? source.stringCount(seq) : 0;
+  }
+
+  size_t liveRecords = size();
+  size_t liveBytes = static_cast<size_t>(m_byteHead - m_byteTail);
+  size_t liveStrings = static_cast<size_t>(m_stringHead - m_stringTail);
+  size_t evicted = 0;
+  for (uint64_t seq = m_first; seq < m_end; ++seq) {
+    if (liveRecords + records <= m_capacity && liveBytes + bytes <= m_byteCapacity &&
+        liveStrings + strings <= m_stringCapacity) {
+      break;
+    }
+    const size_t recordBytes = m_argSizes[slot(seq)];
+    --liveRecords;
+    liveBytes -= recordBytes;
+    liveStrings -= recordBytes ? stringCount(seq) : 0;
+    ++evicted;
+  }
+  return evicted;
+}
+
+void LogStore::dropOldest(size_t count) {
+  count = std::min(count, size());
+  for (size_t i = 0; i < count; ++i) {
+    evictOldest();
+  }
+}
+
+void LogStore::clear() {
+  m_first = m_end;
+  m_byteTail = m_byteHead;
+  m_stringTail = m_stringHead;
+}
+
+size_t LogStore::memoryUsage() const {
+  size_t bytes = m_timesUs.capacity() * sizeof(int64_t) +
+                 m_levels.capacity() * sizeof(uint8_t) +
+                 m_categoryIds.capacity() * sizeof(uint16_t) +
+                 m_templateIds.capacity() * sizeof(uint16_t) +
+                 m_argBegins.capacity() * sizeof(uint32_t) +
+                 m_argSizes.capacity() * sizeof(uint8_t) +
+                 m_bytes.capacity() +
+                 m_strings.capacity() * sizeof(std::string);
+  for (const std::string &s : m_strings) {
+    if (s.capacity() > std::string().capacity()) {
+      bytes += s.capacity() + 1;
+    }
+  }
+  return bytes;
+}
+
+uint64_t LogStore::appendIds(int64_t timeUs, LogLevel level, uint32_t categoryId,
+                             uint32_t templateId, const LogArg *args, size_t argCount) {
+  argCount = std::min(argCount, MAX_ARGS);
+
+  // Encode the arguments first, to know what has to be evicted
+  uint8_t encoded[MAX_ARG_BYTES];
+  size_t size = 0;
+  size_t strings = 0;
+  for (size_t i = 0; i < argCount; ++i) {
+    const LogArg &arg = args[i];
+    switch (arg.type) {
+    case LogArg::Type::Int:
+      encoded[size++] = static_cast<uint8_t>(arg.type);
+      size += putVarint(encoded + size, zigzag(arg.i));
+      break;
+    case LogArg::Type::UInt:
+      encoded[size++] = static_cast<uint8_t>(arg.type);
+      size += putVarint(encoded + size, arg.u);
+      break;
+    case LogArg::Type::Double:
+      encoded[size++] = static_cast<uint8_t>(arg.type);
+      std::memcpy(encoded + size, &arg.d, sizeof(double));
+      size += sizeof(double);
+      break;
+    case LogArg::Type::Bool:
+      encoded[size++] = static_cast<uint8_t>(static_cast<uint8_t>(arg.type) |
+                                             (arg.b ? BOOL_TRUE : 0));
+      break;
+    case LogArg::Type::String:
+      // Strings are FIFO, so the position in the ring identifies them
+      encoded[size++] = static_cast<uint8_t>(arg.type);
+      size += putVarint(encoded + size, (m_stringHead + strings) % m_stringCapacity);
+      ++strings;
+      break;
+    }
+  }
+
+  while (this->size() >= m_capacity || (m_byteHead - m_byteTail) + size > m_byteCapacity ||
+         (m_stringHead - m_stringTail) + strings > m_stringCapacity) {
+    evictOldest();
+  }
+
+  if (slot(m_end) >= m_timesUs.size()) {
+    growColumns();
+  }
+  const size_t s = slot(m_end);
+  m_timesUs[s] = timeUs;
+  m_levels[s] = static_cast<uint8_t>(level);
+  m_categoryIds[s] = static_cast<uint16_t>(categoryId);
+  m_templateIds[s] = static_cast<uint16_t>(templateId);
+  m_argBegins[s] = static_cast<uint32_t>(m_byteHead);
+  m_argSizes[s] = static_cast<uint8_t>(size);
+
+  growBytes(m_byteHead + size);
+  const size_t mask = m_bytes.size() - 1;
+  for (size_t i = 0; i < size; ++i) {
+    m_bytes[static_cast<size_t>(m_byteHead++) & mask] = encoded[i];
+  }
+
+  for (size_t i = 0; i < argCount; ++i) {
+    if (args[i].type == LogArg::Type::String) {
+      const size_t str = static_cast<size_t>(m_stringHead++ % m_stringCapacity);
+      if (str >= m_strings.size()) {
+        m_strings.resize(str + 1);
+      }
+      // Reuses the evicted string's buffer
+      m_strings[str].assign(args[i].s.data(), args[i].s.size());
+    }
+  }
+  return m_end++;
+}
+
+void LogStore::growColumns() {
+  // Grow to an exact size, so a full store holds no slack
+  const size_t newSize = std::min(m_capacity, std::max<size_t>(64, m_timesUs.size() * 2));
+  m_timesUs.reserve(newSize);
+  m_timesUs.resize(newSize);
+  m_levels.reserve(newSize);
+  m_levels.resize(newSize);
+  m_categoryIds.reserve(newSize);
+  m_categoryIds.resize(newSize);
+  m_templateIds.reserve(newSize);
+  m_templateIds.resize(newSize);
+  m_argBegins.reserve(newSize);
+  m_argBegins.resize(newSize);
+  m_argSizes.reserve(newSize);
+  m_argSizes.resize(newSize);
+}
+
+void LogStore::growBytes(uint64_t end) {
+  // Until the ring first wraps, positions index it directly, so it can grow
+  while (m_bytes.size() < m_byteCapacity && end > m_bytes.size()) {
+    const size_t newSize = std::min(m_byteCapacity, std::max<size_t>(256, m_bytes.size() * 2));
+    m_bytes.reserve(newSize);
+    m_bytes.resize(newSize);
+  }
+}
+
+void LogStore::evictOldest() {
+  const size_t s = slot(m_first);
+  if (m_argSizes[s] != 0) {
+    m_stringTail += stringCount(m_first);
+    m_byteTail += m_argSizes[s];
+  }
+  ++m_first;
+}
+
+size_t LogStore::decodeArgs(uint64_t sequence, LogArg *args) const {
+  const size_t s = slot(sequence);
+  const size_t size = m_argSizes[s];
+  if (size == 0) {
+    return 0;
+  }
+
+  uint8_t encoded[MAX_ARG_BYTES];
+  const size_t mask = m_bytes.size() - 1;
+  for (size_t i = 0; i < size; ++i) {
+    encoded[i] = m_bytes[(m_argBegins[s] + i) & mask];
+  }
+
+  size_t count = 0;
+  size_t pos = 0;
+  while (pos < size && count < MAX_ARGS) {
+    const uint8_t tag = encoded[pos++];
+    LogArg &arg = args[count++];
+    arg.type = static_cast<LogArg::Type>(tag & TYPE_MASK);
+    switch (arg.type) {
+    case LogArg::Type::Int:
+      arg.i = unzigzag(getVarint(encoded, pos));
+      break;
+    case LogArg::Type::UInt:
+      arg.u = getVarint(encoded, pos);
+      break;
+    case LogArg::Type::Double:
+      std::memcpy(&arg.d, encoded + pos, sizeof(double));
+      pos += sizeof(double);
+      break;
+    case LogArg::Type::Bool:
+      arg.b = (tag & BOOL_TRUE) != 0;
+      break;
+    case LogArg::Type::String:
+      arg.s = m_strings[static_cast<size_t>(getVarint(encoded, pos))];
+      break;
+    }
+  }
+  return count;
+}
+
+size_t LogStore::stringCount(uint64_t sequence) const {
+  // Walks the tags only; eviction calls this for every record
+  const size_t s = slot(sequence);
+  const size_t mask = m_bytes.size() - 1;
+  // Offsets from the start: the stored position is 32 bits and wraps
+  const size_t begin = m_argBegins[s];
+  const size_t size = m_argSizes[s];
+  size_t strings = 0;
+  for (size_t i = 0; i < size;) {
+    const auto type = static_cast<LogArg::Type>(m_bytes[(begin + i++) & mask] & TYPE_MASK);
+    if (type == LogArg::Type::Double) {
+      i += sizeof(double);
+    } else if (type != LogArg::Type::Bool) {
+      strings += type == LogArg::Type::String ? 1 : 0;
+      while (m_bytes[(begin + i++) & mask] & 0x80) {
+      }
+    }
+  }
+  return strings;
+}
+
+} // namespace logging
+} // namespace yamy
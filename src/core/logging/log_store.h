@@ -0,0 +1,275 @@
+﻿#pragma once
+
+/**
+ * @file log_store.h
+ * @brief Interned, columnar storage for log records.
+ *
+ * Categories and message templates are interned once in a LogDictionary;
+ * a record stores their ids, its level and timestamp, and the template
+ * arguments unformatted. Text is produced only when a record is displayed
+ * or exported.
+ */
+
+#include "log_entry.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace yamy {
+namespace logging {
+
+/**
+ * @brief Append-only set of strings addressed by small ids.
+ *
+ * Interning is thread-safe; text() is lock-free, and the returned views
+ * stay valid for the dictionary's lifetime.
+ */
+class LogDictionary {
+public:
+  static constexpr uint32_t CAPACITY = 1u << 16; ///< Ids fit in 16 bits
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;  ///< No such string / full
+
+  LogDictionary();
+  ~LogDictionary();
+  LogDictionary(const LogDictionary &) = delete;
+  LogDictionary &operator=(const LogDictionary &) = delete;
+
+  /// Id of text, added if new; NONE when the dictionary is full
+  uint32_t intern(std::string_view text);
+
+  /// Id of text, NONE if it was never interned
+  uint32_t find(std::string_view text) const;
+
+  /// Text of an id; empty for unknown ids
+  std::string_view text(uint32_t id) const;
+
+  uint32_t size() const { return m_size.load(std::memory_order_acquire); }
+
+private:
+  static constexpr uint32_t CHUNK = 256;
+
+  mutable std::mutex m_mutex; ///< Serializes intern() and find()
+  std::unordered_map<std::string_view, uint32_t> m_index;
+  std::array<std::unique_ptr<std::string[]>, CAPACITY / CHUNK> m_chunks;
+  std::atomic<uint32_t> m_size;
+};
+
+/**
+ * @brief A message template argument.
+ *
+ * String arguments are views; the store copies them.
+ */
+struct LogArg {
+  enum class Type : uint8_t { Int, UInt, Double, Bool, String };
+
+  Type type = Type::Int;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    bool b;
+  };
+  std::string_view s;
+
+  LogArg() : i(0) {}
+
+  /// Append the argument as text
+  void appendTo(std::string &out) const;
+};
+
+/// Convert a value to a template argument
+template <typename T> LogArg toLogArg(const T &value) {
+  LogArg arg;
+  if constexpr (std::is_same_v<T, bool>) {
+    arg.type = LogArg::Type::Bool;
+    arg.b = value;
+  } else if constexpr (std::is_enum_v<T>) {
+    arg.type = LogArg::Type::Int;
+    arg.i = static_cast<int64_t>(value);
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    arg.type = LogArg::Type::Int;
+    arg.i = value;
+  } else if constexpr (std::is_integral_v<T>) {
+    arg.type = LogArg::Type::UInt;
+    arg.u = value;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    arg.type = LogArg::Type::Double;
+    arg.d = value;
+  } else {
+    arg.type = LogArg::Type::String;
+    arg.s = std::string_view(value);
+  }
+  return arg;
+}
+
+class LogStore;
+
+/**
+ * @brief View of one record in a LogStore.
+ *
+ * Cheap to copy; valid while the store still holds the record. Listeners
+ * must not keep it past their call.
+ */
+class LogRecord {
+public:
+  LogRecord(const LogStore &store, uint64_t sequence)
+      : m_store(&store), m_sequence(sequence) {}
+
+  const LogStore &store() const { return *m_store; }
+  uint64_t sequence() const { return m_sequence; }
+  int64_t timeUs() const; ///< Microseconds since the epoch
+  LogEntry::clock::time_point timestamp() const;
+  LogLevel level() const;
+  uint16_t categoryId() const;
+  uint16_t templateId() const;
+  std::string_view category() const;
+  std::string_view messageTemplate() const;
+
+  size_t argCount() const;
+  LogArg arg(size_t index) const;
+
+  /// Template with each "{}" replaced by the next argument
+  std::string message() const;
+  void appendMessage(std::string &out) const;
+
+  /// "[timestamp] [level] [category] message", as LogEntry::format()
+  std::string format() const;
+
+private:
+  const LogStore *m_store;
+  uint64_t m_sequence;
+};
+
+/**
+ * @brief Fixed-capacity ring of log records, stored column by column.
+ *
+ * Per record: timestamp, level, category and template ids, and a range in
+ * a byte ring holding the arguments, each a type tag and a varint (so a
+ * scancode and a key state take three bytes). String arguments live in a
+ * ring of reused strings. Appending evicts the oldest records until
+ * everything fits. Records are numbered by a sequence that keeps counting
+ * across evictions and clear(). Columns grow on demand up to the capacity.
+ *
+ * Stores sharing dictionaries can copy records between them by id. Not
+ * thread-safe.
+ *
+ * @code
+ * LogStore store(categories, templates, 1000);
+ * store.append(nowUs, LogLevel::Trace, "Engine", "scancode={}", args, 1);
+ * std::string text = store.record(store.endSequence() - 1).message();
+ * @endcode
+ */
+class LogStore {
+public:
+  static constexpr size_t MAX_ARGS = 16;                ///< Extra arguments are dropped
+  static constexpr uint32_t TEXT_TEMPLATE_LIMIT = 4096; ///< See appendText()
+
+  LogStore(LogDictionary &categories, LogDictionary &templates, size_t capacity);
+  LogStore(const LogStore &) = delete;
+  LogStore &operator=(const LogStore &) = delete;
+
+  uint64_t firstSequence() const { return m_first; }
+  uint64_t endSequence() const { return m_end; }
+  size_t size() const { return static_cast<size_t>(m_end - m_first); }
+  bool empty() const { return m_end == m_first; }
+  size_t capacity() const { return m_capacity; }
+  bool contains(uint64_t sequence) const {
+    return sequence >= m_first && sequence < m_end;
+  }
+
+  LogRecord record(uint64_t sequence) const { return LogRecord(*this, sequence); }
+
+  /// Append a record; returns its sequence number
+  uint64_t append(int64_t timeUs, LogLevel level, std::string_view category,
+                  std::string_view messageTemplate, const LogArg *args,
+                  size_t argCount);
+
+  /**
+   * @brief Append an already formatted message.
+   *
+   * The message becomes its own template while fewer than
+   * TEXT_TEMPLATE_LIMIT templates exist, so repeated messages are stored
+   * once; past that, new messages are stored as a string argument.
+   */
+  uint64_t appendText(int64_t timeUs, LogLevel level, std::string_view category,
+                      std::string_view message);
+
+  /// Copy a record from another store sharing this store's dictionaries
+  uint64_t append(const LogRecord &record);
+
+  /**
+   * @brief First record of the longest tail of source that fits here.
+   *
+   * Appending source's records from the result on evicts none of them.
+   */
+  uint64_t fittingTail(const LogStore &source, uint64_t from) const;
+
+  /// Oldest records appending source's records from `from` on would evict
+  size_t evictionsToFit(const LogStore &source, uint64_t from) const;
+
+  void dropOldest(size_t count);
+  void clear();
+
+  /// Bytes held by the columns and string arguments
+  size_t memoryUsage() const;
+
+  const LogDictionary &categories() const { return m_categories; }
+  const LogDictionary &templates() const { return m_templates; }
+
+private:
+  friend class LogRecord;
+
+  /// Most bytes one record's arguments encode to
+  static constexpr size_t MAX_ARG_BYTES = MAX_ARGS * 11;
+
+  size_t slot(uint64_t sequence) const {
+    return static_cast<size_t>(sequence % m_capacity);
+  }
+  uint64_t appendIds(int64_t timeUs, LogLevel level, uint32_t categoryId,
+                     uint32_t templateId, const LogArg *args, size_t argCount);
+  void growColumns();
+  void growBytes(uint64_t end);
+  void evictOldest();
+
+  /// Decode a record's arguments; returns how many
+  size_t decodeArgs(uint64_t sequence, LogArg *args) const;
+  size_t stringCount(uint64_t sequence) const;
+
+  LogDictionary &m_categories;
+  LogDictionary &m_templates;
+  uint32_t m_textTemplate; ///< Id of "{}"
+
+  size_t m_capacity;
+  size_t m_byteCapacity;   ///< Power of two
+  size_t m_stringCapacity;
+
+  // Record columns, indexed by slot(sequence)
+  std::vector<int64_t> m_timesUs;
+  std::vector<uint8_t> m_levels;
+  std::vector<uint16_t> m_categoryIds;
+  std::vector<uint16_t> m_templateIds;
+  std::vector<uint32_t> m_argBegins; ///< Low bits of the byte ring position
+  std::vector<uint8_t> m_argSizes;   ///< Encoded bytes
+
+  // Argument bytes, indexed by position & (m_byteCapacity - 1), and the
+  // string ring, indexed by position % m_stringCapacity
+  std::vector<uint8_t> m_bytes;
+  std::vector<std::string> m_strings;
+
+  uint64_t m_first;
+  uint64_t m_end;
+  uint64_t m_byteTail;
+  uint64_t m_byteHead;
+  uint64_t m_stringTail;
+  uint64_t m_stringHead;
+};
+
+} // namespace logging
+} // namespace yamy
@@ -8,12 +8,27 @@
 namespace yamy {
 namespace logging {
 
+namespace {
+
+int64_t nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             LogEntry::clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
 LogEntry::LogEntry(LogLevel level, std::string category, std::string message)
     : timestamp(clock::now()), level(level), category(std::move(category)),
       message(std::move(message)) {}
 
 std::string LogEntry::format() const {
-  std::time_t time = clock::to_time_t(timestamp);
+  return formatLogLine(timestamp, level, category, message);
+}
+
+std::string formatLogLine(LogEntry::clock::time_point timestamp, LogLevel level,
+                          std::string_view category, std::string_view message) {
+  std::time_t time = LogEntry::clock::to_time_t(timestamp);
   std::tm tm;
   yamy::platform::localtime_safe(&time, &tm);
 
@@ -47,22 +62,41 @@ Logger &Logger::getInstance() {
   return instance;
 }
 
-Logger::Logger() {
-    addListener([](const LogEntry &entry) {
-        std::cout << entry.format() << std::endl;
+Logger::Logger() : m_history(m_categories, m_templates, HISTORY_CAPACITY) {
+    addListener([](const LogRecord &record) {
+        std::cout << record.format() << std::endl;
     });
 }
 
-void Logger::log(LogLevel level, std::string category, std::string message) {
-  LogEntry entry(level, std::move(category), std::move(message));
+void Logger::log(LogLevel level, std::string_view category, std::string_view message) {
+  const int64_t timeUs = nowUs();
   std::lock_guard<std::mutex> lock(m_mutex);
+  const LogRecord record =
+      m_history.record(m_history.appendText(timeUs, level, category, message));
   for (const auto &listener : m_listeners) {
-    listener(entry);
+    listener(record);
   }
 }
 
-void Logger::addListener(Listener listener) {
+void Logger::write(LogLevel level, std::string_view category,
+                   std::string_view messageTemplate, const LogArg *args,
+                   size_t argCount) {
+  const int64_t timeUs = nowUs();
   std::lock_guard<std::mutex> lock(m_mutex);
+  const LogRecord record = m_history.record(
+      m_history.append(timeUs, level, category, messageTemplate, args, argCount));
+  for (const auto &listener : m_listeners) {
+    listener(record);
+  }
+}
+
+void Logger::addListener(Listener listener, bool replayHistory) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (replayHistory) {
+    for (uint64_t seq = m_history.firstSequence(); seq < m_history.endSequence(); ++seq) {
+      listener(m_history.record(seq));
+    }
+  }
   m_listeners.push_back(std::move(listener));
 }
 
@@ -9,9 +9,11 @@
  */
 
 #include "log_entry.h"
+#include "log_store.h"
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <vector>
 
 namespace yamy {
@@ -24,6 +26,11 @@ namespace logging {
  * listeners. Log messages are emitted to all registered listeners synchronously
  * under mutex protection.
  *
+ * Categories and message templates are interned; each message is recorded in
+ * a bounded history as template ids plus unformatted arguments, and listeners
+ * receive a LogRecord view of it. Text is built only when a listener asks
+ * for it.
+ *
  * @note This is a transitional logger. For high-performance logging in the
  *       input processing hot path, use Quill instead.
  *
@@ -31,9 +38,12 @@ namespace logging {
  * // Emit a log message
  * Logger::getInstance().log(LogLevel::Info, "Engine", "Initialized");
  *
+ * // Emit a templated message; formatting is deferred
+ * Logger::getInstance().logf(LogLevel::Trace, "Engine", "scancode={}", scanCode);
+ *
  * // Register a listener
- * Logger::getInstance().addListener([](const LogEntry& entry) {
- *     std::cout << entry.format() << std::endl;
+ * Logger::getInstance().addListener([](const LogRecord& record) {
+ *     std::cout << record.format() << std::endl;
  * });
  * @endcode
  */
@@ -42,9 +52,13 @@ public:
   /**
    * @brief Type for log listener callbacks.
    *
-   * Listeners receive each log entry as it is emitted.
+   * Listeners receive a view of each record as it is emitted; the view is
+   * only valid during the call.
    */
-  using Listener = std::function<void(const LogEntry &)>;
+  using Listener = std::function<void(const LogRecord &)>;
+
+  /// Records kept for listeners registered with replayHistory
+  static constexpr size_t HISTORY_CAPACITY = 4096;
 
   /**
    * @brief Get the singleton Logger instance.
@@ -58,7 +72,8 @@ public:
   /**
    * @brief Emit a log message.
    *
-   * Creates a LogEntry and dispatches it to all registered listeners.
+   * Records the message and dispatches it to all registered listeners.
+   * Repeated messages share one interned copy of their text.
    *
    * @param level Severity level of the message
    * @param category Log category (e.g., "Engine", "Input", "Config")
@@ -70,27 +85,53 @@ public:
    * Logger::getInstance().log(LogLevel::Warning, "Driver", "Retrying connection");
    * @endcode
    */
-  void log(LogLevel level, std::string category, std::string message);
+  void log(LogLevel level, std::string_view category, std::string_view message);
+
+  /**
+   * @brief Emit a templated log message.
+   *
+   * Each "{}" in messageTemplate stands for the next argument. The template
+   * is interned and the arguments stored as values, so nothing is formatted
+   * unless a listener asks for the text.
+   *
+   * @code
+   * Logger::getInstance().logf(LogLevel::Trace, "Engine",
+   *     "Processing key event: scancode={}, isKeyDown={}", scanCode, isKeyDown);
+   * @endcode
+   */
+  template <typename... Args>
+  void logf(LogLevel level, std::string_view category,
+            std::string_view messageTemplate, const Args &...args) {
+    const LogArg packed[] = {toLogArg(args)..., LogArg()};
+    write(level, category, messageTemplate, packed, sizeof...(Args));
+  }
 
   /**
    * @brief Register a log listener.
    *
    * The listener will be called for every log message emitted after registration.
    *
-   * @param listener Callback function to receive log entries
+   * @param listener Callback function to receive log records
+   * @param replayHistory Also call it now for the recorded history
    *
    * @note Thread-safe. Can be called while logging is active.
    * @note Listeners are called synchronously on the logging thread.
    *
    * @code
-   * Logger::getInstance().addListener([](const LogEntry& entry) {
-   *     if (entry.level >= LogLevel::Error) {
-   *         std::cerr << entry.format() << std::endl;
+   * Logger::getInstance().addListener([](const LogRecord& record) {
+   *     if (record.level() >= LogLevel::Error) {
+   *         std::cerr << record.format() << std::endl;
    *     }
    * });
    * @endcode
    */
-  void addListener(Listener listener);
+  void addListener(Listener listener, bool replayHistory = false);
+
+  /// Interned categories, shared with listeners' own LogStores
+  LogDictionary &categories() { return m_categories; }
+
+  /// Interned message templates, shared with listeners' own LogStores
+  LogDictionary &templates() { return m_templates; }
 
 private:
   Logger();
@@ -98,8 +139,15 @@ private:
   Logger(const Logger &) = delete;
   Logger &operator=(const Logger &) = delete;
 
-  std::mutex m_mutex;           ///< Protects m_listeners access
+  void write(LogLevel level, std::string_view category,
+             std::string_view messageTemplate, const LogArg *args,
+             size_t argCount);
+
+  std::mutex m_mutex;           ///< Protects m_listeners and m_history
   std::vector<Listener> m_listeners; ///< Registered log listeners
+  LogDictionary m_categories;
+  LogDictionary m_templates;
+  LogStore m_history;           ///< Most recent records
 };
 
 } // namespace logging
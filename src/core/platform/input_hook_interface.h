@@ -16,6 +16,14 @@ public:
     virtual bool install(KeyCallback keyCallback, MouseCallback mouseCallback) = 0;
     virtual void uninstall() = 0;
     virtual bool isInstalled() const = 0;
+
+    /// Called by the engine just before it queues an input event, under its
+    /// queue lock; events it drops without queueing are not reported
+    virtual void inputQueued() {}
+
+    /// Called on the engine thread each time it is done with an input
+    /// event; hooks that watch for a stalled engine use it as a heartbeat
+    virtual void inputProcessed() {}
 };
 
 IInputHook* createInputHook();
@@ -17,6 +17,14 @@ public:
     virtual void mouseMove(int32_t dx, int32_t dy) = 0;
     virtual void mouseButton(MouseButton button, bool down) = 0;
     virtual void mouseWheel(int32_t delta) = 0;
+
+    /// Relative motion and wheels (1/120 notch) of one mouse frame; injectors
+    /// that can send them as a single report override this
+    virtual void mouseFrame(int32_t dx, int32_t dy, int32_t wheel, int32_t hwheel) {
+        (void)hwheel;
+        if (dx != 0 || dy != 0) mouseMove(dx, dy);
+        if (wheel != 0) mouseWheel(wheel);
+    }
 };
 
 class IWindowSystem;
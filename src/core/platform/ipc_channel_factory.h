@@ -5,6 +5,8 @@
 
 #if defined(__linux__) && defined(QT_CORE_LIB)
 #include "linux/ipc_channel_qt.h"
+#elif defined(__linux__) && defined(YAMY_NATIVE_IPC)
+#include "linux/ipc_channel_unix.h"
 #endif
 
 #include <memory>
@@ -15,6 +17,9 @@ namespace yamy::platform {
 inline std::unique_ptr<IIPCChannel> createIPCChannel(const std::string& name) {
 #if defined(__linux__) && defined(QT_CORE_LIB)
     return std::make_unique<IPCChannelQt>(name);
+#elif defined(__linux__) && defined(YAMY_NATIVE_IPC)
+    // Daemon built without Qt: served by EventLoop::instance()
+    return std::make_unique<IPCChannelUnix>(name);
 #else
     (void)name;  // Suppress unused parameter warning
     return std::make_unique<IPCChannelNull>();
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "core/ipc_messages.h"
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -44,12 +45,24 @@ signals:
 
 namespace yamy::platform {
 
-// A non-Qt stub for headless builds. The engine just holds a pointer to this,
-// so a full definition is not required for the engine itself.
+// Interface for builds without Qt. Received messages are delivered to a
+// callback instead of a signal; implementations call the protected
+// messageReceived()/connected()/disconnected() helpers, which have the same
+// names as the Qt signals so a channel can be written for both.
 class IIPCChannel {
 public:
+    using MessageCallback = std::function<void(const yamy::ipc::Message& message)>;
+    using StateCallback = std::function<void()>;
+
     virtual ~IIPCChannel() = default;
 
+    /// Set the receiver of incoming messages; called on the channel's loop thread
+    void setMessageCallback(MessageCallback callback) { m_messageCallback = std::move(callback); }
+
+    /// Set the receivers of connection state changes
+    void setConnectedCallback(StateCallback callback) { m_connectedCallback = std::move(callback); }
+    void setDisconnectedCallback(StateCallback callback) { m_disconnectedCallback = std::move(callback); }
+
     /// Connect to a named IPC channel
     virtual void connect(const std::string& name) = 0;
 
@@ -67,6 +80,22 @@ public:
 
     /// Non-blocking receive (returns nullptr if no message)
     virtual std::unique_ptr<ipc::Message> nonBlockingReceive() = 0;
+
+protected:
+    void messageReceived(const yamy::ipc::Message& message) {
+        if (m_messageCallback) m_messageCallback(message);
+    }
+    void connected() {
+        if (m_connectedCallback) m_connectedCallback();
+    }
+    void disconnected() {
+        if (m_disconnectedCallback) m_disconnectedCallback();
+    }
+
+private:
+    MessageCallback m_messageCallback;
+    StateCallback m_connectedCallback;
+    StateCallback m_disconnectedCallback;
 };
 
 } // namespace yamy::platform
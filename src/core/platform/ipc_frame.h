@@ -0,0 +1,167 @@
+// ipc_frame.h - Fixed-layout IPC framing shared by IPC channel implementations
+
+#pragma once
+
+#include "core/ipc_messages.h"
+#include "ipc_defs.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace yamy::ipc {
+
+/// Wire layout of one frame (all integers big-endian):
+///
+///   [u32 length][u32 type][payload...]
+///
+/// length counts the type field plus the payload, so an empty message has
+/// length 4. The layout matches what IPCChannelQt always put on the wire.
+constexpr size_t kFrameLengthSize = sizeof(uint32_t);
+constexpr size_t kFrameHeaderSize = kFrameLengthSize + sizeof(uint32_t);
+
+/// Largest payload accepted from a peer; larger lengths mean a corrupt stream
+constexpr size_t kMaxFramePayload = 16 * 1024 * 1024;
+
+/// Encode the 8-byte frame header for a payload of the given size
+inline void encodeFrameHeader(uint32_t type, uint32_t payloadSize, uint8_t out[kFrameHeaderSize]) {
+    const uint32_t length = static_cast<uint32_t>(sizeof(uint32_t)) + payloadSize;
+    out[0] = static_cast<uint8_t>(length >> 24);
+    out[1] = static_cast<uint8_t>(length >> 16);
+    out[2] = static_cast<uint8_t>(length >> 8);
+    out[3] = static_cast<uint8_t>(length);
+    out[4] = static_cast<uint8_t>(type >> 24);
+    out[5] = static_cast<uint8_t>(type >> 16);
+    out[6] = static_cast<uint8_t>(type >> 8);
+    out[7] = static_cast<uint8_t>(type);
+}
+
+/// Read a big-endian u32 from an unaligned byte pointer
+inline uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/// Notifications that carry a full state snapshot, where only the newest one
+/// matters. Channels may drop older queued instances of these in favour of the
+/// latest. Replies never qualify: deferring one would reorder it against the
+/// other replies a client pairs with its requests.
+inline bool isLatestWinsMessage(uint32_t type) {
+    return type == static_cast<uint32_t>(yamy::MessageType::LockStatusUpdate) ||
+           type == static_cast<uint32_t>(ipc::LockStatusUpdate);
+}
+
+/**
+ * @brief Receive buffer that parses frames in place
+ *
+ * Socket data is read directly into the buffer (prepareWrite/commitWrite) and
+ * consume() hands each complete frame's payload to the caller as a pointer
+ * into the buffer, without per-message allocation. Consumed bytes are
+ * reclaimed by sliding the unread tail to the front only when more space is
+ * needed, so frames stay contiguous and the buffer stops growing once it has
+ * reached the largest burst seen.
+ */
+class FrameReader {
+public:
+    /// Result of consume()
+    struct ConsumeResult {
+        size_t frames = 0;      ///< Frames delivered
+        bool corrupt = false;   ///< Stream contained an invalid length; buffer was reset
+    };
+
+    explicit FrameReader(size_t initialCapacity = 4096)
+        : m_buffer(initialCapacity) {}
+
+    /// Return a pointer with room for at least n bytes of incoming data
+    uint8_t* prepareWrite(size_t n) {
+        if (m_buffer.size() - m_end < n) {
+            compact();
+            if (m_buffer.size() - m_end < n) {
+                m_buffer.resize(m_end + n);
+            }
+        }
+        return m_buffer.data() + m_end;
+    }
+
+    /// Mark n bytes written after prepareWrite()
+    void commitWrite(size_t n) { m_end += n; }
+
+    /// Copy data into the buffer (for sources that cannot read in place)
+    void append(const void* data, size_t n) {
+        std::memcpy(prepareWrite(n), data, n);
+        commitWrite(n);
+    }
+
+    /// Bytes received but not yet consumed
+    size_t pending() const { return m_end - m_begin; }
+
+    /// Discard all buffered data
+    void clear() { m_begin = m_end = 0; }
+
+    /**
+     * @brief Deliver every complete frame to onFrame
+     *
+     * @param onFrame Called as onFrame(type, data, size). data points into the
+     *        buffer (or an aligned scratch copy) and is valid only during the call;
+     *        data is nullptr when size is 0.
+     */
+    template <typename Fn>
+    ConsumeResult consume(Fn&& onFrame) {
+        ConsumeResult result;
+        while (m_end - m_begin >= kFrameLengthSize) {
+            const uint8_t* frame = m_buffer.data() + m_begin;
+            const uint32_t length = readBigEndian32(frame);
+            if (length < sizeof(uint32_t) || length - sizeof(uint32_t) > kMaxFramePayload) {
+                clear();
+                result.corrupt = true;
+                return result;
+            }
+            if (m_end - m_begin < kFrameLengthSize + length) {
+                break;  // Wait for more data
+            }
+
+            const uint32_t type = readBigEndian32(frame + kFrameLengthSize);
+            const size_t size = length - sizeof(uint32_t);
+            const uint8_t* payload = frame + kFrameHeaderSize;
+            m_begin += kFrameLengthSize + length;
+
+            onFrame(type, size > 0 ? alignedPayload(payload, size) : nullptr, size);
+            ++result.frames;
+        }
+        if (m_begin == m_end) {
+            m_begin = m_end = 0;
+        }
+        return result;
+    }
+
+private:
+    /// Receivers cast payloads to structs, so hand out 8-byte aligned storage
+    const void* alignedPayload(const uint8_t* payload, size_t size) {
+        if (reinterpret_cast<uintptr_t>(payload) % alignof(uint64_t) == 0) {
+            return payload;
+        }
+        const size_t words = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        if (m_scratch.size() < words) {
+            m_scratch.resize(words);
+        }
+        std::memcpy(m_scratch.data(), payload, size);
+        return m_scratch.data();
+    }
+
+    void compact() {
+        if (m_begin == 0) {
+            return;
+        }
+        const size_t unread = m_end - m_begin;
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, unread);
+        m_begin = 0;
+        m_end = unread;
+    }
+
+    std::vector<uint8_t> m_buffer;
+    std::vector<uint64_t> m_scratch;
+    size_t m_begin = 0;
+    size_t m_end = 0;
+};
+
+} // namespace yamy::ipc
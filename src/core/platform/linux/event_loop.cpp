@@ -0,0 +1,290 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// event_loop.cpp - epoll main loop for the daemon without Qt
+//
+
+#include "event_loop.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace yamy::platform {
+
+namespace {
+
+constexpr int kMaxEvents = 32;
+
+uint64_t packEventData(int fd, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+} // namespace
+
+EventLoop& EventLoop::instance()
+{
+    static EventLoop loop;
+    return loop;
+}
+
+EventLoop::EventLoop()
+    : m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+    , m_wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , m_signalFd(-1)
+    , m_nextGeneration(1)
+    , m_isRunning(false)
+    , m_isQuitRequested(false)
+    , m_exitCode(0)
+    , m_loopThread()
+{
+    if (!isValid()) {
+        std::cerr << "[EventLoop] Failed to create epoll/eventfd: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // The wake fd has no callback; run() handles it
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = packEventData(m_wakeFd, 0);
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+}
+
+EventLoop::~EventLoop()
+{
+    // Timer descriptors are the loop's; other watched descriptors belong to the caller
+    for (int fd : m_timers) {
+        close(fd);
+    }
+    if (m_signalFd >= 0) close(m_signalFd);
+    if (m_wakeFd >= 0) close(m_wakeFd);
+    if (m_epollFd >= 0) close(m_epollFd);
+}
+
+bool EventLoop::watchFd(int fd, uint32_t events, FdCallback callback)
+{
+    if (m_epollFd < 0 || fd < 0) {
+        return false;
+    }
+
+    const uint32_t generation = m_nextGeneration++;
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = packEventData(fd, generation);
+
+    const bool isWatched = m_watches.count(fd) != 0;
+    if (epoll_ctl(m_epollFd, isWatched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "[EventLoop] epoll_ctl(" << fd << ") failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_watches[fd] = Watch{generation, std::make_shared<FdCallback>(std::move(callback))};
+    return true;
+}
+
+bool EventLoop::modifyFd(int fd, uint32_t events)
+{
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end()) {
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = packEventData(fd, it->second.generation);
+    return epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::unwatchFd(int fd)
+{
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end()) {
+        return;
+    }
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    m_watches.erase(it);
+}
+
+void EventLoop::post(Callback callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        m_posted.push_back(std::move(callback));
+    }
+    wake();
+}
+
+EventLoop::TimerId EventLoop::addTimer(uint32_t intervalMs, Callback callback, bool isSingleShot)
+{
+    const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[EventLoop] timerfd_create failed: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    // A zero it_value disarms the timer, so round a 0ms timer up to 1us
+    itimerspec spec{};
+    spec.it_value.tv_sec = intervalMs / 1000;
+    spec.it_value.tv_nsec = static_cast<long>(intervalMs % 1000) * 1000000L;
+    if (intervalMs == 0) {
+        spec.it_value.tv_nsec = 1000;
+    }
+    if (!isSingleShot) {
+        spec.it_interval = spec.it_value;
+    }
+    timerfd_settime(fd, 0, &spec, nullptr);
+
+    auto timerCallback = [this, fd, isSingleShot, callback = std::move(callback)](uint32_t) {
+        uint64_t expirations = 0;
+        if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            return;
+        }
+        if (isSingleShot) {
+            // Unwatching drops this lambda; keep the callback alive for the call
+            Callback once = callback;
+            cancelTimer(fd);
+            once();
+        } else {
+            callback();
+        }
+    };
+
+    if (!watchFd(fd, EPOLLIN, std::move(timerCallback))) {
+        close(fd);
+        return -1;
+    }
+    m_timers.insert(fd);
+    return fd;
+}
+
+void EventLoop::cancelTimer(TimerId id)
+{
+    if (m_timers.erase(id) == 0) {
+        return;
+    }
+    unwatchFd(id);
+    close(id);
+}
+
+bool EventLoop::handleSignals(const std::vector<int>& signals, SignalCallback callback)
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int signo : signals) {
+        sigaddset(&mask, signo);
+    }
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        return false;
+    }
+
+    m_signalFd = signalfd(m_signalFd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (m_signalFd < 0) {
+        std::cerr << "[EventLoop] signalfd failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_signalCallback = std::move(callback);
+    return watchFd(m_signalFd, EPOLLIN, [this](uint32_t) { onSignalFd(); });
+}
+
+void EventLoop::onSignalFd()
+{
+    signalfd_siginfo info;
+    while (read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+        if (m_signalCallback) {
+            m_signalCallback(static_cast<int>(info.ssi_signo));
+        }
+    }
+}
+
+int EventLoop::run()
+{
+    if (!isValid()) {
+        return -1;
+    }
+
+    m_loopThread.store(std::this_thread::get_id());
+    m_isRunning.store(true, std::memory_order_release);
+
+    epoll_event events[kMaxEvents];
+    while (!m_isQuitRequested.load(std::memory_order_acquire)) {
+        const int count = epoll_wait(m_epollFd, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[EventLoop] epoll_wait failed: " << std::strerror(errno) << std::endl;
+            m_exitCode.store(-1);
+            break;
+        }
+
+        bool isWoken = false;
+        for (int i = 0; i < count; ++i) {
+            const int fd = static_cast<int>(static_cast<uint32_t>(events[i].data.u64));
+            const uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+            if (fd == m_wakeFd && generation == 0) {
+                isWoken = true;
+                continue;
+            }
+
+            // An earlier callback in this batch may have unwatched the fd
+            auto it = m_watches.find(fd);
+            if (it == m_watches.end() || it->second.generation != generation) {
+                continue;
+            }
+            std::shared_ptr<FdCallback> callback = it->second.callback;
+            (*callback)(events[i].events);
+        }
+
+        if (isWoken) {
+            uint64_t value;
+            while (read(m_wakeFd, &value, sizeof(value)) == sizeof(value)) {
+            }
+        }
+        // Posted functions run once per turn, after I/O, like Qt's queued calls
+        drainPosted();
+    }
+
+    m_isRunning.store(false, std::memory_order_release);
+    m_loopThread.store(std::thread::id());
+    m_isQuitRequested.store(false, std::memory_order_release);
+    return m_exitCode.load();
+}
+
+void EventLoop::quit(int exitCode)
+{
+    m_exitCode.store(exitCode);
+    m_isQuitRequested.store(true, std::memory_order_release);
+    wake();
+}
+
+bool EventLoop::isInLoopThread() const
+{
+    return m_loopThread.load() == std::this_thread::get_id();
+}
+
+void EventLoop::wake()
+{
+    const uint64_t one = 1;
+    if (write(m_wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        std::cerr << "[EventLoop] Failed to wake loop: " << std::strerror(errno) << std::endl;
+    }
+}
+
+void EventLoop::drainPosted()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        if (m_posted.empty()) {
+            return;
+        }
+        m_running.swap(m_posted);
+    }
+    // Functions posted from here on run next turn; the wake fd is already set
+    for (auto& callback : m_running) {
+        callback();
+    }
+    m_running.clear();
+}
+
+} // namespace yamy::platform
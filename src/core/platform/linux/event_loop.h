@@ -0,0 +1,119 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// event_loop.h - epoll main loop for the daemon without Qt
+//
+// Runs file descriptor callbacks, timers (timerfd), POSIX signals (signalfd)
+// and functions posted from other threads (eventfd) on the thread that
+// calls run(). This is what QCoreApplication::exec() provides to the Qt
+// build of the daemon; IPCChannelUnix is driven by it.
+//
+// post() and quit() may be called from any thread. Everything else must be
+// called on the loop thread, or before run() starts.
+
+#ifndef _EVENT_LOOP_H
+#define _EVENT_LOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace yamy::platform {
+
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using FdCallback = std::function<void(uint32_t events)>;
+    using SignalCallback = std::function<void(int signo)>;
+    using TimerId = int;
+
+    /// The daemon's main loop
+    static EventLoop& instance();
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /// False if the epoll or eventfd descriptors could not be created
+    bool isValid() const { return m_epollFd >= 0 && m_wakeFd >= 0; }
+
+    /// Call callback with the ready epoll events whenever fd is ready
+    /// @param events EPOLLIN, EPOLLOUT, ... (EPOLLERR/EPOLLHUP are implied)
+    bool watchFd(int fd, uint32_t events, FdCallback callback);
+
+    /// Change the events watched on fd
+    bool modifyFd(int fd, uint32_t events);
+
+    /// Stop watching fd; does not close it. Safe from inside fd's callback.
+    void unwatchFd(int fd);
+
+    /// Run callback on the loop thread during the next turn (thread-safe)
+    void post(Callback callback);
+
+    /// Call callback every intervalMs, or once after intervalMs
+    /// @return Timer id, or -1 on failure
+    TimerId addTimer(uint32_t intervalMs, Callback callback, bool isSingleShot = false);
+
+    /// Stop a timer; safe from inside its own callback
+    void cancelTimer(TimerId id);
+
+    /// Deliver the given signals to callback on the loop thread
+    ///
+    /// The signals are blocked in the calling thread, so call this from the
+    /// main thread before other threads are started: they inherit the mask,
+    /// and a signal left unblocked in some thread would be delivered there.
+    bool handleSignals(const std::vector<int>& signals, SignalCallback callback);
+
+    /// Dispatch events until quit()
+    /// @return The exit code passed to quit()
+    int run();
+
+    /// Make run() return after the current turn (thread-safe)
+    void quit(int exitCode = 0);
+
+    bool isRunning() const { return m_isRunning.load(std::memory_order_acquire); }
+
+    /// True on the thread currently inside run()
+    bool isInLoopThread() const;
+
+private:
+    /// A watched descriptor; the generation tells a stale event for a closed
+    /// fd apart from one for a new descriptor that reused the number
+    struct Watch {
+        uint32_t generation;
+        std::shared_ptr<FdCallback> callback;
+    };
+
+    void wake();
+    void drainPosted();
+    void onSignalFd();
+
+    int m_epollFd;
+    int m_wakeFd;                               ///< eventfd for post() and quit()
+    int m_signalFd;
+    SignalCallback m_signalCallback;
+
+    std::map<int, Watch> m_watches;
+    std::set<int> m_timers;                     ///< timerfds created by addTimer()
+    uint32_t m_nextGeneration;
+
+    std::mutex m_postMutex;
+    std::vector<Callback> m_posted;             ///< Guarded by m_postMutex
+    std::vector<Callback> m_running;            ///< Swapped with m_posted; keeps its capacity
+
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_isQuitRequested;
+    std::atomic<int> m_exitCode;
+    std::atomic<std::thread::id> m_loopThread;
+};
+
+} // namespace yamy::platform
+
+#endif // _EVENT_LOOP_H
@@ -1,9 +1,10 @@
 #include "ipc_channel_qt.h"
-#include <QDataStream>
-#include <QBuffer>
 #include <QFile>
+#include <QMetaObject>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <climits>
+#include <iterator>
 #include <unistd.h>
 
 namespace yamy::platform {
@@ -119,45 +120,101 @@ bool IPCChannelQt::isConnected() {
 }
 
 void IPCChannelQt::send(const ipc::Message& msg) {
-    // Serialize message once
-    QByteArray bufferData;
-    QBuffer buffer(&bufferData);
-    buffer.open(QIODevice::WriteOnly);
-    QDataStream stream(&buffer);
-    stream.setByteOrder(QDataStream::BigEndian);
-
-    // Calculate total size: MessageType (4 bytes) + data size
-    uint32_t totalSize = sizeof(uint32_t) + static_cast<uint32_t>(msg.size);
-
-    // Write length prefix
-    stream << totalSize;
-
-    // Write message type
-    stream << static_cast<uint32_t>(msg.type);
-
-    // Write message data - validate size is within reasonable bounds
-    if (msg.data && msg.size > 0 && msg.size < INT_MAX) {
-        stream.writeRawData(static_cast<const char*>(msg.data), static_cast<int>(msg.size));
-    } else if (msg.size >= INT_MAX) {
+    if (msg.size > ipc::kMaxFramePayload) {
         std::cerr << "[IPCChannelQt] Error: Message size too large: " << msg.size << std::endl;
         return;  // Drop message
     }
 
-    buffer.close();
+    const uint32_t type = static_cast<uint32_t>(msg.type);
+    if (!ipc::isLatestWinsMessage(type)) {
+        writeFrame(type, msg.data, msg.size);
+        return;
+    }
+
+    // Latest-wins snapshot: overwrite any queued instance and flush once per loop turn
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_coalesceMutex);
+        auto it = std::find_if(m_coalesced.begin(), m_coalesced.end(),
+                               [type](const CoalescedMessage& m) { return m.type == type; });
+        if (it == m_coalesced.end()) {
+            m_coalesced.push_back(CoalescedMessage{type, QByteArray(), false});
+            it = std::prev(m_coalesced.end());
+        }
+
+        const size_t size = msg.data ? msg.size : 0;
+        it->payload.resize(static_cast<qsizetype>(size));
+        if (size > 0) {
+            std::memcpy(it->payload.data(), msg.data, size);
+        }
+        it->pending = true;
+
+        if (!m_flushScheduled) {
+            m_flushScheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        QMetaObject::invokeMethod(this, &IPCChannelQt::flushCoalesced, Qt::QueuedConnection);
+    }
+}
+
+void IPCChannelQt::flushCoalesced() {
+    size_t i = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_coalesceMutex);
+        m_flushScheduled = false;
+    }
+
+    while (true) {
+        uint32_t type;
+        {
+            std::lock_guard<std::mutex> lock(m_coalesceMutex);
+            while (i < m_coalesced.size() && !m_coalesced[i].pending) {
+                ++i;
+            }
+            if (i >= m_coalesced.size()) {
+                break;
+            }
+            // Swap rather than copy so both buffers keep their capacity
+            m_coalesced[i].payload.swap(m_flushScratch);
+            m_coalesced[i].pending = false;
+            type = m_coalesced[i].type;
+        }
+        writeFrame(type, m_flushScratch.constData(), static_cast<size_t>(m_flushScratch.size()));
+    }
+}
+
+void IPCChannelQt::writeFrame(uint32_t type, const void* data, size_t size) {
+    if (!data) {
+        size = 0;
+    }
+
+    uint8_t header[ipc::kFrameHeaderSize];
+    ipc::encodeFrameHeader(type, static_cast<uint32_t>(size), header);
+
+    // Header and payload go to the socket's write buffer as two pieces;
+    // no combined copy of the message is assembled first
+    auto writeTo = [&](QLocalSocket* socket) {
+        socket->write(reinterpret_cast<const char*>(header), sizeof(header));
+        if (size > 0) {
+            socket->write(static_cast<const char*>(data), static_cast<qint64>(size));
+        }
+        socket->flush();
+    };
 
     if (m_isServerMode) {
         // Broadcast to all connected clients
         for (QLocalSocket* client : m_serverClientSockets) {
             if (client && client->state() == QLocalSocket::ConnectedState) {
-                client->write(bufferData);
-                client->flush();
+                writeTo(client);
             }
         }
     } else {
         // Send to server
         if (m_clientSocket && m_clientSocket->state() == QLocalSocket::ConnectedState) {
-            m_clientSocket->write(bufferData);
-            m_clientSocket->flush();
+            writeTo(m_clientSocket);
         }
     }
 }
@@ -172,92 +229,36 @@ void IPCChannelQt::onReadyRead() {
     QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
     if (!socket) return;
 
-    if (m_isServerMode) {
-        // Use per-client buffer
-        QByteArray& buffer = m_clientReceiveBuffers[socket];
-        buffer.append(socket->readAll());
+    // Server mode uses a per-client buffer, client mode the main buffer
+    ipc::FrameReader& reader = m_isServerMode ? m_clientReceiveBuffers[socket] : m_receiveBuffer;
 
-        // Process complete messages from this client's buffer
-        processReceiveBuffer(socket, buffer);
-    } else {
-        // Client mode - use main buffer
-        m_receiveBuffer.append(socket->readAll());
-        processReceiveBuffer(nullptr, m_receiveBuffer);
+    // Read straight into the frame buffer instead of through readAll()
+    const qint64 available = socket->bytesAvailable();
+    if (available > 0) {
+        char* dest = reinterpret_cast<char*>(reader.prepareWrite(static_cast<size_t>(available)));
+        const qint64 bytesRead = socket->read(dest, available);
+        if (bytesRead > 0) {
+            reader.commitWrite(static_cast<size_t>(bytesRead));
+        }
     }
+
+    processReceiveBuffer(m_isServerMode ? socket : nullptr, reader);
 }
 
-void IPCChannelQt::processReceiveBuffer(QLocalSocket* socket, QByteArray& buffer) {
+void IPCChannelQt::processReceiveBuffer(QLocalSocket* socket, ipc::FrameReader& reader) {
     (void)socket;  // May be used later for client-specific handling
 
-    while (true) {
-        // Need at least 4 bytes for length prefix
-        if (buffer.size() < 4) {
-            break;
-        }
-
-        // Read length prefix (big-endian) - copy first 4 bytes to ensure read-only access
-        QByteArray lengthBytes = buffer.left(4);
-        QDataStream lengthStream(&lengthBytes, QIODevice::ReadOnly);
-        lengthStream.setByteOrder(QDataStream::BigEndian);
-        uint32_t messageSize;
-        lengthStream >> messageSize;
-
-        // Check if we have the complete message
-        if (buffer.size() < static_cast<int>(4 + messageSize)) {
-            break;  // Wait for more data
-        }
-
-        // Extract message data (skip the 4-byte length prefix)
-        QByteArray messageData = buffer.mid(4, messageSize);
-
-        // Remove processed message from buffer
-        buffer.remove(0, 4 + messageSize);
-
-        // Deserialize message - use QDataStream with ReadOnly mode
-        QDataStream messageStream(&messageData, QIODevice::ReadOnly);
-        messageStream.setByteOrder(QDataStream::BigEndian);
-
-        uint32_t messageType;
-        messageStream >> messageType;
-
-        // Read remaining data - validate size
-        size_t dataSize = messageSize - sizeof(uint32_t);
-        QByteArray data;
-        if (dataSize > 0 && dataSize < INT_MAX) {
-            data.resize(dataSize);
-            messageStream.readRawData(data.data(), static_cast<int>(dataSize));
-        } else if (dataSize >= INT_MAX) {
-            std::cerr << "[IPCChannelQt] Error: Data size too large: " << dataSize << std::endl;
-            continue;  // Skip this message
-        }
-
-        // Create message struct
-        // Note: We need to allocate memory for the data that will outlive this function
-        // The receiver is responsible for managing this memory
-        void* msgData = nullptr;
-        if (dataSize > 0) {
-            msgData = malloc(dataSize);
-            memcpy(msgData, data.data(), dataSize);
-        }
-
+    const auto result = reader.consume([this](uint32_t type, const void* data, size_t size) {
         ipc::Message msg;
-        msg.type = static_cast<ipc::MessageType>(messageType);
-        msg.data = msgData;
-        msg.size = dataSize;
-
-        std::cout << "[IPCChannelQt] Received message type 0x"
-                  << std::hex << messageType << std::dec
-                  << " size " << dataSize
-                  << (m_isServerMode ? " (server)" : " (client)")
-                  << std::endl;
-
-        // Emit signal
+        msg.type = static_cast<ipc::MessageType>(type);
+        msg.data = data;
+        msg.size = size;
         emit messageReceived(msg);
+    });
 
-        // Clean up allocated memory
-        if (msgData) {
-            free(msgData);
-        }
+    if (result.corrupt) {
+        std::cerr << "[IPCChannelQt] Error: Invalid frame length, discarding buffered data"
+                  << (m_isServerMode ? " (server)" : " (client)") << std::endl;
     }
 }
 
@@ -296,7 +297,7 @@ void IPCChannelQt::onNewConnection() {
     m_serverClientSockets.append(clientSocket);
 
     // Create buffer for this client
-    m_clientReceiveBuffers[clientSocket] = QByteArray();
+    m_clientReceiveBuffers[clientSocket] = ipc::FrameReader();
 
     // Connect signals
     QObject::connect(clientSocket, &QLocalSocket::readyRead,
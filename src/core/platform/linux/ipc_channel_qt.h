@@ -1,11 +1,15 @@
 #pragma once
 
 #include "core/platform/ipc_channel_interface.h"
+#include "core/platform/ipc_frame.h"
 #include <QLocalSocket>
 #include <QLocalServer>
 #include <QByteArray>
+#include <QMap>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace yamy::platform {
 
@@ -88,8 +92,12 @@ public:
     /**
      * @brief Send a message through the IPC channel
      *
-     * Serializes the message with a 4-byte length prefix (big-endian) followed
-     * by the message data, and sends it through the socket.
+     * Writes the fixed 8-byte frame header (see ipc_frame.h) and the payload
+     * straight to the socket without building an intermediate buffer.
+     *
+     * State snapshots (lock status; see isLatestWinsMessage)
+     * are coalesced: the payload is stored and written on the next event loop
+     * turn, and a newer snapshot sent before then replaces it.
      *
      * @param msg Message to send (contains type, data pointer, and size)
      *
@@ -118,6 +126,14 @@ private slots:
      */
     void onReadyRead();
 
+    /**
+     * @brief Write coalesced latest-wins messages
+     *
+     * Runs on the channel's thread once per event loop turn after send()
+     * stored a snapshot.
+     */
+    void flushCoalesced();
+
     /**
      * @brief Handle successful connection
      *
@@ -164,22 +180,39 @@ private:
     /**
      * @brief Process accumulated receive buffer
      *
-     * Parses the buffer for complete messages (4-byte length prefix + data),
-     * deserializes them, and emits messageReceived() signal.
+     * Parses complete frames in place and emits messageReceived() for each;
+     * message data points into the buffer and is valid only during the signal.
      * Keeps partial messages in the buffer for next call.
      *
      * @param socket The socket that sent the data (used for logging, can be nullptr)
-     * @param buffer The buffer to process
+     * @param reader The buffer to process
      */
-    void processReceiveBuffer(QLocalSocket* socket, QByteArray& buffer);
+    void processReceiveBuffer(QLocalSocket* socket, ipc::FrameReader& reader);
+
+    /**
+     * @brief Write one frame to every connected peer
+     */
+    void writeFrame(uint32_t type, const void* data, size_t size);
+
+    /// Latest-wins message waiting for flushCoalesced()
+    struct CoalescedMessage {
+        uint32_t type;
+        QByteArray payload;     ///< Reused across updates; capacity is retained
+        bool pending;
+    };
 
     std::string m_name;                           ///< Channel name
     QLocalSocket* m_clientSocket;                 ///< Client socket (client mode)
     QLocalServer* m_server;                       ///< Server socket (server mode)
     QList<QLocalSocket*> m_serverClientSockets;   ///< Connected clients (server mode)
-    QByteArray m_receiveBuffer;                   ///< Buffer for partial messages (client mode)
-    QMap<QLocalSocket*, QByteArray> m_clientReceiveBuffers;  ///< Per-client buffers (server mode)
+    ipc::FrameReader m_receiveBuffer;             ///< Buffer for partial messages (client mode)
+    QMap<QLocalSocket*, ipc::FrameReader> m_clientReceiveBuffers;  ///< Per-client buffers (server mode)
     bool m_isServerMode;                          ///< True if in server mode, false if client
+
+    std::mutex m_coalesceMutex;                   ///< Guards the coalescing state (send() may run off-thread)
+    std::vector<CoalescedMessage> m_coalesced;    ///< One slot per latest-wins type seen
+    bool m_flushScheduled = false;                ///< flushCoalesced() already queued
+    QByteArray m_flushScratch;                    ///< Payload being written by flushCoalesced()
 };
 
 } // namespace yamy::platform
@@ -0,0 +1,457 @@
+#include "ipc_channel_unix.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace yamy::platform {
+
+namespace {
+
+/// Queued bytes per peer before new frames to it are dropped; a client
+/// that stopped reading must not grow the daemon without bound. One frame
+/// of the largest size always fits an empty outbox.
+constexpr size_t kMaxOutbox = ipc::kFrameHeaderSize + ipc::kMaxFramePayload;
+
+constexpr uint32_t kReadEvents = EPOLLIN | EPOLLRDHUP;
+
+bool fillAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+} // namespace
+
+IPCChannelUnix::IPCChannelUnix(const std::string& name, EventLoop& loop)
+    : m_name(name)
+    , m_loop(loop)
+    , m_serverFd(-1)
+    , m_isServerMode(false)
+    , m_alive(std::make_shared<bool>(true))
+{
+}
+
+IPCChannelUnix::~IPCChannelUnix() {
+    m_alive.reset();
+
+    std::vector<int> fds;
+    for (const auto& entry : m_peers) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        closePeer(fd, false);
+    }
+
+    if (m_serverFd >= 0) {
+        m_loop.unwatchFd(m_serverFd);
+        close(m_serverFd);
+        unlink(m_serverPath.c_str());
+    }
+}
+
+std::string IPCChannelUnix::getSocketPath(const std::string& name) {
+    uid_t uid = getuid();
+    return "/tmp/yamy-" + name + "-" + std::to_string(uid);
+}
+
+void IPCChannelUnix::connect(const std::string& name) {
+    // Disconnect if already connected
+    if (!m_isServerMode && !m_peers.empty()) {
+        disconnect();
+    }
+
+    m_isServerMode = false;
+
+    const std::string socketPath = getSocketPath(name);
+    sockaddr_un addr;
+    if (!fillAddress(socketPath, addr)) {
+        std::cerr << "[IPCChannelUnix] Socket path too long: " << socketPath << std::endl;
+        return;
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "[IPCChannelUnix] socket() failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // A Unix socket connect either completes or fails at once; it never
+    // reports EINPROGRESS. Results are reported on the next loop turn, as
+    // QLocalSocket does.
+    std::weak_ptr<bool> alive = m_alive;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[IPCChannelUnix] Socket error: connect to " << socketPath
+                  << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        m_loop.post([this, alive]() {
+            if (alive.lock()) disconnected();
+        });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_peers[fd] = std::make_unique<Peer>(Peer{fd, ipc::FrameReader(), {}, 0});
+    }
+    m_loop.watchFd(fd, kReadEvents, [this, fd](uint32_t events) { onPeerEvent(fd, events); });
+
+    m_loop.post([this, alive, fd]() {
+        if (alive.lock() && m_peers.count(fd) != 0) {
+            std::cout << "[IPCChannelUnix] Connected to server" << std::endl;
+            connected();
+        }
+    });
+}
+
+void IPCChannelUnix::disconnect() {
+    std::vector<int> fds;
+    for (const auto& entry : m_peers) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        closePeer(fd, true);
+    }
+}
+
+void IPCChannelUnix::listen() {
+    m_isServerMode = true;
+
+    if (m_serverFd >= 0) {
+        return;
+    }
+
+    const std::string socketPath = getSocketPath(m_name);
+    sockaddr_un addr;
+    if (!fillAddress(socketPath, addr)) {
+        std::cerr << "[IPCChannelUnix] Socket path too long: " << socketPath << std::endl;
+        return;
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "[IPCChannelUnix] socket() failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // Remove existing socket file if it exists
+    unlink(socketPath.c_str());
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "[IPCChannelUnix] Failed to listen on " << socketPath
+                  << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return;
+    }
+
+    m_serverFd = fd;
+    m_serverPath = socketPath;
+    m_loop.watchFd(fd, EPOLLIN, [this](uint32_t) { onServerReadable(); });
+    std::cout << "[IPCChannelUnix] Listening on " << socketPath << std::endl;
+}
+
+bool IPCChannelUnix::isConnected() {
+    // Client mode holds at most the one server connection
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_peers.empty();
+}
+
+void IPCChannelUnix::send(const ipc::Message& msg) {
+    if (msg.size > ipc::kMaxFramePayload) {
+        std::cerr << "[IPCChannelUnix] Error: Message size too large: " << msg.size << std::endl;
+        return;  // Drop message
+    }
+
+    const uint32_t type = static_cast<uint32_t>(msg.type);
+    if (!ipc::isLatestWinsMessage(type)) {
+        writeFrame(type, msg.data, msg.size);
+        return;
+    }
+
+    // Latest-wins snapshot: overwrite any queued instance and flush once per loop turn
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_coalesceMutex);
+        auto it = std::find_if(m_coalesced.begin(), m_coalesced.end(),
+                               [type](const CoalescedMessage& m) { return m.type == type; });
+        if (it == m_coalesced.end()) {
+            m_coalesced.push_back(CoalescedMessage{type, {}, false});
+            it = std::prev(m_coalesced.end());
+        }
+
+        const size_t size = msg.data ? msg.size : 0;
+        it->payload.resize(size);
+        if (size > 0) {
+            std::memcpy(it->payload.data(), msg.data, size);
+        }
+        it->pending = true;
+
+        if (!m_flushScheduled) {
+            m_flushScheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        std::weak_ptr<bool> alive = m_alive;
+        m_loop.post([this, alive]() {
+            if (alive.lock()) flushCoalesced();
+        });
+    }
+}
+
+void IPCChannelUnix::flushCoalesced() {
+    size_t i = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_coalesceMutex);
+        m_flushScheduled = false;
+    }
+
+    while (true) {
+        uint32_t type;
+        {
+            std::lock_guard<std::mutex> lock(m_coalesceMutex);
+            while (i < m_coalesced.size() && !m_coalesced[i].pending) {
+                ++i;
+            }
+            if (i >= m_coalesced.size()) {
+                break;
+            }
+            // Swap rather than copy so both buffers keep their capacity
+            m_coalesced[i].payload.swap(m_flushScratch);
+            m_coalesced[i].pending = false;
+            type = m_coalesced[i].type;
+        }
+        writeFrame(type, m_flushScratch.data(), m_flushScratch.size());
+    }
+}
+
+std::unique_ptr<ipc::Message> IPCChannelUnix::nonBlockingReceive() {
+    // Messages are delivered via messageReceived()
+    return nullptr;
+}
+
+void IPCChannelUnix::writeFrame(uint32_t type, const void* data, size_t size) {
+    if (!data) {
+        size = 0;
+    }
+
+    uint8_t header[ipc::kFrameHeaderSize];
+    ipc::encodeFrameHeader(type, static_cast<uint32_t>(size), header);
+
+    // In server mode this broadcasts to all connected clients
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_peers) {
+        writeLocked(*entry.second, header, data, size);
+    }
+}
+
+void IPCChannelUnix::writeLocked(Peer& peer, const uint8_t* header, const void* data, size_t size) {
+    const size_t total = ipc::kFrameHeaderSize + size;
+    size_t written = 0;
+
+    // Decide before any byte is sent: once part of a frame is on the socket
+    // the rest must follow, or every later frame to the peer is misread
+    const size_t pending = peer.outbox.size() - peer.outboxOffset;
+    if (pending + total > kMaxOutbox) {
+        std::cerr << "[IPCChannelUnix] Peer not reading, dropping message" << std::endl;
+        return;
+    }
+
+    // Frames queued earlier go first; only write directly when none are waiting
+    if (pending == 0) {
+        iovec iov[2];
+        iov[0].iov_base = const_cast<uint8_t*>(header);
+        iov[0].iov_len = ipc::kFrameHeaderSize;
+        iov[1].iov_base = const_cast<void*>(data);
+        iov[1].iov_len = size;
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = size > 0 ? 2 : 1;
+        const ssize_t n = sendmsg(peer.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // The peer is gone; the loop closes it when it sees the hangup
+                return;
+            }
+        } else {
+            written = static_cast<size_t>(n);
+        }
+        if (written == total) {
+            return;
+        }
+    }
+
+    const bool wasEmpty = pending == 0;
+    if (written < ipc::kFrameHeaderSize) {
+        peer.outbox.insert(peer.outbox.end(), header + written, header + ipc::kFrameHeaderSize);
+        written = ipc::kFrameHeaderSize;
+    }
+    const uint8_t* payload = static_cast<const uint8_t*>(data);
+    peer.outbox.insert(peer.outbox.end(), payload + (written - ipc::kFrameHeaderSize), payload + size);
+
+    if (wasEmpty) {
+        requestWritable(peer.fd);
+    }
+}
+
+bool IPCChannelUnix::flushOutboxLocked(Peer& peer) {
+    while (peer.outboxOffset < peer.outbox.size()) {
+        const ssize_t n = ::send(peer.fd, peer.outbox.data() + peer.outboxOffset,
+                                 peer.outbox.size() - peer.outboxOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN: wait for the next EPOLLOUT; errors: the hangup closes the peer
+            return false;
+        }
+        peer.outboxOffset += static_cast<size_t>(n);
+    }
+    // Keep the capacity for the next burst
+    peer.outbox.clear();
+    peer.outboxOffset = 0;
+    return true;
+}
+
+void IPCChannelUnix::requestWritable(int fd) {
+    if (m_loop.isInLoopThread()) {
+        m_loop.modifyFd(fd, kReadEvents | EPOLLOUT);
+        return;
+    }
+    std::weak_ptr<bool> alive = m_alive;
+    m_loop.post([this, alive, fd]() {
+        if (alive.lock() && m_peers.count(fd) != 0) {
+            m_loop.modifyFd(fd, kReadEvents | EPOLLOUT);
+        }
+    });
+}
+
+void IPCChannelUnix::onServerReadable() {
+    while (true) {
+        const int fd = accept4(m_serverFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "[IPCChannelUnix] accept() failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        size_t total = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_peers[fd] = std::make_unique<Peer>(Peer{fd, ipc::FrameReader(), {}, 0});
+            total = m_peers.size();
+        }
+        m_loop.watchFd(fd, kReadEvents, [this, fd](uint32_t events) { onPeerEvent(fd, events); });
+        std::cout << "[IPCChannelUnix] New client connected (total: " << total << ")" << std::endl;
+    }
+}
+
+void IPCChannelUnix::onPeerEvent(int fd, uint32_t events) {
+    m_retired.clear();
+
+    if (events & EPOLLOUT) {
+        bool isDrained = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_peers.find(fd);
+            if (it != m_peers.end()) {
+                isDrained = flushOutboxLocked(*it->second);
+            }
+        }
+        if (isDrained) {
+            m_loop.modifyFd(fd, kReadEvents);
+        }
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        readPeer(fd);
+    }
+}
+
+void IPCChannelUnix::readPeer(int fd) {
+    auto it = m_peers.find(fd);
+    if (it == m_peers.end()) {
+        return;
+    }
+    Peer& peer = *it->second;
+
+    // Read everything available straight into the frame buffer
+    bool isClosed = false;
+    while (true) {
+        uint8_t* dest = peer.reader.prepareWrite(4096);
+        const ssize_t n = read(fd, dest, 4096);
+        if (n > 0) {
+            peer.reader.commitWrite(static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        isClosed = true;    // EOF or error
+        break;
+    }
+
+    // Frames received before a hangup are still delivered. A handler may
+    // close the peer; closePeer() retires it instead of freeing the reader
+    // being consumed.
+    const auto result = peer.reader.consume([this](uint32_t type, const void* data, size_t size) {
+        ipc::Message msg;
+        msg.type = static_cast<ipc::MessageType>(type);
+        msg.data = data;
+        msg.size = size;
+        messageReceived(msg);
+    });
+
+    if (result.corrupt) {
+        std::cerr << "[IPCChannelUnix] Error: Invalid frame length, discarding buffered data"
+                  << (m_isServerMode ? " (server)" : " (client)") << std::endl;
+    }
+
+    if (isClosed) {
+        closePeer(fd, true);
+    }
+}
+
+void IPCChannelUnix::closePeer(int fd, bool notify) {
+    std::unique_ptr<Peer> peer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_peers.find(fd);
+        if (it == m_peers.end()) {
+            return;
+        }
+        peer = std::move(it->second);
+        m_peers.erase(it);
+    }
+    m_loop.unwatchFd(fd);
+    close(fd);
+    m_retired.push_back(std::move(peer));
+
+    if (notify) {
+        std::cout << "[IPCChannelUnix] Disconnected from "
+                  << (m_isServerMode ? "client" : "server") << std::endl;
+        disconnected();
+    }
+}
+
+} // namespace yamy::platform
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/platform/ipc_channel_interface.h"
+#include "core/platform/ipc_frame.h"
+#include "event_loop.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace yamy::platform {
+
+/**
+ * @class IPCChannelUnix
+ * @brief IPC channel over raw AF_UNIX sockets, driven by an EventLoop
+ *
+ * Implements IIPCChannel without Qt for the daemon built without Qt. It
+ * listens on and connects to the same socket path as IPCChannelQt
+ * (/tmp/yamy-{name}-{UID}) and uses the same frames (ipc_frame.h), so a Qt
+ * GUI talks to it unchanged.
+ *
+ * Sockets are non-blocking and serviced on the EventLoop thread; received
+ * messages are delivered there through messageReceived(). connect(),
+ * listen() and disconnect() are called on the loop thread (or before it
+ * runs). send() may be called from any thread: the frame is written
+ * straight to the socket, and whatever the socket does not take is queued
+ * and written when it becomes writable. State snapshots (see isLatestWinsMessage) are coalesced and
+ * written once per loop turn, as IPCChannelQt does.
+ *
+ * Example Usage:
+ * @code
+ * IPCChannelUnix channel("yamy-engine");
+ * channel.setMessageCallback([](const ipc::Message& msg) { ... });
+ * channel.listen();
+ * EventLoop::instance().run();
+ * @endcode
+ */
+class IPCChannelUnix : public IIPCChannel {
+public:
+    /**
+     * @brief Construct a new IPCChannelUnix object
+     * @param name Channel name for socket path generation
+     * @param loop Loop servicing the sockets
+     */
+    explicit IPCChannelUnix(const std::string& name, EventLoop& loop = EventLoop::instance());
+
+    /**
+     * @brief Destructor - closes all sockets and removes the server socket file
+     *
+     * Must run on the loop thread, or after the loop has stopped.
+     */
+    ~IPCChannelUnix() override;
+
+    /**
+     * @brief Connects to a named IPC server
+     *
+     * @param name Server name (e.g., "yamy-engine")
+     *             Socket path will be /tmp/yamy-{name}-{UID}
+     *
+     * @note connected() is reported once the connection is established.
+     */
+    void connect(const std::string& name) override;
+
+    /// Close the client connection and all server-side peers
+    void disconnect() override;
+
+    /**
+     * @brief Start listening on /tmp/yamy-{name}-{UID}
+     *
+     * An existing socket file is removed first.
+     */
+    void listen() override;
+
+    /// True if connected to a server, or (server mode) if any client is connected
+    bool isConnected() override;
+
+    /**
+     * @brief Send a message; in server mode it is broadcast to all clients
+     *
+     * @note If not connected, the message is silently dropped.
+     */
+    void send(const ipc::Message& msg) override;
+
+    /// Messages are delivered through messageReceived(); always returns nullptr
+    std::unique_ptr<ipc::Message> nonBlockingReceive() override;
+
+    /// Socket path for a channel name
+    static std::string getSocketPath(const std::string& name);
+
+private:
+    /// One connected socket: the client connection, or a client of the server
+    struct Peer {
+        int fd;
+        ipc::FrameReader reader;        ///< Loop thread only
+        std::vector<uint8_t> outbox;    ///< Bytes the socket has not taken yet (m_mutex)
+        size_t outboxOffset = 0;        ///< Written prefix of outbox
+    };
+
+    /// Latest-wins message waiting for flushCoalesced()
+    struct CoalescedMessage {
+        uint32_t type;
+        std::vector<uint8_t> payload;   ///< Reused across updates; capacity is retained
+        bool pending;
+    };
+
+    void onServerReadable();
+    void onPeerEvent(int fd, uint32_t events);
+    void readPeer(int fd);
+    void closePeer(int fd, bool notify);
+
+    /// Write one frame to every connected peer
+    void writeFrame(uint32_t type, const void* data, size_t size);
+
+    /// Write to a peer, queueing what the socket does not take (m_mutex held)
+    void writeLocked(Peer& peer, const uint8_t* header, const void* data, size_t size);
+
+    /// Write queued bytes after EPOLLOUT (m_mutex held)
+    bool flushOutboxLocked(Peer& peer);
+
+    void flushCoalesced();
+
+    /// Ask the loop thread to watch a peer for writability
+    void requestWritable(int fd);
+
+    std::string m_name;
+    EventLoop& m_loop;
+    int m_serverFd;
+    std::string m_serverPath;
+    bool m_isServerMode;
+
+    std::mutex m_mutex;                             ///< Guards m_peers membership and outboxes
+    std::map<int, std::unique_ptr<Peer>> m_peers;
+    std::vector<std::unique_ptr<Peer>> m_retired;   ///< Closed while their frames were being delivered
+
+    std::mutex m_coalesceMutex;                     ///< Guards the coalescing state (send() may run off-thread)
+    std::vector<CoalescedMessage> m_coalesced;      ///< One slot per latest-wins type seen
+    bool m_flushScheduled = false;                  ///< flushCoalesced() already posted
+    std::vector<uint8_t> m_flushScratch;            ///< Payload being written by flushCoalesced()
+
+    /// Posted functions check this before touching the channel
+    std::shared_ptr<bool> m_alive;
+};
+
+} // namespace yamy::platform
@@ -143,6 +143,8 @@ struct KeyEvent {
     uint32_t timestamp; ///< Event timestamp in milliseconds
     uint32_t flags;     ///< Platform-specific flags
     uintptr_t extraInfo;///< Extra information (for event identification)
+    uint64_t timestampUs = 0; ///< Kernel event time in microseconds (CLOCK_MONOTONIC), 0 if unknown
+    bool isAutoRepeat = false; ///< Generated by OS/kernel autorepeat of a held key
 };
 
 /**
@@ -157,8 +159,17 @@ struct MouseEvent {
     uint32_t time;       ///< Event timestamp in milliseconds
     uintptr_t extraInfo; ///< Extra information (for event identification)
     uint32_t message;    ///< Platform-specific message type
+    int32_t dx = 0;      ///< Relative motion of an evdev frame, pixels
+    int32_t dy = 0;
+    int32_t wheel = 0;   ///< Vertical wheel of an evdev frame, 1/120 notch, positive is up
+    int32_t hwheel = 0;  ///< Horizontal wheel of an evdev frame, 1/120 notch, positive is right
+    uint64_t timestampUs = 0; ///< Kernel event time in microseconds (CLOCK_MONOTONIC), 0 if unknown
 };
 
+/// KeyEvent::extraInfo of mouse button events; scanCode is the E1 code of
+/// the button (LButton = 1, RButton = 2, MButton = 3, XButton1/2 = 6/7)
+constexpr uintptr_t MOUSE_EVENT_MARKER = 0x59414D59;
+
 /**
  * @brief Window show commands.
  *
@@ -0,0 +1,330 @@
+#include "plugin_event_bus.h"
+#include "../utils/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace yamy {
+namespace core {
+
+static_assert(std::is_trivially_copyable<PluginEvent>::value,
+              "PluginEvent is copied into ring slots word by word");
+static_assert((PluginEventBus::RING_CAPACITY & (PluginEventBus::RING_CAPACITY - 1)) == 0,
+              "RING_CAPACITY must be a power of two");
+
+namespace {
+
+/// Upper bound on how long a subscriber sleeps before rechecking the ring.
+/// Publishers wake sleepers without taking the wake mutex, so a wake-up racing
+/// with a subscriber going to sleep is picked up by this timeout instead.
+constexpr auto SUBSCRIBER_POLL_INTERVAL = std::chrono::milliseconds(10);
+
+uint32_t maskForKind(PluginEventKind kind)
+{
+    switch (kind) {
+        case PluginEventKind::Key: return PluginEventMask_Key;
+        case PluginEventKind::Notification: return PluginEventMask_Notification;
+    }
+    return 0;
+}
+
+} // namespace
+
+struct PluginEventBus::Subscriber {
+    SubscriptionHandle handle = 0;
+    std::string name;
+    uint32_t mask = 0;
+    const void* owner = nullptr;
+    PluginEventCallback callback;
+    std::thread thread;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> cursor{0};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> maxLag{0};
+};
+
+PluginEventBus& PluginEventBus::instance()
+{
+    static PluginEventBus instance;
+    return instance;
+}
+
+PluginEventBus::PluginEventBus()
+    : m_ring(new Slot[RING_CAPACITY])
+{
+}
+
+PluginEventBus::~PluginEventBus()
+{
+    clearSubscribers();
+}
+
+SubscriptionHandle PluginEventBus::subscribe(const std::string& name, uint32_t mask,
+                                             PluginEventCallback callback,
+                                             const void* owner)
+{
+    auto sub = std::make_shared<Subscriber>();
+    sub->name = name;
+    sub->mask = mask;
+    sub->owner = owner;
+    sub->callback = std::move(callback);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sub->handle = m_nextHandle++;
+        // Start at the current head: subscribers observe events published from now on
+        sub->cursor.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        m_subscribers.push_back(sub);
+        m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+        sub->thread = std::thread(&PluginEventBus::runSubscriber, this, sub);
+    }
+
+    LOG_DEBUG("[event-bus] Subscribed handle={} name={} mask={}",
+              static_cast<unsigned long>(sub->handle), name, mask);
+
+    return sub->handle;
+}
+
+bool PluginEventBus::unsubscribe(SubscriptionHandle handle)
+{
+    std::shared_ptr<Subscriber> sub;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_subscribers.begin(), m_subscribers.end(),
+                               [handle](const std::shared_ptr<Subscriber>& s) { return s->handle == handle; });
+        if (it == m_subscribers.end()) {
+            LOG_WARN("[event-bus] Attempted to unsubscribe unknown handle={}",
+                     static_cast<unsigned long>(handle));
+            return false;
+        }
+        sub = *it;
+        m_subscribers.erase(it);
+        m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+    }
+
+    stopSubscriber(sub);
+    LOG_DEBUG("[event-bus] Unsubscribed handle={} delivered={} dropped={}",
+              static_cast<unsigned long>(handle),
+              static_cast<unsigned long>(sub->delivered.load()),
+              static_cast<unsigned long>(sub->dropped.load()));
+    return true;
+}
+
+size_t PluginEventBus::unsubscribeOwner(const void* owner)
+{
+    std::vector<std::shared_ptr<Subscriber>> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::stable_partition(m_subscribers.begin(), m_subscribers.end(),
+                                        [owner](const std::shared_ptr<Subscriber>& s) { return s->owner != owner; });
+        removed.assign(it, m_subscribers.end());
+        m_subscribers.erase(it, m_subscribers.end());
+        m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+    }
+
+    for (const auto& sub : removed) {
+        stopSubscriber(sub);
+    }
+    return removed.size();
+}
+
+void PluginEventBus::clearSubscribers()
+{
+    std::vector<std::shared_ptr<Subscriber>> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        removed.swap(m_subscribers);
+        m_subscriberCount.store(0, std::memory_order_relaxed);
+    }
+
+    for (const auto& sub : removed) {
+        stopSubscriber(sub);
+    }
+}
+
+void PluginEventBus::stopSubscriber(const std::shared_ptr<Subscriber>& sub)
+{
+    sub->stop.store(true, std::memory_order_release);
+    m_wakeCond.notify_all();
+
+    if (!sub->thread.joinable()) {
+        return;
+    }
+    // The thread owns a reference to the subscriber, so detaching is safe when
+    // a callback unsubscribes itself
+    if (sub->thread.get_id() == std::this_thread::get_id()) {
+        sub->thread.detach();
+    } else {
+        sub->thread.join();
+    }
+}
+
+void PluginEventBus::publishKey(uint16_t scanCode, bool isKeyDown, bool isExtended, uint64_t timestampUs)
+{
+    if (!hasSubscribers()) {
+        return;
+    }
+
+    PluginEvent event;
+    event.kind = PluginEventKind::Key;
+    event.timestampUs = timestampUs;
+    event.scanCode = scanCode;
+    event.isKeyDown = isKeyDown;
+    event.isExtended = isExtended;
+    publish(event);
+}
+
+void PluginEventBus::publishNotification(MessageType type, std::string_view data)
+{
+    if (!hasSubscribers()) {
+        return;
+    }
+
+    PluginEvent event;
+    event.kind = PluginEventKind::Notification;
+    event.timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    event.messageType = type;
+    size_t size = std::min(data.size(), PluginEvent::DATA_CAPACITY);
+    std::memcpy(event.data, data.data(), size);
+    event.dataSize = static_cast<uint16_t>(size);
+    event.dataTruncated = size < data.size();
+    publish(event);
+}
+
+void PluginEventBus::publish(PluginEvent& event)
+{
+    uint64_t position = m_head.fetch_add(1, std::memory_order_seq_cst);
+    event.sequence = position;
+
+    uint64_t words[WORDS_PER_RECORD] = {};
+    std::memcpy(words, &event, sizeof(PluginEvent));
+
+    Slot& slot = m_ring[position & (RING_CAPACITY - 1)];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS_PER_RECORD; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(position + 1, std::memory_order_release);
+
+    if (m_sleepers.load(std::memory_order_seq_cst) > 0) {
+        m_wakeCond.notify_all();
+    }
+}
+
+PluginEventBus::ReadResult PluginEventBus::readSlot(uint64_t position, PluginEvent* out) const
+{
+    const Slot& slot = m_ring[position & (RING_CAPACITY - 1)];
+    const uint64_t expected = position + 1;
+
+    if (slot.seq.load(std::memory_order_acquire) != expected) {
+        if (m_head.load(std::memory_order_acquire) > position + RING_CAPACITY) {
+            return ReadResult::Lapped;
+        }
+        return ReadResult::NotReady;
+    }
+
+    uint64_t words[WORDS_PER_RECORD];
+    for (size_t i = 0; i < WORDS_PER_RECORD; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // A publisher that lapped us while copying invalidates the record
+    if (slot.seq.load(std::memory_order_relaxed) != expected) {
+        return ReadResult::Lapped;
+    }
+
+    std::memcpy(out, words, sizeof(PluginEvent));
+    return ReadResult::Ok;
+}
+
+void PluginEventBus::runSubscriber(std::shared_ptr<Subscriber> sub)
+{
+    PluginEvent event;
+    uint64_t cursor = sub->cursor.load(std::memory_order_relaxed);
+
+    while (!sub->stop.load(std::memory_order_acquire)) {
+        switch (readSlot(cursor, &event)) {
+            case ReadResult::Ok: {
+                ++cursor;
+                uint64_t lag = m_head.load(std::memory_order_relaxed) - cursor;
+                if (lag > sub->maxLag.load(std::memory_order_relaxed)) {
+                    sub->maxLag.store(lag, std::memory_order_relaxed);
+                }
+
+                if (sub->mask & maskForKind(event.kind)) {
+                    try {
+                        sub->callback(event);
+                    } catch (const std::exception& e) {
+                        LOG_ERROR("[event-bus] Subscriber {} threw exception: {}", sub->name, e.what());
+                    } catch (...) {
+                        LOG_ERROR("[event-bus] Subscriber {} threw unknown exception", sub->name);
+                    }
+                    sub->delivered.fetch_add(1, std::memory_order_relaxed);
+                }
+                sub->cursor.store(cursor, std::memory_order_release);
+                break;
+            }
+
+            case ReadResult::Lapped: {
+                // Resume at the oldest record still in the ring
+                uint64_t head = m_head.load(std::memory_order_acquire);
+                uint64_t oldest = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+                uint64_t resume = std::max(oldest, cursor + 1);
+                sub->dropped.fetch_add(resume - cursor, std::memory_order_relaxed);
+                cursor = resume;
+                sub->cursor.store(cursor, std::memory_order_release);
+                break;
+            }
+
+            case ReadResult::NotReady: {
+                if (m_head.load(std::memory_order_acquire) > cursor) {
+                    // Slot claimed but still being written
+                    std::this_thread::yield();
+                    break;
+                }
+                m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock<std::mutex> lock(m_wakeMutex);
+                    m_wakeCond.wait_for(lock, SUBSCRIBER_POLL_INTERVAL, [&] {
+                        return sub->stop.load(std::memory_order_acquire) ||
+                               m_head.load(std::memory_order_seq_cst) > cursor;
+                    });
+                }
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<PluginEventSubscriberStats> PluginEventBus::subscriberStats() const
+{
+    std::vector<PluginEventSubscriberStats> stats;
+    uint64_t head = m_head.load(std::memory_order_acquire);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.reserve(m_subscribers.size());
+    for (const auto& sub : m_subscribers) {
+        PluginEventSubscriberStats s;
+        s.handle = sub->handle;
+        s.name = sub->name;
+        s.delivered = sub->delivered.load(std::memory_order_relaxed);
+        s.dropped = sub->dropped.load(std::memory_order_relaxed);
+        uint64_t cursor = sub->cursor.load(std::memory_order_acquire);
+        s.lag = head > cursor ? head - cursor : 0;
+        s.maxLag = std::max(sub->maxLag.load(std::memory_order_relaxed), s.lag);
+        stats.push_back(std::move(s));
+    }
+    return stats;
+}
+
+} // namespace core
+} // namespace yamy
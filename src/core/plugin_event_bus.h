@@ -0,0 +1,172 @@
+#pragma once
+
+#ifndef _PLUGIN_EVENT_BUS_H
+#define _PLUGIN_EVENT_BUS_H
+
+#include "platform/ipc_defs.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yamy {
+namespace core {
+
+/// Kind of record carried on the plugin event bus
+enum class PluginEventKind : uint8_t {
+    Key = 1,            ///< Physical key event as received by the engine
+    Notification = 2,   ///< Engine state change (same types as notifyGUI)
+};
+
+/// Subscription filter bits, one per PluginEventKind
+enum PluginEventMask : uint32_t {
+    PluginEventMask_Key = 1u << 0,
+    PluginEventMask_Notification = 1u << 1,
+    PluginEventMask_All = PluginEventMask_Key | PluginEventMask_Notification,
+};
+
+/// Fixed-size record published on the bus
+/// Trivially copyable so the engine can write it into the ring without allocating
+struct PluginEvent {
+    /// Bytes of notification data kept inline; longer payloads are truncated
+    static constexpr size_t DATA_CAPACITY = 88;
+
+    uint64_t sequence = 0;      ///< Bus-wide publish sequence (gaps mean drops)
+    uint64_t timestampUs = 0;   ///< Kernel event time for keys, steady clock otherwise
+    PluginEventKind kind = PluginEventKind::Key;
+
+    // Key records
+    bool isKeyDown = false;
+    bool isExtended = false;
+    uint16_t scanCode = 0;      ///< YAMY scan code
+
+    // Notification records
+    MessageType messageType = MessageType::EngineStarting;
+    uint16_t dataSize = 0;
+    bool dataTruncated = false;
+    char data[DATA_CAPACITY] = {};
+
+    /// Notification payload (not NUL-terminated)
+    std::string_view dataView() const { return std::string_view(data, dataSize); }
+};
+
+/// Callback invoked on the subscriber's own thread
+using PluginEventCallback = std::function<void(const PluginEvent&)>;
+
+/// Registration handle for unsubscription
+using SubscriptionHandle = uint64_t;
+
+/// Per-subscriber delivery counters
+struct PluginEventSubscriberStats {
+    SubscriptionHandle handle = 0;
+    std::string name;
+    uint64_t delivered = 0;     ///< Records passed to the callback
+    uint64_t dropped = 0;       ///< Records overwritten before the subscriber read them
+    uint64_t lag = 0;           ///< Records published but not yet consumed
+    uint64_t maxLag = 0;        ///< Highest lag observed
+};
+
+/// Broadcast bus for plugin observation of engine activity
+///
+/// The engine writes each record once into a fixed ring shared by all
+/// subscribers and never calls plugin code. Every subscriber consumes the ring
+/// on its own thread with its own cursor; a subscriber that falls more than
+/// RING_CAPACITY records behind loses the oldest records and the loss is
+/// counted in its stats instead of stalling the publisher.
+class PluginEventBus {
+public:
+    /// Number of records retained in the ring (power of two)
+    static constexpr size_t RING_CAPACITY = 4096;
+
+    /// Get singleton instance
+    static PluginEventBus& instance();
+
+    /// Start a subscriber thread receiving records published from now on
+    /// @param name Label reported in stats (usually the plugin name)
+    /// @param mask PluginEventMask bits selecting record kinds
+    /// @param callback Invoked on the subscriber thread for each matching record
+    /// @param owner Optional owner tag for bulk removal (PluginManager uses the IPlugin pointer)
+    /// @return Handle for unsubscription
+    SubscriptionHandle subscribe(const std::string& name, uint32_t mask,
+                                 PluginEventCallback callback,
+                                 const void* owner = nullptr);
+
+    /// Stop a subscriber and wait for its thread to finish the current callback
+    /// When called from the subscriber's own callback the thread is detached instead
+    /// @return true if the handle was found
+    bool unsubscribe(SubscriptionHandle handle);
+
+    /// Stop every subscriber registered with the given owner tag
+    /// @return Number of subscribers removed
+    size_t unsubscribeOwner(const void* owner);
+
+    /// Stop all subscribers (primarily for testing)
+    void clearSubscribers();
+
+    /// Cheap check the engine uses to skip building records nobody reads
+    bool hasSubscribers() const {
+        return m_subscriberCount.load(std::memory_order_relaxed) > 0;
+    }
+
+    /// Publish a key event (wait-free apart from an optional wake-up)
+    void publishKey(uint16_t scanCode, bool isKeyDown, bool isExtended, uint64_t timestampUs);
+
+    /// Publish an engine notification; data beyond DATA_CAPACITY is truncated
+    void publishNotification(MessageType type, std::string_view data);
+
+    /// Total records published since startup
+    uint64_t publishedCount() const { return m_head.load(std::memory_order_acquire); }
+
+    /// Snapshot of per-subscriber counters
+    std::vector<PluginEventSubscriberStats> subscriberStats() const;
+
+    // Non-copyable
+    PluginEventBus(const PluginEventBus&) = delete;
+    PluginEventBus& operator=(const PluginEventBus&) = delete;
+
+private:
+    PluginEventBus();
+    ~PluginEventBus();
+
+    static constexpr size_t WORDS_PER_RECORD = (sizeof(PluginEvent) + 7) / 8;
+
+    /// Ring slot guarded by a sequence lock; payload words are relaxed atomics
+    /// so concurrent overwrite during a read is detected rather than undefined
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // sequence + 1 of the stored record, 0 while writing
+        std::atomic<uint64_t> words[WORDS_PER_RECORD];
+    };
+
+    struct Subscriber;
+
+    void publish(PluginEvent& event);
+    void runSubscriber(std::shared_ptr<Subscriber> sub);
+
+    enum class ReadResult { Ok, NotReady, Lapped };
+    ReadResult readSlot(uint64_t position, PluginEvent* out) const;
+
+    void stopSubscriber(const std::shared_ptr<Subscriber>& sub);
+
+    std::unique_ptr<Slot[]> m_ring;
+    std::atomic<uint64_t> m_head{0};
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCond;
+    std::atomic<uint32_t> m_sleepers{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<Subscriber>> m_subscribers;
+    std::atomic<size_t> m_subscriberCount{0};
+    SubscriptionHandle m_nextHandle{1};
+};
+
+} // namespace core
+} // namespace yamy
+
+#endif // _PLUGIN_EVENT_BUS_H
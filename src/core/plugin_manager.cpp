@@ -1,6 +1,7 @@
 ﻿// Windows Stub Logic
 #ifndef _WIN32
 #include "plugin_manager.h"
+#include "plugin_event_bus.h"
 #include "utils/logger.h"
 
 #include <dlfcn.h>
@@ -389,6 +390,13 @@ void PluginManager::unloadPluginInternal(LoadedPlugin& lp) {
             LOG_ERROR("[plugin] Plugin {} shutdown threw unknown exception", lp.name);
         }
 
+        // Event bus threads call into plugin code; stop any the plugin left
+        // subscribed under its own pointer before the library goes away
+        size_t leaked = PluginEventBus::instance().unsubscribeOwner(lp.plugin);
+        if (leaked > 0) {
+            LOG_WARN("[plugin] Plugin {} left {} event bus subscription(s) active", lp.name, leaked);
+        }
+
         // Destroy the plugin instance
         if (lp.destroyFunc) {
             try {
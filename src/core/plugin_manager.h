@@ -36,6 +36,8 @@ public:
     virtual int getApiVersion() const = 0;
 
     /// Initialize the plugin with access to the engine
+    /// Plugins that observe key events should subscribe to PluginEventBus here,
+    /// passing `this` as the owner so the subscription is stopped on unload
     /// @param engine Pointer to the Engine instance (may be nullptr during early init)
     /// @return true if initialization succeeded, false otherwise
     virtual bool initialize(Engine* engine) = 0;
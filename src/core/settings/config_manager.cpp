@@ -3,6 +3,7 @@
 
 #include "config_manager.h"
 #include "config_metadata.h"
+#include "config_watcher.h"
 #include "../platform/platform_time.h"
 #include <filesystem>
 #include <algorithm>
@@ -780,6 +781,15 @@ std::string ConfigManager::resolveIncludePath(const std::string& includePath,
     return "";
 }
 
+std::set<std::string> ConfigManager::getDependencies(const std::string& configPath)
+{
+    std::set<std::string> dependencies;
+    std::set<std::string> visited;
+    findDependencies(configPath, fs::path(configPath).parent_path().string(),
+                     dependencies, visited);
+    return dependencies;
+}
+
 void ConfigManager::findDependencies(const std::string& configPath,
                                      const std::string& basePath,
                                      std::set<std::string>& dependencies,
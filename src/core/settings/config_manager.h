@@ -14,8 +14,9 @@
 #include <functional>
 #include <memory>
 
-// ConfigWatcher is available on all platforms (stub on Windows, Qt-based on Linux)
-#include "config_watcher.h"
+// ConfigWatcher is available on all platforms (stub on Windows, Qt-based on Linux);
+// only config_manager.cpp needs its Qt headers
+class ConfigWatcher;
 
 /// Configuration file entry with path and optional metadata
 struct ConfigEntry {
@@ -212,6 +213,11 @@ public:
     /// @return Path to the templates directory
     static std::string getTemplatesDir();
 
+    /// Find all files a config includes, directly or indirectly
+    /// @param configPath Path to the config file
+    /// @return Canonical paths of the included files (not the config itself)
+    static std::set<std::string> getDependencies(const std::string& configPath);
+
 private:
     ConfigManager();
     ~ConfigManager();
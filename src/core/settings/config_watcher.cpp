@@ -3,6 +3,8 @@
 // Implementation of config file watcher with debouncing
 
 #include "config_watcher.h"
+
+#if defined(QT_CORE_LIB)
 #include <QFileInfo>
 #include <QDir>
 
@@ -191,3 +193,5 @@ bool ConfigWatcher::fileExists() const
 {
     return QFileInfo::exists(QString::fromStdString(m_configPath));
 }
+
+#endif // defined(QT_CORE_LIB)
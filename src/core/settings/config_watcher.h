@@ -12,7 +12,7 @@
 /// Callback type for config file changes
 using ConfigFileChangedCallback = std::function<void(const std::string& configPath)>;
 
-#if 1 
+#if defined(QT_CORE_LIB)
 // Qt implementation
 #include <QObject>
 #include <QFileSystemWatcher>
@@ -91,8 +91,9 @@ private:
 };
 
 #else
-// Windows stub implementation (no file watching)
-/// Stub config watcher for Windows (no-op, file watching not supported)
+// Stub implementation for builds without Qt (Windows, and the daemon built
+// without Qt, which watches its config with InotifyConfigWatcher instead)
+/// Stub config watcher (no-op, file watching not supported)
 class ConfigWatcher
 {
 public:
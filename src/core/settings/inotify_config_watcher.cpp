@@ -0,0 +1,298 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// inotify_config_watcher.cpp - Qt-free config file watcher for the daemon
+
+#include "inotify_config_watcher.h"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace yamy::settings {
+
+InotifyConfigWatcher::InotifyConfigWatcher()
+    : m_debounceMs(DEBOUNCE_DELAY_MS)
+    , m_inotifyFd(-1)
+    , m_timerFd(-1)
+    , m_wakeFd(-1)
+    , m_running(false)
+{
+}
+
+InotifyConfigWatcher::~InotifyConfigWatcher()
+{
+    stop();
+}
+
+void InotifyConfigWatcher::setConfigPath(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (path == m_configPath) {
+            return;
+        }
+    }
+
+    // Not from the change callback: stop() joins the watcher thread
+    const bool wasWatching = m_running;
+    if (wasWatching) {
+        stop();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_configPath = path;
+    }
+    if (wasWatching && !path.empty()) {
+        start();
+    }
+}
+
+std::string InotifyConfigWatcher::configPath() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_configPath;
+}
+
+std::vector<std::string> InotifyConfigWatcher::watchedFiles() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<std::string>(m_files.begin(), m_files.end());
+}
+
+#ifdef __linux__
+
+namespace {
+
+/// Directory events that can replace the content of a file in it
+constexpr uint32_t WATCH_MASK =
+    IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+
+std::string normalize(const std::string& path)
+{
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    return (ec ? fs::path(path) : absolute).lexically_normal().string();
+}
+
+} // namespace
+
+bool InotifyConfigWatcher::start()
+{
+    if (m_running) return true;
+    if (configPath().empty()) return false;
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inotifyFd < 0 || m_timerFd < 0 || m_wakeFd < 0) {
+        stop();
+        return false;
+    }
+
+    refreshWatches();
+
+    m_running = true;
+    m_thread = std::thread(&InotifyConfigWatcher::run, this);
+    return true;
+}
+
+void InotifyConfigWatcher::stop()
+{
+    if (m_running) {
+        m_running = false;
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+    // Closing the inotify descriptor removes its watches
+    for (int* fd : {&m_inotifyFd, &m_timerFd, &m_wakeFd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    m_dirs.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.clear();
+}
+
+void InotifyConfigWatcher::refreshWatches()
+{
+    const std::string config = configPath();
+
+    std::set<std::string> files;
+    files.insert(normalize(config));
+    // A symlinked config is edited through its target
+    std::error_code ec;
+    fs::path target = fs::canonical(config, ec);
+    if (!ec) {
+        files.insert(target.string());
+    }
+    if (m_dependencyResolver) {
+        for (const auto& dependency : m_dependencyResolver(config)) {
+            files.insert(normalize(dependency));
+        }
+    }
+
+    std::set<std::string> dirs;
+    for (const auto& file : files) {
+        dirs.insert(fs::path(file).parent_path().string());
+    }
+
+    for (auto it = m_dirs.begin(); it != m_dirs.end();) {
+        if (dirs.erase(it->second) == 0) {
+            inotify_rm_watch(m_inotifyFd, it->first);
+            it = m_dirs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // A directory that does not exist yet is picked up by a later refresh
+    for (const auto& dir : dirs) {
+        int wd = inotify_add_watch(m_inotifyFd, dir.c_str(), WATCH_MASK | IN_ONLYDIR);
+        if (wd >= 0) {
+            m_dirs[wd] = dir;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files = std::move(files);
+}
+
+void InotifyConfigWatcher::onFileEvent(int wd, const char* name)
+{
+    auto dir = m_dirs.find(wd);
+    if (dir == m_dirs.end()) return;
+
+    const std::string path = (fs::path(dir->second) / name).string();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_files.count(path) == 0) return;
+    }
+    armDebounce();
+}
+
+void InotifyConfigWatcher::armDebounce()
+{
+    // Each event restarts the delay, so a burst of events is one change
+    itimerspec spec = {};
+    spec.it_value.tv_sec = m_debounceMs / 1000;
+    spec.it_value.tv_nsec = static_cast<long>(m_debounceMs % 1000) * 1000000L;
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        spec.it_value.tv_nsec = 1;    // a zero it_value would disarm
+    }
+    timerfd_settime(m_timerFd, 0, &spec, nullptr);
+}
+
+void InotifyConfigWatcher::onDebounceTimeout()
+{
+    const std::string config = configPath();
+
+    // Deleted, or mid-rename: the file's return is another event
+    std::error_code ec;
+    if (!fs::is_regular_file(config, ec)) {
+        return;
+    }
+
+    // The edit may have added or removed includes
+    refreshWatches();
+
+    if (m_changeCallback) {
+        m_changeCallback(config);
+    }
+}
+
+void InotifyConfigWatcher::run()
+{
+    pollfd fds[3];
+    fds[0].fd = m_inotifyFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_timerFd;
+    fds[1].events = POLLIN;
+    fds[2].fd = m_wakeFd;
+    fds[2].events = POLLIN;
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (m_running) {
+        for (pollfd& fd : fds) fd.revents = 0;
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[2].revents & POLLIN) {
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            ssize_t length;
+            while ((length = read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(p);
+                    if (event->mask & IN_IGNORED) {
+                        // Directory removed; a later refresh watches it again
+                        m_dirs.erase(event->wd);
+                    } else if (event->mask & IN_Q_OVERFLOW) {
+                        // Events were lost; one of them may have been ours
+                        armDebounce();
+                    } else if (event->len > 0) {
+                        onFileEvent(event->wd, event->name);
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t expirations = 0;
+            if (read(m_timerFd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+                expirations > 0) {
+                onDebounceTimeout();
+            }
+        }
+    }
+}
+
+#else // !__linux__
+
+bool InotifyConfigWatcher::start()
+{
+    return false;
+}
+
+void InotifyConfigWatcher::stop()
+{
+}
+
+void InotifyConfigWatcher::refreshWatches()
+{
+}
+
+void InotifyConfigWatcher::onFileEvent(int, const char*)
+{
+}
+
+void InotifyConfigWatcher::armDebounce()
+{
+}
+
+void InotifyConfigWatcher::onDebounceTimeout()
+{
+}
+
+void InotifyConfigWatcher::run()
+{
+}
+
+#endif // __linux__
+
+} // namespace yamy::settings
@@ -0,0 +1,107 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// inotify_config_watcher.h - Qt-free config file watcher for the daemon
+//
+// Watches the active config and every file it includes, and reports edits
+// after a debounce. The parent directory of each file is watched rather than
+// the file itself: editors that save by writing a temporary file and
+// renaming it over the original replace the inode, which would silently end
+// a per-file watch. Every event naming a watched file (re)arms a one-shot
+// timerfd, so a save that produces several events yields one callback.
+//
+// All work happens on the watcher's own thread; no event loop is needed.
+// On platforms without inotify start() returns false.
+
+#ifndef _INOTIFY_CONFIG_WATCHER_H
+#define _INOTIFY_CONFIG_WATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace yamy::settings {
+
+class InotifyConfigWatcher {
+public:
+    /// Debounce delay in milliseconds (same as the Qt ConfigWatcher)
+    static constexpr uint32_t DEBOUNCE_DELAY_MS = 300;
+
+    /// Called on the watcher thread with the config path after an edit
+    using ChangeCallback = std::function<void(const std::string& configPath)>;
+
+    /// Returns the files a config includes (see ConfigManager::getDependencies)
+    using DependencyResolver = std::function<std::set<std::string>(const std::string& configPath)>;
+
+    InotifyConfigWatcher();
+    ~InotifyConfigWatcher();
+
+    InotifyConfigWatcher(const InotifyConfigWatcher&) = delete;
+    InotifyConfigWatcher& operator=(const InotifyConfigWatcher&) = delete;
+
+    /// Set the config file to watch; restarts the watcher if it is running
+    void setConfigPath(const std::string& path);
+
+    /// Get currently watched config path
+    std::string configPath() const;
+
+    /// Set callback for config file changes; call before start()
+    void setChangeCallback(ChangeCallback callback) { m_changeCallback = std::move(callback); }
+
+    /// Set how included files are found; without one only the config is watched
+    void setDependencyResolver(DependencyResolver resolver) { m_dependencyResolver = std::move(resolver); }
+
+    /// Set the debounce delay; call before start()
+    void setDebounceMs(uint32_t ms) { m_debounceMs = ms; }
+
+    /// Start watching on a new thread
+    /// @return false if no config path is set or inotify is unavailable
+    bool start();
+
+    /// Stop watching and join the thread
+    void stop();
+
+    bool isWatching() const { return m_running; }
+
+    /// Files currently watched: the config and its dependencies
+    std::vector<std::string> watchedFiles() const;
+
+private:
+    void run();
+
+    /// Resolve the watched files again and update the directory watches
+    void refreshWatches();
+
+    /// An inotify event named a file in a watched directory
+    void onFileEvent(int wd, const char* name);
+
+    /// (Re)start the debounce timer
+    void armDebounce();
+
+    /// The debounce timer expired
+    void onDebounceTimeout();
+
+    mutable std::mutex m_mutex;                 ///< Guards m_configPath and m_files
+    std::string m_configPath;
+    std::set<std::string> m_files;              ///< Absolute paths of watched files
+    std::map<int, std::string> m_dirs;          ///< Watch descriptor -> directory
+
+    ChangeCallback m_changeCallback;
+    DependencyResolver m_dependencyResolver;
+    uint32_t m_debounceMs;
+
+    int m_inotifyFd;
+    int m_timerFd;
+    int m_wakeFd;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace yamy::settings
+
+#endif // _INOTIFY_CONFIG_WATCHER_H
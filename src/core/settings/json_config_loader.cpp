@@ -2,6 +2,7 @@
 // json_config_loader.cpp - JSON configuration loader implementation
 
 #include "json_config_loader.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -12,6 +13,9 @@ namespace yamy::settings {
 JsonConfigLoader::JsonConfigLoader(std::ostream* log)
     : m_log(log)
     , m_keyboard(nullptr)
+    , m_setting(nullptr)
+    , m_patchCount(0)
+    , m_patchedAssignments(0)
 {
 }
 
@@ -19,15 +23,15 @@ bool JsonConfigLoader::load(Setting* setting, const std::string& json_path)
 {
     Expects(setting != nullptr);
 
-    // Read and parse JSON file
-    nlohmann::json config;
-    if (!loadJsonFile(json_path, config)) {
-        return false;
-    }
+    // A failed load leaves nothing to patch
+    m_setting = nullptr;
+    m_document = nullptr;
+    m_patchCount = 0;
+    m_patchedAssignments = 0;
 
-    // Validate schema
-    if (!validateSchema(config)) {
-        logError("Schema validation failed for " + json_path);
+    // Read, parse and validate JSON file
+    nlohmann::json config;
+    if (!read(json_path, config)) {
         return false;
     }
 
@@ -49,9 +53,217 @@ bool JsonConfigLoader::load(Setting* setting, const std::string& json_path)
         return false;
     }
 
+    // Parse chord options (optional section)
+    if (!parseChords(config, setting)) {
+        logError("Failed to parse chords section in " + json_path);
+        return false;
+    }
+
+    // Parse engine autorepeat (optional section)
+    if (!parseAutoRepeat(config, setting)) {
+        logError("Failed to parse autoRepeat section in " + json_path);
+        return false;
+    }
+
+    // Parse mouse keys (optional section)
+    if (!parseMouseKeys(config, setting)) {
+        logError("Failed to parse mouseKeys section in " + json_path);
+        return false;
+    }
+
+    m_setting = setting;
+    m_document = std::move(config);
+    return true;
+}
+
+bool JsonConfigLoader::read(const std::string& json_path, nlohmann::json& config)
+{
+    // Read and parse JSON file
+    if (!loadJsonFile(json_path, config)) {
+        return false;
+    }
+
+    // Validate schema
+    if (!validateSchema(config)) {
+        logError("Schema validation failed for " + json_path);
+        return false;
+    }
     return true;
 }
 
+namespace {
+
+/// Do two documents differ in anything but their "mappings"?
+bool differsOutsideMappings(const nlohmann::json& a, const nlohmann::json& b)
+{
+    size_t count = 0;
+    for (auto it = a.begin(); it != a.end(); ++it) {
+        if (it.key() == "mappings") {
+            continue;
+        }
+        auto other = b.find(it.key());
+        if (other == b.end() || *other != it.value()) {
+            return true;
+        }
+        ++count;
+    }
+    return count != b.size() - (b.contains("mappings") ? 1 : 0);
+}
+
+/// Mappings of one "from" spec, in file order
+using MappingIndex = std::unordered_map<std::string, std::vector<const nlohmann::json*>>;
+
+/**
+ * @brief Index mappings by "from" spec
+ * @return false if an entry is not an object with a string "from"
+ */
+bool indexMappings(const nlohmann::json& config, MappingIndex* index)
+{
+    auto mappings = config.find("mappings");
+    if (mappings == config.end()) {
+        return true;
+    }
+    if (!mappings->is_array()) {
+        return false;
+    }
+    for (const auto& mapping : *mappings) {
+        auto from = mapping.is_object() ? mapping.find("from") : mapping.end();
+        if (from == mapping.end() || !from->is_string()) {
+            return false;
+        }
+        (*index)[from->get<std::string>()].push_back(&mapping);
+    }
+    return true;
+}
+
+/// Do two lists of mappings differ?
+bool differs(const std::vector<const nlohmann::json*>& a, const std::vector<const nlohmann::json*>& b)
+{
+    if (a.size() != b.size()) {
+        return true;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (*a[i] != *b[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+JsonConfigLoader::PatchResult JsonConfigLoader::patch(Setting* setting,
+                                                      nlohmann::json config,
+                                                      std::vector<Key*>* changedKeys)
+{
+    Expects(setting != nullptr);
+    Expects(changedKeys != nullptr);
+
+    changedKeys->clear();
+    if (setting != m_setting || !config.is_object() || differsOutsideMappings(m_document, config)) {
+        return PatchResult::NeedsFullLoad;
+    }
+
+    // Mappings that load() would reject are left to load() to report
+    MappingIndex oldIndex;
+    MappingIndex newIndex;
+    if (!indexMappings(m_document, &oldIndex) || !indexMappings(config, &newIndex)) {
+        return PatchResult::NeedsFullLoad;
+    }
+
+    // "from" specs with a mapping added, removed or edited
+    std::vector<std::string> changedSpecs;
+    for (const auto& [fromSpec, mappings] : oldIndex) {
+        auto it = newIndex.find(fromSpec);
+        if (it == newIndex.end() || differs(it->second, mappings)) {
+            changedSpecs.push_back(fromSpec);
+        }
+    }
+    for (const auto& [fromSpec, mappings] : newIndex) {
+        if (oldIndex.find(fromSpec) == oldIndex.end()) {
+            changedSpecs.push_back(fromSpec);
+        }
+    }
+    if (changedSpecs.empty()) {
+        m_document = std::move(config);
+        return PatchResult::Patched;
+    }
+
+    Keymap* globalKeymap = setting->m_keymaps.searchByName("Global");
+    if (!globalKeymap) {
+        return PatchResult::NeedsFullLoad;
+    }
+
+    std::vector<Key*> keys;
+    for (const auto& fromSpec : changedSpecs) {
+        // Chords are compiled into their own table
+        if (isChordSpec(fromSpec)) {
+            return PatchResult::NeedsFullLoad;
+        }
+        ModifiedKey fromKey = parseModifiedKey(fromSpec);
+        if (!fromKey.m_key) {
+            logError("Failed to parse 'from' key '" + fromSpec + "'");
+            return PatchResult::Failed;
+        }
+        if (std::find(keys.begin(), keys.end(), fromKey.m_key) == keys.end()) {
+            keys.push_back(fromKey.m_key);
+        }
+    }
+
+    // Parse every mapping of the changed keys before touching the setting
+    struct Assignment {
+        ModifiedKey fromKey;
+        KeySeq keySeq;
+    };
+    std::vector<Assignment> assignments;
+    if (config.contains("mappings")) {
+        int mappingIndex = 0;
+        for (const auto& mapping : config["mappings"]) {
+            mappingIndex++;
+            const std::string fromSpec = mapping["from"].get<std::string>();
+            if (isChordSpec(fromSpec)) {
+                continue;
+            }
+            ModifiedKey fromKey = parseModifiedKey(fromSpec);
+            if (std::find(keys.begin(), keys.end(), fromKey.m_key) == keys.end()) {
+                continue;
+            }
+            if (!mapping.contains("to")) {
+                logError("Mapping #" + std::to_string(mappingIndex) + " missing required 'to' field");
+                return PatchResult::Failed;
+            }
+            KeySeq keySeq(mappingKeySeqName(mappingIndex, fromSpec));
+            keySeq.setMode(Modifier::Type_ASSIGN);
+            if (!parseToField(mapping["to"], keySeq, mappingIndex)) {
+                return PatchResult::Failed;
+            }
+            assignments.push_back(Assignment{fromKey, std::move(keySeq)});
+        }
+    }
+
+    // Replaced key sequences and assignments stay in the setting's arena;
+    // a full load starts a fresh one
+    if (m_patchCount >= MAX_PATCHES ||
+        m_patchedAssignments + assignments.size() > MAX_PATCHED_ASSIGNMENTS) {
+        return PatchResult::NeedsFullLoad;
+    }
+    ++m_patchCount;
+    m_patchedAssignments += assignments.size();
+
+    // Nothing can fail from here on
+    for (Key* key : keys) {
+        globalKeymap->removeAssignments(key);
+    }
+    for (const auto& assignment : assignments) {
+        KeySeq* keySeq = setting->m_keySeqs.add(assignment.keySeq);
+        globalKeymap->addAssignment(assignment.fromKey, keySeq);
+    }
+
+    *changedKeys = std::move(keys);
+    m_document = std::move(config);
+    return PatchResult::Patched;
+}
+
 bool JsonConfigLoader::parseKeyboard(const nlohmann::json& obj, Setting* setting)
 {
     Expects(setting != nullptr);
@@ -352,17 +564,24 @@ bool JsonConfigLoader::parseKeyDefinition(const std::string& name, const nlohman
 
     std::string scanCodeHex = scanCodeValue.get<std::string>();
 
+    // "E1-0x01": mouse buttons and wheels, as in .mayu keyboard definitions
+    uint16_t flags = 0;
+    if (scanCodeHex.compare(0, 3, "E1-") == 0) {
+        flags = ScanCode::E1;
+        scanCodeHex.erase(0, 3);
+    }
+
     // Parse scan code from hex string
     uint16_t scanCode;
     if (!parseScanCode(scanCodeHex, &scanCode)) {
-        logError("Invalid scan code for key '" + name + "': " + scanCodeHex);
+        logError("Invalid scan code for key '" + name + "': " + scanCodeValue.get<std::string>());
         return false;
     }
 
     // Create Key object
     Key key;
     key.addName(name);
-    key.addScanCode(ScanCode(scanCode, 0));  // flags = 0 for basic keys
+    key.addScanCode(ScanCode(scanCode, flags));  // flags = 0 for basic keys
 
     // Add key to keyboard
     m_keyboard->addKey(key);
@@ -460,6 +679,267 @@ bool JsonConfigLoader::parseVirtualModifier(const std::string& modName,
     return true;
 }
 
+bool JsonConfigLoader::parseAutoRepeat(const nlohmann::json& obj, Setting* setting)
+{
+    Expects(setting != nullptr);
+
+    // autoRepeat section is optional
+    if (!obj.contains("autoRepeat")) {
+        return true;
+    }
+
+    const auto& autoRepeat = obj["autoRepeat"];
+    if (!autoRepeat.is_object()) {
+        logError("'autoRepeat' must be an object");
+        return false;
+    }
+
+    if (autoRepeat.contains("enabled")) {
+        if (!autoRepeat["enabled"].is_boolean()) {
+            logError("'autoRepeat.enabled' must be a boolean");
+            return false;
+        }
+        setting->m_engineAutoRepeat = autoRepeat["enabled"].get<bool>();
+    }
+
+    if (!parseAutoRepeatTiming(autoRepeat, "autoRepeat", &setting->m_autoRepeat)) {
+        return false;
+    }
+
+    if (!autoRepeat.contains("keys")) {
+        return true;
+    }
+    const auto& keys = autoRepeat["keys"];
+    if (!keys.is_object()) {
+        logError("'autoRepeat.keys' must be an object");
+        return false;
+    }
+    for (auto& [keyName, timingDef] : keys.items()) {
+        const std::string context = "autoRepeat.keys." + keyName;
+        if (!timingDef.is_object()) {
+            logError("'" + context + "' must be an object");
+            return false;
+        }
+        Key* key = resolveKeyName(keyName);
+        if (!key) {
+            return false;
+        }
+        if (key->getScanCodesSize() == 0) {
+            logError("Key '" + keyName + "' in autoRepeat.keys has no scan codes");
+            return false;
+        }
+
+        // Unset fields inherit the section defaults
+        Setting::AutoRepeatTiming timing = setting->m_autoRepeat;
+        if (!parseAutoRepeatTiming(timingDef, context, &timing)) {
+            return false;
+        }
+        setting->m_autoRepeatKeys[key->getScanCodes()[0].m_scan] = timing;
+    }
+
+    return true;
+}
+
+bool JsonConfigLoader::parseAutoRepeatTiming(const nlohmann::json& obj, const std::string& context,
+                                            Setting::AutoRepeatTiming* timing)
+{
+    Expects(timing != nullptr);
+
+    static const char* const fields[] = {"delayMs", "intervalMs"};
+    unsigned int* targets[] = {&timing->m_delay, &timing->m_interval};
+    for (size_t i = 0; i < 2; ++i) {
+        if (!obj.contains(fields[i])) {
+            continue;
+        }
+        const auto& value = obj[fields[i]];
+        if (!value.is_number_unsigned() || value.get<uint64_t>() > 60000) {
+            logError("'" + context + "." + fields[i] + "' must be an integer between 0 and 60000");
+            return false;
+        }
+        *targets[i] = value.get<unsigned int>();
+    }
+    return true;
+}
+
+bool JsonConfigLoader::parseMouseKeys(const nlohmann::json& obj, Setting* setting)
+{
+    Expects(setting != nullptr);
+
+    // mouseKeys section is optional
+    if (!obj.contains("mouseKeys")) {
+        return true;
+    }
+
+    const auto& mouseKeys = obj["mouseKeys"];
+    if (!mouseKeys.is_object()) {
+        logError("'mouseKeys' must be an object");
+        return false;
+    }
+
+    if (mouseKeys.contains("rateHz")) {
+        const auto& rate = mouseKeys["rateHz"];
+        if (!rate.is_number_unsigned() || rate.get<uint64_t>() < 50 || rate.get<uint64_t>() > 1000) {
+            logError("'mouseKeys.rateHz' must be an integer between 50 and 1000");
+            return false;
+        }
+        setting->m_mouseKeysRate = rate.get<unsigned int>();
+    }
+
+    // Profile names by index; "default" is always index 0
+    std::vector<std::string> profileNames = {"default"};
+    if (mouseKeys.contains("profiles")) {
+        const auto& profiles = mouseKeys["profiles"];
+        if (!profiles.is_object()) {
+            logError("'mouseKeys.profiles' must be an object");
+            return false;
+        }
+        if (profiles.contains("default") &&
+                !parseMouseKeysProfile(profiles["default"], "mouseKeys.profiles.default",
+                                       &setting->m_mouseKeysProfiles[0])) {
+            return false;
+        }
+        for (auto& [name, profileDef] : profiles.items()) {
+            if (name == "default") {
+                continue;
+            }
+            if (profileNames.size() == yamy::engine::MouseKeys::MAX_PROFILES) {
+                logError("'mouseKeys.profiles' has more than " +
+                         std::to_string(yamy::engine::MouseKeys::MAX_PROFILES) + " profiles");
+                return false;
+            }
+            // Unset fields inherit the default profile
+            yamy::engine::MouseKeysProfile profile = setting->m_mouseKeysProfiles[0];
+            if (!parseMouseKeysProfile(profileDef, "mouseKeys.profiles." + name, &profile)) {
+                return false;
+            }
+            profileNames.push_back(name);
+            setting->m_mouseKeysProfiles.push_back(profile);
+        }
+    }
+
+    if (!mouseKeys.contains("keys")) {
+        return true;
+    }
+    const auto& keys = mouseKeys["keys"];
+    if (!keys.is_object()) {
+        logError("'mouseKeys.keys' must be an object");
+        return false;
+    }
+
+    static const std::pair<const char*, yamy::engine::MouseKeysAction> actions[] = {
+        {"left", yamy::engine::MouseKeysAction::Left},
+        {"right", yamy::engine::MouseKeysAction::Right},
+        {"up", yamy::engine::MouseKeysAction::Up},
+        {"down", yamy::engine::MouseKeysAction::Down},
+        {"wheelUp", yamy::engine::MouseKeysAction::WheelUp},
+        {"wheelDown", yamy::engine::MouseKeysAction::WheelDown},
+        {"none", yamy::engine::MouseKeysAction::None},
+    };
+    for (auto& [keyName, binding] : keys.items()) {
+        const std::string context = "mouseKeys.keys." + keyName;
+        std::string actionName;
+        std::string profileName = "default";
+        if (binding.is_string()) {
+            actionName = binding.get<std::string>();
+        } else if (binding.is_object() && binding.contains("action") && binding["action"].is_string()) {
+            actionName = binding["action"].get<std::string>();
+            if (binding.contains("profile")) {
+                if (!binding["profile"].is_string()) {
+                    logError("'" + context + ".profile' must be a string");
+                    return false;
+                }
+                profileName = binding["profile"].get<std::string>();
+            }
+        } else {
+            logError("'" + context + "' must be an action string or an object with an 'action'");
+            return false;
+        }
+
+        Setting::MouseKey mouseKey;
+        const auto action = std::find_if(std::begin(actions), std::end(actions),
+            [&actionName](const auto& entry) { return actionName == entry.first; });
+        if (action == std::end(actions)) {
+            logError("'" + context + "' has unknown action '" + actionName +
+                     "' (left, right, up, down, wheelUp, wheelDown, none)");
+            return false;
+        }
+        mouseKey.m_action = action->second;
+
+        const auto profile = std::find(profileNames.begin(), profileNames.end(), profileName);
+        if (profile == profileNames.end()) {
+            logError("'" + context + "' refers to unknown profile '" + profileName + "'");
+            return false;
+        }
+        mouseKey.m_profile = static_cast<uint8_t>(profile - profileNames.begin());
+
+        mouseKey.m_key = resolveKeyName(keyName);
+        if (!mouseKey.m_key) {
+            return false;
+        }
+        if (mouseKey.m_key->getScanCodesSize() == 0) {
+            logError("Key '" + keyName + "' in mouseKeys.keys has no scan codes");
+            return false;
+        }
+        if (setting->m_mouseKeys.size() == yamy::engine::MouseKeys::MAX_BINDINGS) {
+            logError("'mouseKeys.keys' has more than " +
+                     std::to_string(yamy::engine::MouseKeys::MAX_BINDINGS) + " keys");
+            return false;
+        }
+        setting->m_mouseKeys.push_back(mouseKey);
+    }
+
+    return true;
+}
+
+bool JsonConfigLoader::parseMouseKeysProfile(const nlohmann::json& obj, const std::string& context,
+                                            yamy::engine::MouseKeysProfile* profile)
+{
+    Expects(profile != nullptr);
+
+    if (!obj.is_object()) {
+        logError("'" + context + "' must be an object");
+        return false;
+    }
+
+    // Speeds in px/s (wheel: notches/s), with their accepted ranges
+    struct Field {
+        const char* name;
+        double* target;
+        double min;
+        double max;
+    };
+    const Field fields[] = {
+        {"initialSpeed", &profile->initialSpeed, 1, 20000},
+        {"maxSpeed", &profile->maxSpeed, 1, 20000},
+        {"curve", &profile->curve, 0.1, 10},
+        {"wheelSpeed", &profile->wheelSpeed, 0.1, 200},
+    };
+    for (const Field& field : fields) {
+        if (!obj.contains(field.name)) {
+            continue;
+        }
+        const auto& value = obj[field.name];
+        if (!value.is_number() || value.get<double>() < field.min || value.get<double>() > field.max) {
+            std::ostringstream message;
+            message << "'" << context << "." << field.name << "' must be a number between "
+                    << field.min << " and " << field.max;
+            logError(message.str());
+            return false;
+        }
+        *field.target = value.get<double>();
+    }
+
+    if (obj.contains("accelerationMs")) {
+        const auto& value = obj["accelerationMs"];
+        if (!value.is_number_unsigned() || value.get<uint64_t>() > 60000) {
+            logError("'" + context + ".accelerationMs' must be an integer between 0 and 60000");
+            return false;
+        }
+        profile->accelerationMs = value.get<uint32_t>();
+    }
+    return true;
+}
+
 bool JsonConfigLoader::parseSingleMapping(const nlohmann::json& mapping,
                                          int mappingIndex,
                                          Keymap* globalKeymap,
@@ -483,10 +963,18 @@ bool JsonConfigLoader::parseSingleMapping(const nlohmann::json& mapping,
     }
 
     std::string fromSpec = mapping["from"].get<std::string>();
-    ModifiedKey fromKey = parseModifiedKey(fromSpec);
-    if (!fromKey.m_key) {
-        logError("Failed to parse 'from' key in mapping #" + std::to_string(mappingIndex) + ": '" + fromSpec + "'");
-        return false;
+    ModifiedKey fromKey;
+    std::vector<Key*> chordKeys;
+    if (isChordSpec(fromSpec)) {
+        if (!parseChordKeys(fromSpec, mappingIndex, &chordKeys)) {
+            return false;
+        }
+    } else {
+        fromKey = parseModifiedKey(fromSpec);
+        if (!fromKey.m_key) {
+            logError("Failed to parse 'from' key in mapping #" + std::to_string(mappingIndex) + ": '" + fromSpec + "'");
+            return false;
+        }
     }
 
     // Parse "to" field (required)
@@ -496,8 +984,7 @@ bool JsonConfigLoader::parseSingleMapping(const nlohmann::json& mapping,
     }
 
     // Create a KeySeq to hold the action(s)
-    std::string keySeqName = "mapping_" + std::to_string(mappingIndex) + "_" + fromSpec;
-    KeySeq keySeq(keySeqName);
+    KeySeq keySeq(mappingKeySeqName(mappingIndex, fromSpec));
     keySeq.setMode(Modifier::Type_ASSIGN);
 
     // Parse "to" field
@@ -512,11 +999,98 @@ bool JsonConfigLoader::parseSingleMapping(const nlohmann::json& mapping,
         return false;
     }
 
+    if (!chordKeys.empty()) {
+        Setting::Chord chord;
+        chord.m_keys = chordKeys;
+        chord.m_keySeq = addedKeySeq;
+        setting->m_chords.push_back(chord);
+        return true;
+    }
+
     // Add the mapping to the global keymap
     globalKeymap->addAssignment(fromKey, addedKeySeq);
     return true;
 }
 
+bool JsonConfigLoader::isChordSpec(const std::string& fromSpec) const
+{
+    // "J+K" is a chord, unless a key is really named that way
+    return fromSpec.size() > 1 && fromSpec.find('+') != std::string::npos &&
+           m_keyLookup.find(fromSpec) == m_keyLookup.end();
+}
+
+std::string JsonConfigLoader::mappingKeySeqName(int mappingIndex, const std::string& fromSpec)
+{
+    return "mapping_" + std::to_string(mappingIndex) + "_" + fromSpec;
+}
+
+bool JsonConfigLoader::parseChordKeys(const std::string& fromSpec,
+                                      int mappingIndex,
+                                      std::vector<Key*>* keys)
+{
+    Expects(keys != nullptr);
+
+    size_t start = 0;
+    while (start <= fromSpec.size()) {
+        size_t end = fromSpec.find('+', start);
+        if (end == std::string::npos) {
+            end = fromSpec.size();
+        }
+        std::string keyName = fromSpec.substr(start, end - start);
+        if (keyName.empty()) {
+            logError("Empty key name in chord '" + fromSpec + "' of mapping #" + std::to_string(mappingIndex));
+            return false;
+        }
+
+        Key* key = resolveKeyName(keyName);
+        if (!key) {
+            return false;
+        }
+        for (Key* other : *keys) {
+            if (other == key) {
+                logError("Key '" + keyName + "' appears twice in chord '" + fromSpec + "'");
+                return false;
+            }
+        }
+        keys->push_back(key);
+        start = end + 1;
+    }
+
+    if (keys->size() > Setting::Chord::MAX_KEYS) {
+        logError("Chord '" + fromSpec + "' has more than " +
+                 std::to_string(Setting::Chord::MAX_KEYS) + " keys");
+        return false;
+    }
+    return true;
+}
+
+bool JsonConfigLoader::parseChords(const nlohmann::json& obj, Setting* setting)
+{
+    Expects(setting != nullptr);
+
+    // chords section is optional
+    if (!obj.contains("chords")) {
+        return true;
+    }
+
+    const auto& chords = obj["chords"];
+    if (!chords.is_object()) {
+        logError("'chords' must be an object");
+        return false;
+    }
+
+    if (chords.contains("timeoutMs")) {
+        const auto& timeout = chords["timeoutMs"];
+        if (!timeout.is_number_unsigned() || timeout.get<uint64_t>() < 1 ||
+                timeout.get<uint64_t>() > 1000) {
+            logError("'chords.timeoutMs' must be an integer between 1 and 1000");
+            return false;
+        }
+        setting->m_chordTimeout = timeout.get<unsigned int>();
+    }
+    return true;
+}
+
 bool JsonConfigLoader::parseToField(const nlohmann::json& toField,
                                     KeySeq& keySeq,
                                     int mappingIndex)
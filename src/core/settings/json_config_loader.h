@@ -8,6 +8,7 @@
 #include <string>
 #include <ostream>
 #include <unordered_map>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "setting.h"
 #include "../input/keyboard.h"
@@ -28,6 +29,18 @@ namespace yamy::settings {
  */
 class JsonConfigLoader {
 public:
+    /// Outcome of patch()
+    enum class PatchResult {
+        Patched,        ///< Setting updated in place (possibly with no changes)
+        NeedsFullLoad,  ///< Change cannot be patched; load() the file into a new setting
+        Failed,         ///< New mappings are invalid; setting left unchanged
+    };
+
+    /// Patches applied to one setting before patch() asks for a full load
+    static constexpr int MAX_PATCHES = 64;
+    /// Assignments patches may re-add to one setting before a full load
+    static constexpr size_t MAX_PATCHED_ASSIGNMENTS = 4096;
+
     /**
      * @brief Construct loader with optional logging stream
      * @param log Output stream for warnings/errors (nullptr = no logging)
@@ -46,6 +59,40 @@ public:
      */
     bool load(Setting* setting, const std::string& json_path);
 
+    /**
+     * @brief Read and validate a JSON configuration file without applying it
+     * @param json_path Path to JSON config file
+     * @param config Output JSON document
+     * @return true on success, false on error (see log for details)
+     *
+     * Touches no setting, so it can run outside the engine lock ahead of
+     * patch().
+     */
+    bool read(const std::string& json_path, nlohmann::json& config);
+
+    /**
+     * @brief Apply an edited document to the setting of the last load()
+     * @param setting Setting populated by the last successful load()
+     * @param config New document, as returned by read(); kept for the next patch
+     * @param changedKeys Output keys whose assignments in the Global keymap
+     *        were replaced; their compiled rules must be rebuilt
+     * @return Patched, NeedsFullLoad, or Failed (see PatchResult)
+     *
+     * Mappings are matched by their "from" spec. Only keys with an added,
+     * removed or edited mapping are touched: their assignments are removed
+     * and the new document's mappings for them re-added in file order, so
+     * the Global keymap ends up as load() would leave it. Anything else -
+     * an edit outside "mappings", an edited chord mapping, a mapping load()
+     * would reject - needs a full load.
+     *
+     * Key sequences of replaced mappings are left in the setting's arena
+     * until the next full load. To bound that growth, a patch needs a full
+     * load once MAX_PATCHES patches or MAX_PATCHED_ASSIGNMENTS re-added
+     * assignments have gone into the setting since load().
+     */
+    PatchResult patch(Setting* setting, nlohmann::json config,
+                      std::vector<Key*>* changedKeys);
+
 private:
     /**
      * @brief Parse keyboard.keys section
@@ -81,6 +128,65 @@ private:
      */
     bool parseMappings(const nlohmann::json& obj, Setting* setting);
 
+    /**
+     * @brief Parse optional chords section
+     * @param obj JSON object containing the chords section
+     * @param setting Setting object to populate
+     * @return true on success, false on error
+     *
+     * Chords themselves are mappings with a "J+K" from spec; this section
+     * only holds their options:
+     * "chords": { "timeoutMs": 50 }
+     */
+    bool parseChords(const nlohmann::json& obj, Setting* setting);
+
+    /**
+     * @brief Parse optional autoRepeat section
+     * @param obj JSON object containing the autoRepeat section
+     * @param setting Setting object to populate
+     * @return true on success, false on error
+     *
+     * Enables engine-generated autorepeat and sets its timing, with
+     * per output key overrides:
+     * "autoRepeat": { "enabled": true, "delayMs": 400, "intervalMs": 30,
+     *                 "keys": { "Left": { "intervalMs": 15 }, "Escape": { "intervalMs": 0 } } }
+     */
+    bool parseAutoRepeat(const nlohmann::json& obj, Setting* setting);
+
+    /**
+     * @brief Parse optional mouseKeys section
+     * @param obj JSON object containing the mouseKeys section
+     * @param setting Setting object to populate
+     * @return true on success, false on error
+     *
+     * Binds keys to pointer motion and scrolling while they are held, with
+     * named speed profiles; other profiles inherit unset fields from "default":
+     * "mouseKeys": { "rateHz": 500,
+     *                "profiles": { "default": { "maxSpeed": 1600 }, "slow": { "maxSpeed": 200 } },
+     *                "keys": { "H": "left", "J": "down", "Space": { "action": "none", "profile": "slow" } } }
+     */
+    bool parseMouseKeys(const nlohmann::json& obj, Setting* setting);
+
+    /**
+     * @brief Parse the fields of a mouseKeys profile, leaving absent fields unchanged
+     * @param obj JSON object holding the fields
+     * @param context Path used in error messages
+     * @param profile Profile to update
+     * @return true on success, false on error
+     */
+    bool parseMouseKeysProfile(const nlohmann::json& obj, const std::string& context,
+                               yamy::engine::MouseKeysProfile* profile);
+
+    /**
+     * @brief Parse delayMs / intervalMs fields, leaving absent fields unchanged
+     * @param obj JSON object holding the fields
+     * @param context Path used in error messages
+     * @param timing Timing to update
+     * @return true on success, false on error
+     */
+    bool parseAutoRepeatTiming(const nlohmann::json& obj, const std::string& context,
+                               Setting::AutoRepeatTiming* timing);
+
     /**
      * @brief Resolve key name to Key pointer
      * @param name Key name (e.g., "A", "CapsLock", "Left")
@@ -163,6 +269,30 @@ private:
     bool parseSingleMapping(const nlohmann::json& mapping, int mappingIndex,
                            Keymap* globalKeymap, Setting* setting);
 
+    /**
+     * @brief Parse the keys of a chord "from" spec ("J+K")
+     * @param fromSpec Plus-separated key names
+     * @param mappingIndex Index for error messages
+     * @param keys Output chord keys
+     * @return true on success, false on error
+     */
+    bool parseChordKeys(const std::string& fromSpec, int mappingIndex, std::vector<Key*>* keys);
+
+    /**
+     * @brief Is a "from" spec a chord ("J+K")?
+     * @param fromSpec Mapping "from" field
+     * @return true unless the spec has no '+' or names a key
+     */
+    bool isChordSpec(const std::string& fromSpec) const;
+
+    /**
+     * @brief Name of the KeySeq created for a mapping
+     * @param mappingIndex 1-based position in the mappings array
+     * @param fromSpec Mapping "from" field
+     * @return "mapping_<index>_<from>"
+     */
+    static std::string mappingKeySeqName(int mappingIndex, const std::string& fromSpec);
+
     /**
      * @brief Parse "to" field of mapping (string or array)
      * @param toField JSON value for "to" field
@@ -193,6 +323,10 @@ private:
     std::ostream* m_log;                              ///< Optional logging stream
     std::unordered_map<std::string, Key*> m_keyLookup; ///< Key name → Key* lookup
     Keyboard* m_keyboard;                             ///< Current keyboard (set during load)
+    Setting* m_setting;                               ///< Setting of the last successful load
+    nlohmann::json m_document;                        ///< Document m_setting reflects, for patch()
+    int m_patchCount;                                 ///< Patches applied to m_setting
+    size_t m_patchedAssignments;                      ///< Assignments patches added to m_setting
 };
 
 } // namespace yamy::settings
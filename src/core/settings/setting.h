@@ -8,10 +8,14 @@
 
 
 #  include "../input/keymap.h"
+#  include "../engine/mouse_keys.h"
 #  include "multithread.h"
 #  include "../utils/config_store.h"
+#  include <memory>
+#  include <memory_resource>
 #  include <set>
 #  include <unordered_map>
+#  include <vector>
 
 
 /// this class contains all of loaded settings
@@ -21,6 +25,50 @@ public:
     typedef std::set<std::string> Symbols;        ///
     typedef std::list<Modifier> Modifiers;    ///
 
+    /// engine autorepeat timing of an output key
+    class AutoRepeatTiming
+    {
+    public:
+        unsigned int m_delay;            /// ms before the first repeat
+        unsigned int m_interval;        /// ms between repeats, 0: no repeat
+    };
+    typedef std::unordered_map<uint16_t, AutoRepeatTiming> AutoRepeatTimings; /// by scan code
+
+    /// keys pressed together that run a key sequence
+    class Chord
+    {
+    public:
+        enum { MAX_KEYS = 8 };            /// keys in one chord
+        std::vector<Key *> m_keys;        /// keys of the chord
+        KeySeq *m_keySeq;            /// action while the chord is held
+    };
+    typedef std::vector<Chord> Chords;    ///
+
+    /// key that moves the pointer or scrolls while held
+    class MouseKey
+    {
+    public:
+        Key *m_key;                /// bound key
+        yamy::engine::MouseKeysAction m_action;    /// direction, or None
+        uint8_t m_profile;            /// index into m_mouseKeysProfiles
+    };
+    typedef std::vector<MouseKey> MouseKeyBindings;    ///
+
+    /// where the keys, keymaps and key sequences of the setting allocate
+    enum Allocation {
+        Allocation_arena,            /** one monotonic arena: a few contiguous
+                                                    blocks, released at once */
+        Allocation_heap,            /// global heap, node by node
+    };
+
+    enum {
+        ARENA_INITIAL_SIZE = 8 * 1024,        /// first arena block; later ones grow
+    };
+
+private:
+    /// declared before the containers it backs, so it is destroyed after them
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+
 public:
     Keyboard m_keyboard;                ///
     Keymaps m_keymaps;                ///
@@ -34,15 +82,43 @@ public:
     unsigned int m_oneShotRepeatableDelay;    ///
     std::unordered_map<uint8_t, uint16_t> m_modTapActions;  /// Tap actions for M00-MFF modifiers
     std::unordered_map<uint16_t, uint8_t> m_virtualModTriggers; /// Trigger keys for M00-MFF modifiers
+    bool m_engineAutoRepeat;            /// drop OS repeats, repeat output keys in the engine
+    AutoRepeatTiming m_autoRepeat;        /// default engine autorepeat timing
+    AutoRepeatTimings m_autoRepeatKeys;        /// per output key engine autorepeat timing
+    Chords m_chords;                /// simultaneous-press chords
+    unsigned int m_chordTimeout;        /// ms to complete a chord after its first key
+    MouseKeyBindings m_mouseKeys;        /// keys bound to pointer motion
+    std::vector<yamy::engine::MouseKeysProfile> m_mouseKeysProfiles; /// [0]: default profile
+    unsigned int m_mouseKeysRate;        /// mouse keys ticks per second
 
 public:
-    Setting()
-            : m_correctKanaLockHandling(false),
+    explicit Setting(Allocation i_allocation = Allocation_arena)
+            : m_arena(i_allocation == Allocation_arena
+                      ? std::make_unique<std::pmr::monotonic_buffer_resource>(
+                          static_cast<size_t>(ARENA_INITIAL_SIZE))
+                      : nullptr),
+            m_keyboard(getMemoryResource()),
+            m_keymaps(getMemoryResource()),
+            m_keySeqs(getMemoryResource()),
+            m_correctKanaLockHandling(false),
             m_sts4mayu(false),
             m_cts4mayu(false),
             m_mouseEvent(false),
             m_dragThreshold(0),
-            m_oneShotRepeatableDelay(0) { }
+            m_oneShotRepeatableDelay(0),
+            m_engineAutoRepeat(false),
+            m_autoRepeat{500, 33},
+            m_chordTimeout(50),
+            m_mouseKeysProfiles(1),
+            m_mouseKeysRate(500) { }
+
+    Setting(const Setting &) = delete;
+    Setting &operator=(const Setting &) = delete;
+
+    /// resource of m_keyboard, m_keymaps and m_keySeqs
+    std::pmr::memory_resource *getMemoryResource() const {
+        return m_arena ? m_arena.get() : std::pmr::new_delete_resource();
+    }
 };
 
 
@@ -7,10 +7,16 @@
 #endif
 #include <linux/input.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "../../utils/logger.h"
 #include <dirent.h>
 
@@ -20,6 +26,30 @@
 
 namespace yamy::platform {
 
+static_assert(DeviceCapabilities::KEY_BITMAP_BYTES == NBITS(KEY_CNT),
+              "EV_KEY bitmap size must match the kernel headers");
+
+namespace {
+
+struct CachedCapabilities {
+    int64_t mtimeNs;            // Of the sysfs node when probed
+    DeviceCapabilities caps;
+};
+
+/// Capability cache keyed by sysfs path, shared by every DeviceManager
+std::mutex g_cacheMutex;
+std::unordered_map<std::string, CachedCapabilities> g_capabilityCache;
+DeviceManager::CacheStats g_cacheStats;
+
+/// sysfs node of an event device (/sys/class/input/eventN links to it)
+std::string sysfsPathFor(const std::string& devNode)
+{
+    const size_t slash = devNode.rfind('/');
+    return "/sys/class/input/" + devNode.substr(slash == std::string::npos ? 0 : slash + 1);
+}
+
+} // namespace
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // DeviceManager Implementation
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -127,10 +157,6 @@ std::vector<InputDeviceInfo> DeviceManager::enumerateDevices()
             if (product) info.product = std::stoi(product, nullptr, 16);
         }
 
-        // Check capabilities
-        info.isKeyboard = isKeyboardDevice(devNodeStr);
-        info.isMouse = false;
-
         devices.push_back(info);
 
         udev_device_unref(dev);
@@ -157,20 +183,32 @@ std::vector<InputDeviceInfo> DeviceManager::enumerateDevices()
 
         InputDeviceInfo info;
         info.devNode = devNode;
-        info.name = getDeviceName(devNode);
         info.vendor = 0;
         info.product = 0;
-        info.isKeyboard = isKeyboardDevice(devNode);
-        info.isMouse = false;
-
-        if (!info.name.empty()) {
-            devices.push_back(info);
-        }
+        devices.push_back(info);
     }
 
     closedir(dir);
 #endif
 
+    // Capabilities come from the device nodes; probe the uncached ones side by side
+    forEachParallel(devices.size(), [&devices](size_t i) {
+        InputDeviceInfo& info = devices[i];
+        info.caps = getCapabilities(info.devNode, info.sysPath);
+        info.isKeyboard = info.caps.isKeyboard;
+        info.isMouse = info.caps.isMouse;
+        if (info.name.empty()) {
+            info.name = info.caps.name;
+        }
+    });
+
+#ifndef HAVE_LIBUDEV
+    // Without udev a node that cannot be read is not listed
+    devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                 [](const InputDeviceInfo& info) { return info.name.empty(); }),
+                  devices.end());
+#endif
+
     return devices;
 }
 
@@ -188,64 +226,161 @@ std::vector<InputDeviceInfo> DeviceManager::enumerateKeyboards()
     return keyboards;
 }
 
-bool DeviceManager::isKeyboardDevice(const std::string& devNode)
+std::vector<InputDeviceInfo> DeviceManager::enumerateMice()
 {
-    // Open device
+    std::vector<InputDeviceInfo> allDevices = enumerateDevices();
+    std::vector<InputDeviceInfo> mice;
+
+    for (const auto& dev : allDevices) {
+        if (dev.isMouse) {
+            mice.push_back(dev);
+        }
+    }
+
+    return mice;
+}
+
+DeviceCapabilities DeviceManager::probeDevice(const std::string& devNode)
+{
+    DeviceCapabilities caps;
     int fd = open(devNode.c_str(), O_RDONLY | O_NONBLOCK);
     if (fd < 0) {
         // Permission denied or doesn't exist
-        return false;
+        return caps;
     }
+    caps.isReadable = true;
 
-    // Check for EV_KEY capability
-    unsigned long evBits[NBITS(EV_MAX)] = {0};
-    if (ioctl(fd, EVIOCGBIT(0, sizeof(evBits)), evBits) < 0) {
+    char name[256] = {0};
+    if (ioctl(fd, EVIOCGNAME(sizeof(name)), name) < 0) {
         close(fd);
-        return false;
+        return caps;
     }
+    caps.name = name;
 
-    bool hasKeys = test_bit(EV_KEY, evBits);
-
-    if (hasKeys) {
-        // Check for actual keyboard keys (not just mouse buttons)
-        unsigned long keyBits[NBITS(KEY_MAX)] = {0};
-        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) >= 0) {
-            // Check for typical keyboard keys
-            // Check for letters, numbers, or common keys
-            bool hasKeyboardKeys =
-                test_bit(KEY_A, keyBits) ||
-                test_bit(KEY_Z, keyBits) ||
-                test_bit(KEY_ENTER, keyBits) ||
-                test_bit(KEY_SPACE, keyBits) ||
-                test_bit(KEY_ESC, keyBits) ||
-                test_bit(KEY_1, keyBits) ||
-                test_bit(KEY_2, keyBits) ||
-                test_bit(KEY_TAB, keyBits);
-
-            close(fd);
-            return hasKeyboardKeys;
-        }
+    struct input_id id;
+    if (ioctl(fd, EVIOCGID, &id) >= 0) {
+        caps.vendor = id.vendor;
+        caps.product = id.product;
     }
 
+    char serial[256] = {0};
+    if (ioctl(fd, EVIOCGUNIQ(sizeof(serial)), serial) >= 0) {
+        caps.serial = serial;
+    }
+
+    // Byte arrays: test_bit() indexes bytes
+    unsigned char evBits[NBITS(EV_MAX)] = {0};
+    unsigned char relBits[NBITS(REL_MAX)] = {0};
+    const bool hasEvBits = ioctl(fd, EVIOCGBIT(0, sizeof(evBits)), evBits) >= 0;
+    if (hasEvBits && test_bit(EV_KEY, evBits)) {
+        ioctl(fd, EVIOCGBIT(EV_KEY, caps.keyBits.size()), caps.keyBits.data());
+    }
+    if (hasEvBits && test_bit(EV_REL, evBits)) {
+        ioctl(fd, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits);
+    }
     close(fd);
-    return false;
+
+    // Letters, digits or common keys, not just mouse buttons
+    const uint8_t* keyBits = caps.keyBits.data();
+    caps.isKeyboard =
+        test_bit(KEY_A, keyBits) ||
+        test_bit(KEY_Z, keyBits) ||
+        test_bit(KEY_ENTER, keyBits) ||
+        test_bit(KEY_SPACE, keyBits) ||
+        test_bit(KEY_ESC, keyBits) ||
+        test_bit(KEY_1, keyBits) ||
+        test_bit(KEY_2, keyBits) ||
+        test_bit(KEY_TAB, keyBits);
+    // Touchpads report absolute axes and are not mice
+    caps.isMouse =
+        test_bit(REL_X, relBits) && test_bit(REL_Y, relBits) &&
+        test_bit(BTN_LEFT, keyBits);
+    return caps;
 }
 
-std::string DeviceManager::getDeviceName(const std::string& devNode)
+DeviceCapabilities DeviceManager::getCapabilities(const std::string& devNode,
+                                                  const std::string& sysPath)
 {
-    int fd = open(devNode.c_str(), O_RDONLY | O_NONBLOCK);
-    if (fd < 0) {
-        return "";
+    const std::string key = sysPath.empty() ? sysfsPathFor(devNode) : sysPath;
+
+    // A device that is unplugged and plugged in again gets a new sysfs node
+    struct stat st;
+    const bool hasNode = stat(key.c_str(), &st) == 0;
+    const int64_t mtimeNs = hasNode
+        ? static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec
+        : 0;
+
+    if (hasNode) {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto it = g_capabilityCache.find(key);
+        if (it != g_capabilityCache.end() && it->second.mtimeNs == mtimeNs) {
+            ++g_cacheStats.hits;
+            return it->second.caps;
+        }
     }
 
-    char name[256] = "Unknown";
-    if (ioctl(fd, EVIOCGNAME(sizeof(name)), name) < 0) {
-        close(fd);
-        return "";
+    DeviceCapabilities caps = probeDevice(devNode);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    ++g_cacheStats.probes;
+    // Unreadable nodes are probed again: permissions may be granted later
+    if (hasNode && caps.isReadable) {
+        g_capabilityCache[key] = CachedCapabilities{mtimeNs, caps};
     }
+    return caps;
+}
 
-    close(fd);
-    return std::string(name);
+DeviceManager::CacheStats DeviceManager::cacheStats()
+{
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    return g_cacheStats;
+}
+
+void DeviceManager::clearCapabilityCache()
+{
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_capabilityCache.clear();
+    g_cacheStats = CacheStats();
+}
+
+void DeviceManager::forEachParallel(size_t count, const std::function<void(size_t)>& work)
+{
+    std::atomic<size_t> next{0};
+    auto worker = [&next, count, &work]() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                work(i);
+            } catch (const std::exception& e) {
+                LOG_ERROR("[DeviceManager] Device {} failed: {}", i, e.what());
+            }
+        }
+    };
+
+    const size_t threadCount = std::min(count, PARALLEL_DEVICES);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+    for (size_t t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();   // The calling thread takes a share too
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool DeviceManager::isKeyboardDevice(const std::string& devNode)
+{
+    return getCapabilities(devNode).isKeyboard;
+}
+
+bool DeviceManager::isMouseDevice(const std::string& devNode)
+{
+    return getCapabilities(devNode).isMouse;
+}
+
+std::string DeviceManager::getDeviceName(const std::string& devNode)
+{
+    return getCapabilities(devNode).name;
 }
 
 int DeviceManager::openDevice(const std::string& devNode, bool nonBlock)
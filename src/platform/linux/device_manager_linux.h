@@ -2,15 +2,33 @@
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // device_manager_linux.h - Device enumeration and management (Track 9 Phase 2-3)
 
+#include <array>
 #include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 
 // Forward declaration for udev
 struct udev;
 
 namespace yamy::platform {
 
+/// What a device node reports about itself, read with a single open.
+/// DeviceManager caches it by sysfs path and modification time.
+struct DeviceCapabilities {
+    static constexpr size_t KEY_BITMAP_BYTES = 96;      // KEY_CNT / 8
+
+    std::string name;           // EVIOCGNAME; empty if the node cannot be read
+    std::string serial;         // EVIOCGUNIQ, often empty
+    uint16_t vendor = 0;        // EVIOCGID
+    uint16_t product = 0;       // EVIOCGID
+    std::array<uint8_t, KEY_BITMAP_BYTES> keyBits{};   // EV_KEY bitmap
+    bool isKeyboard = false;    // Has letter, digit or editing keys
+    bool isMouse = false;       // Has REL_X, REL_Y and BTN_LEFT
+    bool isReadable = false;    // The node could be opened
+};
+
 /// Information about an input device
 struct InputDeviceInfo {
     std::string devNode;        // e.g. "/dev/input/event0"
@@ -20,6 +38,7 @@ struct InputDeviceInfo {
     uint16_t product = 0;       // Product ID
     bool isKeyboard = false;    // Has keyboard capabilities
     bool isMouse = false;       // Has mouse capabilities
+    DeviceCapabilities caps;    // Read from the device node
 };
 
 /// Represents an opened input device
@@ -44,6 +63,38 @@ public:
     /// @return List of keyboard devices
     std::vector<InputDeviceInfo> enumerateKeyboards();
 
+    /// Enumerate only mouse devices
+    /// @return List of devices with relative X/Y axes and a left button
+    std::vector<InputDeviceInfo> enumerateMice();
+
+    /// Capabilities of a device, probed or taken from the cache. The entry
+    /// is reused while the sysfs node keeps its modification time; a
+    /// replugged device gets a new node and is probed again.
+    /// @param devNode Device node path (e.g. "/dev/input/event0")
+    /// @param sysPath sysfs path; derived from devNode if empty
+    static DeviceCapabilities getCapabilities(const std::string& devNode,
+                                              const std::string& sysPath = std::string());
+
+    /// Read capabilities from the device node, bypassing the cache
+    static DeviceCapabilities probeDevice(const std::string& devNode);
+
+    /// Probes and cache hits since the process started
+    struct CacheStats {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+    };
+    static CacheStats cacheStats();
+
+    /// Forget every cached device
+    static void clearCapabilityCache();
+
+    /// Run work(i) for each i in [0, count) on up to PARALLEL_DEVICES
+    /// threads and wait for all of them. Opening a device can block for
+    /// milliseconds, so devices are probed and opened side by side.
+    static void forEachParallel(size_t count, const std::function<void(size_t)>& work);
+
+    static constexpr size_t PARALLEL_DEVICES = 8;
+
     /// Open device for reading
     /// @param devNode Device path (e.g. "/dev/input/event0")
     /// @param nonBlock Open in non-blocking mode
@@ -65,6 +116,11 @@ public:
     /// @return true if device has EV_KEY capability
     static bool isKeyboardDevice(const std::string& devNode);
 
+    /// Check if device is a mouse (touchpads report absolute axes and are not)
+    /// @param devNode Device node path (e.g. "/dev/input/event0")
+    /// @return true if device has REL_X, REL_Y and BTN_LEFT
+    static bool isMouseDevice(const std::string& devNode);
+
     /// Get device name
     /// @param devNode Device node path
     /// @return Device name or empty string on error
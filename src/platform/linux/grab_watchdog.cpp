@@ -0,0 +1,108 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// grab_watchdog.cpp - give grabbed keyboards back when the engine stalls
+
+#include "grab_watchdog.h"
+#include "../../utils/platform_logger.h"
+#include <algorithm>
+
+namespace yamy::platform {
+
+namespace {
+
+/// Checks per stall threshold, so a stall is caught within 1.25 thresholds
+constexpr int CHECKS_PER_THRESHOLD = 4;
+
+} // namespace
+
+GrabWatchdog::GrabWatchdog(ReleaseCallback release)
+    : m_release(std::move(release))
+    , m_stallThreshold(DEFAULT_STALL_THRESHOLD)
+{
+}
+
+GrabWatchdog::~GrabWatchdog()
+{
+    stop();
+}
+
+uint64_t GrabWatchdog::nowUs()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // 0 means "nothing waiting", so the clock never reads as 0
+    return std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()));
+}
+
+bool GrabWatchdog::start(std::chrono::milliseconds stallThreshold)
+{
+    if (m_running) return true;
+
+    m_stallThreshold = std::max(stallThreshold, std::chrono::milliseconds(1));
+    m_waitingSinceUs.store(0, std::memory_order_relaxed);
+    m_released = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = false;
+    }
+    m_running = true;
+    m_thread = std::thread(&GrabWatchdog::run, this);
+    return true;
+}
+
+void GrabWatchdog::stop()
+{
+    if (!m_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running = false;
+}
+
+void GrabWatchdog::inputDelivered()
+{
+    uint64_t idle = 0;
+    m_waitingSinceUs.compare_exchange_strong(idle, nowUs(), std::memory_order_relaxed);
+}
+
+void GrabWatchdog::inputProcessed()
+{
+    // Read first: the engine thread must not dirty the line on every event
+    if (m_waitingSinceUs.load(std::memory_order_relaxed) != 0) {
+        m_waitingSinceUs.store(0, std::memory_order_relaxed);
+    }
+}
+
+void GrabWatchdog::run()
+{
+    const uint64_t thresholdUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(m_stallThreshold).count());
+    const auto checkInterval = std::max(m_stallThreshold / CHECKS_PER_THRESHOLD,
+                                        std::chrono::milliseconds(1));
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wake.wait_for(lock, checkInterval, [this] { return m_stopRequested; })) {
+        const uint64_t since = m_waitingSinceUs.load(std::memory_order_relaxed);
+        if (since == 0) continue;
+
+        const uint64_t now = nowUs();
+        if (now <= since || now - since < thresholdUs) continue;
+
+        PLATFORM_LOG_ERROR("input", "Engine has not taken input for %llu ms; releasing grabbed "
+                           "keyboards. Restart YAMY to grab them again.",
+                           static_cast<unsigned long long>((now - since) / 1000));
+        m_released = true;
+        lock.unlock();
+        if (m_release) {
+            m_release();
+        }
+        return;
+    }
+}
+
+} // namespace yamy::platform
@@ -0,0 +1,75 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// grab_watchdog.h - give grabbed keyboards back when the engine stalls
+//
+// In exclusive mode every keyboard is grabbed (EVIOCGRAB) and only the
+// uinput output device reaches the desktop. If the engine thread stops
+// taking keys off its queue the keyboard is dead for the whole session.
+// The watchdog notes when a key is handed to the engine and when the engine
+// is done with one; input left waiting longer than the stall threshold
+// makes it call the release callback once, which ungrabs the keyboards.
+// Keys then reach the desktop directly, as they do without exclusive mode.
+//
+// Crashes are covered elsewhere: the kernel drops a grab when its fd is
+// closed, and the crash handler releases the grabs before writing its
+// report (see InputHookLinux::releaseGrabs()).
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace yamy::platform {
+
+class GrabWatchdog {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_STALL_THRESHOLD{1000};
+
+    using ReleaseCallback = std::function<void()>;
+
+    /// @param release Called once, on the watchdog thread, when the engine stalls
+    explicit GrabWatchdog(ReleaseCallback release);
+    ~GrabWatchdog();
+
+    GrabWatchdog(const GrabWatchdog&) = delete;
+    GrabWatchdog& operator=(const GrabWatchdog&) = delete;
+
+    /// Start watching; no-op if running
+    bool start(std::chrono::milliseconds stallThreshold = DEFAULT_STALL_THRESHOLD);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    /// A key is about to enter the engine's queue (reader threads).
+    /// Call before the engine can see it, so its completion is not missed;
+    /// never for a key the engine drops, which it will not answer.
+    void inputDelivered();
+
+    /// The engine is done with an input event (engine thread)
+    void inputProcessed();
+
+    /// The release callback has run since the last start()
+    bool hasReleased() const { return m_released; }
+
+private:
+    void run();
+
+    static uint64_t nowUs();
+
+    ReleaseCallback m_release;
+    std::chrono::milliseconds m_stallThreshold;
+
+    /// When the oldest input the engine has not answered arrived; 0 if none
+    alignas(64) std::atomic<uint64_t> m_waitingSinceUs{0};
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_released{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopRequested = false;   // (m_mutex)
+    std::thread m_thread;
+};
+
+} // namespace yamy::platform
@@ -0,0 +1,281 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// input_event_merger.cpp - kernel-timestamp order across keyboards
+
+#include "input_event_merger.h"
+#include "../../utils/platform_logger.h"
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace yamy::platform {
+
+namespace {
+
+/// Merge thread wake-up when nothing is held, so stop() is noticed
+constexpr uint64_t IDLE_TIMEOUT_US = 100000;
+
+} // namespace
+
+InputEventMerger::InputEventMerger(KeyCallback callback, uint64_t windowUs)
+    : m_callback(std::move(callback))
+    , m_windowUs(windowUs)
+    , m_wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , m_running(false)
+    , m_stopRequested(false)
+{
+    if (m_wakeFd < 0) {
+        PLATFORM_LOG_ERROR("input", "eventfd failed: %s", strerror(errno));
+    }
+}
+
+InputEventMerger::~InputEventMerger()
+{
+    stop();
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+    }
+}
+
+bool InputEventMerger::isLater(const Pending& a, const Pending& b)
+{
+    if (a.event.timestampUs != b.event.timestampUs) {
+        return a.event.timestampUs > b.event.timestampUs;
+    }
+    return a.intake > b.intake;
+}
+
+uint64_t InputEventMerger::nowUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+}
+
+size_t InputEventMerger::addLane(int fd)
+{
+    auto lane = std::make_unique<Lane>();
+    lane->fd = fd;
+    lane->caughtUpUs.store(nowUs(), std::memory_order_relaxed);
+    m_lanes.push_back(std::move(lane));
+    return m_lanes.size() - 1;
+}
+
+bool InputEventMerger::start()
+{
+    if (m_running) return true;
+    if (m_wakeFd < 0) return false;
+
+    m_stopRequested = false;
+    m_running = true;
+    m_thread = std::thread(&InputEventMerger::run, this);
+    return true;
+}
+
+void InputEventMerger::stop()
+{
+    if (!m_running) return;
+
+    m_stopRequested = true;
+    wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running = false;
+}
+
+void InputEventMerger::beginRead(size_t lane)
+{
+    m_lanes[lane]->busy.store(true, std::memory_order_seq_cst);
+}
+
+void InputEventMerger::push(size_t laneIndex, const KeyEvent& event)
+{
+    Lane& lane = *m_lanes[laneIndex];
+    const uint64_t tail = lane.tail.load(std::memory_order_relaxed);
+    while (tail - lane.head.load(std::memory_order_acquire) >= LANE_CAPACITY) {
+        if (!m_running) return;
+        wake();
+        std::this_thread::yield();
+    }
+    lane.ring[tail % LANE_CAPACITY] = event;
+    lane.tail.store(tail + 1, std::memory_order_release);
+}
+
+void InputEventMerger::endRead(size_t laneIndex, uint64_t caughtUpUs)
+{
+    Lane& lane = *m_lanes[laneIndex];
+    lane.caughtUpUs.store(caughtUpUs, std::memory_order_release);
+    lane.busy.store(false, std::memory_order_seq_cst);
+    wake();
+}
+
+void InputEventMerger::closeLane(size_t laneIndex)
+{
+    Lane& lane = *m_lanes[laneIndex];
+    lane.closed.store(true, std::memory_order_release);
+    lane.busy.store(false, std::memory_order_seq_cst);
+    wake();
+}
+
+InputEventMerger::Stats InputEventMerger::stats() const
+{
+    Stats stats;
+    stats.merged = m_merged.load(std::memory_order_relaxed);
+    stats.reordered = m_reordered.load(std::memory_order_relaxed);
+    stats.late = m_late.load(std::memory_order_relaxed);
+    stats.expired = m_expired.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void InputEventMerger::wake()
+{
+    if (m_wakeFd >= 0) {
+        const uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void InputEventMerger::run()
+{
+    while (!m_stopRequested) {
+        collect();
+        const uint64_t deadline = release();
+
+        uint64_t timeoutUs = IDLE_TIMEOUT_US;
+        if (deadline != 0) {
+            const uint64_t now = nowUs();
+            timeoutUs = deadline > now ? deadline - now : 0;
+        }
+        timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(timeoutUs / 1000000ULL);
+        timeout.tv_nsec = static_cast<long>(timeoutUs % 1000000ULL) * 1000L;
+
+        pollfd pfd{m_wakeFd, POLLIN, 0};
+        if (ppoll(&pfd, 1, &timeout, nullptr) > 0 && (pfd.revents & POLLIN)) {
+            uint64_t count;
+            ssize_t bytes = read(m_wakeFd, &count, sizeof(count));
+            (void)bytes;
+        }
+    }
+
+    // Readers are stopped first; whatever they queued goes out in order
+    collect();
+    while (!m_pending.empty()) {
+        std::pop_heap(m_pending.begin(), m_pending.end(), isLater);
+        const Pending pending = m_pending.back();
+        m_pending.pop_back();
+        deliver(pending);
+    }
+
+    const Stats totals = stats();
+    PLATFORM_LOG_INFO("input", "Merged %llu event(s): %llu reordered, %llu late, %llu expired",
+                      static_cast<unsigned long long>(totals.merged),
+                      static_cast<unsigned long long>(totals.reordered),
+                      static_cast<unsigned long long>(totals.late),
+                      static_cast<unsigned long long>(totals.expired));
+}
+
+void InputEventMerger::collect()
+{
+    for (const auto& lanePtr : m_lanes) {
+        Lane& lane = *lanePtr;
+        uint64_t head = lane.head.load(std::memory_order_relaxed);
+        const uint64_t tail = lane.tail.load(std::memory_order_acquire);
+        if (head == tail) continue;
+
+        for (; head != tail; ++head) {
+            Pending pending{lane.ring[head % LANE_CAPACITY], m_intake++};
+            if (m_hasDelivered && pending.event.timestampUs < m_lastDeliveredUs) {
+                ++m_late;
+            }
+            m_pending.push_back(pending);
+            std::push_heap(m_pending.begin(), m_pending.end(), isLater);
+        }
+        lane.head.store(head, std::memory_order_release);
+    }
+}
+
+uint64_t InputEventMerger::laneFloor(Lane& lane, uint64_t oldestPending)
+{
+    if (lane.closed.load(std::memory_order_acquire)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const uint64_t caughtUp = lane.caughtUpUs.load(std::memory_order_acquire);
+    if (caughtUp >= oldestPending) {
+        return caughtUp;
+    }
+
+    // The reader may be idle in poll(): if the device has nothing waiting
+    // and the reader is not holding events it read, the lane is current
+    const uint64_t probeUs = nowUs();
+    pollfd pfd{lane.fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        return caughtUp;
+    }
+    if (lane.busy.load(std::memory_order_seq_cst)) {
+        return caughtUp;
+    }
+    return probeUs;
+}
+
+uint64_t InputEventMerger::release()
+{
+    while (!m_pending.empty()) {
+        const uint64_t oldest = m_pending.front().event.timestampUs;
+        uint64_t floor = std::numeric_limits<uint64_t>::max();
+        for (const auto& lane : m_lanes) {
+            floor = std::min(floor, laneFloor(*lane, oldest));
+        }
+        // Events the floors vouch for were pushed before the floors were read
+        collect();
+
+        const uint64_t now = nowUs();
+        bool delivered = false;
+        while (!m_pending.empty()) {
+            const uint64_t timeUs = m_pending.front().event.timestampUs;
+            const bool isSafe = timeUs <= floor;
+            if (!isSafe && timeUs + m_windowUs > now) {
+                break;
+            }
+            if (!isSafe) {
+                ++m_expired;
+            }
+            std::pop_heap(m_pending.begin(), m_pending.end(), isLater);
+            const Pending pending = m_pending.back();
+            m_pending.pop_back();
+            deliver(pending);
+            delivered = true;
+        }
+        if (!delivered) {
+            return m_pending.front().event.timestampUs + m_windowUs;
+        }
+    }
+    return 0;
+}
+
+void InputEventMerger::deliver(const Pending& pending)
+{
+    if (m_hasDelivered && pending.intake < m_maxDeliveredIntake) {
+        ++m_reordered;
+    }
+    m_maxDeliveredIntake = std::max(m_maxDeliveredIntake, pending.intake);
+    m_lastDeliveredUs = std::max(m_lastDeliveredUs, pending.event.timestampUs);
+    m_hasDelivered = true;
+    ++m_merged;
+
+    if (!m_callback) return;
+    try {
+        m_callback(pending.event);
+    } catch (const std::exception& e) {
+        PLATFORM_LOG_ERROR("input", "Callback exception: %s", e.what());
+    }
+}
+
+} // namespace yamy::platform
@@ -0,0 +1,126 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// input_event_merger.h - kernel-timestamp order across keyboards
+//
+// With several keyboards, each EventReaderThread used to call the engine on
+// its own; under scheduling jitter a key from one device could enter the
+// engine queue ahead of an earlier key from another, breaking chords and
+// modifier+key across devices. The merger gives each reader a lane (a
+// single-producer ring) and delivers from one merge thread in
+// input_event.time order.
+//
+// An event is delivered once no lane can still produce an older one. A
+// reader publishes a watermark after each read() that returns EAGAIN: every
+// event stamped before the read is in its ring. An idle lane's watermark
+// is refreshed by polling its fd from the merge thread. A lane that stays
+// behind (its reader not scheduled) holds events back for at most the
+// reorder window. No lock is shared between readers.
+
+#include "../../core/platform/input_hook_interface.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace yamy::platform {
+
+class InputEventMerger {
+public:
+    static constexpr uint64_t DEFAULT_WINDOW_US = 2000;
+    static constexpr size_t LANE_CAPACITY = 256;    ///< Events per lane, power of two
+
+    struct Stats {
+        uint64_t merged = 0;      ///< Events delivered
+        uint64_t reordered = 0;   ///< Delivered after an event that reached the merger later
+        uint64_t late = 0;        ///< Older than an event already delivered
+        uint64_t expired = 0;     ///< Released by the window while a lane lagged
+    };
+
+    /**
+     * @param callback Receives every event, on the merge thread
+     * @param windowUs Longest an event waits for a lagging lane
+     */
+    explicit InputEventMerger(KeyCallback callback, uint64_t windowUs = DEFAULT_WINDOW_US);
+    ~InputEventMerger();
+
+    InputEventMerger(const InputEventMerger&) = delete;
+    InputEventMerger& operator=(const InputEventMerger&) = delete;
+
+    /// Add a lane for a device stamping events with CLOCK_MONOTONIC; before start()
+    size_t addLane(int fd);
+    size_t laneCount() const { return m_lanes.size(); }
+
+    bool start();
+    /// Deliver what is queued and join the merge thread
+    void stop();
+
+    // Lane side: called by the lane's reader thread only
+
+    /// The reader is about to read; its watermark is no longer current
+    void beginRead(size_t lane);
+    /// Queue an event; waits for room if the lane is full
+    void push(size_t lane, const KeyEvent& event);
+    /// Everything stamped before caughtUpUs has been pushed
+    void endRead(size_t lane, uint64_t caughtUpUs);
+    /// The device is gone; the lane no longer holds others back
+    void closeLane(size_t lane);
+
+    Stats stats() const;
+
+    /// CLOCK_MONOTONIC in microseconds, the time base of KeyEvent::timestampUs
+    static uint64_t nowUs();
+
+private:
+    struct Lane {
+        int fd = -1;
+        std::array<KeyEvent, LANE_CAPACITY> ring;
+        alignas(64) std::atomic<uint64_t> head{0};      ///< Merge thread
+        alignas(64) std::atomic<uint64_t> tail{0};      ///< Reader thread
+        std::atomic<uint64_t> caughtUpUs{0};
+        std::atomic<bool> busy{false};
+        std::atomic<bool> closed{false};
+    };
+
+    struct Pending {
+        KeyEvent event;
+        uint64_t intake;        ///< Order of arrival at the merger
+    };
+
+    /// Heap order: oldest timestamp first, then order of arrival
+    static bool isLater(const Pending& a, const Pending& b);
+
+    void run();
+    /// Move queued events from the lanes into m_pending
+    void collect();
+    /// Oldest timestamp a lane may still produce
+    uint64_t laneFloor(Lane& lane, uint64_t oldestPending);
+    /// Deliver what is safe; returns when the oldest held event expires (0 if none)
+    uint64_t release();
+    void deliver(const Pending& pending);
+    void wake();
+
+    KeyCallback m_callback;
+    uint64_t m_windowUs;
+    std::vector<std::unique_ptr<Lane>> m_lanes;
+    int m_wakeFd;               ///< eventfd the readers signal
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_stopRequested;
+
+    // Merge thread only
+    std::vector<Pending> m_pending;     ///< Min-heap on timestamp
+    uint64_t m_intake = 0;
+    uint64_t m_maxDeliveredIntake = 0;
+    uint64_t m_lastDeliveredUs = 0;
+    bool m_hasDelivered = false;
+
+    std::atomic<uint64_t> m_merged{0};
+    std::atomic<uint64_t> m_reordered{0};
+    std::atomic<uint64_t> m_late{0};
+    std::atomic<uint64_t> m_expired{0};
+};
+
+} // namespace yamy::platform
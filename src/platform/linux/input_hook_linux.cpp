@@ -6,9 +6,11 @@
 #include "core/platform/platform_exception.h"
 #include "../../utils/platform_logger.h"
 #include "../../utils/metrics.h"
+#include "../../utils/startup_profiler.h"
 #include "../../core/logger/journey_logger.h"
 #include <iostream>
 #include <linux/input.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -16,7 +18,12 @@
 #include <cstring>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <memory>
 #include <mutex>
 
@@ -26,6 +33,36 @@ namespace yamy::platform {
 // EventReaderThread Implementation
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+namespace {
+
+/// Poll timeout, so stop() is noticed on an idle keyboard
+constexpr int POLL_TIMEOUT_MS = 100;
+
+/// Call the engine with one key event and record the hook latency
+void dispatchKeyEvent(const KeyCallback& callback, const KeyEvent& event, const std::string& source)
+{
+    if (!callback) {
+        return;
+    }
+    std::cerr << "[EVENT] Read from " << source << ": scancode=0x" << std::hex << event.scanCode << std::dec
+              << " " << (event.isKeyDown ? "DOWN" : "UP") << std::endl;
+    auto callbackStart = std::chrono::high_resolution_clock::now();
+    try {
+        bool blocked = callback(event);
+        std::cerr << "[EVENT] Callback returned " << (blocked ? "BLOCK" : "PASS") << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[EVENT] Callback exception: " << e.what() << std::endl;
+        PLATFORM_LOG_ERROR("input", "Callback exception: %s", e.what());
+    }
+    auto callbackEnd = std::chrono::high_resolution_clock::now();
+    auto durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        callbackEnd - callbackStart).count();
+    yamy::metrics::PerformanceMetrics::instance().recordLatency(
+        yamy::metrics::Operations::HOOK_CALLBACK, static_cast<uint64_t>(durationNs));
+}
+
+} // namespace
+
 EventReaderThread::EventReaderThread(int fd, const std::string& devNode, KeyCallback callback)
     : m_fd(fd)
     , m_devNode(devNode)
@@ -40,6 +77,12 @@ EventReaderThread::~EventReaderThread()
     stop();
 }
 
+void EventReaderThread::setMerger(InputEventMerger* merger, size_t lane)
+{
+    m_merger = merger;
+    m_lane = lane;
+}
+
 bool EventReaderThread::start()
 {
     if (m_running) return true;
@@ -66,136 +109,287 @@ void EventReaderThread::run()
     std::cerr << "[READER_THREAD] *** RUN() STARTED for " << m_devNode << " ***" << std::endl;
     PLATFORM_LOG_INFO("input", "Started reading from %s", m_devNode.c_str());
 
-    struct input_event ev;
+    // The read loop drains the device until EAGAIN
+    const int fdFlags = fcntl(m_fd, F_GETFL);
+    if (fdFlags >= 0 && !(fdFlags & O_NONBLOCK)) {
+        fcntl(m_fd, F_SETFL, fdFlags | O_NONBLOCK);
+    }
 
-    while (!m_stopRequested) {
-        ssize_t bytes = read(m_fd, &ev, sizeof(ev));
+    input_event events[READ_BATCH];
+    bool isOpen = true;
 
-        if (bytes < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                // No data available, sleep briefly
-                usleep(10000); // 10ms
-                continue;
-            }
-            if (errno == ENODEV) {
-                // Device disconnected
-                PLATFORM_LOG_WARN("input", "Device %s disconnected", m_devNode.c_str());
-                break;
-            }
-            // Other error
-            PLATFORM_LOG_ERROR("input", "Read error on %s: %s", m_devNode.c_str(), strerror(errno));
+    while (isOpen && !m_stopRequested) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, POLL_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            PLATFORM_LOG_ERROR("input", "Poll error on %s: %s", m_devNode.c_str(), strerror(errno));
             break;
         }
-
-        if (bytes != sizeof(ev)) {
-            // Incomplete read
-            continue;
-        }
-
-        // Process only key events
-        if (ev.type != EV_KEY) {
+        if (ready == 0) {
             continue;
         }
 
-        // Filter out buttons (mouse buttons are also EV_KEY)
-        // Mouse buttons are BTN_LEFT (0x110), BTN_RIGHT (0x111), etc.
-        // Keyboard keys are KEY_ESC (1), KEY_A (30), etc.
-        if (ev.code >= BTN_MISC && ev.code < KEY_OK) {
-            // This is a button, not a keyboard key
-            continue;
+        if (m_merger) {
+            m_merger->beginRead(m_lane);
         }
 
-        // Convert evdev code to YAMY code
-        uint16_t yamyCode = evdevToYamyKeyCode(ev.code, ev.value);
-        if (yamyCode == 0) {
-            // Unknown key, skip
-            continue;
-        }
+        // Drain the device: a read that comes back empty shows every event
+        // stamped before it has been seen, which is the merger's watermark
+        while (true) {
+            const uint64_t readStartUs = InputEventMerger::nowUs();
+            ssize_t bytes = read(m_fd, events, sizeof(events));
+
+            if (bytes < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (m_merger) {
+                        m_merger->endRead(m_lane, readStartUs);
+                    }
+                    break;
+                }
+                if (errno == ENODEV) {
+                    // Device disconnected
+                    PLATFORM_LOG_WARN("input", "Device %s disconnected", m_devNode.c_str());
+                } else {
+                    PLATFORM_LOG_ERROR("input", "Read error on %s: %s", m_devNode.c_str(), strerror(errno));
+                }
+                isOpen = false;
+                break;
+            }
+            if (bytes == 0) {
+                isOpen = false;
+                break;
+            }
 
-        // Create KeyEvent
-        KeyEvent event;
-        event.key = KeyCode::Unknown; // We use scanCode primarily
-        event.scanCode = yamyCode;
-        event.isKeyDown = (ev.value == 1 || ev.value == 2); // 1=press, 2=repeat, 0=release
-        event.isExtended = false; // evdev doesn't use extended scancodes
-        event.timestamp = ev.time.tv_sec * 1000 + ev.time.tv_usec / 1000; // Convert to ms
-        event.flags = 0;
-        if (ev.value == 0) {
-            event.flags |= 1; // Mark as key up
-        }
-        event.extraInfo = 0;
-
-        // Log key event (scancode only, no sensitive info)
-        PLATFORM_LOG_DEBUG("input", "Key event: scancode=0x%04x %s",
-                           yamyCode, event.isKeyDown ? "DOWN" : "UP");
-
-        // Call callback with timing
-        if (m_callback) {
-            std::cerr << "[EVENT] Read from " << m_devNode << ": scancode=0x" << std::hex << yamyCode << std::dec
-                      << " " << (event.isKeyDown ? "DOWN" : "UP") << std::endl;
-            auto callbackStart = std::chrono::high_resolution_clock::now();
-            try {
-                bool blocked = m_callback(event);
-                std::cerr << "[EVENT] Callback returned " << (blocked ? "BLOCK" : "PASS") << std::endl;
-            } catch (const std::exception& e) {
-                std::cerr << "[EVENT] Callback exception: " << e.what() << std::endl;
-                PLATFORM_LOG_ERROR("input", "Callback exception: %s", e.what());
+            const size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+            for (size_t i = 0; i < count; ++i) {
+                processEvent(events[i]);
             }
-            auto callbackEnd = std::chrono::high_resolution_clock::now();
-            auto durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                callbackEnd - callbackStart).count();
-            yamy::metrics::PerformanceMetrics::instance().recordLatency(
-                yamy::metrics::Operations::HOOK_CALLBACK, static_cast<uint64_t>(durationNs));
         }
     }
 
+    if (m_merger) {
+        m_merger->closeLane(m_lane);
+    }
     PLATFORM_LOG_INFO("input", "Stopped reading from %s", m_devNode.c_str());
 }
 
+void EventReaderThread::processEvent(const input_event& ev)
+{
+    // Process only key events
+    if (ev.type != EV_KEY) {
+        return;
+    }
+
+    // Filter out buttons (mouse buttons are also EV_KEY)
+    // Mouse buttons are BTN_LEFT (0x110), BTN_RIGHT (0x111), etc.
+    // Keyboard keys are KEY_ESC (1), KEY_A (30), etc.
+    if (ev.code >= BTN_MISC && ev.code < KEY_OK) {
+        // This is a button, not a keyboard key
+        return;
+    }
+
+    // Convert evdev code to YAMY code
+    uint16_t yamyCode = evdevToYamyKeyCode(ev.code, ev.value);
+    if (yamyCode == 0) {
+        // Unknown key, skip
+        return;
+    }
+
+    // Create KeyEvent
+    KeyEvent event;
+    event.key = KeyCode::Unknown; // We use scanCode primarily
+    event.scanCode = yamyCode;
+    event.isKeyDown = (ev.value == 1 || ev.value == 2); // 1=press, 2=repeat, 0=release
+    event.isAutoRepeat = (ev.value == 2);
+    event.isExtended = false; // evdev doesn't use extended scancodes
+    event.timestamp = ev.time.tv_sec * 1000 + ev.time.tv_usec / 1000; // Convert to ms
+    event.timestampUs = static_cast<uint64_t>(ev.time.tv_sec) * 1000000ULL +
+                        static_cast<uint64_t>(ev.time.tv_usec); // Engine clock source
+    event.flags = 0;
+    if (ev.value == 0) {
+        event.flags |= 1; // Mark as key up
+    }
+    event.extraInfo = 0;
+
+    // Log key event (scancode only, no sensitive info)
+    PLATFORM_LOG_DEBUG("input", "Key event: scancode=0x%04x %s",
+                       yamyCode, event.isKeyDown ? "DOWN" : "UP");
+
+    if (m_merger) {
+        m_merger->push(m_lane, event);
+    } else {
+        dispatchKeyEvent(m_callback, event, m_devNode);
+    }
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // InputHookLinux Implementation
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+namespace {
+
+/// Keyboards grabbed in exclusive mode, as fd + 1 (0 is a free slot).
+/// Plain atomics so releaseGrabs() can run in a signal handler.
+constexpr size_t MAX_GRABBED_KEYBOARDS = 32;
+std::array<std::atomic<int>, MAX_GRABBED_KEYBOARDS> g_grabbedKeyboards;
+
+/// Longest wait for held keys to come up before a keyboard is grabbed
+constexpr int GRAB_SETTLE_TIMEOUT_MS = 1000;
+
+bool registerGrab(int fd)
+{
+    for (auto& slot : g_grabbedKeyboards) {
+        int freeSlot = 0;
+        if (slot.compare_exchange_strong(freeSlot, fd + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void unregisterGrab(int fd)
+{
+    for (auto& slot : g_grabbedKeyboards) {
+        int expected = fd + 1;
+        if (slot.compare_exchange_strong(expected, 0)) {
+            return;
+        }
+    }
+}
+
+/// Wait for every key on the device to be up. A key held while the grab
+/// starts would never be released as far as the desktop can tell.
+bool waitForKeysReleased(int fd)
+{
+    unsigned char keys[KEY_MAX / 8 + 1];
+    for (int waitedMs = 0; ; waitedMs += 10) {
+        std::memset(keys, 0, sizeof(keys));
+        if (ioctl(fd, EVIOCGKEY(sizeof(keys)), keys) < 0) {
+            return true;    // Key state unknown; nothing to wait for
+        }
+        if (std::all_of(std::begin(keys), std::end(keys), [](unsigned char bits) { return bits == 0; })) {
+            return true;
+        }
+        if (waitedMs >= GRAB_SETTLE_TIMEOUT_MS) {
+            return false;
+        }
+        usleep(10000);
+    }
+}
+
+/// Grab a keyboard for exclusive mode; false leaves it shared
+bool grabKeyboard(int fd, const std::string& devNode)
+{
+    if (!waitForKeysReleased(fd)) {
+        PLATFORM_LOG_WARN("input", "Keys still held on %s; not grabbing it", devNode.c_str());
+        return false;
+    }
+    if (!DeviceManager::grabDevice(fd, true)) {
+        PLATFORM_LOG_WARN("input", "Cannot grab %s; sharing it with the desktop", devNode.c_str());
+        return false;
+    }
+    if (!registerGrab(fd)) {
+        PLATFORM_LOG_WARN("input", "Too many grabbed keyboards; sharing %s", devNode.c_str());
+        DeviceManager::grabDevice(fd, false);
+        return false;
+    }
+    return true;
+}
+
+/// A keyboard opened on a worker thread; fd is -1 if it could not be opened
+struct OpenedKeyboard {
+    int fd = -1;
+    bool hasMonotonicClock = false;
+    bool grabbed = false;
+};
+
+/// Open one keyboard and prepare it for its reader. Runs alongside the
+/// other keyboards; its time shows in the startup trace as "device_open:<node>".
+OpenedKeyboard openKeyboard(const InputDeviceInfo& kbInfo, bool isExclusive)
+{
+    yamy::metrics::StartupProfiler& profiler = yamy::metrics::StartupProfiler::instance();
+    const uint64_t startUs = profiler.nowUs();
+    const uint64_t startCpuUs = yamy::metrics::StartupProfiler::threadCpuUs();
+
+    OpenedKeyboard opened;
+    PLATFORM_LOG_INFO("input", "Opening: %s (%s)", kbInfo.devNode.c_str(), kbInfo.name.c_str());
+
+    // Open device; the reader polls and drains it until EAGAIN
+    opened.fd = DeviceManager::openDevice(kbInfo.devNode, true);
+    if (opened.fd < 0) {
+        PLATFORM_LOG_WARN("input", "Failed to open %s", kbInfo.devNode.c_str());
+    } else {
+        // Stamp events with CLOCK_MONOTONIC so kernel timestamps share the
+        // engine clock's time base (steady_clock) instead of wall time.
+        int clockId = CLOCK_MONOTONIC;
+        opened.hasMonotonicClock = ioctl(opened.fd, EVIOCSCLOCKID, &clockId) >= 0;
+        if (!opened.hasMonotonicClock) {
+            PLATFORM_LOG_WARN("input", "EVIOCSCLOCKID failed on %s: %s",
+                              kbInfo.devNode.c_str(), strerror(errno));
+        }
+        // By default the device is shared and the desktop sees its keys too.
+        // A grab hides them from everyone but this fd; only the output device
+        // then reaches the desktop, so it is opt-in and watched.
+        if (isExclusive) {
+            opened.grabbed = grabKeyboard(opened.fd, kbInfo.devNode);
+        }
+        PLATFORM_LOG_INFO("input", "Opened %s for event reading%s", kbInfo.devNode.c_str(),
+                          opened.grabbed ? " (grabbed)" : "");
+    }
+
+    const uint64_t endCpuUs = yamy::metrics::StartupProfiler::threadCpuUs();
+    profiler.record(("device_open:" + kbInfo.devNode).c_str(), startUs, profiler.nowUs() - startUs,
+                    endCpuUs >= startCpuUs ? endCpuUs - startCpuUs : 0);
+    return opened;
+}
+
+} // namespace
+
 InputHookLinux::InputHookLinux()
     : m_isInstalled(false)
+    , m_watchdog(&InputHookLinux::releaseGrabs)
 {
 }
 
+void InputHookLinux::releaseGrabs()
+{
+    for (auto& slot : g_grabbedKeyboards) {
+        const int fdPlusOne = slot.exchange(0);
+        if (fdPlusOne > 0) {
+            ioctl(fdPlusOne - 1, EVIOCGRAB, 0);
+        }
+    }
+}
+
 InputHookLinux::~InputHookLinux()
 {
     uninstall();
 }
 
-// Helper function to extract device hardware info
-static yamy::logger::DeviceInfo extractDeviceInfo(int fd, const std::string& devNode, const std::string& name)
+// Device hardware info for journey logging, from the cached capabilities
+static yamy::logger::DeviceInfo extractDeviceInfo(const InputDeviceInfo& device)
 {
     yamy::logger::DeviceInfo info;
-    info.path = devNode;
-    info.name = name;
+    info.path = device.devNode;
+    info.name = device.name;
 
     // Extract event number from path (e.g., /dev/input/event3 -> 3)
-    size_t pos = devNode.rfind("event");
+    size_t pos = device.devNode.rfind("event");
     if (pos != std::string::npos) {
         try {
-            info.event_number = std::stoi(devNode.substr(pos + 5));
+            info.event_number = std::stoi(device.devNode.substr(pos + 5));
         } catch (...) {
             info.event_number = -1;
         }
     }
 
-    // Get device ID (vendor/product)
-    struct input_id id;
-    if (ioctl(fd, EVIOCGID, &id) >= 0) {
-        info.vendor_id = id.vendor;
-        info.product_id = id.product;
-    }
-
-    // Try to get serial number (if available)
-    char serial[256] = {0};
-    if (ioctl(fd, EVIOCGUNIQ(sizeof(serial)), serial) >= 0) {
-        info.serial = std::string(serial);
-    }
-
+    info.vendor_id = device.caps.vendor;
+    info.product_id = device.caps.product;
+    info.serial = device.caps.serial;
     return info;
 }
 
@@ -248,9 +442,19 @@ bool InputHookLinux::install(KeyCallback keyCallback, MouseCallback mouseCallbac
     m_keyCallback = keyCallback;
     m_mouseCallback = mouseCallback;
 
+    // Exclusive mode: keyboards are grabbed. The watchdog hears of a key only
+    // when the engine queues it (inputQueued()): keys the engine drops, such
+    // as kernel repeats under engine autorepeat, never wake the engine thread
+    const char* exclusiveGrab = std::getenv(EXCLUSIVE_GRAB_ENV);
+    const bool isExclusive = keyCallback && exclusiveGrab && std::strcmp(exclusiveGrab, "0") != 0;
+
     std::cerr << "[DEBUG] About to call m_deviceManager.enumerateKeyboards()..." << std::endl;
     // Enumerate keyboard devices
-    std::vector<InputDeviceInfo> keyboards = m_deviceManager.enumerateKeyboards();
+    std::vector<InputDeviceInfo> keyboards;
+    {
+        STARTUP_PHASE("device_enumerate");
+        keyboards = m_deviceManager.enumerateKeyboards();
+    }
     std::cerr << "[DEBUG] enumerateKeyboards() returned " << keyboards.size() << " keyboards" << std::endl;
 
     if (keyboards.empty()) {
@@ -265,16 +469,18 @@ bool InputHookLinux::install(KeyCallback keyCallback, MouseCallback mouseCallbac
     // Track grab failures for better error reporting
     int openFailures = 0;
     int grabFailures = 0;
+    int grabbedKeyboards = 0;
     std::string lastGrabError;
 
     // Collect device info for journey logging
     std::vector<yamy::logger::DeviceInfo> deviceInfoList;
 
-    // Open and grab each keyboard
-    std::cerr << "[DEBUG] Starting keyboard grab loop..." << std::endl;
+    // Readers whose events carry CLOCK_MONOTONIC time and can be merged
+    std::vector<bool> monotonic;
+
+    // Skip devices we should never grab
+    std::vector<const InputDeviceInfo*> candidates;
     for (const auto& kbInfo : keyboards) {
-        std::cerr << "[DEBUG] Processing keyboard: " << kbInfo.devNode << " (" << kbInfo.name << ")" << std::endl;
-        // Skip devices we should never grab
         if (kbInfo.name.find("Yamy Remapped Output Device") != std::string::npos || // Skip Yamy's own output
             kbInfo.name.find("mouse-button-passthrough") != std::string::npos ||
             kbInfo.name.find("Mouse") != std::string::npos ||
@@ -285,50 +491,54 @@ bool InputHookLinux::install(KeyCallback keyCallback, MouseCallback mouseCallbac
                               kbInfo.devNode.c_str(), kbInfo.name.c_str());
             continue;
         }
+        candidates.push_back(&kbInfo);
+    }
 
-        std::cerr << "[DEBUG] Attempting to open: " << kbInfo.devNode << std::endl;
-        PLATFORM_LOG_INFO("input", "Opening: %s (%s)", kbInfo.devNode.c_str(), kbInfo.name.c_str());
-
-        // Open device
-        int fd = DeviceManager::openDevice(kbInfo.devNode, false); // Blocking mode for read
-        std::cerr << "[DEBUG] openDevice() returned fd=" << fd << std::endl;
-        if (fd < 0) {
-            std::cerr << "[DEBUG] Failed to open device, errno=" << errno << " (" << strerror(errno) << ")" << std::endl;
-            PLATFORM_LOG_WARN("input", "Failed to open %s", kbInfo.devNode.c_str());
+    // Open the keyboards side by side: an open can block, and a grab waits
+    // for held keys to come up. Readers are then created in device order.
+    PLATFORM_LOG_INFO("input", "Opening %zu keyboard(s)", candidates.size());
+    std::vector<OpenedKeyboard> opened(candidates.size());
+    DeviceManager::forEachParallel(candidates.size(), [&](size_t i) {
+        opened[i] = openKeyboard(*candidates[i], isExclusive);
+    });
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const InputDeviceInfo& kbInfo = *candidates[i];
+        if (opened[i].fd < 0) {
             openFailures++;
             continue;
         }
-
-        std::cerr << "[DEBUG] Device opened successfully (fd=" << fd << ")" << std::endl;
-        // NOTE: We DON'T grab the device because EVIOCGRAB in Linux blocks ALL events,
-        // even to the grabbing process! Instead, we read events and suppress originals
-        // by not re-injecting them. This is the correct Linux evdev approach.
-        PLATFORM_LOG_INFO("input", "Opened %s for event reading", kbInfo.devNode.c_str());
+        if (isExclusive) {
+            if (opened[i].grabbed) {
+                grabbedKeyboards++;
+            } else {
+                grabFailures++;
+                lastGrabError = "Cannot grab " + kbInfo.devNode;
+            }
+        }
 
         // Store device
         OpenDevice dev;
-        dev.fd = fd;
+        dev.fd = opened[i].fd;
         dev.devNode = kbInfo.devNode;
         dev.name = kbInfo.name;
-        dev.grabbed = false;  // Not grabbed - we read events without exclusive access
+        dev.grabbed = opened[i].grabbed;
         m_openDevices.push_back(dev);
 
         std::cerr << "[DEBUG] Creating reader thread for " << kbInfo.devNode << std::endl;
-        // Create reader thread
-        auto reader = std::make_unique<EventReaderThread>(fd, kbInfo.devNode, m_keyCallback);
-        if (!reader->start()) {
-            std::cerr << "[DEBUG] Failed to start reader thread!" << std::endl;
-            PLATFORM_LOG_WARN("input", "Failed to start reader thread for %s", kbInfo.devNode.c_str());
-            continue;
-        }
+        // Create reader thread; started once the merger is set up
+        m_readerThreads.push_back(std::make_unique<EventReaderThread>(dev.fd, kbInfo.devNode, m_keyCallback));
+        monotonic.push_back(opened[i].hasMonotonicClock);
 
-        std::cerr << "[DEBUG] Reader thread started successfully for " << kbInfo.devNode << std::endl;
-        m_readerThreads.push_back(std::move(reader));
-        PLATFORM_LOG_INFO("input", "Successfully hooked %s", kbInfo.devNode.c_str());
+        // Store device info for journey logging
+        deviceInfoList.push_back(extractDeviceInfo(kbInfo));
+    }
 
-        // Extract and store device info for journey logging
-        yamy::logger::DeviceInfo devInfo = extractDeviceInfo(fd, kbInfo.devNode, kbInfo.name);
-        deviceInfoList.push_back(devInfo);
+    installMerger(monotonic);
+    for (auto& reader : m_readerThreads) {
+        reader->start();
+        std::cerr << "[DEBUG] Reader thread started successfully for " << reader->getDevNode() << std::endl;
+        PLATFORM_LOG_INFO("input", "Successfully hooked %s", reader->getDevNode().c_str());
     }
 
     if (m_readerThreads.empty()) {
@@ -346,6 +556,24 @@ bool InputHookLinux::install(KeyCallback keyCallback, MouseCallback mouseCallbac
         }
     }
 
+    if (grabbedKeyboards > 0) {
+        std::chrono::milliseconds stallThreshold = GrabWatchdog::DEFAULT_STALL_THRESHOLD;
+        if (const char* stall = std::getenv(GRAB_STALL_ENV)) {
+            stallThreshold = std::chrono::milliseconds(std::strtoull(stall, nullptr, 10));
+        }
+        m_watchdog.start(stallThreshold);
+        PLATFORM_LOG_INFO("input", "Exclusive mode: %d keyboard(s) grabbed, released if the "
+                          "engine stalls for %lld ms", grabbedKeyboards,
+                          static_cast<long long>(stallThreshold.count()));
+    }
+
+    // Mice are left alone unless asked for: grabbing them takes the pointer
+    // away from the desktop until YAMY forwards it
+    const char* mouseRemap = std::getenv(MOUSE_REMAP_ENV);
+    if (m_mouseCallback && mouseRemap && std::strcmp(mouseRemap, "0") != 0) {
+        installMice(deviceInfoList);
+    }
+
     m_isInstalled = true;
     std::cerr << "[DEBUG] InputHook installation complete! " << m_readerThreads.size() << " reader threads active" << std::endl;
     PLATFORM_LOG_INFO("input", "Input hook installed successfully (%zu device(s) active)", m_readerThreads.size());
@@ -362,6 +590,104 @@ bool InputHookLinux::install(KeyCallback keyCallback, MouseCallback mouseCallbac
     return true;
 }
 
+void InputHookLinux::installMerger(const std::vector<bool>& monotonic)
+{
+    uint64_t windowUs = InputEventMerger::DEFAULT_WINDOW_US;
+    if (const char* window = std::getenv(MERGE_WINDOW_ENV)) {
+        windowUs = std::strtoull(window, nullptr, 10);
+    }
+
+    // One keyboard is in order already; only merge when there is something to merge
+    const size_t mergeable = static_cast<size_t>(std::count(monotonic.begin(), monotonic.end(), true));
+    if (windowUs == 0 || mergeable < 2) {
+        return;
+    }
+
+    m_merger = std::make_unique<InputEventMerger>(
+        [this](const KeyEvent& event) {
+            dispatchKeyEvent(m_keyCallback, event, "merged keyboards");
+            return false;
+        },
+        windowUs);
+    for (size_t i = 0; i < m_readerThreads.size(); ++i) {
+        if (monotonic[i]) {
+            m_readerThreads[i]->setMerger(m_merger.get(), m_merger->addLane(m_readerThreads[i]->getFd()));
+        }
+    }
+    if (!m_merger->start()) {
+        PLATFORM_LOG_WARN("input", "Cannot start the keyboard merge; keyboards call back unordered");
+        for (auto& reader : m_readerThreads) {
+            reader->setMerger(nullptr, 0);
+        }
+        m_merger.reset();
+        return;
+    }
+    PLATFORM_LOG_INFO("input", "Merging %zu keyboards by event time (window %llu us)",
+                      mergeable, static_cast<unsigned long long>(windowUs));
+}
+
+InputEventMerger::Stats InputHookLinux::mergeStats() const
+{
+    std::lock_guard<std::mutex> lock(m_readerThreadsMutex);
+    return m_merger ? m_merger->stats() : InputEventMerger::Stats();
+}
+
+void InputHookLinux::installMice(std::vector<yamy::logger::DeviceInfo>& deviceInfoList)
+{
+    for (const auto& mouseInfo : m_deviceManager.enumerateMice()) {
+        // Our own output device has mouse axes too; reading it would loop
+        if (mouseInfo.name.find("Yamy Remapped Output Device") != std::string::npos ||
+            mouseInfo.name.find("mouse-button-passthrough") != std::string::npos) {
+            continue;
+        }
+        // Combo devices (keyboards with a touchpad) report keys and motion on
+        // one node. The mouse reader forwards no keys, so grabbing the node
+        // here would starve its keyboard reader; the keyboard side keeps it.
+        const bool isOpenAsKeyboard = std::any_of(
+            m_openDevices.begin(), m_openDevices.end(),
+            [&mouseInfo](const OpenDevice& open) { return open.devNode == mouseInfo.devNode; });
+        if (isOpenAsKeyboard || mouseInfo.isKeyboard) {
+            PLATFORM_LOG_INFO("input", "Mouse lane skips %s (%s): it is read as a keyboard",
+                              mouseInfo.devNode.c_str(), mouseInfo.name.c_str());
+            continue;
+        }
+
+        int fd = DeviceManager::openDevice(mouseInfo.devNode, true);
+        if (fd < 0) {
+            PLATFORM_LOG_WARN("input", "Failed to open mouse %s", mouseInfo.devNode.c_str());
+            continue;
+        }
+        int clockId = CLOCK_MONOTONIC;
+        if (ioctl(fd, EVIOCSCLOCKID, &clockId) < 0) {
+            PLATFORM_LOG_WARN("input", "EVIOCSCLOCKID failed on %s: %s",
+                              mouseInfo.devNode.c_str(), strerror(errno));
+        }
+        // Motion is forwarded, so the original events must not reach the
+        // desktop as well; without the grab the pointer would move twice
+        if (!DeviceManager::grabDevice(fd, true)) {
+            PLATFORM_LOG_WARN("input", "Cannot grab mouse %s; leaving it alone",
+                              mouseInfo.devNode.c_str());
+            DeviceManager::closeDevice(fd);
+            continue;
+        }
+
+        OpenDevice dev;
+        dev.fd = fd;
+        dev.devNode = mouseInfo.devNode;
+        dev.name = mouseInfo.name;
+        dev.grabbed = true;
+        m_openDevices.push_back(dev);
+
+        auto reader = std::make_unique<MouseReaderThread>(fd, mouseInfo.devNode,
+                                                          m_keyCallback, m_mouseCallback);
+        reader->start();
+        m_mouseReaders.push_back(std::move(reader));
+        deviceInfoList.push_back(extractDeviceInfo(mouseInfo));
+        PLATFORM_LOG_INFO("input", "Mouse lane on %s (%s)",
+                          mouseInfo.devNode.c_str(), mouseInfo.name.c_str());
+    }
+}
+
 void InputHookLinux::uninstall()
 {
     if (!m_isInstalled) return;
@@ -380,15 +706,27 @@ void InputHookLinux::uninstall()
 void InputHookLinux::cleanup()
 {
     std::lock_guard<std::mutex> lock(m_readerThreadsMutex);
+    m_watchdog.stop();
     // Stop all reader threads
     for (auto& reader : m_readerThreads) {
         reader->stop();
     }
     m_readerThreads.clear();
+    // After the readers, so what they queued is still delivered
+    if (m_merger) {
+        m_merger->stop();
+        m_merger.reset();
+    }
+    for (auto& reader : m_mouseReaders) {
+        reader->stop();
+    }
+    m_mouseReaders.clear();
 
     // Close all devices
     for (const OpenDevice& dev : m_openDevices) {
         PLATFORM_LOG_DEBUG("input", "Closing %s", dev.devNode.c_str());
+        // Before close(): the fd number may be reused once it is closed
+        unregisterGrab(dev.fd);
         DeviceManager::closeDevice(dev.fd);
     }
     m_openDevices.clear();
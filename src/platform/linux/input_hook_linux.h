@@ -4,6 +4,11 @@
 
 #include "../../core/platform/input_hook_interface.h"
 #include "device_manager_linux.h"
+#include "mouse_reader_linux.h"
+#include "input_event_merger.h"
+#include "grab_watchdog.h"
+#include "../../core/logger/journey_logger.h"
+#include <linux/input.h>
 #include <vector>
 #include <thread>
 #include <mutex>
@@ -15,21 +20,31 @@ namespace yamy::platform {
 /// Event reader thread for a single device
 class EventReaderThread {
 public:
+    /// Events per read()
+    static constexpr size_t READ_BATCH = 64;
+
     EventReaderThread(int fd, const std::string& devNode, KeyCallback callback);
     ~EventReaderThread();
 
+    /// Queue events on a merger lane instead of calling back; before start()
+    void setMerger(InputEventMerger* merger, size_t lane);
+
     bool start();
     void stop();
     bool isRunning() const { return m_running; }
 
+    int getFd() const { return m_fd; }
     const std::string& getDevNode() const { return m_devNode; }
 
 private:
     void run();
+    void processEvent(const input_event& ev);
 
     int m_fd;
     std::string m_devNode;
     KeyCallback m_callback;
+    InputEventMerger* m_merger = nullptr;
+    size_t m_lane = 0;
     std::thread m_thread;
     std::atomic<bool> m_running;
     std::atomic<bool> m_stopRequested;
@@ -44,9 +59,42 @@ public:
     bool install(KeyCallback keyCallback, MouseCallback mouseCallback) override;
     void uninstall() override;
     bool isInstalled() const override { return m_isInstalled; }
+    void inputQueued() override {
+        if (m_watchdog.isRunning()) m_watchdog.inputDelivered();
+    }
+    void inputProcessed() override { m_watchdog.inputProcessed(); }
+
+    /// Environment variable that enables the mouse lane: mice are grabbed,
+    /// their buttons remapped and their motion forwarded through uinput
+    static constexpr const char* MOUSE_REMAP_ENV = "YAMY_MOUSE_REMAP";
+
+    /// Environment variable overriding the reorder window of the keyboard
+    /// merge, in microseconds; 0 lets every keyboard call back on its own
+    static constexpr const char* MERGE_WINDOW_ENV = "YAMY_INPUT_MERGE_WINDOW_US";
+
+    /// Environment variable that grabs keyboards (EVIOCGRAB) so that only
+    /// the remapped output device reaches the desktop
+    static constexpr const char* EXCLUSIVE_GRAB_ENV = "YAMY_EXCLUSIVE_GRAB";
+
+    /// Environment variable overriding how long, in milliseconds, input may
+    /// wait on a stalled engine before the keyboards are released
+    static constexpr const char* GRAB_STALL_ENV = "YAMY_GRAB_STALL_MS";
+
+    /// Ungrab every keyboard grabbed in exclusive mode. Async-signal-safe:
+    /// the crash handler calls it before writing its report.
+    static void releaseGrabs();
+
+    /// Reorder and late-event counters of the keyboard merge (zero if the
+    /// keyboards are not merged)
+    InputEventMerger::Stats mergeStats() const;
 
 private:
     void cleanup();
+    /// Put keys from several keyboards in kernel-timestamp order
+    /// (m_readerThreadsMutex held, readers not started)
+    void installMerger(const std::vector<bool>& monotonic);
+    /// Open, grab and start a reader for every mouse (m_readerThreadsMutex held)
+    void installMice(std::vector<yamy::logger::DeviceInfo>& deviceInfoList);
 
     KeyCallback m_keyCallback;
     MouseCallback m_mouseCallback;
@@ -55,7 +103,10 @@ private:
     DeviceManager m_deviceManager;
     std::vector<OpenDevice> m_openDevices;
     std::vector<std::unique_ptr<EventReaderThread>> m_readerThreads;
-    std::mutex m_readerThreadsMutex;
+    std::vector<std::unique_ptr<MouseReaderThread>> m_mouseReaders;
+    std::unique_ptr<InputEventMerger> m_merger;     ///< Stopped after the readers
+    GrabWatchdog m_watchdog;                        ///< Runs while keyboards are grabbed
+    mutable std::mutex m_readerThreadsMutex;
 };
 
 } // namespace yamy::platform
@@ -13,13 +13,14 @@
 #include <cerrno>
 #include <chrono>
 #include <iostream>
+#include <mutex>
 
 namespace yamy::platform {
 
 class InputInjectorLinux : public IInputInjector {
 public:
     InputInjectorLinux(IWindowSystem* windowSystem)
-        : m_windowSystem(windowSystem), m_fd(-1), m_wheelAccumulator(0) {
+        : m_windowSystem(windowSystem), m_fd(-1), m_wheelAccumulator(0), m_hwheelAccumulator(0) {
         initializeUinput();
     }
 
@@ -41,12 +42,11 @@ public:
     }
 
     // Mouse
+    // Called from the mouse keys timer thread and the mouse reader threads
+    // as well as the engine thread: each report goes out in a single
+    // write(), so reports never interleave
     void mouseMove(int32_t dx, int32_t dy) override {
-        if (m_fd < 0) return;
-
-        if (dx != 0) writeEvent(EV_REL, REL_X, dx);
-        if (dy != 0) writeEvent(EV_REL, REL_Y, dy);
-        if (dx != 0 || dy != 0) writeEvent(EV_SYN, SYN_REPORT, 0);
+        mouseFrame(dx, dy, 0, 0);
     }
 
     void mouseButton(MouseButton button, bool down) override {
@@ -62,24 +62,47 @@ public:
             default: return;
         }
 
-        writeEvent(EV_KEY, btnCode, down ? 1 : 0);
-        writeEvent(EV_SYN, SYN_REPORT, 0);
+        input_event events[2];
+        setEvent(events[0], EV_KEY, btnCode, down ? 1 : 0);
+        setEvent(events[1], EV_SYN, SYN_REPORT, 0);
+        writeEvents(events, 2);
     }
 
     void mouseWheel(int32_t delta) override {
-        if (m_fd < 0) return;
-
-        // Windows uses 120 per notch. Linux uses 1.
-        m_wheelAccumulator += delta;
-
-        int32_t steps = m_wheelAccumulator / 120;
-        if (steps != 0) {
-            writeEvent(EV_REL, REL_WHEEL, steps);
-            writeEvent(EV_SYN, SYN_REPORT, 0);
+        mouseFrame(0, 0, delta, 0);
+    }
 
-            // Keep the remainder for future accumulation
+    void mouseFrame(int32_t dx, int32_t dy, int32_t wheel, int32_t hwheel) override {
+        if (m_fd < 0 || (dx == 0 && dy == 0 && wheel == 0 && hwheel == 0)) return;
+
+        // Windows uses 120 per notch, as does REL_WHEEL_HI_RES, so fractions
+        // of a notch (mouse keys, hi-res mice) scroll smoothly where hi-res
+        // is supported. Clients reading REL_WHEEL get whole notches.
+        int32_t steps = 0;
+        int32_t hsteps = 0;
+        if (wheel != 0 || hwheel != 0) {
+            std::lock_guard<std::mutex> lock(m_wheelMutex);
+            m_wheelAccumulator += wheel;
+            steps = m_wheelAccumulator / 120;
             m_wheelAccumulator %= 120;
+            m_hwheelAccumulator += hwheel;
+            hsteps = m_hwheelAccumulator / 120;
+            m_hwheelAccumulator %= 120;
         }
+
+        input_event events[7];
+        size_t count = 0;
+        if (dx != 0) setEvent(events[count++], EV_REL, REL_X, dx);
+        if (dy != 0) setEvent(events[count++], EV_REL, REL_Y, dy);
+#ifdef REL_WHEEL_HI_RES
+        if (wheel != 0) setEvent(events[count++], EV_REL, REL_WHEEL_HI_RES, wheel);
+        if (hwheel != 0) setEvent(events[count++], EV_REL, REL_HWHEEL_HI_RES, hwheel);
+#endif
+        if (steps != 0) setEvent(events[count++], EV_REL, REL_WHEEL, steps);
+        if (hsteps != 0) setEvent(events[count++], EV_REL, REL_HWHEEL, hsteps);
+        if (count == 0) return;
+        setEvent(events[count++], EV_SYN, SYN_REPORT, 0);
+        writeEvents(events, count);
     }
 
     void inject(const KEYBOARD_INPUT_DATA *data, const InjectionContext &ctx, const void *rawData = 0) override {
@@ -154,8 +177,10 @@ public:
             std::cerr << "[OUTPUT] Injecting evdev code 0x" << std::hex << evdevCode << std::dec
                       << " (" << getKeyName(evdevCode) << ") " << (isKeyUp ? "UP" : "DOWN") << std::endl;
 
-            writeEvent(EV_KEY, evdevCode, value);
-            writeEvent(EV_SYN, SYN_REPORT, 0);
+            input_event events[2];
+            setEvent(events[0], EV_KEY, evdevCode, value);
+            setEvent(events[1], EV_SYN, SYN_REPORT, 0);
+            writeEvents(events, 2);
         }
 
         // Record injection latency
@@ -169,7 +194,9 @@ public:
 private:
     IWindowSystem* m_windowSystem;
     int m_fd;
-    int32_t m_wheelAccumulator;
+    std::mutex m_wheelMutex;
+    int32_t m_wheelAccumulator;        ///< Partial notch, 1/120 units (m_wheelMutex)
+    int32_t m_hwheelAccumulator;       ///< Same for the horizontal wheel
 
     /// Check if uinput is available on this system
     static bool checkUinputAvailable() {
@@ -231,6 +258,11 @@ private:
         ioctl(m_fd, UI_SET_RELBIT, REL_X);
         ioctl(m_fd, UI_SET_RELBIT, REL_Y);
         ioctl(m_fd, UI_SET_RELBIT, REL_WHEEL);
+        ioctl(m_fd, UI_SET_RELBIT, REL_HWHEEL);
+#ifdef REL_WHEEL_HI_RES
+        ioctl(m_fd, UI_SET_RELBIT, REL_WHEEL_HI_RES);
+        ioctl(m_fd, UI_SET_RELBIT, REL_HWHEEL_HI_RES);
+#endif
 
         // Enable Sync Events
         ioctl(m_fd, UI_SET_EVBIT, EV_SYN);
@@ -273,21 +305,25 @@ private:
             return;
         }
 
-        writeEvent(EV_KEY, evdevCode, value);
-        writeEvent(EV_SYN, SYN_REPORT, 0);
+        input_event events[2];
+        setEvent(events[0], EV_KEY, evdevCode, value);
+        setEvent(events[1], EV_SYN, SYN_REPORT, 0);
+        writeEvents(events, 2);
     }
 
-    void writeEvent(uint16_t type, uint16_t code, int32_t value) {
-        struct input_event ev;
+    static void setEvent(input_event& ev, uint16_t type, uint16_t code, int32_t value) {
         memset(&ev, 0, sizeof(ev));
         ev.type = type;
         ev.code = code;
         ev.value = value;
+    }
 
-        if (write(m_fd, &ev, sizeof(ev)) < 0) {
+    /// Write one report (events ending in SYN_REPORT) in a single write()
+    void writeEvents(const input_event* events, size_t count) {
+        if (write(m_fd, events, count * sizeof(input_event)) < 0) {
             if (errno != EAGAIN && errno != EWOULDBLOCK) {
                 LOG_ERROR("[injector] Failed to write event (type={} code={}): {}",
-                          type, code, std::strerror(errno));
+                          events[0].type, events[0].code, std::strerror(errno));
             }
         }
     }
@@ -3,13 +3,16 @@
 //
 
 #include "ipc_control_server.h"
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
-#include <poll.h>
+#include <algorithm>
 #include <cstring>
 #include <cerrno>
 #include <iostream>
+#include <sstream>
+#include <nlohmann/json.hpp>
 #include "../../utils/logger.h"
 
 namespace yamy::platform {
@@ -30,7 +33,10 @@ enum MessageType : uint32_t {
     RspStatus = 0x2102,
     RspConfig = 0x2103,
     RspKeymaps = 0x2104,
-    RspMetrics = 0x2105
+    RspMetrics = 0x2105,
+    CmdSubscribe = 0x2008,
+    CmdUnsubscribe = 0x2009,
+    NtfWatchEvent = 0x2106
 };
 
 /// Wire protocol message header
@@ -39,53 +45,41 @@ struct MessageHeader {
     uint32_t dataSize;
 };
 
-/// Receive all bytes from socket
-bool recvAll(int fd, void* buf, size_t len) {
-    char* ptr = static_cast<char*>(buf);
-    size_t remaining = len;
-    while (remaining > 0) {
-        ssize_t n = recv(fd, ptr, remaining, MSG_WAITALL);
-        if (n <= 0) {
-            return false;
-        }
-        ptr += n;
-        remaining -= n;
-    }
-    return true;
-}
+/// Largest command payload accepted from a client
+constexpr uint32_t MAX_COMMAND_SIZE = 1024 * 1024;
 
-/// Send all bytes to socket
-bool sendAll(int fd, const void* buf, size_t len) {
-    const char* ptr = static_cast<const char*>(buf);
-    size_t remaining = len;
-    while (remaining > 0) {
-        ssize_t n = send(fd, ptr, remaining, MSG_NOSIGNAL);
-        if (n <= 0) {
-            return false;
-        }
-        ptr += n;
-        remaining -= n;
-    }
-    return true;
-}
-
-/// Send response to client
-bool sendResponse(int fd, uint32_t type, const std::string& data) {
+void appendMessage(std::string& out, uint32_t type, const std::string& data) {
     MessageHeader header;
     header.type = type;
     header.dataSize = static_cast<uint32_t>(data.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(data);
+}
 
-    if (!sendAll(fd, &header, sizeof(header))) {
-        return false;
+/// Top-level fields of current whose values differ from previous;
+/// everything if previous is empty or either side is not a JSON object
+std::string changedFields(const std::string& previous, const std::string& current) {
+    const auto now = nlohmann::json::parse(current, nullptr, false);
+    if (previous.empty() || !now.is_object()) {
+        return now.is_discarded() ? nlohmann::json(current).dump() : now.dump();
     }
-
-    if (!data.empty()) {
-        if (!sendAll(fd, data.c_str(), data.size())) {
-            return false;
+    const auto before = nlohmann::json::parse(previous, nullptr, false);
+    if (!before.is_object()) {
+        return now.dump();
+    }
+    nlohmann::json delta = nlohmann::json::object();
+    for (auto it = now.begin(); it != now.end(); ++it) {
+        const auto old = before.find(it.key());
+        if (old == before.end() || *old != it.value()) {
+            delta[it.key()] = it.value();
         }
     }
-
-    return true;
+    for (auto it = before.begin(); it != before.end(); ++it) {
+        if (!now.contains(it.key())) {
+            delta[it.key()] = nullptr;
+        }
+    }
+    return delta.empty() ? std::string() : delta.dump();
 }
 
 } // anonymous namespace
@@ -94,6 +88,7 @@ IPCControlServer::IPCControlServer(const std::string& socketPath)
     : m_socketPath(socketPath)
     , m_serverFd(-1)
     , m_running(false)
+    , m_clientCount(0)
 {
 }
 
@@ -105,16 +100,24 @@ void IPCControlServer::setCommandCallback(ControlCommandCallback callback) {
     m_callback = std::move(callback);
 }
 
+void IPCControlServer::setTopicCallback(ControlTopicCallback callback) {
+    m_topicCallback = std::move(callback);
+}
+
 bool IPCControlServer::start() {
     if (m_running) {
         return true; // Already running
     }
+    if (!m_loop.isValid()) {
+        LOG_ERROR("[ipc-control] Event loop unavailable");
+        return false;
+    }
 
     // Remove existing socket file
     unlink(m_socketPath.c_str());
 
     // Create socket
-    m_serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    m_serverFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (m_serverFd == -1) {
         LOG_ERROR("[ipc-control] Failed to create socket: {}", std::strerror(errno));
         return false;
@@ -134,7 +137,8 @@ bool IPCControlServer::start() {
     }
 
     // Listen for connections
-    if (listen(m_serverFd, 5) == -1) {
+    if (listen(m_serverFd, SOMAXCONN) == -1
+        || !m_loop.watchFd(m_serverFd, EPOLLIN, [this](uint32_t) { onServerReadable(); })) {
         LOG_ERROR("[ipc-control] Failed to listen: {}", std::strerror(errno));
         close(m_serverFd);
         m_serverFd = -1;
@@ -144,7 +148,7 @@ bool IPCControlServer::start() {
 
     // Start server thread
     m_running = true;
-    m_serverThread = std::make_unique<std::thread>(&IPCControlServer::serverLoop, this);
+    m_serverThread = std::make_unique<std::thread>([this]() { m_loop.run(); });
 
     std::cout << "IPCControlServer: Listening on " << m_socketPath << "\n";
     return true;
@@ -157,19 +161,23 @@ void IPCControlServer::stop() {
 
     m_running = false;
 
-    // Close server socket to unblock accept()
-    if (m_serverFd >= 0) {
-        shutdown(m_serverFd, SHUT_RDWR);
-        close(m_serverFd);
-        m_serverFd = -1;
-    }
-
     // Wait for server thread to finish
+    m_loop.quit();
     if (m_serverThread && m_serverThread->joinable()) {
         m_serverThread->join();
     }
     m_serverThread.reset();
 
+    // The loop has stopped, so its descriptors can be released from here
+    while (!m_clients.empty()) {
+        closeClient(m_clients.begin()->first);
+    }
+    if (m_serverFd >= 0) {
+        m_loop.unwatchFd(m_serverFd);
+        close(m_serverFd);
+        m_serverFd = -1;
+    }
+
     // Remove socket file
     unlink(m_socketPath.c_str());
 
@@ -180,74 +188,91 @@ bool IPCControlServer::isRunning() const {
     return m_running;
 }
 
-void IPCControlServer::serverLoop() {
-    while (m_running) {
-        // Use poll to allow timeout for shutdown check
-        struct pollfd pfd;
-        pfd.fd = m_serverFd;
-        pfd.events = POLLIN;
-
-        int pollResult = poll(&pfd, 1, 500); // 500ms timeout
-        if (pollResult < 0) {
-            if (errno == EINTR) {
-                continue; // Interrupted, check m_running
-            }
-            if (m_running) {
-                LOG_ERROR("[ipc-control] poll() error: {}", std::strerror(errno));
-            }
-            break;
-        }
-
-        if (pollResult == 0) {
-            continue; // Timeout, check m_running and retry
-        }
-
-        // Accept new connection
-        int clientFd = accept(m_serverFd, nullptr, nullptr);
+void IPCControlServer::onServerReadable() {
+    while (true) {
+        const int clientFd = accept4(m_serverFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (clientFd < 0) {
             if (errno == EINTR || errno == ECONNABORTED) {
                 continue;
             }
-            if (m_running) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
                 LOG_ERROR("[ipc-control] accept() error: {}", std::strerror(errno));
             }
-            break;
+            return;
         }
 
-        // Handle client (synchronously - simple protocol)
-        handleClient(clientFd);
-        close(clientFd);
+        auto client = std::make_unique<Client>();
+        client->fd = clientFd;
+        if (!m_loop.watchFd(clientFd, EPOLLIN, [this, clientFd](uint32_t events) {
+                onClientEvent(clientFd, events);
+            })) {
+            close(clientFd);
+            continue;
+        }
+        m_clients[clientFd] = std::move(client);
+        m_clientCount = m_clients.size();
     }
 }
 
-void IPCControlServer::handleClient(int clientFd) {
-    // Read message header
-    MessageHeader header;
-    if (!recvAll(clientFd, &header, sizeof(header))) {
-        LOG_WARN("[ipc-control] Failed to receive message header");
+void IPCControlServer::onClientEvent(int fd, uint32_t events) {
+    const auto it = m_clients.find(fd);
+    if (it == m_clients.end()) {
         return;
     }
+    Client& client = *it->second;
 
-    // Read message data
-    std::string data;
-    if (header.dataSize > 0) {
-        // Sanity check
-        if (header.dataSize > 1024 * 1024) {
-            LOG_WARN("[ipc-control] Message data too large");
-            sendResponse(clientFd, MessageType::RspError, "Message data too large");
-            return;
+    if ((events & EPOLLOUT) && !flushClient(client)) {
+        closeClient(fd);
+        return;
+    }
+
+    bool isClosed = (events & (EPOLLERR | EPOLLHUP)) != 0 && !(events & EPOLLIN);
+    if (events & EPOLLIN) {
+        char buffer[4096];
+        while (true) {
+            const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                client.inbox.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            isClosed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
         }
+    }
 
-        data.resize(header.dataSize);
-        if (!recvAll(clientFd, &data[0], header.dataSize)) {
-            LOG_WARN("[ipc-control] Failed to receive message data");
-            return;
+    // Answer every complete command; a client may pipeline several
+    size_t offset = 0;
+    while (!client.isBroken && client.inbox.size() - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        std::memcpy(&header, client.inbox.data() + offset, sizeof(header));
+        if (header.dataSize > MAX_COMMAND_SIZE) {
+            LOG_WARN("[ipc-control] Message data too large");
+            sendToClient(client, MessageType::RspError, "Message data too large");
+            flushClient(client);
+            client.isBroken = true;
+            break;
+        }
+        if (client.inbox.size() - offset - sizeof(header) < header.dataSize) {
+            break;
         }
+        handleCommand(client, header.type,
+                      client.inbox.substr(offset + sizeof(header), header.dataSize));
+        offset += sizeof(header) + header.dataSize;
+    }
+    client.inbox.erase(0, offset);
+
+    if (isClosed || client.isBroken) {
+        closeClient(fd);
     }
+}
 
+void IPCControlServer::handleCommand(Client& client, uint32_t type, const std::string& data) {
     // Map message type to command
     ControlCommand cmd;
-    switch (header.type) {
+    switch (type) {
         case MessageType::CmdReload:
             cmd = ControlCommand::Reload;
             break;
@@ -269,8 +294,14 @@ void IPCControlServer::handleClient(int clientFd) {
         case MessageType::CmdGetMetrics:
             cmd = ControlCommand::GetMetrics;
             break;
+        case MessageType::CmdSubscribe:
+            subscribe(client, data);
+            return;
+        case MessageType::CmdUnsubscribe:
+            unsubscribe(client, data);
+            return;
         default:
-            sendResponse(clientFd, MessageType::RspError, "Unknown command");
+            sendToClient(client, MessageType::RspError, "Unknown command");
             return;
     }
 
@@ -285,18 +316,168 @@ void IPCControlServer::handleClient(int clientFd) {
 
     // Send response with appropriate type
     if (!result.success) {
-        sendResponse(clientFd, MessageType::RspError, result.message);
+        sendToClient(client, MessageType::RspError, result.message);
     } else if (cmd == ControlCommand::GetStatus) {
-        sendResponse(clientFd, MessageType::RspStatus, result.message);
+        sendToClient(client, MessageType::RspStatus, result.message);
     } else if (cmd == ControlCommand::GetConfig) {
-        sendResponse(clientFd, MessageType::RspConfig, result.message);
+        sendToClient(client, MessageType::RspConfig, result.message);
     } else if (cmd == ControlCommand::GetKeymaps) {
-        sendResponse(clientFd, MessageType::RspKeymaps, result.message);
+        sendToClient(client, MessageType::RspKeymaps, result.message);
     } else if (cmd == ControlCommand::GetMetrics) {
-        sendResponse(clientFd, MessageType::RspMetrics, result.message);
+        sendToClient(client, MessageType::RspMetrics, result.message);
     } else {
-        sendResponse(clientFd, MessageType::RspOk, result.message);
+        sendToClient(client, MessageType::RspOk, result.message);
+    }
+}
+
+void IPCControlServer::subscribe(Client& client, const std::string& data) {
+    std::istringstream args(data);
+    std::string topic;
+    long intervalMs = DEFAULT_WATCH_INTERVAL_MS;
+    args >> topic;
+    if (!(args >> intervalMs)) {
+        intervalMs = DEFAULT_WATCH_INTERVAL_MS;
+    }
+    intervalMs = std::clamp<long>(intervalMs, MIN_WATCH_INTERVAL_MS, MAX_WATCH_INTERVAL_MS);
+
+    if (topic.empty() || !m_topicCallback || m_topicCallback(topic).empty()) {
+        sendToClient(client, MessageType::RspError, "Unknown topic: " + topic);
+        return;
+    }
+
+    // Re-subscribing to a topic only changes its rate
+    auto existing = std::find_if(client.subscriptions.begin(), client.subscriptions.end(),
+                                 [&topic](const auto& sub) { return sub->topic == topic; });
+    if (existing != client.subscriptions.end()) {
+        m_loop.cancelTimer((*existing)->timer);
+        client.subscriptions.erase(existing);
+    }
+
+    auto sub = std::make_unique<Subscription>();
+    sub->topic = topic;
+    sub->intervalMs = static_cast<uint32_t>(intervalMs);
+    sub->sequence = 0;
+    const int fd = client.fd;
+    Subscription* const subscription = sub.get();
+    sub->timer = m_loop.addTimer(sub->intervalMs, [this, fd, subscription]() {
+        const auto it = m_clients.find(fd);
+        if (it == m_clients.end()) {
+            return;
+        }
+        pushTopic(*it->second, *subscription);
+        if (it->second->isBroken) {
+            closeClient(fd);
+        }
+    });
+    if (sub->timer < 0) {
+        sendToClient(client, MessageType::RspError, "Failed to create timer");
+        return;
+    }
+    client.subscriptions.push_back(std::move(sub));
+
+    sendToClient(client, MessageType::RspOk,
+                 "Watching " + topic + " every " + std::to_string(intervalMs) + " ms");
+    // The first event carries the full state; later ones only what changed
+    pushTopic(client, *subscription);
+}
+
+void IPCControlServer::unsubscribe(Client& client, const std::string& data) {
+    std::istringstream args(data);
+    std::string topic;
+    args >> topic;
+
+    size_t removed = 0;
+    for (auto it = client.subscriptions.begin(); it != client.subscriptions.end();) {
+        if (topic.empty() || (*it)->topic == topic) {
+            m_loop.cancelTimer((*it)->timer);
+            it = client.subscriptions.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    if (removed == 0 && !topic.empty()) {
+        sendToClient(client, MessageType::RspError, "Not watching " + topic);
+        return;
+    }
+    sendToClient(client, MessageType::RspOk, "Unsubscribed");
+}
+
+void IPCControlServer::pushTopic(Client& client, Subscription& subscription) {
+    // A client that has not read the previous event gets the accumulated
+    // changes once it catches up, instead of a growing backlog
+    if (!client.outbox.empty()) {
+        return;
+    }
+
+    std::string state = m_topicCallback ? m_topicCallback(subscription.topic) : std::string();
+    if (state.empty() || state == subscription.lastState) {
+        return;
+    }
+    const std::string delta = changedFields(subscription.lastState, state);
+    if (delta.empty()) {
+        return;
+    }
+    subscription.lastState = std::move(state);
+
+    nlohmann::json event;
+    event["topic"] = subscription.topic;
+    event["seq"] = ++subscription.sequence;
+    event["data"] = nlohmann::json::parse(delta, nullptr, false);
+    sendToClient(client, MessageType::NtfWatchEvent, event.dump());
+}
+
+void IPCControlServer::sendToClient(Client& client, uint32_t type, const std::string& data) {
+    if (client.isBroken) {
+        return;
+    }
+    appendMessage(client.outbox, type, data);
+    if (!flushClient(client)) {
+        client.isBroken = true;
+    } else if (client.outbox.size() > MAX_CLIENT_OUTBOX) {
+        LOG_WARN("[ipc-control] Dropping client that stopped reading");
+        client.isBroken = true;
+    }
+}
+
+bool IPCControlServer::flushClient(Client& client) {
+    size_t written = 0;
+    while (written < client.outbox.size()) {
+        const ssize_t n = send(client.fd, client.outbox.data() + written,
+                               client.outbox.size() - written, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            written += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    client.outbox.erase(0, written);
+
+    // Only ask for EPOLLOUT while there is something left to write
+    const bool isWaiting = !client.outbox.empty();
+    if (isWaiting != client.isWaitingWritable) {
+        client.isWaitingWritable = isWaiting;
+        m_loop.modifyFd(client.fd, isWaiting ? (EPOLLIN | EPOLLOUT) : EPOLLIN);
+    }
+    return true;
+}
+
+void IPCControlServer::closeClient(int fd) {
+    const auto it = m_clients.find(fd);
+    if (it == m_clients.end()) {
+        return;
+    }
+    for (const auto& sub : it->second->subscriptions) {
+        m_loop.cancelTimer(sub->timer);
     }
+    m_loop.unwatchFd(fd);
+    close(fd);
+    m_clients.erase(it);
+    m_clientCount = m_clients.size();
 }
 
 } // namespace yamy::platform
@@ -5,12 +5,21 @@
 // Listens on a Unix domain socket for control commands from yamy-ctl.
 // Handles: reload, stop, start, status commands.
 //
+// All clients are served non-blocking from one epoll loop on the server
+// thread, so a slow client does not hold up the others. A connection stays
+// open after a reply and may send further commands. Subscriptions
+// (yamy-ctl watch) push the fields of a topic that changed since the last
+// push, at the rate the client asked for.
+//
 
+#include "core/platform/linux/event_loop.h"
 #include <string>
 #include <functional>
 #include <atomic>
 #include <thread>
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace yamy::platform {
 
@@ -37,6 +46,11 @@ struct ControlResult {
 /// @return Result of command execution
 using ControlCommandCallback = std::function<ControlResult(ControlCommand cmd, const std::string& data)>;
 
+/// Callback returning the current state of a subscription topic
+/// (metrics, locks, keys, config) as a JSON object, or "" for an unknown topic.
+/// Called on the server thread.
+using ControlTopicCallback = std::function<std::string(const std::string& topic)>;
+
 /// IPC Control Server
 /// Listens for control commands from yamy-ctl and dispatches to registered callback.
 class IPCControlServer {
@@ -44,6 +58,14 @@ public:
     /// Default socket path
     static constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/yamy-engine.sock";
 
+    /// Subscription rates accepted from clients (milliseconds)
+    static constexpr uint32_t MIN_WATCH_INTERVAL_MS = 50;
+    static constexpr uint32_t DEFAULT_WATCH_INTERVAL_MS = 1000;
+    static constexpr uint32_t MAX_WATCH_INTERVAL_MS = 60000;
+
+    /// Unsent bytes after which a client is dropped as not reading
+    static constexpr size_t MAX_CLIENT_OUTBOX = 1024 * 1024;
+
     /// Construct server with optional custom socket path
     /// @param socketPath Path for the Unix domain socket
     explicit IPCControlServer(const std::string& socketPath = DEFAULT_SOCKET_PATH);
@@ -59,6 +81,9 @@ public:
     /// @param callback Function to call when command is received
     void setCommandCallback(ControlCommandCallback callback);
 
+    /// Register the source of subscription topics; call before start()
+    void setTopicCallback(ControlTopicCallback callback);
+
     /// Start listening for connections (non-blocking, spawns thread)
     /// @return true if server started successfully
     bool start();
@@ -72,19 +97,66 @@ public:
     /// Get the socket path being used
     const std::string& socketPath() const { return m_socketPath; }
 
+    /// Number of connected clients
+    size_t clientCount() const { return m_clientCount; }
+
 private:
-    /// Server thread main loop
-    void serverLoop();
+    /// One topic a client subscribed to
+    struct Subscription {
+        std::string topic;
+        uint32_t intervalMs;
+        EventLoop::TimerId timer;
+        std::string lastState;      ///< JSON object last pushed, for the delta
+        uint64_t sequence;
+    };
+
+    /// One connected client
+    struct Client {
+        int fd;
+        std::string inbox;          ///< Received bytes not yet parsed
+        std::string outbox;         ///< Bytes the socket has not taken yet
+        std::vector<std::unique_ptr<Subscription>> subscriptions;
+        bool isWaitingWritable = false;  ///< EPOLLOUT is being watched
+        bool isBroken = false;           ///< Write failed or outbox overflowed; close it
+    };
+
+    /// Accept pending connections
+    void onServerReadable();
 
-    /// Handle a single client connection
-    /// @param clientFd Client socket file descriptor
-    void handleClient(int clientFd);
+    /// Read, parse and answer the commands a client sent
+    void onClientEvent(int fd, uint32_t events);
+
+    /// Handle one complete command from a client
+    void handleCommand(Client& client, uint32_t type, const std::string& data);
+
+    /// Subscribe a client: data is "<topic> [interval_ms]"
+    void subscribe(Client& client, const std::string& data);
+
+    /// Unsubscribe a client from a topic, or from all topics if data is empty
+    void unsubscribe(Client& client, const std::string& data);
+
+    /// Push the fields of a topic that changed since the last push
+    void pushTopic(Client& client, Subscription& subscription);
+
+    /// Queue a message for a client and write as much as the socket takes;
+    /// marks the client broken instead of closing it
+    void sendToClient(Client& client, uint32_t type, const std::string& data);
+
+    /// Write queued bytes; false if the client is gone
+    bool flushClient(Client& client);
+
+    void closeClient(int fd);
 
     std::string m_socketPath;
     int m_serverFd;
     std::atomic<bool> m_running;
     std::unique_ptr<std::thread> m_serverThread;
     ControlCommandCallback m_callback;
+    ControlTopicCallback m_topicCallback;
+
+    EventLoop m_loop;                                   ///< Runs on m_serverThread
+    std::map<int, std::unique_ptr<Client>> m_clients;   ///< Server thread only
+    std::atomic<size_t> m_clientCount;
 };
 
 } // namespace yamy::platform
@@ -0,0 +1,286 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// mouse_reader_linux.cpp - evdev mouse lane
+
+#include "mouse_reader_linux.h"
+#include "../../utils/platform_logger.h"
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace yamy::platform {
+
+namespace {
+
+/// Remappable buttons and their E1 scan codes (see keymaps/104.mayu)
+struct ButtonCode {
+    uint16_t evdev;
+    uint16_t scan;
+};
+
+constexpr ButtonCode BUTTON_CODES[] = {
+    {BTN_LEFT, 0x01},
+    {BTN_RIGHT, 0x02},
+    {BTN_MIDDLE, 0x03},
+    {BTN_SIDE, 0x06},
+    {BTN_EXTRA, 0x07},
+    {BTN_BACK, 0x06},
+    {BTN_FORWARD, 0x07},
+};
+
+constexpr int32_t WHEEL_NOTCH = 120;
+
+/// Poll timeout, so stop() is noticed on an idle mouse
+constexpr int POLL_TIMEOUT_MS = 100;
+
+uint64_t eventTimeUs(const input_event& ev)
+{
+    return static_cast<uint64_t>(ev.input_event_sec) * 1000000ULL +
+           static_cast<uint64_t>(ev.input_event_usec);
+}
+
+} // namespace
+
+MouseReaderThread::MouseReaderThread(int fd, const std::string& devNode,
+                                     KeyCallback buttonCallback, MouseCallback motionCallback)
+    : m_fd(fd)
+    , m_devNode(devNode)
+    , m_buttonCallback(std::move(buttonCallback))
+    , m_motionCallback(std::move(motionCallback))
+    , m_running(false)
+    , m_stopRequested(false)
+{
+}
+
+MouseReaderThread::~MouseReaderThread()
+{
+    stop();
+}
+
+bool MouseReaderThread::start()
+{
+    if (m_running) return true;
+
+    m_stopRequested = false;
+    m_thread = std::thread(&MouseReaderThread::run, this);
+    m_running = true;
+    return true;
+}
+
+void MouseReaderThread::stop()
+{
+    if (!m_running) return;
+
+    m_stopRequested = true;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running = false;
+}
+
+uint16_t MouseReaderThread::buttonScanCode(uint16_t evdevCode)
+{
+    for (const ButtonCode& button : BUTTON_CODES) {
+        if (button.evdev == evdevCode) {
+            return button.scan;
+        }
+    }
+    return 0;
+}
+
+void MouseReaderThread::run()
+{
+    PLATFORM_LOG_INFO("input", "Started reading mouse %s", m_devNode.c_str());
+
+    input_event events[READ_BATCH];
+    while (!m_stopRequested) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, POLL_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            PLATFORM_LOG_ERROR("input", "Poll error on %s: %s", m_devNode.c_str(), strerror(errno));
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        ssize_t bytes = read(m_fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                continue;
+            }
+            if (errno == ENODEV) {
+                PLATFORM_LOG_WARN("input", "Mouse %s disconnected", m_devNode.c_str());
+            } else {
+                PLATFORM_LOG_ERROR("input", "Read error on %s: %s", m_devNode.c_str(), strerror(errno));
+            }
+            break;
+        }
+        if (bytes == 0) {
+            break;
+        }
+
+        try {
+            processEvents(events, static_cast<size_t>(bytes) / sizeof(input_event));
+        } catch (const std::exception& e) {
+            PLATFORM_LOG_ERROR("input", "Mouse callback exception: %s", e.what());
+        }
+    }
+
+    PLATFORM_LOG_INFO("input", "Stopped reading mouse %s", m_devNode.c_str());
+}
+
+void MouseReaderThread::processEvents(const input_event* events, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const input_event& ev = events[i];
+
+        if (m_isDropping) {
+            // The kernel queue overflowed: everything up to the next
+            // SYN_REPORT is incomplete and only button state is recovered
+            if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+                m_isDropping = false;
+                resyncButtons(eventTimeUs(ev));
+            }
+            continue;
+        }
+
+        switch (ev.type) {
+            case EV_REL:
+                switch (ev.code) {
+                    case REL_X: m_frame.dx += ev.value; break;
+                    case REL_Y: m_frame.dy += ev.value; break;
+                    case REL_WHEEL: m_frame.wheel += ev.value * WHEEL_NOTCH; break;
+                    case REL_HWHEEL: m_frame.hwheel += ev.value * WHEEL_NOTCH; break;
+#ifdef REL_WHEEL_HI_RES
+                    case REL_WHEEL_HI_RES:
+                        m_frameWheelHiRes += ev.value;
+                        m_hasWheelHiRes = true;
+                        break;
+                    case REL_HWHEEL_HI_RES:
+                        m_frameHWheelHiRes += ev.value;
+                        m_hasHWheelHiRes = true;
+                        break;
+#endif
+                    default: break;
+                }
+                break;
+
+            case EV_KEY: {
+                // value 2 is autorepeat, which mice do not send
+                uint16_t scan = buttonScanCode(ev.code);
+                if (scan != 0 && ev.value != 2 && m_frameButtonCount < MAX_FRAME_BUTTONS) {
+                    m_frameButtons[m_frameButtonCount++] = Button{scan, ev.value == 1};
+                }
+                break;
+            }
+
+            case EV_SYN:
+                if (ev.code == SYN_REPORT) {
+                    commitFrame(eventTimeUs(ev));
+                } else if (ev.code == SYN_DROPPED) {
+                    m_frame = Motion();
+                    m_frameWheelHiRes = m_frameHWheelHiRes = 0;
+                    m_hasWheelHiRes = m_hasHWheelHiRes = false;
+                    m_frameButtonCount = 0;
+                    m_isDropping = true;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    flushMotion();
+}
+
+void MouseReaderThread::commitFrame(uint64_t timestampUs)
+{
+    m_batch.dx += m_frame.dx;
+    m_batch.dy += m_frame.dy;
+    m_batch.wheel += m_hasWheelHiRes ? m_frameWheelHiRes : m_frame.wheel;
+    m_batch.hwheel += m_hasHWheelHiRes ? m_frameHWheelHiRes : m_frame.hwheel;
+    m_batchTimeUs = timestampUs;
+    m_frame = Motion();
+    m_frameWheelHiRes = m_frameHWheelHiRes = 0;
+    m_hasWheelHiRes = m_hasHWheelHiRes = false;
+
+    if (m_frameButtonCount == 0) {
+        return;
+    }
+    flushMotion();
+    for (size_t i = 0; i < m_frameButtonCount; ++i) {
+        sendButton(m_frameButtons[i].scan, m_frameButtons[i].isDown, timestampUs);
+    }
+    m_frameButtonCount = 0;
+}
+
+void MouseReaderThread::flushMotion()
+{
+    if (m_batch.dx == 0 && m_batch.dy == 0 && m_batch.wheel == 0 && m_batch.hwheel == 0) {
+        return;
+    }
+
+    MouseEvent event{};
+    event.dx = m_batch.dx;
+    event.dy = m_batch.dy;
+    event.wheel = m_batch.wheel;
+    event.hwheel = m_batch.hwheel;
+    event.timestampUs = m_batchTimeUs;
+    event.time = static_cast<uint32_t>(m_batchTimeUs / 1000);
+    m_batch = Motion();
+
+    if (m_motionCallback) {
+        m_motionCallback(event);
+    }
+}
+
+void MouseReaderThread::sendButton(uint16_t scan, bool isDown, uint64_t timestampUs)
+{
+    const uint8_t bit = static_cast<uint8_t>(1u << scan);
+    if (isDown) {
+        m_buttonsDown |= bit;
+    } else {
+        m_buttonsDown &= static_cast<uint8_t>(~bit);
+    }
+
+    KeyEvent event{};
+    event.key = KeyCode::Unknown;
+    event.scanCode = scan;
+    event.isKeyDown = isDown;
+    event.isExtended = false;
+    event.timestamp = static_cast<uint32_t>(timestampUs / 1000);
+    event.timestampUs = timestampUs;
+    event.flags = isDown ? 0 : 1;
+    event.extraInfo = MOUSE_EVENT_MARKER;
+
+    if (m_buttonCallback) {
+        m_buttonCallback(event);
+    }
+}
+
+void MouseReaderThread::resyncButtons(uint64_t timestampUs)
+{
+    unsigned char keyBits[KEY_MAX / 8 + 1] = {0};
+    if (ioctl(m_fd, EVIOCGKEY(sizeof(keyBits)), keyBits) < 0) {
+        return;
+    }
+
+    uint8_t down = 0;
+    for (const ButtonCode& button : BUTTON_CODES) {
+        if (keyBits[button.evdev / 8] & (1 << (button.evdev % 8))) {
+            down |= static_cast<uint8_t>(1u << button.scan);
+        }
+    }
+    for (uint16_t scan = 1; scan < 8; ++scan) {
+        const uint8_t bit = static_cast<uint8_t>(1u << scan);
+        if ((down & bit) != (m_buttonsDown & bit)) {
+            sendButton(scan, (down & bit) != 0, timestampUs);
+        }
+    }
+}
+
+} // namespace yamy::platform
@@ -0,0 +1,93 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// mouse_reader_linux.h - evdev mouse lane
+//
+// One MouseReaderThread per grabbed mouse. Relative motion and wheel events
+// are summed over the frames of each read() and handed to the motion
+// callback as one MouseEvent, which injects them directly; a mouse polling
+// at 8 kHz never touches the engine input queue. Only button presses and
+// releases go to the button callback, as KeyEvents carrying
+// MOUSE_EVENT_MARKER, to be remapped like keys. Pending motion is flushed
+// before a button, so a click lands where the pointer was.
+
+#include "../../core/platform/input_hook_interface.h"
+#include <linux/input.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace yamy::platform {
+
+/// Reader thread for a single mouse
+class MouseReaderThread {
+public:
+    /// Events per read(); frames read together are injected as one
+    static constexpr size_t READ_BATCH = 128;
+
+    /**
+     * @param buttonCallback Receives button events (reader thread)
+     * @param motionCallback Receives summed motion and wheels (reader thread)
+     */
+    MouseReaderThread(int fd, const std::string& devNode,
+                      KeyCallback buttonCallback, MouseCallback motionCallback);
+    ~MouseReaderThread();
+
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    const std::string& getDevNode() const { return m_devNode; }
+
+    /// E1 scan code of an evdev button, 0 if the button is not remappable
+    static uint16_t buttonScanCode(uint16_t evdevCode);
+
+private:
+    /// Motion of one frame or a batch of frames
+    struct Motion {
+        int32_t dx = 0;
+        int32_t dy = 0;
+        int32_t wheel = 0;          ///< 1/120 notch
+        int32_t hwheel = 0;
+    };
+
+    /// A button event waiting for the end of its frame
+    struct Button {
+        uint16_t scan;
+        bool isDown;
+    };
+
+    static constexpr size_t MAX_FRAME_BUTTONS = 8;
+
+    void run();
+    void processEvents(const input_event* events, size_t count);
+    void commitFrame(uint64_t timestampUs);
+    void flushMotion();
+    void sendButton(uint16_t scan, bool isDown, uint64_t timestampUs);
+    /// Report buttons whose state changed while events were dropped
+    void resyncButtons(uint64_t timestampUs);
+
+    int m_fd;
+    std::string m_devNode;
+    KeyCallback m_buttonCallback;
+    MouseCallback m_motionCallback;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_stopRequested;
+
+    // Reader thread only
+    Motion m_frame;                 ///< Frame being read
+    int32_t m_frameWheelHiRes = 0;
+    int32_t m_frameHWheelHiRes = 0;
+    bool m_hasWheelHiRes = false;   ///< Hi-res wheels replace REL_WHEEL/REL_HWHEEL
+    bool m_hasHWheelHiRes = false;
+    Button m_frameButtons[MAX_FRAME_BUTTONS];
+    size_t m_frameButtonCount = 0;
+    Motion m_batch;                 ///< Complete frames not yet injected
+    uint64_t m_batchTimeUs = 0;
+    bool m_isDropping = false;      ///< SYN_DROPPED until the next SYN_REPORT
+    uint8_t m_buttonsDown = 0;      ///< Bit per E1 scan code
+};
+
+} // namespace yamy::platform
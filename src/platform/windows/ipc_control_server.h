@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // ipc_control_server.h - IPC server stub for Windows
 //
@@ -34,6 +34,9 @@ struct ControlResult {
 /// Callback for handling control commands
 using ControlCommandCallback = std::function<ControlResult(ControlCommand cmd, const std::string& data)>;
 
+/// Callback returning the state of a subscription topic as JSON
+using ControlTopicCallback = std::function<std::string(const std::string& topic)>;
+
 /// IPC Control Server (Windows Stub)
 class IPCControlServer {
 public:
@@ -53,6 +56,9 @@ public:
     /// Register callback for handling commands
     void setCommandCallback(ControlCommandCallback callback);
 
+    /// Register the source of subscription topics (Stub: no subscriptions)
+    void setTopicCallback(ControlTopicCallback) {}
+
     /// Start listening (Stub)
     bool start();
 
@@ -0,0 +1,367 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// inprocess_executor.cpp - In-process scenario execution for yamy-test-runner
+
+#include "inprocess_executor.h"
+#include "test_scenario_json.h"
+
+#include "engine.h"
+#include "setting.h"
+#include "msgstream.h"
+#include "json_config_loader.h"
+#include "keycode_mapping.h"
+#include "../../tests/test_utils/null_platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace yamy::test {
+namespace {
+
+/// Virtual time of the first event fed to a fresh engine
+constexpr uint64_t kVirtualEpochUs = 1000000;
+
+/// Virtual gap between test cases, keeps hold/tap state from leaking across cases
+/// while staying below ModifierKeyHandler's 5 s suspend/resume cutoff
+constexpr uint64_t kTestCaseGapUs = 1000000;
+
+/// Real time to wait for stray output after the expected count has been reached
+constexpr milliseconds kSettleTime(5);
+
+/// Input hook that lets the executor feed events straight into the engine
+class ScenarioInputHook : public platform::IInputHook {
+public:
+    bool install(platform::KeyCallback keyCallback, platform::MouseCallback) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keyCallback = keyCallback;
+        return true;
+    }
+
+    void uninstall() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keyCallback = nullptr;
+    }
+
+    bool isInstalled() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<bool>(m_keyCallback);
+    }
+
+    /// Deliver one event as the evdev reader thread would
+    bool feed(const platform::KeyEvent& event) {
+        platform::KeyCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            callback = m_keyCallback;
+        }
+        if (!callback) {
+            return false;
+        }
+        callback(event);
+        return true;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    platform::KeyCallback m_keyCallback;
+};
+
+/// Input injector that records engine output as captured evdev events
+class RecordingInputInjector : public platform::IInputInjector {
+public:
+    void inject(const KEYBOARD_INPUT_DATA* data, const platform::InjectionContext&, const void*) override {
+        // Mouse events (E1) are not part of key scenarios
+        if (!data || (data->Flags & KEYBOARD_INPUT_DATA::E1)) {
+            return;
+        }
+
+        CapturedEvent captured;
+        captured.evdev_code = platform::yamyToEvdevKeyCode(data->MakeCode);
+        captured.key_name = platform::getKeyName(captured.evdev_code);
+        captured.type = (data->Flags & KEYBOARD_INPUT_DATA::BREAK) ? EventType::RELEASE : EventType::PRESS;
+
+        auto now = steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        captured.timestamp = duration_cast<microseconds>(now.time_since_epoch());
+        captured.latency = duration_cast<microseconds>(now - m_startTime);
+        m_events.push_back(captured);
+        m_cond.notify_all();
+    }
+
+    void keyDown(platform::KeyCode) override {}
+    void keyUp(platform::KeyCode) override {}
+    void mouseMove(int32_t, int32_t) override {}
+    void mouseButton(platform::MouseButton, bool) override {}
+    void mouseWheel(int32_t) override {}
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_events.clear();
+        m_startTime = steady_clock::now();
+    }
+
+    /// Wait until at least count events arrived, then until output goes quiet
+    /// @return false if count was not reached within timeout
+    bool waitForEvents(size_t count, milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cond.wait_for(lock, timeout, [&] { return m_events.size() >= count; })) {
+            return false;
+        }
+        size_t seen = m_events.size();
+        while (m_cond.wait_for(lock, kSettleTime, [&] { return m_events.size() != seen; })) {
+            seen = m_events.size();
+        }
+        return true;
+    }
+
+    std::vector<CapturedEvent> getEvents() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_events;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<CapturedEvent> m_events;
+    steady_clock::time_point m_startTime;
+};
+
+/// One engine plus its mock platform, reused across the scenarios of a worker.
+/// Engine construction, start() and stop() touch process-wide state
+/// (StrExprArg::setSystem, PerformanceMetrics periodic logging), so fixtures
+/// are created and destroyed on one thread only; see executeAll().
+class EngineFixture {
+public:
+    EngineFixture()
+        : m_log(0)
+        , m_virtualTimeUs(kVirtualEpochUs) {
+        m_engine = std::make_unique<Engine>(m_log, &m_windowSystem, nullptr,
+                                            &m_injector, &m_hook, &m_driver);
+        m_engine->start();
+    }
+
+    ~EngineFixture() {
+        m_engine->stop();
+        m_engine.reset();
+    }
+
+    EngineFixture(const EngineFixture&) = delete;
+    EngineFixture& operator=(const EngineFixture&) = delete;
+
+    /// Load a JSON config, skipped if it is already active
+    bool loadConfig(const std::string& path, std::string& error) {
+        if (m_setting && path == m_configPath) {
+            return true;
+        }
+
+        auto setting = std::make_unique<Setting>();
+        settings::JsonConfigLoader loader;
+        if (!loader.load(setting.get(), path)) {
+            error = "Failed to load config: " + path;
+            return false;
+        }
+
+        // setSetting refuses while the engine is synchronizing; retry briefly
+        int retries = 10;
+        while (!m_engine->setSetting(setting.get())) {
+            if (--retries == 0) {
+                error = "Engine busy, could not apply config: " + path;
+                return false;
+            }
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+
+        // The previous setting is released only after the engine switched away
+        m_setting = std::move(setting);
+        m_configPath = path;
+        return true;
+    }
+
+    TestCaseResult executeTestCase(const TestCase& test_case) {
+        TestCaseResult result;
+        result.name = test_case.name;
+
+        auto start_time = steady_clock::now();
+        m_injector.clear();
+        m_virtualTimeUs += kTestCaseGapUs;
+
+        for (const auto& input : test_case.input) {
+            // delay_before_ms moves the event timestamp, not the wall clock
+            m_virtualTimeUs += static_cast<uint64_t>(input.delay_before_ms) * 1000;
+            if (!feed(input)) {
+                result.status = TestStatus::ERROR;
+                result.error_message = "Failed to inject input events";
+                result.duration_ms = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+                return result;
+            }
+        }
+
+        size_t expected_count = test_case.expected_output.size();
+        bool captured_all = m_injector.waitForEvents(expected_count, milliseconds(test_case.timeout_ms));
+
+        result.duration_ms = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+        result.actual_output = m_injector.getEvents();
+
+        if (!captured_all) {
+            result.status = TestStatus::TIMEOUT;
+            result.error_message = "Timeout waiting for output events";
+            return result;
+        }
+
+        if (!verifyOutput(test_case.expected_output, result.actual_output, result.error_message)) {
+            result.status = TestStatus::FAILED;
+            return result;
+        }
+
+        result.status = TestStatus::PASSED;
+        if (!result.actual_output.empty()) {
+            uint64_t total_latency = 0;
+            for (const auto& event : result.actual_output) {
+                total_latency += event.latency.count();
+            }
+            result.latency_us = static_cast<uint32_t>(total_latency / result.actual_output.size());
+        }
+        return result;
+    }
+
+private:
+    /// Build the KeyEvent the evdev reader would produce for this input
+    bool feed(const KeyEvent& input) {
+        int value = (input.type == EventType::PRESS) ? 1 : 0;
+        uint16_t yamyCode = platform::evdevToYamyKeyCode(input.evdev_code, value);
+        if (yamyCode == 0) {
+            return false;
+        }
+
+        platform::KeyEvent event{};
+        event.key = platform::KeyCode::Unknown;
+        event.scanCode = yamyCode;
+        event.isKeyDown = (value == 1);
+        event.isExtended = false;
+        event.timestamp = static_cast<uint32_t>(m_virtualTimeUs / 1000);
+        event.timestampUs = m_virtualTimeUs;
+        event.flags = (value == 0) ? 1 : 0;
+        event.extraInfo = 0;
+        return m_hook.feed(event);
+    }
+
+    tomsgstream m_log;
+    platform::NullWindowSystem m_windowSystem;
+    platform::NullInputDriver m_driver;
+    ScenarioInputHook m_hook;
+    RecordingInputInjector m_injector;
+    std::unique_ptr<Setting> m_setting;
+    std::string m_configPath;
+    std::unique_ptr<Engine> m_engine;
+    uint64_t m_virtualTimeUs;
+};
+
+ScenarioResult executeScenario(EngineFixture& fixture, const InProcessJob& job,
+                               bool verbose, std::ostream& out) {
+    const TestScenario& scenario = job.scenario;
+    ScenarioResult result;
+    result.scenario_name = scenario.name;
+
+    auto start_time = steady_clock::now();
+
+    if (verbose) {
+        out << "Scenario: " << scenario.name << " (" << scenario.test_cases.size() << " test cases)\n";
+    }
+
+    std::string error;
+    if (job.config_path.empty()) {
+        error = "No JSON config for scenario (config '" + scenario.config_file + "'); use --config";
+    }
+    if (!error.empty() || !fixture.loadConfig(job.config_path, error)) {
+        result.status = TestStatus::ERROR;
+        out << "  ✗ ERROR: " << error << "\n";
+        result.duration_ms = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+        return result;
+    }
+
+    bool all_passed = true;
+    for (const auto& test_case : scenario.test_cases) {
+        auto tc_result = fixture.executeTestCase(test_case);
+        if (verbose) {
+            out << "  " << (tc_result.status == TestStatus::PASSED ? "✓ " : "✗ ")
+                << test_case.name << " " << testStatusToString(tc_result.status);
+            if (!tc_result.error_message.empty()) {
+                out << ": " << tc_result.error_message;
+            }
+            out << "\n";
+        }
+        if (tc_result.status != TestStatus::PASSED) {
+            all_passed = false;
+        }
+        result.test_case_results.push_back(std::move(tc_result));
+    }
+
+    result.status = all_passed ? TestStatus::PASSED : TestStatus::FAILED;
+    result.duration_ms = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+
+    if (verbose) {
+        out << "Scenario result: " << testStatusToString(result.status)
+            << " (" << result.duration_ms << " ms)\n";
+    }
+    return result;
+}
+
+} // namespace
+
+InProcessExecutor::InProcessExecutor(unsigned jobs, bool verbose)
+    : m_jobs(jobs)
+    , m_verbose(verbose) {
+    if (m_jobs == 0) {
+        m_jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<ScenarioResult> InProcessExecutor::executeAll(const std::vector<InProcessJob>& jobs) {
+    std::vector<ScenarioResult> results(jobs.size());
+    std::atomic<size_t> next(0);
+    std::mutex out_mutex;
+
+    // Each worker owns one engine and pulls scenarios until none are left.
+    // Scenario output is buffered so concurrent scenarios don't interleave.
+    auto worker = [&](EngineFixture& fixture) {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            std::ostringstream out;
+            results[i] = executeScenario(fixture, jobs[i], m_verbose, out);
+            std::lock_guard<std::mutex> lock(out_mutex);
+            std::cout << out.str() << std::flush;
+        }
+    };
+
+    // Engines are started and stopped here, one after another, never from the
+    // workers. This also keeps the engine last registered with StrExprArg
+    // alive until every worker is done.
+    size_t worker_count = std::min<size_t>(m_jobs, jobs.size());
+    std::vector<std::unique_ptr<EngineFixture>> fixtures;
+    fixtures.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        fixtures.push_back(std::make_unique<EngineFixture>());
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker, std::ref(*fixtures[i]));
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    fixtures.clear();
+
+    return results;
+}
+
+} // namespace yamy::test
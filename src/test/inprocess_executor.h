@@ -0,0 +1,38 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// inprocess_executor.h - In-process scenario execution for yamy-test-runner
+//
+// Runs test scenarios against Engine instances inside the test runner process
+// instead of a running daemon: input is fed through a mock IInputHook, output
+// is recorded by a mock IInputInjector, and delay_before_ms advances a virtual
+// clock (the kernel event timestamp the engine sees) rather than sleeping.
+// Independent scenarios run concurrently, one engine per worker thread.
+
+#include "test_scenario.h"
+#include <string>
+#include <vector>
+
+namespace yamy::test {
+
+/// Scenario to execute together with the config it should run against
+struct InProcessJob {
+    TestScenario scenario;
+    std::string config_path;  // JSON config loaded into the worker's engine
+};
+
+/// Executes scenarios in-process on a pool of engine workers
+class InProcessExecutor {
+public:
+    /// @param jobs Number of worker threads (0 = hardware concurrency)
+    /// @param verbose Print per-test-case progress
+    InProcessExecutor(unsigned jobs, bool verbose);
+
+    /// Run all jobs; results are returned in the same order as the input
+    std::vector<ScenarioResult> executeAll(const std::vector<InProcessJob>& jobs);
+
+private:
+    unsigned m_jobs;
+    bool m_verbose;
+};
+
+} // namespace yamy::test
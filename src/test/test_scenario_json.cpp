@@ -113,6 +113,32 @@ ScenarioSetup parseScenarioSetup(const json& j) {
     return setup;
 }
 
+// Compare captured output against expected events
+bool verifyOutput(const std::vector<KeyEvent>& expected, const std::vector<CapturedEvent>& actual, std::string& error_msg) {
+    if (expected.size() != actual.size()) {
+        error_msg = "Event count mismatch (expected " + std::to_string(expected.size()) + ", got " + std::to_string(actual.size()) + ")";
+        return false;
+    }
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i].evdev_code != actual[i].evdev_code) {
+            error_msg = "Key code mismatch at position " + std::to_string(i) +
+                       " (expected " + std::to_string(expected[i].evdev_code) +
+                       ", got " + std::to_string(actual[i].evdev_code) + ")";
+            return false;
+        }
+
+        if (expected[i].type != actual[i].type) {
+            error_msg = "Event type mismatch at position " + std::to_string(i) +
+                       " (expected " + eventTypeToString(expected[i].type) +
+                       ", got " + eventTypeToString(actual[i].type) + ")";
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // Load TestScenario from JSON file
 TestScenario loadScenarioFromJson(const std::string& filename) {
     std::ifstream file(filename);
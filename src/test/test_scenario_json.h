@@ -16,6 +16,10 @@ EventType stringToEventType(const std::string& str);
 /// Convert TestStatus to string
 const char* testStatusToString(TestStatus status);
 
+/// Compare captured output against expected events (code and type, in order)
+/// @return true if they match; otherwise error_msg describes the first mismatch
+bool verifyOutput(const std::vector<KeyEvent>& expected, const std::vector<CapturedEvent>& actual, std::string& error_msg);
+
 /// Load test scenario from JSON file
 TestScenario loadScenarioFromJson(const std::string& filename);
 
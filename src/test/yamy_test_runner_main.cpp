@@ -2,10 +2,17 @@
 // yamy-test-runner - E2E test orchestrator for YAMY
 //
 // Executes complete test scenarios: inject input, capture output, verify results
+//
+// Default mode drives a running daemon through uinput in real time. With
+// --in-process (when built against yamy_core) scenarios run against engines
+// inside this process on a virtual clock, several scenarios at a time.
 
 #include "test_scenario.h"
 #include "test_scenario_json.h"
 #include "../../platform/linux/keycode_mapping.h"
+#ifdef YAMY_TEST_RUNNER_INPROCESS
+#include "inprocess_executor.h"
+#endif
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -24,6 +31,7 @@
 #include <mutex>
 #include <signal.h>
 #include <sys/wait.h>
+#include <filesystem>
 
 using namespace yamy::test;
 using namespace std::chrono;
@@ -363,40 +371,23 @@ public:
         return result;
     }
 
-private:
-    bool verifyOutput(const std::vector<KeyEvent>& expected, const std::vector<CapturedEvent>& actual, std::string& error_msg) {
-        if (expected.size() != actual.size()) {
-            error_msg = "Event count mismatch (expected " + std::to_string(expected.size()) + ", got " + std::to_string(actual.size()) + ")";
-            return false;
-        }
-
-        for (size_t i = 0; i < expected.size(); i++) {
-            if (expected[i].evdev_code != actual[i].evdev_code) {
-                error_msg = "Key code mismatch at position " + std::to_string(i) +
-                           " (expected " + std::to_string(expected[i].evdev_code) +
-                           ", got " + std::to_string(actual[i].evdev_code) + ")";
-                return false;
-            }
-
-            if (expected[i].type != actual[i].type) {
-                error_msg = "Event type mismatch at position " + std::to_string(i) +
-                           " (expected " + eventTypeToString(expected[i].type) +
-                           ", got " + eventTypeToString(actual[i].type) + ")";
-                return false;
-            }
-        }
-
-        return true;
-    }
 };
 
 /// CLI tool class
 class YamyTestRunnerTool {
 private:
     TestExecutor m_executor;
+    bool m_verbose;
+    bool m_inProcess;
+    unsigned m_jobs;
+    std::string m_configOverride;
 
 public:
-    YamyTestRunnerTool(bool verbose) : m_executor(verbose) {}
+    YamyTestRunnerTool(bool verbose)
+        : m_executor(verbose)
+        , m_verbose(verbose)
+        , m_inProcess(false)
+        , m_jobs(0) {}
 
     void printUsage() {
         std::cout << "yamy-test-runner - E2E test orchestrator for YAMY\n\n";
@@ -411,14 +402,18 @@ public:
         std::cout << "  --test-case <name>  Run specific test case from scenario\n";
         std::cout << "  --report <file>     Save test report to file (JSON)\n";
         std::cout << "  --quiet             Suppress detailed output\n";
+        std::cout << "  --in-process        Run against in-process engines (no daemon, no sleeps)\n";
+        std::cout << "  --jobs <n>          In-process worker threads (default: CPU count)\n";
+        std::cout << "  --config <file>     In-process JSON config (default: scenario config)\n";
         std::cout << "  --help              Show this help\n\n";
 
         std::cout << "Examples:\n";
         std::cout << "  yamy-test-runner --scenario tests/scenarios/basic_remap.json\n";
         std::cout << "  yamy-test-runner --suite tests/suites/all_features.json\n";
-        std::cout << "  yamy-test-runner --scenario test.json --report results.json\n\n";
+        std::cout << "  yamy-test-runner --scenario test.json --report results.json\n";
+        std::cout << "  yamy-test-runner --suite tests/suites/full_suite.json --in-process --config keymaps/config.json\n\n";
 
-        std::cout << "Prerequisites:\n";
+        std::cout << "Prerequisites (default mode):\n";
         std::cout << "  - YAMY daemon must be running with appropriate config\n";
         std::cout << "  - User must have permission to access /dev/uinput\n";
     }
@@ -456,12 +451,31 @@ public:
             else if (arg == "--report" && i + 1 < argc) {
                 report_file = argv[++i];
             }
+            else if (arg == "--in-process") {
+                m_inProcess = true;
+            }
+            else if (arg == "--jobs" && i + 1 < argc) {
+                m_jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--config" && i + 1 < argc) {
+                m_configOverride = argv[++i];
+            }
+            else if (arg == "--quiet" || arg == "-q") {
+                // Handled in main()
+            }
             else {
                 std::cerr << "Unknown option: " << arg << std::endl;
                 return 1;
             }
         }
 
+#ifndef YAMY_TEST_RUNNER_INPROCESS
+        if (m_inProcess) {
+            std::cerr << "--in-process is not available: yamy-test-runner was built without yamy_core" << std::endl;
+            return 1;
+        }
+#endif
+
         // Execute based on mode
         try {
             if (mode == "scenario") {
@@ -500,7 +514,8 @@ private:
             scenario.test_cases = filtered;
         }
 
-        auto result = m_executor.executeScenario(scenario);
+        auto result = m_inProcess ? executeInProcess({scenario}, {filename}).front()
+                                  : m_executor.executeScenario(scenario);
 
         // Save report if requested
         if (!report_file.empty()) {
@@ -525,10 +540,21 @@ private:
 
         auto suite_start = steady_clock::now();
 
-        for (const auto& scenario_file : suite.scenario_files) {
-            TestScenario scenario = loadScenarioFromJson(scenario_file);
-            auto result = m_executor.executeScenario(scenario);
+        std::vector<ScenarioResult> results;
+        if (m_inProcess) {
+            std::vector<TestScenario> scenarios;
+            for (const auto& scenario_file : suite.scenario_files) {
+                scenarios.push_back(loadScenarioFromJson(scenario_file));
+            }
+            results = executeInProcess(scenarios, suite.scenario_files);
+        } else {
+            for (const auto& scenario_file : suite.scenario_files) {
+                TestScenario scenario = loadScenarioFromJson(scenario_file);
+                results.push_back(m_executor.executeScenario(scenario));
+            }
+        }
 
+        for (const auto& result : results) {
             suite_result.scenario_results.push_back(result);
             suite_result.total_scenarios++;
             suite_result.total_test_cases += result.test_case_results.size();
@@ -557,6 +583,44 @@ private:
         return (suite_result.failed == 0) ? 0 : 1;
     }
 
+    /// Run scenarios on in-process engines; results keep the input order
+    std::vector<ScenarioResult> executeInProcess(const std::vector<TestScenario>& scenarios,
+                                                 const std::vector<std::string>& scenario_files) {
+#ifdef YAMY_TEST_RUNNER_INPROCESS
+        std::vector<InProcessJob> jobs;
+        for (size_t i = 0; i < scenarios.size(); i++) {
+            InProcessJob job;
+            job.scenario = scenarios[i];
+            job.config_path = resolveInProcessConfig(scenarios[i], scenario_files[i]);
+            jobs.push_back(std::move(job));
+        }
+        InProcessExecutor executor(m_jobs, m_verbose);
+        return executor.executeAll(jobs);
+#else
+        (void)scenario_files;
+        return std::vector<ScenarioResult>(scenarios.size());
+#endif
+    }
+
+    /// Pick the JSON config for an in-process scenario: --config wins, then the
+    /// scenario's own config (as given, or relative to the scenario file).
+    /// The engine only loads JSON configs, so .mayu scenarios need --config.
+    std::string resolveInProcessConfig(const TestScenario& scenario, const std::string& scenario_file) {
+        namespace fs = std::filesystem;
+        if (!m_configOverride.empty()) {
+            return m_configOverride;
+        }
+        fs::path config(scenario.config_file);
+        if (config.extension() != ".json") {
+            return "";
+        }
+        fs::path relative = fs::path(scenario_file).parent_path() / config;
+        if (!fs::exists(config) && fs::exists(relative)) {
+            return relative.string();
+        }
+        return config.string();
+    }
+
     void printSuiteSummary(const TestSuiteResult& result) {
         std::cout << "\n╔═══════════════════════════════════════════════════════════╗" << std::endl;
         std::cout << "║  Test Suite Summary" << std::endl;
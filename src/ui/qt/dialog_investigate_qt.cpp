@@ -536,6 +536,25 @@ void DialogInvestigateQt::onIpcMessageReceived(const yamy::ipc::Message& message
             const auto* notification = static_cast<const yamy::ipc::KeyEventNotification*>(message.data);
             m_liveLog->append(QString::fromUtf8(notification->keyEvent));
         }
+    } else if (message.type == yamy::ipc::NtfKeyEventBatch) {
+        if (message.size >= sizeof(yamy::ipc::KeyEventBatchHeader)) {
+            yamy::ipc::KeyEventBatchHeader header;
+            memcpy(&header, message.data, sizeof(header));
+            const char* text = static_cast<const char*>(message.data) + sizeof(header);
+            qsizetype length = static_cast<qsizetype>(message.size - sizeof(header));
+
+            // One append per batch: the text ends in a newline append() adds itself
+            if (length > 0 && text[length - 1] == '\n') {
+                --length;
+            }
+            QString lines = QString::fromUtf8(text, length);
+            if (header.dropped > 0) {
+                lines.prepend(QString("(%1 key events dropped)\n").arg(header.dropped));
+            }
+            if (!lines.isEmpty()) {
+                m_liveLog->append(lines);
+            }
+        }
     }
 }
 
@@ -9,15 +9,23 @@
 #include <QFontDatabase>
 #include <QLabel>
 #include <QMessageBox>
-#include <QScrollBar>
 #include <QSettings>
 #include <QStandardPaths>
-#include <QTextCharFormat>
 // QTextCodec removed in Qt 6 - QTextStream uses UTF-8 by default
-#include <QTextCursor>
-#include <QTextDocument>
 #include <QTextStream>
 
+namespace {
+
+/// A store sharing the Logger's dictionaries, so records copy between them by id
+std::unique_ptr<yamy::logging::LogStore> newLogStore(size_t capacity)
+{
+    auto& logger = yamy::logging::Logger::getInstance();
+    return std::make_unique<yamy::logging::LogStore>(
+        logger.categories(), logger.templates(), capacity);
+}
+
+}  // namespace
+
 DialogLogQt::DialogLogQt(QWidget* parent)
     : QDialog(parent)
     , m_levelFilter(nullptr)
@@ -27,6 +35,7 @@ DialogLogQt::DialogLogQt(QWidget* parent)
     , m_bufferLimitSpinner(nullptr)
     , m_timestampFormatCombo(nullptr)
     , m_statsPanel(nullptr)
+    , m_model(nullptr)
     , m_logView(nullptr)
     , m_btnClear(nullptr)
     , m_btnPause(nullptr)
@@ -41,6 +50,10 @@ DialogLogQt::DialogLogQt(QWidget* parent)
     , m_paused(false)
     , m_entriesWhilePaused(0)
     , m_minLevel(yamy::logging::LogLevel::Trace)
+    , m_pending(newLogStore(MAX_BUFFER_SIZE))
+    , m_draining(newLogStore(MAX_BUFFER_SIZE))
+    , m_flushRequested(false)
+    , m_flushTimer(nullptr)
     , m_searchCaseSensitive(false)
     , m_currentMatchIndex(0)
     , m_totalMatches(0)
@@ -76,13 +89,26 @@ void DialogLogQt::setupUI()
             this, &DialogLogQt::clearLog);
     mainLayout->addWidget(m_statsPanel);
 
-    // Log view
-    m_logView = new QTextEdit();
-    m_logView->setReadOnly(true);
+    // Log view: rows are rendered by the model only when shown
+    auto& logger = yamy::logging::Logger::getInstance();
+    m_model = new yamy::ui::LogViewModel(logger.categories(), logger.templates(),
+                                         MAX_BUFFER_SIZE, this);
+    m_model->setTimeOrigin(std::chrono::duration_cast<std::chrono::milliseconds>(
+        m_dialogStartTime.time_since_epoch()).count());
+    m_logView = new QListView();
+    m_logView->setObjectName("logView");
+    m_logView->setModel(m_model);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
     // Font is set in loadFontSettings()
-    m_logView->setLineWrapMode(QTextEdit::NoWrap);
     mainLayout->addWidget(m_logView);
 
+    // Entries are appended at most once per frame
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &DialogLogQt::flushPendingEntries);
+
     // Bottom controls
     auto* controlLayout = new QHBoxLayout();
 
@@ -257,258 +283,143 @@ void DialogLogQt::setupSearchControls(QVBoxLayout* mainLayout)
 void DialogLogQt::subscribeToLogger()
 {
     auto& logger = yamy::logging::Logger::getInstance();
-    logger.addListener([this](const yamy::logging::LogEntry& entry) {
-        // Copy entry data to capture by value for thread safety
-        CachedLogEntry cached;
-        cached.level = entry.level;
-        cached.category = QString::fromStdString(entry.category);
-        cached.message = QString::fromStdString(entry.message);
-        cached.timestamp = entry.timestamp;
-        cached.plainText = formatLogEntry(entry);
-        cached.htmlText = formatLogEntryHtml(entry);
-
-        // Use QMetaObject::invokeMethod for thread-safe UI update
-        QMetaObject::invokeMethod(this, [this, cached = std::move(cached)]() {
-            processLogEntry(cached);
-        }, Qt::QueuedConnection);
+    logger.addListener([this](const yamy::logging::LogRecord& record) {
+        enqueueRecord(record);
     });
 }
 
 void DialogLogQt::onLogEntry(const yamy::logging::LogEntry& entry)
 {
-    CachedLogEntry cached;
-    cached.level = entry.level;
-    cached.category = QString::fromStdString(entry.category);
-    cached.message = QString::fromStdString(entry.message);
-    cached.timestamp = entry.timestamp;
-    cached.plainText = formatLogEntry(entry);
-    cached.htmlText = formatLogEntryHtml(entry);
-    processLogEntry(cached);
-}
+    const int64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        entry.timestamp.time_since_epoch()).count();
 
-void DialogLogQt::processLogEntry(const CachedLogEntry& entry)
-{
-    m_allEntries.push_back(entry);
-
-    // Update stats by level
-    switch (entry.level) {
-        case yamy::logging::LogLevel::Trace:
-            m_statsPanel->incrementTrace();
-            break;
-        case yamy::logging::LogLevel::Info:
-            m_statsPanel->incrementInfo();
-            break;
-        case yamy::logging::LogLevel::Warning:
-            m_statsPanel->incrementWarning();
-            break;
-        case yamy::logging::LogLevel::Error:
-            m_statsPanel->incrementError();
-            break;
+    bool requestFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending->appendText(timeUs, entry.level, entry.category, entry.message);
+        requestFlush = !m_flushRequested;
+        m_flushRequested = true;
     }
-
-    // Update stats by category
-    m_statsPanel->incrementCategory(entry.category);
-
-    // Trim buffer if needed (removes 10% when limit reached)
-    trimBufferIfNeeded();
-
-    // Update buffer usage display
-    updateBufferUsageDisplay();
-
-    // Display if passes filter
-    if (shouldDisplay(m_allEntries.back())) {
-        m_logView->append(m_allEntries.back().htmlText);
-        if (!m_paused) {
-            scrollToBottom();
-        } else {
-            // Update paused indicator with entry count
-            ++m_entriesWhilePaused;
-            updatePauseIndicator();
-        }
+    if (requestFlush) {
+        QMetaObject::invokeMethod(this, &DialogLogQt::scheduleFlush, Qt::QueuedConnection);
     }
 }
 
-QString DialogLogQt::formatLogEntry(const yamy::logging::LogEntry& entry) const
+void DialogLogQt::enqueueRecord(const yamy::logging::LogRecord& record)
 {
-    QString levelStr;
-    switch (entry.level) {
-        case yamy::logging::LogLevel::Trace:   levelStr = "TRACE"; break;
-        case yamy::logging::LogLevel::Info:    levelStr = "INFO"; break;
-        case yamy::logging::LogLevel::Warning: levelStr = "WARN"; break;
-        case yamy::logging::LogLevel::Error:   levelStr = "ERROR"; break;
+    bool requestFlush = false;
+    {
+        // Copies ids and argument values; nothing is formatted here
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending->append(record);
+        requestFlush = !m_flushRequested;
+        m_flushRequested = true;
     }
 
-    QString timestampStr = formatTimestamp(entry.timestamp);
-    QString result;
-
-    if (!timestampStr.isEmpty()) {
-        result = QString("%1 [%2] [%3] %4")
-            .arg(timestampStr)
-            .arg(levelStr, -5)
-            .arg(QString::fromStdString(entry.category), -8)
-            .arg(QString::fromStdString(entry.message));
-    } else {
-        result = QString("[%1] [%2] %3")
-            .arg(levelStr, -5)
-            .arg(QString::fromStdString(entry.category), -8)
-            .arg(QString::fromStdString(entry.message));
+    // One queued call per batch rather than per entry
+    if (requestFlush) {
+        QMetaObject::invokeMethod(this, &DialogLogQt::scheduleFlush, Qt::QueuedConnection);
     }
-
-    return result;
-}
-
-QString DialogLogQt::escapeHtml(const QString& text)
-{
-    QString escaped = text;
-    escaped.replace('&', "&amp;");
-    escaped.replace('<', "&lt;");
-    escaped.replace('>', "&gt;");
-    return escaped;
 }
 
-QString DialogLogQt::highlightKeywords(const QString& text)
+void DialogLogQt::scheduleFlush()
 {
-    QString result = text;
-    // Highlight DOWN and UP in bold
-    result.replace(" DOWN ", " <b>DOWN</b> ");
-    result.replace(" UP ", " <b>UP</b> ");
-    // Highlight HANDLED in green
-    result.replace("HANDLED", "<span style='color:#228B22;'>HANDLED</span>");
-    // PASSED remains default (no change needed)
-    return result;
+    if (m_flushTimer->isActive()) {
+        return;
+    }
+    qint64 wait = 0;
+    if (m_sinceFlush.isValid()) {
+        wait = std::max<qint64>(0, FRAME_INTERVAL_MS - m_sinceFlush.elapsed());
+    }
+    m_flushTimer->start(static_cast<int>(wait));
 }
 
-QString DialogLogQt::formatLogEntryHtml(const yamy::logging::LogEntry& entry) const
+void DialogLogQt::flushPendingEntries()
 {
-    QString levelStr;
-    QString levelColor;
-    switch (entry.level) {
-        case yamy::logging::LogLevel::Trace:
-            levelStr = "TRACE";
-            levelColor = "#808080";  // Gray
-            break;
-        case yamy::logging::LogLevel::Info:
-            levelStr = "INFO";
-            levelColor.clear();  // Default (no color)
-            break;
-        case yamy::logging::LogLevel::Warning:
-            levelStr = "WARN";
-            levelColor = "#FFA500";  // Orange
-            break;
-        case yamy::logging::LogLevel::Error:
-            levelStr = "ERROR";
-            levelColor = "#FF0000";  // Red
-            break;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.swap(m_draining);
+        m_flushRequested = false;
     }
+    m_flushTimer->stop();
+    m_sinceFlush.start();
 
-    // Escape HTML characters in message
-    QString escapedMessage = escapeHtml(QString::fromStdString(entry.message));
-    QString escapedCategory = escapeHtml(QString::fromStdString(entry.category));
-
-    // Apply keyword highlighting
-    escapedMessage = highlightKeywords(escapedMessage);
+    const yamy::logging::LogStore& batch = *m_draining;
+    if (batch.empty()) {
+        return;
+    }
 
-    // Format the log entry with timestamp
-    QString timestampHtml = formatTimestampHtml(entry.timestamp);
-    QString formattedEntry;
+    for (uint64_t seq = batch.firstSequence(); seq < batch.endSequence(); ++seq) {
+        const yamy::logging::LogRecord record = batch.record(seq);
+
+        // Update stats by level
+        switch (record.level()) {
+            case yamy::logging::LogLevel::Trace:
+                m_statsPanel->incrementTrace();
+                break;
+            case yamy::logging::LogLevel::Info:
+                m_statsPanel->incrementInfo();
+                break;
+            case yamy::logging::LogLevel::Warning:
+                m_statsPanel->incrementWarning();
+                break;
+            case yamy::logging::LogLevel::Error:
+                m_statsPanel->incrementError();
+                break;
+        }
 
-    if (!timestampHtml.isEmpty()) {
-        formattedEntry = QString("%1[%2] [%3] %4")
-            .arg(timestampHtml)
-            .arg(levelStr, -5)
-            .arg(escapedCategory, -8)
-            .arg(escapedMessage);
-    } else {
-        formattedEntry = QString("[%1] [%2] %3")
-            .arg(levelStr, -5)
-            .arg(escapedCategory, -8)
-            .arg(escapedMessage);
+        // Update stats by category
+        m_statsPanel->incrementCategory(m_model->categoryName(record.categoryId()));
     }
 
-    // Wrap in color span if needed
-    if (!levelColor.isEmpty()) {
-        return QString("<span style='color:%1;'>%2</span>")
-            .arg(levelColor)
-            .arg(formattedEntry);
-    }
+    // Entries that would be trimmed right away are never shown
+    const uint64_t from = batch.endSequence() -
+        std::min<uint64_t>(batch.size(), static_cast<uint64_t>(m_maxBufferSize));
+    const int shown = m_model->append(batch, from);
+    m_draining->clear();
 
-    return formattedEntry;
-}
+    // Trim buffer if needed (removes 10% when limit reached)
+    trimBufferIfNeeded();
 
-bool DialogLogQt::shouldDisplay(const CachedLogEntry& entry) const
-{
-    // Check level filter
-    if (entry.level < m_minLevel) {
-        return false;
-    }
+    // Update buffer usage display
+    updateBufferUsageDisplay();
 
-    // Check category filter
-    auto it = m_categoryFilters.find(entry.category);
-    if (it != m_categoryFilters.end()) {
-        return it.value()->isChecked();
+    if (!m_searchText.isEmpty()) {
+        m_totalMatches = m_model->matchCount();
+        m_currentMatchIndex = std::min(m_currentMatchIndex, std::max(0, m_totalMatches - 1));
+        updateSearchButtons();
+        updateSearchStatus();
     }
 
-    // Unknown category - show by default
-    return true;
+    if (shown > 0) {
+        if (!m_paused) {
+            scrollToBottom();
+        } else {
+            // Update paused indicator with entry count
+            m_entriesWhilePaused += shown;
+            updatePauseIndicator();
+        }
+    }
 }
 
-void DialogLogQt::rebuildLogView()
+void DialogLogQt::applyFilter()
 {
-    m_logView->clear();
-
-    for (const auto& entry : m_allEntries) {
-        if (shouldDisplay(entry)) {
-            // Regenerate HTML with current timestamp format
-            QString levelStr;
-            QString levelColor;
-            switch (entry.level) {
-                case yamy::logging::LogLevel::Trace:
-                    levelStr = "TRACE";
-                    levelColor = "#808080";
-                    break;
-                case yamy::logging::LogLevel::Info:
-                    levelStr = "INFO";
-                    levelColor.clear();
-                    break;
-                case yamy::logging::LogLevel::Warning:
-                    levelStr = "WARN";
-                    levelColor = "#FFA500";
-                    break;
-                case yamy::logging::LogLevel::Error:
-                    levelStr = "ERROR";
-                    levelColor = "#FF0000";
-                    break;
-            }
-
-            QString escapedCategory = escapeHtml(entry.category);
-            QString escapedMessage = escapeHtml(entry.message);
-            escapedMessage = highlightKeywords(escapedMessage);
-
-            QString timestampHtml = formatTimestampHtml(entry.timestamp);
-            QString formattedEntry;
-
-            if (!timestampHtml.isEmpty()) {
-                formattedEntry = QString("%1[%2] [%3] %4")
-                    .arg(timestampHtml)
-                    .arg(levelStr, -5)
-                    .arg(escapedCategory, -8)
-                    .arg(escapedMessage);
-            } else {
-                formattedEntry = QString("[%1] [%2] %3")
-                    .arg(levelStr, -5)
-                    .arg(escapedCategory, -8)
-                    .arg(escapedMessage);
-            }
-
-            if (!levelColor.isEmpty()) {
-                m_logView->append(QString("<span style='color:%1;'>%2</span>")
-                    .arg(levelColor)
-                    .arg(formattedEntry));
-            } else {
-                m_logView->append(formattedEntry);
-            }
+    flushPendingEntries();
+
+    QSet<QString> hiddenCategories;
+    for (auto it = m_categoryFilters.cbegin(); it != m_categoryFilters.cend(); ++it) {
+        if (!it.value()->isChecked()) {
+            hiddenCategories.insert(it.key());
         }
     }
+    m_model->setFilter(m_minLevel, hiddenCategories);
+
+    if (!m_searchText.isEmpty()) {
+        m_totalMatches = m_model->matchCount();
+        m_currentMatchIndex = 0;
+        updateSearchButtons();
+        updateSearchStatus();
+    }
 
     if (!m_paused) {
         scrollToBottom();
@@ -519,12 +430,12 @@ void DialogLogQt::onLevelFilterChanged(int index)
 {
     m_minLevel = static_cast<yamy::logging::LogLevel>(
         m_levelFilter->itemData(index).toInt());
-    rebuildLogView();
+    applyFilter();
 }
 
 void DialogLogQt::onCategoryFilterChanged(bool /*checked*/)
 {
-    rebuildLogView();
+    applyFilter();
 }
 
 void DialogLogQt::appendLog(const QString& message)
@@ -540,9 +451,18 @@ void DialogLogQt::appendLog(const QString& message)
 
 void DialogLogQt::clearLog()
 {
-    m_logView->clear();
-    m_allEntries.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending->clear();
+    }
+    m_model->clear();
     m_statsPanel->reset();
+    m_totalMatches = 0;
+    m_currentMatchIndex = 0;
+    if (!m_searchText.isEmpty()) {
+        updateSearchButtons();
+        updateSearchStatus();
+    }
     m_entriesWhilePaused = 0;
     updateBufferUsageDisplay();
     if (m_paused) {
@@ -567,11 +487,12 @@ void DialogLogQt::setAutoScroll(bool enabled)
 
 void DialogLogQt::onClear()
 {
-    if (m_allEntries.size() > 1000) {
+    flushPendingEntries();
+    if (m_model->entryCount() > 1000) {
         int ret = QMessageBox::question(
             this,
             "Clear Log",
-            QString("Clear all %1 log messages?").arg(m_allEntries.size()),
+            QString("Clear all %1 log messages?").arg(m_model->entryCount()),
             QMessageBox::Yes | QMessageBox::No
         );
         if (ret != QMessageBox::Yes) {
@@ -634,23 +555,9 @@ void DialogLogQt::onExport()
     // Qt 6: QTextStream uses UTF-8 by default, no need to set codec
     out.setEncoding(QStringConverter::Utf8);
 
-    int exportedCount = 0;
-
-    if (exportFiltered) {
-        // Export only entries that pass the current filter
-        for (const auto& entry : m_allEntries) {
-            if (shouldDisplay(entry)) {
-                out << entry.plainText << "\n";
-                ++exportedCount;
-            }
-        }
-    } else {
-        // Export all entries
-        for (const auto& entry : m_allEntries) {
-            out << entry.plainText << "\n";
-            ++exportedCount;
-        }
-    }
+    // Include entries still waiting for the next frame
+    flushPendingEntries();
+    int exportedCount = m_model->writeText(out, exportFiltered);
 
     file.close();
 
@@ -698,8 +605,7 @@ void DialogLogQt::updatePauseIndicator()
 
 void DialogLogQt::scrollToBottom()
 {
-    QScrollBar* scrollBar = m_logView->verticalScrollBar();
-    scrollBar->setValue(scrollBar->maximum());
+    m_logView->scrollToBottom();
 }
 
 void DialogLogQt::onFontFamilyChanged(const QFont& /*font*/)
@@ -770,29 +676,24 @@ void DialogLogQt::applyFont()
 
 void DialogLogQt::onSearchTextChanged(const QString& text)
 {
+    flushPendingEntries();
+
     m_searchText = text;
     m_currentMatchIndex = 0;
+    m_totalMatches = m_model->setSearch(
+        text, m_searchCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    updateSearchButtons();
 
     if (text.isEmpty()) {
-        clearSearchHighlights();
-        m_btnFindNext->setEnabled(false);
-        m_btnFindPrev->setEnabled(false);
         m_searchStatus->clear();
-        m_totalMatches = 0;
         return;
     }
 
-    highlightAllMatches();
     updateSearchStatus();
 
-    bool hasMatches = m_totalMatches > 0;
-    m_btnFindNext->setEnabled(hasMatches);
-    m_btnFindPrev->setEnabled(hasMatches);
-
-    // Move cursor to first match if any
-    if (hasMatches) {
-        m_logView->moveCursor(QTextCursor::Start);
-        findMatch(true);
+    // Move to the first match if any
+    if (m_totalMatches > 0) {
+        selectMatch(0);
     }
 }
 
@@ -814,46 +715,11 @@ void DialogLogQt::onCaseSensitiveToggled(bool checked)
     }
 }
 
-void DialogLogQt::highlightAllMatches()
+void DialogLogQt::updateSearchButtons()
 {
-    clearSearchHighlights();
-
-    if (m_searchText.isEmpty()) {
-        m_totalMatches = 0;
-        return;
-    }
-
-    QTextDocument* document = m_logView->document();
-    QTextCursor cursor(document);
-
-    // Define highlight format
-    QTextCharFormat highlightFormat;
-    highlightFormat.setBackground(QColor(255, 255, 0)); // Yellow background
-    highlightFormat.setForeground(QColor(0, 0, 0));     // Black text
-
-    QTextDocument::FindFlags flags;
-    if (m_searchCaseSensitive) {
-        flags |= QTextDocument::FindCaseSensitively;
-    }
-
-    m_totalMatches = 0;
-
-    // Find and highlight all matches
-    cursor = document->find(m_searchText, 0, flags);
-    while (!cursor.isNull()) {
-        cursor.mergeCharFormat(highlightFormat);
-        ++m_totalMatches;
-        cursor = document->find(m_searchText, cursor, flags);
-    }
-}
-
-void DialogLogQt::clearSearchHighlights()
-{
-    // Reset all formatting by rebuilding the log view
-    // This preserves the original HTML formatting
-    if (!m_searchText.isEmpty() || m_totalMatches > 0) {
-        rebuildLogView();
-    }
+    bool hasMatches = !m_searchText.isEmpty() && m_totalMatches > 0;
+    m_btnFindNext->setEnabled(hasMatches);
+    m_btnFindPrev->setEnabled(hasMatches);
 }
 
 void DialogLogQt::updateSearchStatus()
@@ -874,68 +740,31 @@ void DialogLogQt::updateSearchStatus()
     }
 }
 
-int DialogLogQt::countMatches()
-{
-    if (m_searchText.isEmpty()) {
-        return 0;
-    }
-
-    QTextDocument* document = m_logView->document();
-    QTextDocument::FindFlags flags;
-    if (m_searchCaseSensitive) {
-        flags |= QTextDocument::FindCaseSensitively;
-    }
-
-    int count = 0;
-    QTextCursor cursor(document);
-    cursor = document->find(m_searchText, cursor, flags);
-    while (!cursor.isNull()) {
-        ++count;
-        cursor = document->find(m_searchText, cursor, flags);
-    }
-
-    return count;
-}
-
 void DialogLogQt::findMatch(bool forward)
 {
     if (m_searchText.isEmpty() || m_totalMatches == 0) {
         return;
     }
 
-    QTextDocument::FindFlags flags;
-    if (m_searchCaseSensitive) {
-        flags |= QTextDocument::FindCaseSensitively;
-    }
-    if (!forward) {
-        flags |= QTextDocument::FindBackward;
+    // Wrap around at either end
+    if (forward) {
+        selectMatch((m_currentMatchIndex + 1) % m_totalMatches);
+    } else {
+        selectMatch((m_currentMatchIndex - 1 + m_totalMatches) % m_totalMatches);
     }
+}
 
-    bool found = m_logView->find(m_searchText, flags);
-
-    if (!found) {
-        // Wrap around
-        QTextCursor cursor = m_logView->textCursor();
-        if (forward) {
-            cursor.movePosition(QTextCursor::Start);
-            m_currentMatchIndex = 0;
-        } else {
-            cursor.movePosition(QTextCursor::End);
-            m_currentMatchIndex = m_totalMatches - 1;
-        }
-        m_logView->setTextCursor(cursor);
-        m_logView->find(m_searchText, flags);
-    } else {
-        // Update match index
-        if (forward) {
-            m_currentMatchIndex = (m_currentMatchIndex + 1) % m_totalMatches;
-        } else {
-            m_currentMatchIndex = (m_currentMatchIndex - 1 + m_totalMatches) % m_totalMatches;
-        }
+void DialogLogQt::selectMatch(int matchIndex)
+{
+    int row = m_model->matchRow(matchIndex);
+    if (row < 0) {
+        return;
     }
 
-    // Ensure the match is visible
-    m_logView->ensureCursorVisible();
+    m_currentMatchIndex = matchIndex;
+    QModelIndex index = m_model->index(row);
+    m_logView->setCurrentIndex(index);
+    m_logView->scrollTo(index, QAbstractItemView::PositionAtCenter);
     updateSearchStatus();
 }
 
@@ -968,19 +797,16 @@ void DialogLogQt::onBufferLimitChanged(int value)
     m_maxBufferSize = value;
     saveBufferSettings();
 
-    // If current buffer exceeds new limit, trim immediately
+    // If current buffer exceeds new limit, trim immediately; the model
+    // removes the trimmed rows from the view
     trimBufferIfNeeded();
     updateBufferUsageDisplay();
-
-    // Rebuild view if entries were trimmed
-    if (!m_allEntries.empty()) {
-        rebuildLogView();
-    }
 }
 
 void DialogLogQt::trimBufferIfNeeded()
 {
-    if (m_allEntries.size() > static_cast<size_t>(m_maxBufferSize)) {
+    const size_t entryCount = m_model->entryCount();
+    if (entryCount > static_cast<size_t>(m_maxBufferSize)) {
         // Remove oldest 10% when limit is exceeded to avoid frequent trimming
         size_t trimCount = static_cast<size_t>(m_maxBufferSize) / 10;
         if (trimCount < 1) {
@@ -988,20 +814,16 @@ void DialogLogQt::trimBufferIfNeeded()
         }
 
         // Calculate how many entries to remove to get back under limit
-        size_t excess = m_allEntries.size() - static_cast<size_t>(m_maxBufferSize);
+        size_t excess = entryCount - static_cast<size_t>(m_maxBufferSize);
         size_t toRemove = std::max(trimCount, excess);
 
-        m_allEntries.erase(m_allEntries.begin(),
-                          m_allEntries.begin() + static_cast<std::ptrdiff_t>(toRemove));
-
-        // Rebuild the view after trimming (only if not triggered from rebuildLogView)
-        // Note: rebuildLogView will be called separately when needed
+        m_model->dropOldest(toRemove);
     }
 }
 
 void DialogLogQt::updateBufferUsageDisplay()
 {
-    m_statsPanel->setBufferUsage(static_cast<int>(m_allEntries.size()), m_maxBufferSize);
+    m_statsPanel->setBufferUsage(static_cast<int>(m_model->entryCount()), m_maxBufferSize);
 }
 
 void DialogLogQt::loadTimestampSettings()
@@ -1021,6 +843,8 @@ void DialogLogQt::loadTimestampSettings()
     m_timestampFormatCombo->blockSignals(true);
     m_timestampFormatCombo->setCurrentIndex(savedFormat);
     m_timestampFormatCombo->blockSignals(false);
+
+    m_model->setTimestampFormat(m_timestampFormat);
 }
 
 void DialogLogQt::saveTimestampSettings()
@@ -1035,61 +859,5 @@ void DialogLogQt::onTimestampFormatChanged(int index)
     m_timestampFormat = static_cast<TimestampFormat>(
         m_timestampFormatCombo->itemData(index).toInt());
     saveTimestampSettings();
-    rebuildLogView();
-}
-
-QString DialogLogQt::formatTimestamp(const std::chrono::system_clock::time_point& timestamp) const
-{
-    switch (m_timestampFormat) {
-        case TimestampFormat::Absolute: {
-            auto time_t_val = std::chrono::system_clock::to_time_t(timestamp);
-            std::tm tm{};
-#ifdef _WIN32
-            localtime_s(&tm, &time_t_val);
-#else
-            localtime_r(&time_t_val, &tm);
-#endif
-
-            // Get milliseconds
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                timestamp.time_since_epoch()) % 1000;
-
-            char timeBuf[32];
-            std::strftime(timeBuf, sizeof(timeBuf), "%H:%M:%S", &tm);
-            return QString("[%1.%2]")
-                .arg(timeBuf)
-                .arg(ms.count(), 3, 10, QChar('0'));
-        }
-        case TimestampFormat::Relative: {
-            auto duration = timestamp - m_dialogStartTime;
-            auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-
-            // Handle negative durations (entries from before dialog opened)
-            if (totalMs < 0) {
-                totalMs = 0;
-            }
-
-            auto minutes = totalMs / 60000;
-            auto seconds = (totalMs % 60000) / 1000;
-            auto ms = totalMs % 1000;
-
-            return QString("[+%1:%2.%3]")
-                .arg(minutes, 2, 10, QChar('0'))
-                .arg(seconds, 2, 10, QChar('0'))
-                .arg(ms, 3, 10, QChar('0'));
-        }
-        case TimestampFormat::None:
-            return QString();
-    }
-    return QString();
-}
-
-QString DialogLogQt::formatTimestampHtml(const std::chrono::system_clock::time_point& timestamp) const
-{
-    QString ts = formatTimestamp(timestamp);
-    if (ts.isEmpty()) {
-        return QString();
-    }
-    // Wrap timestamp in a span with gray color for readability
-    return QString("<span style='color:#666666;'>%1</span> ").arg(ts);
+    m_model->setTimestampFormat(m_timestampFormat);
 }
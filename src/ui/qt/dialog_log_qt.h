@@ -3,6 +3,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDialog>
+#include <QElapsedTimer>
 #include <QFontComboBox>
 #include <QGroupBox>
 #include <QHBoxLayout>
@@ -10,24 +11,18 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QListView>
 #include <QSpinBox>
 #include <QString>
-#include <QTextEdit>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <chrono>
-#include <vector>
+#include <memory>
+#include <mutex>
 
 #include "core/logging/log_entry.h"
-
-/**
- * @brief Timestamp display format options for log entries
- */
-enum class TimestampFormat {
-    Absolute,  ///< Show absolute time: HH:MM:SS.mmm
-    Relative,  ///< Show time relative to dialog start: +MM:SS.mmm
-    None       ///< Hide timestamps
-};
+#include "core/logging/log_store.h"
+#include "log_view_model.h"
 
 namespace yamy {
 namespace ui {
@@ -45,7 +40,8 @@ class LogStatsPanel;
  * - Auto-scroll to latest messages
  * - Clear log functionality
  * - Save to file
- * - Thread-safe updates via QMetaObject::invokeMethod
+ * - Thread-safe updates: entries are queued from any thread and appended
+ *   to the view in batches, at most once per frame
  */
 class DialogLogQt : public QDialog {
     Q_OBJECT
@@ -67,6 +63,11 @@ public slots:
      */
     void onLogEntry(const yamy::logging::LogEntry& entry);
 
+    /**
+     * @brief Append queued entries now instead of at the next frame
+     */
+    void flushPendingEntries();
+
     void clearLog();
     void setAutoScroll(bool enabled);
 
@@ -85,29 +86,16 @@ private slots:
     void onCaseSensitiveToggled(bool checked);
     void onBufferLimitChanged(int value);
     void onTimestampFormatChanged(int index);
+    void scheduleFlush();
 
 private:
-    struct CachedLogEntry {
-        yamy::logging::LogLevel level;
-        QString category;
-        QString message;  ///< Original message text
-        QString plainText;
-        QString htmlText;
-        std::chrono::system_clock::time_point timestamp;  ///< Original timestamp for reformatting
-    };
-
     void setupUI();
     void setupFilterControls(QVBoxLayout* mainLayout);
     void setupFontControls(QHBoxLayout* filterLayout);
     void subscribeToLogger();
+    void enqueueRecord(const yamy::logging::LogRecord& record);
     void scrollToBottom();
-    void rebuildLogView();
-    void processLogEntry(const CachedLogEntry& entry);
-    bool shouldDisplay(const CachedLogEntry& entry) const;
-    QString formatLogEntry(const yamy::logging::LogEntry& entry) const;
-    QString formatLogEntryHtml(const yamy::logging::LogEntry& entry) const;
-    static QString escapeHtml(const QString& text);
-    static QString highlightKeywords(const QString& text);
+    void applyFilter();
     void loadFontSettings();
     void saveFontSettings();
     void applyFont();
@@ -119,13 +107,10 @@ private:
     void setupSearchControls(QVBoxLayout* mainLayout);
     void loadTimestampSettings();
     void saveTimestampSettings();
-    QString formatTimestamp(const std::chrono::system_clock::time_point& timestamp) const;
-    QString formatTimestampHtml(const std::chrono::system_clock::time_point& timestamp) const;
-    void highlightAllMatches();
-    void clearSearchHighlights();
     void updateSearchStatus();
-    int countMatches();
+    void updateSearchButtons();
     void findMatch(bool forward);
+    void selectMatch(int matchIndex);
 
     // Filter controls
     QComboBox* m_levelFilter;
@@ -144,7 +129,8 @@ private:
 
     // UI Components
     yamy::ui::LogStatsPanel* m_statsPanel;
-    QTextEdit* m_logView;
+    yamy::ui::LogViewModel* m_model;
+    QListView* m_logView;
     QPushButton* m_btnClear;
     QPushButton* m_btnPause;
     QPushButton* m_btnSave;
@@ -162,7 +148,17 @@ private:
     bool m_paused;
     int m_entriesWhilePaused;
     yamy::logging::LogLevel m_minLevel;
-    std::vector<CachedLogEntry> m_allEntries;
+
+    // Records queued by the logger, appended once per frame. The flush
+    // swaps the two stores, so the logger keeps appending to one while the
+    // other is drained, and neither reallocates once grown.
+    std::mutex m_pendingMutex;
+    std::unique_ptr<yamy::logging::LogStore> m_pending;  ///< Guarded by m_pendingMutex
+    std::unique_ptr<yamy::logging::LogStore> m_draining;
+    bool m_flushRequested;              ///< Guarded by m_pendingMutex
+    QTimer* m_flushTimer;
+    QElapsedTimer m_sinceFlush;
+    static constexpr int FRAME_INTERVAL_MS = 16;
 
     // Search state
     QString m_searchText;
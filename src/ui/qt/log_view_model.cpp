@@ -0,0 +1,393 @@
+#include "log_view_model.h"
+#include <QColor>
+#include <algorithm>
+#include <ctime>
+
+namespace yamy {
+namespace ui {
+
+namespace {
+
+using yamy::logging::LogLevel;
+using yamy::logging::LogRecord;
+
+const char* levelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Trace:   return "TRACE";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error:   return "ERROR";
+    }
+    return "";
+}
+
+/// Remove the sequence numbers failing pred, keeping the order
+template <typename Pred>
+void eraseIf(std::deque<uint64_t>& seqs, Pred pred)
+{
+    seqs.erase(std::remove_if(seqs.begin(), seqs.end(), pred), seqs.end());
+}
+
+}  // namespace
+
+LogViewModel::LogViewModel(yamy::logging::LogDictionary& categories,
+                           yamy::logging::LogDictionary& templates,
+                           size_t capacity, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_store(categories, templates, capacity)
+    , m_minLevel(LogLevel::Trace)
+    , m_searchCase(Qt::CaseInsensitive)
+    , m_timestampFormat(TimestampFormat::Absolute)
+    , m_timeOriginMs(0)
+{
+}
+
+LogViewModel::~LogViewModel() = default;
+
+int LogViewModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_rows.size());
+}
+
+QVariant LogViewModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const uint64_t seq = m_rows[static_cast<size_t>(index.row())];
+    switch (role) {
+        case Qt::DisplayRole:
+            return formatEntry(seq);
+
+        case Qt::ForegroundRole:
+            if (isMatch(seq)) {
+                return QColor(0, 0, 0);
+            }
+            switch (m_store.record(seq).level()) {
+                case LogLevel::Trace:   return QColor(0x80, 0x80, 0x80);
+                case LogLevel::Warning: return QColor(0xFF, 0xA5, 0x00);
+                case LogLevel::Error:   return QColor(0xFF, 0x00, 0x00);
+                case LogLevel::Info:    break;
+            }
+            return QVariant();
+
+        case Qt::BackgroundRole:
+            if (isMatch(seq)) {
+                return QColor(255, 255, 0);
+            }
+            return QVariant();
+
+        default:
+            return QVariant();
+    }
+}
+
+int LogViewModel::append(const yamy::logging::LogStore& batch, uint64_t from)
+{
+    // Make room first, so rows are removed before their entries go
+    from = m_store.fittingTail(batch, from);
+    dropOldest(m_store.evictionsToFit(batch, from));
+    if (from >= batch.endSequence()) {
+        return 0;
+    }
+
+    const uint64_t firstNew = m_store.endSequence();
+    for (uint64_t seq = from; seq < batch.endSequence(); ++seq) {
+        m_store.append(batch.record(seq));
+    }
+
+    // Only the new entries are tested against the filter and search
+    std::vector<uint64_t> shown;
+    shown.reserve(static_cast<size_t>(m_store.endSequence() - firstNew));
+    for (uint64_t seq = firstNew; seq < m_store.endSequence(); ++seq) {
+        if (passesFilter(seq)) {
+            shown.push_back(seq);
+        }
+    }
+    if (shown.empty()) {
+        return 0;
+    }
+
+    if (!m_searchText.isEmpty()) {
+        for (uint64_t seq : shown) {
+            if (matchesSearch(seq)) {
+                m_matches.push_back(seq);
+            }
+        }
+    }
+
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(shown.size()) - 1);
+    m_rows.insert(m_rows.end(), shown.begin(), shown.end());
+    endInsertRows();
+    return static_cast<int>(shown.size());
+}
+
+void LogViewModel::dropOldest(size_t count)
+{
+    count = std::min(count, entryCount());
+    if (count == 0) {
+        return;
+    }
+
+    const uint64_t newFirst = m_store.firstSequence() + count;
+    auto rowEnd = std::lower_bound(m_rows.begin(), m_rows.end(), newFirst);
+    const int removed = static_cast<int>(rowEnd - m_rows.begin());
+    if (removed > 0) {
+        beginRemoveRows(QModelIndex(), 0, removed - 1);
+        m_rows.erase(m_rows.begin(), rowEnd);
+        m_matches.erase(m_matches.begin(),
+                        std::lower_bound(m_matches.begin(), m_matches.end(), newFirst));
+        endRemoveRows();
+    }
+    m_store.dropOldest(count);
+}
+
+void LogViewModel::clear()
+{
+    beginResetModel();
+    m_store.clear();
+    m_rows.clear();
+    m_matches.clear();
+    endResetModel();
+}
+
+const QString& LogViewModel::categoryName(uint16_t categoryId) const
+{
+    cacheCategories(categoryId);
+    return m_categoryNames[categoryId];
+}
+
+void LogViewModel::setFilter(LogLevel minLevel, const QSet<QString>& hiddenCategories)
+{
+    if (minLevel == m_minLevel && hiddenCategories == m_hiddenCategories) {
+        return;
+    }
+
+    // A filter that only hides more can only remove rows
+    const bool narrowing = minLevel >= m_minLevel &&
+                           hiddenCategories.contains(m_hiddenCategories);
+
+    m_minLevel = minLevel;
+    m_hiddenCategories = hiddenCategories;
+    for (size_t id = 0; id < m_categoryNames.size(); ++id) {
+        m_categoryHidden[id] = hiddenCategories.contains(m_categoryNames[id]) ? 1 : 0;
+    }
+
+    beginResetModel();
+    if (narrowing) {
+        auto fails = [this](uint64_t seq) { return !passesFilter(seq); };
+        eraseIf(m_rows, fails);
+        eraseIf(m_matches, fails);
+    } else {
+        m_rows.clear();
+        m_matches.clear();
+        for (uint64_t seq = m_store.firstSequence(); seq < m_store.endSequence(); ++seq) {
+            if (passesFilter(seq)) {
+                m_rows.push_back(seq);
+                if (!m_searchText.isEmpty() && matchesSearch(seq)) {
+                    m_matches.push_back(seq);
+                }
+            }
+        }
+    }
+    endResetModel();
+}
+
+void LogViewModel::setTimestampFormat(TimestampFormat format)
+{
+    if (format == m_timestampFormat) {
+        return;
+    }
+    m_timestampFormat = format;
+    if (!m_rows.empty()) {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole});
+    }
+}
+
+void LogViewModel::setTimeOrigin(qint64 originMs)
+{
+    m_timeOriginMs = originMs;
+}
+
+int LogViewModel::setSearch(const QString& text, Qt::CaseSensitivity caseSensitivity)
+{
+    // Typing more of the same query only narrows the previous matches
+    const bool refine = !m_searchText.isEmpty() &&
+                        caseSensitivity == m_searchCase &&
+                        text.contains(m_searchText, caseSensitivity);
+
+    m_searchText = text;
+    m_searchCase = caseSensitivity;
+
+    if (text.isEmpty()) {
+        m_matches.clear();
+    } else if (refine) {
+        eraseIf(m_matches, [this](uint64_t seq) { return !matchesSearch(seq); });
+    } else {
+        m_matches.clear();
+        for (uint64_t seq : m_rows) {
+            if (matchesSearch(seq)) {
+                m_matches.push_back(seq);
+            }
+        }
+    }
+
+    if (!m_rows.empty()) {
+        emit dataChanged(index(0), index(rowCount() - 1),
+                         {Qt::ForegroundRole, Qt::BackgroundRole});
+    }
+    return matchCount();
+}
+
+int LogViewModel::matchRow(int matchIndex) const
+{
+    if (matchIndex < 0 || matchIndex >= matchCount()) {
+        return -1;
+    }
+    const uint64_t seq = m_matches[static_cast<size_t>(matchIndex)];
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), seq);
+    return static_cast<int>(it - m_rows.begin());
+}
+
+QString LogViewModel::rowText(int row) const
+{
+    if (row < 0 || row >= rowCount()) {
+        return QString();
+    }
+    return formatEntry(m_rows[static_cast<size_t>(row)]);
+}
+
+int LogViewModel::writeText(QTextStream& out, bool visibleOnly) const
+{
+    int written = 0;
+    for (uint64_t seq = m_store.firstSequence(); seq < m_store.endSequence(); ++seq) {
+        if (visibleOnly && !passesFilter(seq)) {
+            continue;
+        }
+        out << formatEntry(seq) << "\n";
+        ++written;
+    }
+    return written;
+}
+
+void LogViewModel::cacheCategories(uint16_t categoryId) const
+{
+    const auto& dictionary = m_store.categories();
+    while (m_categoryNames.size() <= categoryId) {
+        const auto id = static_cast<uint32_t>(m_categoryNames.size());
+        const std::string_view name = dictionary.text(id);
+        m_categoryNames.push_back(QString::fromUtf8(name.data(), static_cast<int>(name.size())));
+        m_categoryHidden.push_back(m_hiddenCategories.contains(m_categoryNames.back()) ? 1 : 0);
+    }
+}
+
+bool LogViewModel::isCategoryHidden(uint16_t categoryId) const
+{
+    cacheCategories(categoryId);
+    return m_categoryHidden[categoryId] != 0;
+}
+
+bool LogViewModel::passesFilter(uint64_t seq) const
+{
+    const LogRecord record = m_store.record(seq);
+    if (record.level() < m_minLevel) {
+        return false;
+    }
+    return !isCategoryHidden(record.categoryId());
+}
+
+bool LogViewModel::matchesSearch(uint64_t seq) const
+{
+    const LogRecord record = m_store.record(seq);
+    return messageText(record).contains(m_searchText, m_searchCase) ||
+           categoryName(record.categoryId()).contains(m_searchText, m_searchCase);
+}
+
+QString LogViewModel::messageText(const LogRecord& record) const
+{
+    if (record.argCount() == 0) {
+        // The template is the text; convert it once per template
+        const uint16_t id = record.templateId();
+        if (m_templateTexts.size() <= id) {
+            m_templateTexts.resize(static_cast<size_t>(id) + 1);
+        }
+        QString& text = m_templateTexts[id];
+        if (text.isNull()) {
+            const std::string_view tmpl = record.messageTemplate();
+            text = QString::fromUtf8(tmpl.data(), static_cast<int>(tmpl.size()));
+        }
+        return text;
+    }
+
+    std::string message;
+    record.appendMessage(message);
+    return QString::fromStdString(message);
+}
+
+bool LogViewModel::isMatch(uint64_t seq) const
+{
+    return std::binary_search(m_matches.begin(), m_matches.end(), seq);
+}
+
+QString LogViewModel::formatEntry(uint64_t seq) const
+{
+    const LogRecord record = m_store.record(seq);
+    const QString levelStr = levelName(record.level());
+    const QString& category = categoryName(record.categoryId());
+    const QString message = messageText(record);
+    const QString timestampStr = formatTimestamp(record.timeUs() / 1000);
+
+    if (!timestampStr.isEmpty()) {
+        return QString("%1 [%2] [%3] %4")
+            .arg(timestampStr)
+            .arg(levelStr, -5)
+            .arg(category, -8)
+            .arg(message);
+    }
+    return QString("[%1] [%2] %3")
+        .arg(levelStr, -5)
+        .arg(category, -8)
+        .arg(message);
+}
+
+QString LogViewModel::formatTimestamp(qint64 timeMs) const
+{
+    switch (m_timestampFormat) {
+        case TimestampFormat::Absolute: {
+            auto time_t_val = static_cast<std::time_t>(timeMs / 1000);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &time_t_val);
+#else
+            localtime_r(&time_t_val, &tm);
+#endif
+
+            char timeBuf[32];
+            std::strftime(timeBuf, sizeof(timeBuf), "%H:%M:%S", &tm);
+            return QString("[%1.%2]")
+                .arg(timeBuf)
+                .arg(timeMs % 1000, 3, 10, QChar('0'));
+        }
+        case TimestampFormat::Relative: {
+            // Entries from before the dialog opened show as +00:00.000
+            const qint64 totalMs = std::max<qint64>(0, timeMs - m_timeOriginMs);
+
+            return QString("[+%1:%2.%3]")
+                .arg(totalMs / 60000, 2, 10, QChar('0'))
+                .arg((totalMs % 60000) / 1000, 2, 10, QChar('0'))
+                .arg(totalMs % 1000, 3, 10, QChar('0'));
+        }
+        case TimestampFormat::None:
+            return QString();
+    }
+    return QString();
+}
+
+}  // namespace ui
+}  // namespace yamy
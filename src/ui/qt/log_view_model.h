@@ -0,0 +1,143 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QSet>
+#include <QString>
+#include <QTextStream>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "core/logging/log_store.h"
+
+/**
+ * @brief Timestamp display format options for log entries
+ */
+enum class TimestampFormat {
+    Absolute,  ///< Show absolute time: HH:MM:SS.mmm
+    Relative,  ///< Show time relative to dialog start: +MM:SS.mmm
+    None       ///< Hide timestamps
+};
+
+namespace yamy {
+namespace ui {
+
+/**
+ * @brief List model behind the log viewer
+ *
+ * Entries are kept in a LogStore sharing the Logger's dictionaries: per
+ * entry a timestamp, level, category and template ids and the unformatted
+ * arguments. Text is built only when the view asks for a row, on search
+ * and on export, so the view only formats the rows on screen.
+ *
+ * Rows are the entries passing the level and category filter, held as a
+ * sorted index of entry sequence numbers. Appending tests only the new
+ * entries; a narrowing filter or search only re-tests the rows that
+ * currently pass. Search results are a second sorted index, so the
+ * highlight of a row and the row of a match are binary searches.
+ *
+ * Not thread-safe: use from the GUI thread.
+ */
+class LogViewModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @param categories Category dictionary of the stores appended from
+     * @param templates Template dictionary of the stores appended from
+     * @param capacity Most entries kept; the oldest are dropped past it
+     */
+    LogViewModel(yamy::logging::LogDictionary& categories,
+                 yamy::logging::LogDictionary& templates,
+                 size_t capacity, QObject* parent = nullptr);
+    ~LogViewModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Append a batch's records from sequence from on
+     *
+     * The batch must share the model's dictionaries. Entries that do not
+     * fit are dropped oldest first, the batch's own included.
+     *
+     * @return Number of rows the batch added to the view
+     */
+    int append(const yamy::logging::LogStore& batch, uint64_t from);
+
+    /// Drop the oldest entries and their rows
+    void dropOldest(size_t count);
+
+    void clear();
+
+    /// Number of stored entries, shown or not
+    size_t entryCount() const { return m_store.size(); }
+
+    /// Name of an interned category
+    const QString& categoryName(uint16_t categoryId) const;
+
+    /// Show entries at or above minLevel whose category is not hidden
+    void setFilter(yamy::logging::LogLevel minLevel, const QSet<QString>& hiddenCategories);
+
+    void setTimestampFormat(TimestampFormat format);
+
+    /// Origin of relative timestamps, in milliseconds since the epoch
+    void setTimeOrigin(qint64 originMs);
+
+    /**
+     * @brief Highlight rows whose category or message contains text
+     * @return Number of matching rows
+     */
+    int setSearch(const QString& text, Qt::CaseSensitivity caseSensitivity);
+
+    int matchCount() const { return static_cast<int>(m_matches.size()); }
+
+    /// Row of the index-th match
+    int matchRow(int matchIndex) const;
+
+    /// Plain text of a row, formatted like the view shows it
+    QString rowText(int row) const;
+
+    /**
+     * @brief Write entries as plain text lines
+     * @param visibleOnly Write only the entries passing the filter
+     * @return Number of lines written
+     */
+    int writeText(QTextStream& out, bool visibleOnly) const;
+
+private:
+    bool passesFilter(uint64_t seq) const;
+    bool matchesSearch(uint64_t seq) const;
+    bool isMatch(uint64_t seq) const;
+    void cacheCategories(uint16_t categoryId) const;
+    bool isCategoryHidden(uint16_t categoryId) const;
+    QString messageText(const yamy::logging::LogRecord& record) const;
+    QString formatEntry(uint64_t seq) const;
+    QString formatTimestamp(qint64 timeMs) const;
+
+    yamy::logging::LogStore m_store;
+
+    // Per dictionary id, filled in as ids show up
+    mutable std::vector<QString> m_categoryNames;
+    mutable std::vector<uint8_t> m_categoryHidden;
+    mutable std::vector<QString> m_templateTexts;   ///< Text of argument-less records
+
+    // Sorted sequence numbers of the rows and of the matching rows
+    std::deque<uint64_t> m_rows;
+    std::deque<uint64_t> m_matches;
+
+    // Filter
+    yamy::logging::LogLevel m_minLevel;
+    QSet<QString> m_hiddenCategories;
+
+    // Search
+    QString m_searchText;
+    Qt::CaseSensitivity m_searchCase;
+
+    // Formatting
+    TimestampFormat m_timestampFormat;
+    qint64 m_timeOriginMs;
+};
+
+}  // namespace ui
+}  // namespace yamy
@@ -613,7 +613,7 @@ void SystemTrayAppIndicator::onReload()
         std::string currentConfigPath = configs[activeIndex].path;
 
         // Reload configuration via Engine
-        bool success = m_engine->switchConfiguration(currentConfigPath);
+        bool success = m_engine->reloadConfiguration(currentConfigPath);
 
         if (success) {
             showNotification("Configuration Reloaded",
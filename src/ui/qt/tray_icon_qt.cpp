@@ -220,7 +220,7 @@ void TrayIconQt::onReload()
         
         // Reload configuration via Engine
         // This will trigger a re-parse and update keymaps
-        bool success = m_engine->switchConfiguration(currentConfigPath);
+        bool success = m_engine->reloadConfiguration(currentConfigPath);
         
         if (success) {
             showNotification(
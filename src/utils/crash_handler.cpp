@@ -33,6 +33,7 @@ char g_version[MAX_VERSION_LEN] = "unknown";
 char g_configPath[MAX_CONFIG_PATH_LEN] = "";
 char g_crashDir[MAX_PATH_LEN] = "";
 bool g_installed = false;
+void (*volatile g_emergencyHandler)() = nullptr;
 
 // Original signal handlers (to chain to after report generation)
 struct sigaction g_oldSigsegv;
@@ -250,6 +251,10 @@ void CrashHandler::setConfigPath(const std::string& configPath) {
     safeStrcpy(g_configPath, configPath.c_str(), MAX_CONFIG_PATH_LEN);
 }
 
+void CrashHandler::setEmergencyHandler(void (*handler)()) {
+    g_emergencyHandler = handler;
+}
+
 std::string CrashHandler::getCrashDir() {
     return getDataDir() + "/crashes";
 }
@@ -302,6 +307,12 @@ int CrashHandler::deleteAllCrashReports() {
 }
 
 void CrashHandler::signalHandler(int sig, siginfo_t* info, void* context) {
+    // Release what must not outlive us first, in case writing the report hangs
+    void (*emergency)() = g_emergencyHandler;
+    if (emergency) {
+        emergency();
+    }
+
     // Write crash report using async-signal-safe operations
     writeCrashReport(sig, info, context);
 
@@ -458,6 +469,7 @@ namespace yamy {
     void CrashHandler::uninstall() {}
     void CrashHandler::setVersion(const std::string&) {}
     void CrashHandler::setConfigPath(const std::string&) {}
+    void CrashHandler::setEmergencyHandler(void (*)()) {}
     bool CrashHandler::hasCrashReports() { return false; }
     std::vector<std::string> CrashHandler::getCrashReports() { return {}; }
     bool CrashHandler::deleteCrashReport(const std::string&) { return false; }
@@ -46,6 +46,11 @@ public:
     /// @param configPath Path to the active configuration file
     static void setConfigPath(const std::string& configPath);
 
+    /// Set a function run first when a crash signal arrives, before the
+    /// report is written (e.g. to release grabbed input devices)
+    /// @param handler Must be async-signal-safe; nullptr clears it
+    static void setEmergencyHandler(void (*handler)());
+
     /// Get the crash reports directory path
     /// @return Path to ~/.local/share/yamy/crashes/
     static std::string getCrashDir();
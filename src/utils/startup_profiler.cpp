@@ -0,0 +1,124 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// startup_profiler.cpp - Startup phase trace for the daemon
+//
+
+#include "startup_profiler.h"
+#include <algorithm>
+#include <limits>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace yamy::metrics {
+
+StartupProfiler::StartupProfiler()
+    : m_origin(std::chrono::steady_clock::now())
+    , m_isFirstKeySeen(false)
+    , m_isComplete(false)
+{
+}
+
+uint64_t StartupProfiler::nowUs() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_origin).count());
+}
+
+uint64_t StartupProfiler::threadCpuUs()
+{
+#ifndef _WIN32
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL +
+               static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+    }
+#endif
+    return 0;
+}
+
+void StartupProfiler::record(const char* name, uint64_t startUs, uint64_t wallUs, uint64_t cpuUs)
+{
+    if (m_isComplete.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    StartupPhase phase;
+    phase.name = name;
+    phase.startUs = startUs;
+    phase.wallUs = wallUs;
+    phase.cpuUs = cpuUs;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.push_back(std::move(phase));
+}
+
+void StartupProfiler::mark(const char* name)
+{
+    const uint64_t at = nowUs();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& milestone : m_milestones) {
+        if (milestone.name == name) {
+            return;
+        }
+    }
+    m_milestones.push_back(StartupMilestone{name, at});
+    if (m_milestones.back().name == Milestones::STARTUP_COMPLETE) {
+        m_isComplete.store(true, std::memory_order_relaxed);
+    }
+}
+
+void StartupProfiler::markFirstKey()
+{
+    if (!m_isFirstKeySeen.exchange(true, std::memory_order_relaxed)) {
+        mark(Milestones::FIRST_KEY);
+    }
+}
+
+std::vector<StartupPhase> StartupProfiler::phases() const
+{
+    std::vector<StartupPhase> result;
+    uint64_t hookLiveUs = std::numeric_limits<uint64_t>::max();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        result = m_phases;
+        for (const auto& milestone : m_milestones) {
+            if (milestone.name == Milestones::HOOK_LIVE) {
+                hookLiveUs = milestone.atUs;
+            }
+        }
+    }
+    for (auto& phase : result) {
+        phase.isDeferred = phase.startUs >= hookLiveUs;
+    }
+    // Phases are recorded when they end; report them in start order
+    std::stable_sort(result.begin(), result.end(),
+                     [](const StartupPhase& a, const StartupPhase& b) {
+                         return a.startUs < b.startUs;
+                     });
+    return result;
+}
+
+std::vector<StartupMilestone> StartupProfiler::milestones() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_milestones;
+}
+
+StartupProfiler::Scope::Scope(const char* name)
+    : m_name(name)
+    , m_startUs(StartupProfiler::instance().nowUs())
+    , m_startCpuUs(StartupProfiler::threadCpuUs())
+{
+}
+
+StartupProfiler::Scope::~Scope()
+{
+    StartupProfiler& profiler = StartupProfiler::instance();
+    const uint64_t endUs = profiler.nowUs();
+    const uint64_t endCpuUs = threadCpuUs();
+    profiler.record(m_name, m_startUs, endUs - m_startUs,
+                    endCpuUs >= m_startCpuUs ? endCpuUs - m_startCpuUs : 0);
+}
+
+} // namespace yamy::metrics
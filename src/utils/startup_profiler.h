@@ -0,0 +1,121 @@
+#pragma once
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// startup_profiler.h - Startup phase trace for the daemon
+//
+// Records how long each startup phase took, in wall time and in CPU time of
+// the thread that ran it, plus milestones such as the hook going live and
+// the first key being processed with a setting. Times are relative to the
+// first use of the profiler, which main() makes its first statement.
+//
+// Usage:
+//   { STARTUP_PHASE("input_hook_install"); m_inputHook->install(...); }
+//   StartupProfiler::instance().mark(Milestones::HOOK_LIVE);
+//
+// Recording takes a mutex and is meant for startup only; noteFirstKey() is
+// the exception and costs one relaxed load once the first key was seen.
+
+#ifndef _STARTUP_PROFILER_H
+#define _STARTUP_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace yamy::metrics {
+
+/// One timed startup phase
+struct StartupPhase {
+    std::string name;
+    uint64_t startUs = 0;       ///< Since profiler start
+    uint64_t wallUs = 0;
+    uint64_t cpuUs = 0;         ///< CPU time of the thread that ran the phase
+    bool isDeferred = false;    ///< Started after the hook was live
+};
+
+/// One point in time during startup
+struct StartupMilestone {
+    std::string name;
+    uint64_t atUs = 0;          ///< Since profiler start
+};
+
+class StartupProfiler {
+public:
+    static StartupProfiler& instance() {
+        static StartupProfiler profiler;
+        return profiler;
+    }
+
+    /// RAII timer for one phase
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_startUs;
+        uint64_t m_startCpuUs;
+    };
+
+    /// Record a finished phase; ignored once startup is complete
+    void record(const char* name, uint64_t startUs, uint64_t wallUs, uint64_t cpuUs);
+
+    /// Record a milestone at the current time; repeated names are ignored.
+    /// Marking STARTUP_COMPLETE ends the trace: later restarts of the engine
+    /// do not add phases.
+    void mark(const char* name);
+
+    /// Mark the first processed key; cheap after the first call
+    void noteFirstKey() {
+        if (!m_isFirstKeySeen.load(std::memory_order_relaxed)) {
+            markFirstKey();
+        }
+    }
+
+    std::vector<StartupPhase> phases() const;
+    std::vector<StartupMilestone> milestones() const;
+
+    /// Microseconds since profiler start
+    uint64_t nowUs() const;
+
+    /// CPU time of the calling thread in microseconds
+    static uint64_t threadCpuUs();
+
+private:
+    StartupProfiler();
+
+    StartupProfiler(const StartupProfiler&) = delete;
+    StartupProfiler& operator=(const StartupProfiler&) = delete;
+
+    void markFirstKey();
+
+    const std::chrono::steady_clock::time_point m_origin;
+    mutable std::mutex m_mutex;
+    std::vector<StartupPhase> m_phases;
+    std::vector<StartupMilestone> m_milestones;
+    std::atomic<bool> m_isFirstKeySeen;
+    std::atomic<bool> m_isComplete;     ///< STARTUP_COMPLETE was marked
+};
+
+// Milestone names (constants for consistency)
+namespace Milestones {
+    constexpr const char* HOOK_LIVE = "hook_live";
+    constexpr const char* FIRST_KEY = "first_key";
+    constexpr const char* STARTUP_COMPLETE = "startup_complete";
+}
+
+#define STARTUP_PHASE_CONCAT_(a, b) a##b
+#define STARTUP_PHASE_NAME_(line) STARTUP_PHASE_CONCAT_(_startup_phase_, line)
+
+#define STARTUP_PHASE(name) \
+    yamy::metrics::StartupProfiler::Scope STARTUP_PHASE_NAME_(__LINE__)(name)
+
+} // namespace yamy::metrics
+
+#endif // _STARTUP_PROFILER_H
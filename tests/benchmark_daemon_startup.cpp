@@ -0,0 +1,200 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// benchmark_daemon_startup.cpp - Cold start time and memory of the daemon
+//
+// Launches the yamy daemon repeatedly and measures:
+//   - cold start: from fork() until the control socket accepts a connection
+//   - resident memory (VmRSS) once startup has settled, and its peak (VmHWM)
+//
+// Pass one or more daemon binaries to compare them, e.g. the default build
+// against one configured with -DYAMY_DAEMON_WITHOUT_QT=ON:
+//
+//   benchmark_daemon_startup build/bin/yamy build-noqt/bin/yamy
+//
+// Each run gets a scratch HOME so no saved session or config is restored.
+// Input devices that cannot be opened do not stop the daemon, so this also
+// runs without access to /dev/input.
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+// Test configuration
+constexpr int BENCHMARK_RUNS = 10;
+constexpr int STARTUP_TIMEOUT_MS = 10000;
+constexpr int SETTLE_MS = 300;            // deferred init (IPC, plugins) finishes in this time
+constexpr const char* CONTROL_SOCKET = "/tmp/yamy-engine.sock";
+
+struct RunResult {
+    double start_ms = 0;
+    long rss_kb = 0;
+    long peak_rss_kb = 0;
+};
+
+/// A field of /proc/<pid>/status in KiB, 0 if unknown
+long statusKb(pid_t pid, const std::string& field) {
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") == 0) {
+            return std::strtol(line.c_str() + field.size() + 1, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+bool controlSocketAccepts() {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, CONTROL_SOCKET, sizeof(addr.sun_path) - 1);
+    const bool isConnected = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    close(fd);
+    return isConnected;
+}
+
+bool stopDaemon(pid_t pid) {
+    kill(pid, SIGTERM);
+    for (int i = 0; i < 500; ++i) {
+        int status = 0;
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            return true;
+        }
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    return false;
+}
+
+/// One cold start of the daemon; false if it did not come up
+bool runOnce(const std::string& daemon, const fs::path& home, RunResult& result) {
+    fs::remove_all(home);
+    fs::create_directories(home);
+
+    const auto start = steady_clock::now();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        setenv("HOME", home.c_str(), 1);
+        unsetenv("XDG_CONFIG_HOME");
+        unsetenv("XDG_DATA_HOME");
+        const int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        dup2(devNull, STDERR_FILENO);
+        execl(daemon.c_str(), daemon.c_str(), "--no-restore", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    bool isUp = false;
+    while (duration_cast<milliseconds>(steady_clock::now() - start).count() < STARTUP_TIMEOUT_MS) {
+        if (controlSocketAccepts()) {
+            isUp = true;
+            break;
+        }
+        if (waitpid(pid, nullptr, WNOHANG) == pid) {
+            return false;   // Exited during startup
+        }
+        std::this_thread::sleep_for(microseconds(200));
+    }
+    result.start_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    if (isUp) {
+        std::this_thread::sleep_for(milliseconds(SETTLE_MS));
+        result.rss_kb = statusKb(pid, "VmRSS");
+        result.peak_rss_kb = statusKb(pid, "VmHWM");
+    }
+    stopDaemon(pid);
+    return isUp;
+}
+
+template <typename T>
+T median(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+void benchmarkDaemon(const std::string& daemon) {
+    std::cout << "\n=== " << daemon << " ===" << std::endl;
+
+    const fs::path home = fs::temp_directory_path() / ("yamy_startup_bench_" + std::to_string(getpid()));
+    std::vector<double> startMs;
+    std::vector<long> rssKb;
+    std::vector<long> peakKb;
+    for (int i = 0; i < BENCHMARK_RUNS; ++i) {
+        RunResult result;
+        if (!runOnce(daemon, home, result)) {
+            std::cout << "  run " << (i + 1) << ": daemon did not start" << std::endl;
+            continue;
+        }
+        startMs.push_back(result.start_ms);
+        rssKb.push_back(result.rss_kb);
+        peakKb.push_back(result.peak_rss_kb);
+    }
+    fs::remove_all(home);
+
+    if (startMs.empty()) {
+        std::cout << "  no successful runs" << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Runs:            " << startMs.size() << std::endl;
+    std::cout << "  Cold start min:  " << *std::min_element(startMs.begin(), startMs.end()) << " ms" << std::endl;
+    std::cout << "  Cold start p50:  " << median(startMs) << " ms" << std::endl;
+    std::cout << "  Cold start max:  " << *std::max_element(startMs.begin(), startMs.end()) << " ms" << std::endl;
+    std::cout << "  RSS p50:         " << median(rssKb) << " KiB" << std::endl;
+    std::cout << "  Peak RSS p50:    " << median(peakKb) << " KiB" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> daemons;
+    for (int i = 1; i < argc; ++i) {
+        daemons.push_back(argv[i]);
+    }
+#ifdef YAMY_DAEMON_PATH
+    if (daemons.empty()) {
+        daemons.push_back(YAMY_DAEMON_PATH);
+    }
+#endif
+    if (daemons.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <yamy daemon binary>..." << std::endl;
+        return 1;
+    }
+
+    if (controlSocketAccepts()) {
+        std::cerr << "A yamy daemon is already running (" << CONTROL_SOCKET
+                  << "); stop it before benchmarking" << std::endl;
+        return 1;
+    }
+
+    std::cout << "YAMY Daemon Startup Benchmark" << std::endl;
+    std::cout << "=============================" << std::endl;
+    std::cout << "Runs per daemon: " << BENCHMARK_RUNS << std::endl;
+
+    for (const auto& daemon : daemons) {
+        benchmarkDaemon(daemon);
+    }
+    return 0;
+}
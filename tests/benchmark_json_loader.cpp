@@ -3,6 +3,11 @@
 //
 // This tool measures JSON config loading latency to verify that configs
 // load in <10ms (requirement NFR-1 from json-refactoring spec).
+//
+// Each config is measured with both Setting allocation modes (heap and
+// arena): load time, teardown time, and resident memory per loaded setting.
+// Reload is measured as the patch() of a document with one edited mapping,
+// which must stay under 1ms.
 
 #include "../src/core/settings/json_config_loader.h"
 #include "../src/core/settings/setting.h"
@@ -13,6 +18,12 @@
 #include <numeric>
 #include <vector>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 using namespace yamy::settings;
 using namespace std::chrono;
@@ -20,6 +31,7 @@ using namespace std::chrono;
 // Test configuration
 constexpr int WARMUP_ITERATIONS = 10;
 constexpr int BENCHMARK_ITERATIONS = 1000;
+constexpr int RESIDENT_SETTINGS = 200;    // settings kept alive for the RSS measurement
 
 struct BenchmarkResult {
     double min_ms;
@@ -28,8 +40,48 @@ struct BenchmarkResult {
     double median_ms;
     double p95_ms;
     double p99_ms;
+    double teardown_mean_ms;
+    double rss_kb_per_setting;
 };
 
+const char* allocationName(Setting::Allocation allocation) {
+    return allocation == Setting::Allocation_arena ? "arena" : "heap";
+}
+
+/// Resident set size of this process in KiB, 0 if unknown
+long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long totalPages = 0, residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/// Hand freed heap memory back to the OS so RSS deltas start from a clean slate
+void trimHeap() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+/// Resident memory added per setting while RESIDENT_SETTINGS copies are loaded
+double measureResidentKbPerSetting(JsonConfigLoader& loader, const std::string& config_path,
+                                   Setting::Allocation allocation) {
+    trimHeap();
+    const long before = residentKb();
+    std::vector<std::unique_ptr<Setting>> settings;
+    settings.reserve(RESIDENT_SETTINGS);
+    for (int i = 0; i < RESIDENT_SETTINGS; i++) {
+        settings.push_back(std::make_unique<Setting>(allocation));
+        loader.load(settings.back().get(), config_path);
+    }
+    const long after = residentKb();
+    settings.clear();
+    trimHeap();
+    return static_cast<double>(after - before) / RESIDENT_SETTINGS;
+}
+
 BenchmarkResult calculateStats(std::vector<double>& latencies) {
     std::sort(latencies.begin(), latencies.end());
 
@@ -52,22 +104,26 @@ void printResults(const std::string& name, const BenchmarkResult& result, double
     std::cout << "  P95:    " << result.p95_ms << " ms\n";
     std::cout << "  P99:    " << result.p99_ms << " ms\n";
     std::cout << "  Max:    " << result.max_ms << " ms\n";
+    std::cout << "  Teardown mean: " << result.teardown_mean_ms << " ms\n";
+    std::cout << "  RSS per setting: " << std::setprecision(1) << result.rss_kb_per_setting
+              << " KiB\n" << std::setprecision(3);
 
     bool meets_requirement = result.p99_ms < target_ms;
     std::cout << "  Status: " << (meets_requirement ? "✓ PASS" : "✗ FAIL")
               << " (requirement: P99 < " << target_ms << "ms)\n";
 }
 
-BenchmarkResult benchmarkConfigLoad(const std::string& config_path, const std::string& name) {
+BenchmarkResult benchmarkConfigLoad(const std::string& config_path, const std::string& name,
+                                    Setting::Allocation allocation) {
     std::cout << "\n=============================================================\n";
-    std::cout << "Benchmarking: " << name << "\n";
+    std::cout << "Benchmarking: " << name << " (" << allocationName(allocation) << ")\n";
     std::cout << "Config: " << config_path << "\n";
     std::cout << "=============================================================\n";
 
     // Check if file exists
     if (!std::filesystem::exists(config_path)) {
         std::cerr << "Error: Config file not found: " << config_path << "\n";
-        return {0, 0, 0, 0, 0, 0};
+        return {0, 0, 0, 0, 0, 0, 0, 0};
     }
 
     JsonConfigLoader loader(nullptr);  // No logging for benchmarks
@@ -78,35 +134,84 @@ BenchmarkResult benchmarkConfigLoad(const std::string& config_path, const std::s
 
     // Warmup
     for (int i = 0; i < WARMUP_ITERATIONS; i++) {
-        Setting setting;
+        Setting setting(allocation);
         loader.load(&setting, config_path);
     }
 
     // Benchmark
     std::vector<double> latencies;
     latencies.reserve(BENCHMARK_ITERATIONS);
+    double teardown_total_ms = 0;
 
     for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        Setting setting;
+        auto setting = std::make_unique<Setting>(allocation);
 
         auto start = high_resolution_clock::now();
-        bool success = loader.load(&setting, config_path);
+        bool success = loader.load(setting.get(), config_path);
         auto end = high_resolution_clock::now();
 
         if (!success) {
             std::cerr << "Warning: Load failed on iteration " << i << "\n";
         }
 
-        double elapsed_ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+        double elapsed_ms = duration_cast<nanoseconds>(end - start).count() / 1000000.0;
         latencies.push_back(elapsed_ms);
+
+        start = high_resolution_clock::now();
+        setting.reset();
+        end = high_resolution_clock::now();
+        teardown_total_ms += duration_cast<nanoseconds>(end - start).count() / 1000000.0;
     }
 
     BenchmarkResult result = calculateStats(latencies);
+    result.teardown_mean_ms = teardown_total_ms / BENCHMARK_ITERATIONS;
+    result.rss_kb_per_setting = measureResidentKbPerSetting(loader, config_path, allocation);
     printResults(name, result, 10.0);  // 10ms target
 
     return result;
 }
 
+/// Time patch() of a document whose first mapping alternates between two targets
+BenchmarkResult benchmarkMappingPatch(const std::string& config_path, const std::string& name) {
+    std::cout << "\n=============================================================\n";
+    std::cout << "Benchmarking: " << name << " (one mapping edited)\n";
+    std::cout << "=============================================================\n";
+
+    JsonConfigLoader loader(nullptr);
+    Setting setting;
+    nlohmann::json edits[2];
+    if (!loader.load(&setting, config_path) || !loader.read(config_path, edits[0]) ||
+            !edits[0].contains("mappings") || edits[0]["mappings"].size() < 2) {
+        std::cout << "Skipped: config without two mappings\n";
+        return {0, 0, 0, 0, 0, 0, 0, 0};
+    }
+    edits[1] = edits[0];
+    edits[1]["mappings"][0]["to"] = edits[0]["mappings"][1]["to"];
+
+    std::vector<double> latencies;
+    latencies.reserve(BENCHMARK_ITERATIONS);
+    std::vector<Key*> changed;
+    for (int i = 0; i < WARMUP_ITERATIONS + BENCHMARK_ITERATIONS; i++) {
+        nlohmann::json edit = edits[(i + 1) % 2];    // the engine hands over a fresh document
+        auto start = high_resolution_clock::now();
+        auto patched = loader.patch(&setting, std::move(edit), &changed);
+        auto end = high_resolution_clock::now();
+
+        if (patched != JsonConfigLoader::PatchResult::Patched) {
+            std::cerr << "Warning: Patch not applied on iteration " << i << "\n";
+        }
+        if (i >= WARMUP_ITERATIONS) {
+            latencies.push_back(duration_cast<nanoseconds>(end - start).count() / 1000000.0);
+        }
+    }
+
+    BenchmarkResult result = calculateStats(latencies);
+    result.teardown_mean_ms = 0;
+    result.rss_kb_per_setting = 0;
+    printResults(name + " patch", result, 1.0);  // 1ms target
+    return result;
+}
+
 int main(int argc, char** argv) {
     std::cout << "=============================================================\n";
     std::cout << "JSON Config Loader Performance Benchmark\n";
@@ -120,10 +225,12 @@ int main(int argc, char** argv) {
     };
 
     std::vector<BenchmarkResult> results;
+    std::vector<BenchmarkResult> heap_results;
     bool all_pass = true;
 
     for (const auto& [path, name] : configs) {
-        BenchmarkResult result = benchmarkConfigLoad(path, name);
+        heap_results.push_back(benchmarkConfigLoad(path, name, Setting::Allocation_heap));
+        BenchmarkResult result = benchmarkConfigLoad(path, name, Setting::Allocation_arena);
         results.push_back(result);
 
         if (result.p99_ms >= 10.0) {
@@ -131,6 +238,14 @@ int main(int argc, char** argv) {
         }
     }
 
+    std::vector<BenchmarkResult> patch_results;
+    for (const auto& [path, name] : configs) {
+        patch_results.push_back(benchmarkMappingPatch(path, name));
+        if (patch_results.back().p99_ms >= 1.0) {
+            all_pass = false;
+        }
+    }
+
     // Summary
     std::cout << "\n=============================================================\n";
     std::cout << "Summary\n";
@@ -142,6 +257,26 @@ int main(int argc, char** argv) {
                   << "] " << configs[i].second << " P99 < 10ms ("
                   << std::fixed << std::setprecision(3) << results[i].p99_ms << " ms)\n";
     }
+    for (size_t i = 0; i < configs.size(); i++) {
+        if (patch_results[i].max_ms == 0) {
+            continue;   // skipped
+        }
+        std::cout << "  [" << (patch_results[i].p99_ms < 1.0 ? "✓" : "✗")
+                  << "] " << configs[i].second << " patch P99 < 1ms ("
+                  << std::fixed << std::setprecision(3) << patch_results[i].p99_ms << " ms)\n";
+    }
+
+    std::cout << "\nHeap -> arena (mean load, mean teardown, RSS per setting):\n";
+    for (size_t i = 0; i < configs.size(); i++) {
+        const BenchmarkResult& heap = heap_results[i];
+        const BenchmarkResult& arena = results[i];
+        std::cout << "  " << configs[i].second << ": "
+                  << std::fixed << std::setprecision(3)
+                  << heap.mean_ms << " -> " << arena.mean_ms << " ms, "
+                  << heap.teardown_mean_ms << " -> " << arena.teardown_mean_ms << " ms, "
+                  << std::setprecision(1)
+                  << heap.rss_kb_per_setting << " -> " << arena.rss_kb_per_setting << " KiB\n";
+    }
 
     std::cout << "\n" << (all_pass ? "✓ ALL REQUIREMENTS MET" : "✗ SOME REQUIREMENTS FAILED") << "\n\n";
 
@@ -0,0 +1,180 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// benchmark_log_store.cpp - Memory and CPU of a 100k-entry log buffer
+//
+// Fills a buffer with the engine's key-event trace and a few fixed messages,
+// once the old way (every message formatted into an owned std::string and
+// kept in a LogEntry) and once in a LogStore (interned category and
+// template, arguments stored as values). Reports live heap bytes per entry,
+// the cost of recording an entry, and the cost of formatting the whole
+// buffer afterwards, as an export does.
+//
+// Live bytes are counted by replacing the global operator new/delete.
+//
+// Usage: benchmark_log_store [entries]
+
+#include "core/logging/log_store.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+
+using namespace yamy::logging;
+
+namespace {
+
+std::atomic<long long> g_liveBytes{0};
+
+// Header in front of each allocation, keeping its size
+constexpr size_t HEADER = alignof(std::max_align_t);
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    void* block = std::malloc(size + HEADER);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+    g_liveBytes += static_cast<long long>(size);
+    return static_cast<char*>(block) + HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - HEADER;
+    g_liveBytes -= static_cast<long long>(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace {
+
+const char* const FIXED_MESSAGES[] = {
+    "Keyboard handler thread started, waiting for events...",
+    "Engine started successfully",
+    "Configuration reloaded",
+};
+
+struct Result {
+    double bytesPerEntry;
+    double recordNs;
+    double formatNs;
+};
+
+double nsPerEntry(std::chrono::steady_clock::time_point start, int entries)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / entries;
+}
+
+Result runOwnedStrings(int entries)
+{
+    const long long before = g_liveBytes;
+    Result result{};
+    {
+        std::deque<LogEntry> buffer;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < entries; ++i) {
+            if (i % 16 == 15) {
+                buffer.emplace_back(LogLevel::Info, "Engine", FIXED_MESSAGES[i % 3]);
+            } else {
+                const unsigned scanCode = 0x10 + i % 40;
+                const bool isKeyDown = i % 2 == 0;
+                buffer.emplace_back(LogLevel::Trace, "Engine",
+                    "Processing key event: scancode=" + std::to_string(scanCode) +
+                        ", isKeyDown=" + std::to_string(isKeyDown));
+            }
+        }
+        result.recordNs = nsPerEntry(start, entries);
+        result.bytesPerEntry = static_cast<double>(g_liveBytes - before) / entries;
+
+        size_t total = 0;
+        start = std::chrono::steady_clock::now();
+        for (const LogEntry& entry : buffer) {
+            total += entry.message.size();
+        }
+        result.formatNs = nsPerEntry(start, entries);
+        if (total == 0) {
+            std::puts("");
+        }
+    }
+    return result;
+}
+
+Result runLogStore(int entries)
+{
+    // Dictionaries outlive every buffer; count them once, with the store
+    const long long before = g_liveBytes;
+    Result result{};
+    LogDictionary categories;
+    LogDictionary templates;
+    {
+        LogStore buffer(categories, templates, static_cast<size_t>(entries));
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < entries; ++i) {
+            const int64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                LogEntry::clock::now().time_since_epoch()).count();
+            if (i % 16 == 15) {
+                buffer.appendText(timeUs, LogLevel::Info, "Engine", FIXED_MESSAGES[i % 3]);
+            } else {
+                const unsigned scanCode = 0x10 + i % 40;
+                const bool isKeyDown = i % 2 == 0;
+                const LogArg args[] = {toLogArg(scanCode), toLogArg(isKeyDown)};
+                buffer.append(timeUs, LogLevel::Trace, "Engine",
+                              "Processing key event: scancode={}, isKeyDown={}", args, 2);
+            }
+        }
+        result.recordNs = nsPerEntry(start, entries);
+        result.bytesPerEntry = static_cast<double>(g_liveBytes - before) / entries;
+
+        size_t total = 0;
+        std::string line;
+        start = std::chrono::steady_clock::now();
+        for (uint64_t seq = buffer.firstSequence(); seq < buffer.endSequence(); ++seq) {
+            line.clear();
+            buffer.record(seq).appendMessage(line);
+            total += line.size();
+        }
+        result.formatNs = nsPerEntry(start, entries);
+        if (total == 0) {
+            std::puts("");
+        }
+    }
+    return result;
+}
+
+void print(const char* name, const Result& result)
+{
+    std::printf("%-16s %8.1f bytes/entry  record %7.1f ns/entry  format %7.1f ns/entry\n",
+                name, result.bytesPerEntry, result.recordNs, result.formatNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int entries = argc > 1 ? std::max(1000, std::atoi(argv[1])) : 100000;
+
+    std::printf("Log buffer of %d entries\n", entries);
+    const Result owned = runOwnedStrings(entries);
+    const Result store = runLogStore(entries);
+    print("owned strings", owned);
+    print("LogStore", store);
+    std::printf("memory %.1fx smaller, recording %.1fx faster\n",
+                owned.bytesPerEntry / store.bytesPerEntry, owned.recordNs / store.recordNs);
+    return 0;
+}
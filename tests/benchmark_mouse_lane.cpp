@@ -0,0 +1,214 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// benchmark_mouse_lane.cpp - Keyboard latency under an 8 kHz mouse
+//
+// Runs the real keyboard reader (EventReaderThread) and mouse lane
+// (MouseReaderThread) on pipes fed with evdev events, and measures the
+// keyboard lane's latency from event time to callback, first alone and then
+// while a mouse reports motion at 8 kHz with a click every 100 ms.
+//
+// The keyboard callback pushes into a mutex-guarded queue as
+// Engine::pushInputEvent() does; motion is "injected" with one write() per
+// batch to /dev/null, as InputInjectorLinux writes one report. The keyboard
+// p99 should not move; the motion line shows how many frames each injected
+// report carried.
+//
+// Usage: benchmark_mouse_lane [keys-per-phase]
+
+#include "platform/linux/input_hook_linux.h"
+#include "platform/linux/mouse_reader_linux.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace yamy::platform;
+
+namespace {
+
+constexpr long MOUSE_PERIOD_NS = 125000;        // 8 kHz
+constexpr long KEY_PERIOD_NS = 2000000;         // A key edge every 2 ms
+constexpr int CLICK_EVERY_FRAMES = 800;         // A click every 100 ms
+
+uint64_t nowUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void setEvent(input_event& ev, uint16_t type, uint16_t code, int32_t value, uint64_t timeUs)
+{
+    ev.input_event_sec = static_cast<decltype(ev.input_event_sec)>(timeUs / 1000000);
+    ev.input_event_usec = static_cast<decltype(ev.input_event_usec)>(timeUs % 1000000);
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+}
+
+void sleepUntil(timespec& next, long periodNs)
+{
+    next.tv_nsec += periodNs;
+    while (next.tv_nsec >= 1000000000L) {
+        next.tv_nsec -= 1000000000L;
+        ++next.tv_sec;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+}
+
+struct Stats {
+    double p50;
+    double p99;
+    double max;
+};
+
+Stats summarize(std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))];
+    };
+    return Stats{at(0.50), at(0.99), samples.back()};
+}
+
+struct Phase {
+    std::vector<double> keyLatencyUs;
+    uint64_t mouseFrames = 0;
+    uint64_t motionReports = 0;
+    uint64_t buttons = 0;
+    double seconds = 0;
+};
+
+Phase runPhase(int keyCount, bool withMouse)
+{
+    int keyPipe[2];
+    int mousePipe[2];
+    if (pipe(keyPipe) != 0 || pipe(mousePipe) != 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+    const int sink = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+    Phase phase;
+    phase.keyLatencyUs.reserve(keyCount);
+    std::mutex queueMutex;
+    std::deque<KeyEvent> queue;
+    std::atomic<uint64_t> motionReports{0};
+    std::atomic<uint64_t> buttons{0};
+
+    EventReaderThread keyboard(keyPipe[0], "bench-keyboard", [&](const KeyEvent& event) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        phase.keyLatencyUs.push_back(static_cast<double>(nowUs() - event.timestampUs));
+        queue.push_back(event);
+        if (queue.size() > 64) queue.pop_front();
+        return true;
+    });
+    MouseReaderThread mouse(mousePipe[0], "bench-mouse",
+        [&](const KeyEvent& event) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(event);
+            ++buttons;
+            return true;
+        },
+        [&](const MouseEvent& event) {
+            char report[72] = {};
+            report[0] = static_cast<char>(event.dx);
+            if (write(sink, report, sizeof(report)) < 0) std::perror("write");
+            ++motionReports;
+            return true;
+        });
+    keyboard.start();
+    mouse.start();
+
+    std::atomic<bool> mouseDone{false};
+    std::thread mouseProducer;
+    uint64_t mouseFrames = 0;
+    if (withMouse) {
+        mouseProducer = std::thread([&] {
+            timespec next;
+            clock_gettime(CLOCK_MONOTONIC, &next);
+            bool isDown = false;
+            while (!mouseDone) {
+                input_event frame[4];
+                size_t count = 0;
+                const uint64_t t = nowUs();
+                setEvent(frame[count++], EV_REL, REL_X, 1, t);
+                setEvent(frame[count++], EV_REL, REL_Y, -1, t);
+                if (++mouseFrames % CLICK_EVERY_FRAMES == 0) {
+                    isDown = !isDown;
+                    setEvent(frame[count++], EV_KEY, BTN_LEFT, isDown ? 1 : 0, t);
+                }
+                setEvent(frame[count++], EV_SYN, SYN_REPORT, 0, t);
+                if (write(mousePipe[1], frame, count * sizeof(input_event)) < 0) break;
+                sleepUntil(next, MOUSE_PERIOD_NS);
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (int i = 0; i < keyCount; ++i) {
+        input_event ev;
+        setEvent(ev, EV_KEY, KEY_A, (i % 2 == 0) ? 1 : 0, nowUs());
+        if (write(keyPipe[1], &ev, sizeof(ev)) < 0) break;
+        sleepUntil(next, KEY_PERIOD_NS);
+    }
+    // Let the last key arrive
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    phase.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    mouseDone = true;
+    if (mouseProducer.joinable()) mouseProducer.join();
+    close(keyPipe[1]);
+    close(mousePipe[1]);
+    keyboard.stop();
+    mouse.stop();
+    close(keyPipe[0]);
+    close(mousePipe[0]);
+    close(sink);
+
+    phase.mouseFrames = mouseFrames;
+    phase.motionReports = motionReports;
+    phase.buttons = buttons;
+    return phase;
+}
+
+void print(const char* name, const Phase& phase)
+{
+    Stats stats = summarize(phase.keyLatencyUs);
+    std::printf("%-22s keys=%-6zu p50=%7.1fus p99=%7.1fus max=%8.1fus\n",
+                name, phase.keyLatencyUs.size(), stats.p50, stats.p99, stats.max);
+    if (phase.mouseFrames > 0) {
+        std::printf("%-22s frames=%llu (%.0f Hz) reports=%llu (%.2f frames/report) buttons=%llu\n",
+                    "", static_cast<unsigned long long>(phase.mouseFrames),
+                    phase.mouseFrames / phase.seconds,
+                    static_cast<unsigned long long>(phase.motionReports),
+                    phase.motionReports ? double(phase.mouseFrames) / phase.motionReports : 0.0,
+                    static_cast<unsigned long long>(phase.buttons));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int keyCount = argc > 1 ? std::max(10, std::atoi(argv[1])) : 2000;
+
+    // EventReaderThread traces every event to stderr
+    std::cerr.rdbuf(nullptr);
+
+    std::printf("Keyboard lane latency, %d key edges per phase\n", keyCount);
+    print("keyboard only", runPhase(keyCount, false));
+    print("keyboard + 8 kHz mouse", runPhase(keyCount, true));
+    return 0;
+}
@@ -0,0 +1,419 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// micro_bench.cpp - Google Benchmark microbenchmarks for engine stages
+//
+// Measures each stage of the key pipeline in isolation so a change in
+// end-to-end latency can be attributed to a layer:
+// - EventProcessor layer 1/2/3 (evdev -> YAMY, substitution, YAMY -> evdev)
+// - RuleLookupTable::findMatch
+// - Keyboard::searchKey, Keymap::searchAssignment
+// - ModifierState::toModifier
+// - Engine::generateModifierEvents
+// - ChordDetector::onKey for keys outside and inside a chord
+//
+// Inputs are synthetic and parameterized (rule count, mapping count, active
+// virtual modifiers). Scan codes 0x23-0x26 are avoided because
+// RuleLookupTable still carries debug output for them.
+//
+// Usage:
+//   ./build/bin/yamy_micro_bench
+//   ./build/bin/yamy_micro_bench --benchmark_format=json --benchmark_out=bench.json
+//   tools/compare.py benchmarks old.json new.json   (from google/benchmark)
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <benchmark/benchmark.h>
+
+#include "engine.h"
+#include "chord_detector.h"
+#include "engine_event_processor.h"
+#include "lookup_table.h"
+#include "modifier_state.h"
+#include "json_config_loader.h"
+#include "setting.h"
+#include "msgstream.h"
+#include "../test_utils/null_platform.h"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace yamy::test {
+
+/// Reaches the private stage functions benchmarked below
+class MicroBenchAccess {
+public:
+    static uint16_t layer1(EventProcessor& p, uint16_t evdev) {
+        return p.layer1_evdevToYamy(evdev);
+    }
+    static uint16_t layer2(EventProcessor& p, uint16_t yamy, EventType type, input::ModifierState* state) {
+        return p.layer2_applySubstitution(yamy, type, state);
+    }
+    static uint16_t layer3(EventProcessor& p, uint16_t yamy) {
+        return p.layer3_yamyToEvdev(yamy);
+    }
+    static void generateModifierEvents(Engine& engine, const Modifier& mod) {
+        engine.generateModifierEvents(mod);
+    }
+};
+
+} // namespace yamy::test
+
+using yamy::test::MicroBenchAccess;
+using yamy::input::ModifierState;
+
+namespace {
+
+/// Letter keys (name, YAMY scan code, evdev code); H/J/K/L omitted, see header
+struct SyntheticKey {
+    const char* name;
+    uint16_t yamy;
+    uint16_t evdev;
+};
+
+const std::array<SyntheticKey, 22> kKeys = {{
+    {"A", 0x1e, 30}, {"B", 0x30, 48}, {"C", 0x2e, 46}, {"D", 0x20, 32},
+    {"E", 0x12, 18}, {"F", 0x21, 33}, {"G", 0x22, 34}, {"I", 0x17, 23},
+    {"M", 0x32, 50}, {"N", 0x31, 49}, {"O", 0x18, 24}, {"P", 0x19, 25},
+    {"Q", 0x10, 16}, {"R", 0x13, 19}, {"S", 0x1f, 31}, {"T", 0x14, 20},
+    {"U", 0x16, 22}, {"V", 0x2f, 47}, {"W", 0x11, 17}, {"X", 0x2d, 45},
+    {"Y", 0x15, 21}, {"Z", 0x2c, 44},
+}};
+
+const std::array<const char*, 4> kStdModifierNames = {{"Shift", "Alt", "Ctrl", "Win"}};
+
+/// Fill a lookup table with rulesPerKey virtual-modifier rules (M00..) per key,
+/// followed by an unconditional fallback rule
+void populateRules(yamy::engine::RuleLookupTable& table, int rulesPerKey)
+{
+    for (size_t k = 0; k < kKeys.size(); ++k) {
+        uint16_t output = kKeys[(k + 1) % kKeys.size()].yamy;
+        for (int m = 0; m < rulesPerKey; ++m) {
+            yamy::engine::CompiledRule rule;
+            rule.requiredOn.set(ModifierState::VIRTUAL_OFFSET + m);
+            rule.outputScanCode = output;
+            table.addRule(kKeys[k].yamy, rule);
+        }
+        yamy::engine::CompiledRule fallback;
+        fallback.outputScanCode = kKeys[k].yamy;
+        table.addRule(kKeys[k].yamy, fallback);
+    }
+}
+
+/// Activate the first count virtual modifiers (M00..)
+void activateVirtualModifiers(ModifierState& state, int count)
+{
+    for (int m = 0; m < count; ++m) {
+        state.activateModifier(static_cast<uint8_t>(m));
+    }
+}
+
+/// Build a JSON config with every letter mapped under the first
+/// comboCount combinations of Shift/Alt/Ctrl/Win (1..16)
+std::string makeSyntheticConfig(int comboCount)
+{
+    std::ostringstream json;
+    json << "{\n  \"version\": \"2.0\",\n  \"keyboard\": {\n    \"keys\": {\n";
+    for (const auto& key : kKeys) {
+        char scan[8];
+        std::snprintf(scan, sizeof(scan), "0x%02x", key.yamy);
+        json << "      \"" << key.name << "\": \"" << scan << "\",\n";
+    }
+    json << "      \"LeftShift\": \"0x2a\",\n      \"LeftAlt\": \"0x38\",\n"
+         << "      \"LeftCtrl\": \"0x1d\",\n      \"LeftWin\": \"0xdb\"\n"
+         << "    }\n  },\n  \"mappings\": [\n";
+
+    bool first = true;
+    for (size_t k = 0; k < kKeys.size(); ++k) {
+        for (int combo = 0; combo < comboCount; ++combo) {
+            std::string from;
+            for (size_t m = 0; m < kStdModifierNames.size(); ++m) {
+                if (combo & (1 << m)) {
+                    from += std::string(kStdModifierNames[m]) + "-";
+                }
+            }
+            from += kKeys[k].name;
+            json << (first ? "" : ",\n") << "    {\"from\": \"" << from
+                 << "\", \"to\": \"" << kKeys[(k + 1) % kKeys.size()].name << "\"}";
+            first = false;
+        }
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+/// Load a synthetic config into a fresh Setting and register the modifier keys
+std::unique_ptr<Setting> loadSyntheticSetting(int comboCount)
+{
+    std::string path = "/tmp/yamy_micro_bench_" + std::to_string(comboCount) + ".json";
+    {
+        std::ofstream out(path);
+        out << makeSyntheticConfig(comboCount);
+    }
+
+    auto setting = std::make_unique<Setting>();
+    yamy::settings::JsonConfigLoader loader(nullptr);
+    bool loaded = loader.load(setting.get(), path);
+    std::remove(path.c_str());
+    if (!loaded) {
+        return nullptr;
+    }
+
+    // The JSON loader does not declare modifier keys; generateModifierEvents needs them
+    Keyboard& keyboard = setting->m_keyboard;
+    keyboard.addModifier(Modifier::Type_Shift, keyboard.searchKey("LeftShift"));
+    keyboard.addModifier(Modifier::Type_Alt, keyboard.searchKey("LeftAlt"));
+    keyboard.addModifier(Modifier::Type_Control, keyboard.searchKey("LeftCtrl"));
+    keyboard.addModifier(Modifier::Type_Windows, keyboard.searchKey("LeftWin"));
+    return setting;
+}
+
+/// Modifier with the given Shift/Alt/Ctrl/Win bits pressed and the rest released
+Modifier makeStdModifier(int combo)
+{
+    static const Modifier::Type types[] = {
+        Modifier::Type_Shift, Modifier::Type_Alt, Modifier::Type_Control, Modifier::Type_Windows
+    };
+    Modifier mod;
+    for (size_t m = 0; m < 4; ++m) {
+        mod.press(types[m], (combo & (1 << m)) != 0);
+    }
+    return mod;
+}
+
+//=============================================================================
+// EventProcessor layers
+//=============================================================================
+
+void BM_Layer1_EvdevToYamy(benchmark::State& state)
+{
+    yamy::EventProcessor processor;
+    size_t i = 0;
+    for (auto _ : state) {
+        uint16_t evdev = kKeys[i++ % kKeys.size()].evdev;
+        benchmark::DoNotOptimize(MicroBenchAccess::layer1(processor, evdev));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Layer1_EvdevToYamy);
+
+/// Arg: number of active virtual modifiers (rules cover M00-M0F per key)
+void BM_Layer2_ApplySubstitution(benchmark::State& state)
+{
+    yamy::EventProcessor processor;
+    populateRules(*processor.getLookupTable(), 16);
+    ModifierState modState;
+    activateVirtualModifiers(modState, static_cast<int>(state.range(0)));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        uint16_t yamy = kKeys[i++ % kKeys.size()].yamy;
+        benchmark::DoNotOptimize(
+            MicroBenchAccess::layer2(processor, yamy, yamy::EventType::PRESS, &modState));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Layer2_ApplySubstitution)->Arg(0)->Arg(16)->Arg(256);
+
+void BM_Layer3_YamyToEvdev(benchmark::State& state)
+{
+    yamy::EventProcessor processor;
+    size_t i = 0;
+    for (auto _ : state) {
+        uint16_t yamy = kKeys[i++ % kKeys.size()].yamy;
+        benchmark::DoNotOptimize(MicroBenchAccess::layer3(processor, yamy));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Layer3_YamyToEvdev);
+
+//=============================================================================
+// Rule lookup
+//=============================================================================
+
+/// Arg: rules per key; no modifier is active, so every lookup walks to the fallback
+void BM_RuleLookupTable_FindMatch(benchmark::State& state)
+{
+    yamy::engine::RuleLookupTable table;
+    populateRules(table, static_cast<int>(state.range(0)));
+    ModifierState modState;
+    const auto& bits = modState.getFullState();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        uint16_t yamy = kKeys[i++ % kKeys.size()].yamy;
+        benchmark::DoNotOptimize(table.findMatch(yamy, bits));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RuleLookupTable_FindMatch)->Arg(1)->Arg(16)->Arg(256);
+
+//=============================================================================
+// Legacy keyboard / keymap structures
+//=============================================================================
+
+void BM_Keyboard_SearchKey(benchmark::State& state)
+{
+    auto setting = loadSyntheticSetting(1);
+    if (!setting) {
+        state.SkipWithError("failed to load synthetic config");
+        return;
+    }
+
+    std::vector<Key> probes;
+    for (const auto& key : kKeys) {
+        Key probe;
+        probe.addScanCode(ScanCode(key.yamy, 0));
+        probes.push_back(probe);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(setting->m_keyboard.searchKey(probes[i++ % probes.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Keyboard_SearchKey);
+
+/// Arg: modifier combinations mapped per key (1 = plain, 16 = every Shift/Alt/Ctrl/Win combo)
+void BM_Keymap_SearchAssignment(benchmark::State& state)
+{
+    const int combos = static_cast<int>(state.range(0));
+    auto setting = loadSyntheticSetting(combos);
+    const Keymap* keymap = setting ? setting->m_keymaps.searchByName("Global") : nullptr;
+    if (!keymap) {
+        state.SkipWithError("failed to load synthetic config");
+        return;
+    }
+
+    std::vector<ModifiedKey> probes;
+    for (const auto& key : kKeys) {
+        Key* k = setting->m_keyboard.searchKey(key.name);
+        for (int combo = 0; combo < combos; ++combo) {
+            probes.emplace_back(makeStdModifier(combo), k);
+        }
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(keymap->searchAssignment(probes[i++ % probes.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["mappings"] = static_cast<double>(probes.size());
+}
+BENCHMARK(BM_Keymap_SearchAssignment)->Arg(1)->Arg(16);
+
+//=============================================================================
+// Modifier state conversion and generation
+//=============================================================================
+
+/// Arg: number of active virtual modifiers
+void BM_ModifierState_ToModifier(benchmark::State& state)
+{
+    ModifierState modState;
+    KEYBOARD_INPUT_DATA shift = { 0, 0x2a, 0, 0, 0 };
+    modState.updateFromKID(shift);
+    activateVirtualModifiers(modState, static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(modState.toModifier());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ModifierState_ToModifier)->Arg(0)->Arg(16)->Arg(256);
+
+/// Arg: number of standard modifiers toggled per call (1 = Shift, 4 = Shift/Alt/Ctrl/Win)
+void BM_Engine_GenerateModifierEvents(benchmark::State& state)
+{
+    auto setting = loadSyntheticSetting(1);
+    if (!setting) {
+        state.SkipWithError("failed to load synthetic config");
+        return;
+    }
+
+    tomsgstream log(0);
+    yamy::platform::NullWindowSystem windowSystem;
+    yamy::platform::NullInputInjector injector;
+    yamy::platform::NullInputHook hook;
+    yamy::platform::NullInputDriver driver;
+    Engine engine(log, &windowSystem, nullptr, &injector, &hook, &driver);
+    engine.setSetting(setting.get());
+
+    // Alternate between pressing and releasing the modifiers so every call emits events
+    const Modifier pressed = makeStdModifier((1 << state.range(0)) - 1);
+    const Modifier released = makeStdModifier(0);
+    bool press = true;
+    for (auto _ : state) {
+        MicroBenchAccess::generateModifierEvents(engine, press ? pressed : released);
+        press = !press;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Engine_GenerateModifierEvents)->Arg(1)->Arg(4);
+
+//=============================================================================
+// Chord detection
+//=============================================================================
+
+/// Table of count two-key chords on scan codes from 0x100 up
+std::unique_ptr<yamy::engine::ChordTable> makeChordTable(size_t count)
+{
+    auto table = std::make_unique<yamy::engine::ChordTable>();
+    for (size_t i = 0; i < count; ++i) {
+        const uint16_t pair[] = {static_cast<uint16_t>(0x100 + 2 * i),
+                                 static_cast<uint16_t>(0x101 + 2 * i)};
+        table->addChord(pair, 2, static_cast<uint32_t>(i));
+    }
+    return table;
+}
+
+/// Arg: number of chords. The common case: a key in no chord
+void BM_ChordDetector_NonChordKey(benchmark::State& state)
+{
+    auto table = makeChordTable(static_cast<size_t>(state.range(0)));
+    yamy::engine::ChordDetector detector(*table, 50);
+    yamy::engine::ChordKeyEvent key;
+    key.scan = 0x1e;
+    yamy::engine::ChordSteps steps;
+
+    for (auto _ : state) {
+        key.isPressed = !key.isPressed;
+        steps.clear();
+        detector.onKey(key, steps);
+        benchmark::DoNotOptimize(steps.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChordDetector_NonChordKey)->Arg(1)->Arg(32);
+
+/// Arg: number of chords. Press and release of the last chord: 4 events
+void BM_ChordDetector_Chord(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto table = makeChordTable(count);
+    yamy::engine::ChordDetector detector(*table, 50);
+    const uint16_t first = static_cast<uint16_t>(0x100 + 2 * (count - 1));
+    yamy::engine::ChordKeyEvent events[4];
+    events[0].scan = first;
+    events[0].isPressed = true;
+    events[1].scan = first + 1;
+    events[1].isPressed = true;
+    events[2].scan = first;
+    events[3].scan = first + 1;
+    yamy::engine::ChordSteps steps;
+
+    for (auto _ : state) {
+        steps.clear();
+        for (const auto& event : events)
+            detector.onKey(event, steps);
+        benchmark::DoNotOptimize(steps.size());
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_ChordDetector_Chord)->Arg(1)->Arg(32);
+
+} // namespace
+
+BENCHMARK_MAIN();
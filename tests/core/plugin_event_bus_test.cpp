@@ -0,0 +1,279 @@
+/**
+ * @file plugin_event_bus_test.cpp
+ * @brief Tests for the PluginEventBus broadcast ring
+ *
+ * Tests cover:
+ * - Delivery order and subscription filtering
+ * - Notification payload truncation
+ * - Publishing never blocks on a slow subscriber; drops are counted
+ * - Owner-based and self-unsubscription
+ * - Exception handling in subscriber callbacks
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/plugin_event_bus.h"
+
+using namespace yamy;
+using namespace yamy::core;
+
+namespace {
+
+/// Wait until pred() holds or the timeout elapses
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000))
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// =============================================================================
+// Test Fixture Setup
+// =============================================================================
+
+class PluginEventBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        PluginEventBus::instance().clearSubscribers();
+    }
+
+    void TearDown() override {
+        PluginEventBus::instance().clearSubscribers();
+    }
+};
+
+// =============================================================================
+// Delivery Tests
+// =============================================================================
+
+TEST_F(PluginEventBusTest, PublishWithoutSubscribersIsDropped) {
+    auto& bus = PluginEventBus::instance();
+    uint64_t before = bus.publishedCount();
+
+    bus.publishKey(0x1e, true, false, 100);
+
+    EXPECT_FALSE(bus.hasSubscribers());
+    EXPECT_EQ(bus.publishedCount(), before);
+}
+
+TEST_F(PluginEventBusTest, DeliversKeyEventsInOrder) {
+    auto& bus = PluginEventBus::instance();
+    std::mutex mutex;
+    std::vector<PluginEvent> received;
+
+    bus.subscribe("order", PluginEventMask_All, [&](const PluginEvent& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(e);
+    });
+
+    for (uint16_t i = 0; i < 100; ++i) {
+        bus.publishKey(i, (i % 2) == 0, false, 1000 + i);
+    }
+
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received.size() == 100;
+    }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint16_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(received[i].kind, PluginEventKind::Key);
+        EXPECT_EQ(received[i].scanCode, i);
+        EXPECT_EQ(received[i].isKeyDown, (i % 2) == 0);
+        EXPECT_EQ(received[i].timestampUs, 1000u + i);
+        if (i > 0) {
+            EXPECT_EQ(received[i].sequence, received[i - 1].sequence + 1);
+        }
+    }
+}
+
+TEST_F(PluginEventBusTest, MaskFiltersRecordKinds) {
+    auto& bus = PluginEventBus::instance();
+    std::atomic<int> keys{0};
+    std::atomic<int> notifications{0};
+
+    bus.subscribe("keys", PluginEventMask_Key, [&](const PluginEvent& e) {
+        EXPECT_EQ(e.kind, PluginEventKind::Key);
+        keys++;
+    });
+    bus.subscribe("notifications", PluginEventMask_Notification, [&](const PluginEvent& e) {
+        EXPECT_EQ(e.kind, PluginEventKind::Notification);
+        notifications++;
+    });
+
+    bus.publishKey(0x1e, true, false, 1);
+    bus.publishNotification(MessageType::ConfigLoaded, "config.json");
+    bus.publishKey(0x1e, false, false, 2);
+
+    ASSERT_TRUE(waitFor([&] { return keys == 2 && notifications == 1; }));
+}
+
+TEST_F(PluginEventBusTest, NotificationPayloadIsCopiedAndTruncated) {
+    auto& bus = PluginEventBus::instance();
+    std::mutex mutex;
+    std::vector<std::string> payloads;
+    std::vector<bool> truncated;
+
+    bus.subscribe("payload", PluginEventMask_Notification, [&](const PluginEvent& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        payloads.emplace_back(e.dataView());
+        truncated.push_back(e.dataTruncated);
+    });
+
+    std::string longData(PluginEvent::DATA_CAPACITY + 20, 'x');
+    bus.publishNotification(MessageType::ConfigLoaded, "short");
+    bus.publishNotification(MessageType::ConfigError, longData);
+
+    ASSERT_TRUE(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return payloads.size() == 2;
+    }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(payloads[0], "short");
+    EXPECT_FALSE(truncated[0]);
+    EXPECT_EQ(payloads[1], longData.substr(0, PluginEvent::DATA_CAPACITY));
+    EXPECT_TRUE(truncated[1]);
+}
+
+// =============================================================================
+// Backpressure Tests
+// =============================================================================
+
+TEST_F(PluginEventBusTest, SlowSubscriberDropsInsteadOfBlockingPublisher) {
+    auto& bus = PluginEventBus::instance();
+    std::mutex gateMutex;
+    std::condition_variable gateCond;
+    bool released = false;
+    std::atomic<uint64_t> delivered{0};
+
+    auto handle = bus.subscribe("slow", PluginEventMask_All, [&](const PluginEvent&) {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gateCond.wait(lock, [&] { return released; });
+        delivered++;
+    });
+
+    // Far more records than the ring holds while the subscriber is stuck
+    const size_t total = PluginEventBus::RING_CAPACITY * 3;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < total; ++i) {
+        bus.publishKey(static_cast<uint16_t>(i), true, false, i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(1)) << "Publisher must not wait for subscribers";
+
+    {
+        std::lock_guard<std::mutex> lock(gateMutex);
+        released = true;
+    }
+    gateCond.notify_all();
+
+    ASSERT_TRUE(waitFor([&] {
+        auto stats = bus.subscriberStats();
+        return stats.size() == 1 && stats[0].delivered + stats[0].dropped == total;
+    }));
+
+    auto stats = bus.subscriberStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].handle, handle);
+    EXPECT_EQ(stats[0].name, "slow");
+    EXPECT_GT(stats[0].dropped, 0u);
+    EXPECT_LE(stats[0].delivered, PluginEventBus::RING_CAPACITY + 1);
+    EXPECT_EQ(stats[0].lag, 0u);
+    EXPECT_GT(stats[0].maxLag, 0u);
+}
+
+// =============================================================================
+// Unsubscription Tests
+// =============================================================================
+
+TEST_F(PluginEventBusTest, UnsubscribeStopsDelivery) {
+    auto& bus = PluginEventBus::instance();
+    std::atomic<int> count{0};
+
+    auto handle = bus.subscribe("once", PluginEventMask_All, [&](const PluginEvent&) { count++; });
+    bus.publishKey(0x1e, true, false, 1);
+    ASSERT_TRUE(waitFor([&] { return count == 1; }));
+
+    EXPECT_TRUE(bus.unsubscribe(handle));
+    EXPECT_FALSE(bus.unsubscribe(handle));
+    EXPECT_FALSE(bus.hasSubscribers());
+
+    bus.publishKey(0x1e, false, false, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(count, 1);
+}
+
+TEST_F(PluginEventBusTest, UnsubscribeOwnerRemovesOnlyThatOwner) {
+    auto& bus = PluginEventBus::instance();
+    int ownerA = 0;
+    int ownerB = 0;
+
+    bus.subscribe("a1", PluginEventMask_All, [](const PluginEvent&) {}, &ownerA);
+    bus.subscribe("a2", PluginEventMask_All, [](const PluginEvent&) {}, &ownerA);
+    bus.subscribe("b", PluginEventMask_All, [](const PluginEvent&) {}, &ownerB);
+
+    EXPECT_EQ(bus.unsubscribeOwner(&ownerA), 2u);
+
+    auto stats = bus.subscriberStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].name, "b");
+}
+
+TEST_F(PluginEventBusTest, CallbackCanUnsubscribeItself) {
+    auto& bus = PluginEventBus::instance();
+    std::atomic<SubscriptionHandle> handle{0};
+    std::atomic<bool> done{false};
+
+    handle = bus.subscribe("self", PluginEventMask_All, [&](const PluginEvent&) {
+        PluginEventBus::instance().unsubscribe(handle.load());
+        done = true;
+    });
+
+    bus.publishKey(0x1e, true, false, 1);
+    ASSERT_TRUE(waitFor([&] { return done.load(); }));
+    EXPECT_FALSE(bus.hasSubscribers());
+}
+
+// =============================================================================
+// Exception Handling Tests
+// =============================================================================
+
+TEST_F(PluginEventBusTest, ThrowingCallbackDoesNotStopSubscriber) {
+    auto& bus = PluginEventBus::instance();
+    std::atomic<int> count{0};
+
+    bus.subscribe("throws", PluginEventMask_All, [&](const PluginEvent&) {
+        count++;
+        throw std::runtime_error("plugin failure");
+    });
+
+    bus.publishKey(0x1e, true, false, 1);
+    bus.publishKey(0x1e, false, false, 2);
+
+    ASSERT_TRUE(waitFor([&] { return count == 2; }));
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
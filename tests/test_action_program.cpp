@@ -0,0 +1,233 @@
+/**
+ * @file test_action_program.cpp
+ * @brief Tests for the compiled KeySeq bytecode interpreter
+ *
+ * Tests cover:
+ * - Part_all / Part_down / Part_up walk over action steps
+ * - Nested sequences
+ * - Variable and Repeat resolution
+ * - Depth and frame size limits
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../src/core/engine/action_program.h"
+
+using namespace yamy::engine;
+
+namespace {
+
+// Keys are only carried as opaque pointers by the interpreter
+const char kKeyA = 'a';
+const char kKeyB = 'b';
+const char kKeyC = 'c';
+
+ActionStepCode keyStep(const char* key) {
+    ActionStepCode step;
+    ActionInstr press;
+    press.op = ActionOp::KeyPress;
+    press.isPressed = true;
+    press.ptr = key;
+    step.press.push_back(press);
+
+    ActionInstr release;
+    release.op = ActionOp::KeyRelease;
+    release.isPressed = false;
+    release.ptr = key;
+    step.release.push_back(release);
+    return step;
+}
+
+ActionStepCode controlStep(ActionOp op, int32_t arg0, int32_t arg1 = 0, bool onRelease = true) {
+    ActionStepCode step;
+    ActionInstr instr;
+    instr.op = op;
+    instr.arg0 = arg0;
+    instr.arg1 = arg1;
+    instr.isPressed = true;
+    step.press.push_back(instr);
+    if (onRelease) {
+        instr.isPressed = false;
+        step.release.push_back(instr);
+    }
+    return step;
+}
+
+/// Render a frame as "+a -a +b" for compact comparisons
+std::string render(const ActionFrame& frame) {
+    std::string out;
+    for (const auto& instr : frame) {
+        if (!out.empty()) out += ' ';
+        switch (instr.op) {
+            case ActionOp::KeyPress: out += '+'; break;
+            case ActionOp::KeyRelease: out += '-'; break;
+            default: out += '?'; break;
+        }
+        out += *static_cast<const char*>(instr.ptr);
+    }
+    return out;
+}
+
+std::string runToString(const ActionProgramTable& table, uint32_t program, ActionPart part, int& variable) {
+    ActionFrame frame;
+    EXPECT_TRUE(table.run(program, part, variable, frame));
+    return render(frame);
+}
+
+} // namespace
+
+// =============================================================================
+// Part Semantics
+// =============================================================================
+
+TEST(ActionProgramTest, PartsMatchLegacyKeySeqWalk) {
+    ActionProgramTable table;
+    uint32_t abc = table.addProgram({keyStep(&kKeyA), keyStep(&kKeyB), keyStep(&kKeyC)});
+    int variable = 0;
+
+    EXPECT_EQ(runToString(table, abc, ActionPart::All, variable), "+a -a +b -b +c -c");
+    EXPECT_EQ(runToString(table, abc, ActionPart::Down, variable), "+a -a +b -b +c");
+    EXPECT_EQ(runToString(table, abc, ActionPart::Up, variable), "-c");
+}
+
+TEST(ActionProgramTest, EmptyAndUnknownProgramsProduceNothing) {
+    ActionProgramTable table;
+    uint32_t empty = table.addProgram({});
+    int variable = 0;
+
+    EXPECT_EQ(runToString(table, empty, ActionPart::All, variable), "");
+    EXPECT_EQ(runToString(table, ActionProgramTable::NO_PROGRAM, ActionPart::All, variable), "");
+}
+
+TEST(ActionProgramTest, FrameIsAppendedNotCleared) {
+    ActionProgramTable table;
+    uint32_t a = table.addProgram({keyStep(&kKeyA)});
+    int variable = 0;
+
+    ActionFrame frame;
+    table.run(a, ActionPart::Down, variable, frame);
+    table.run(a, ActionPart::Up, variable, frame);
+    EXPECT_EQ(render(frame), "+a -a");
+}
+
+// =============================================================================
+// Control Instructions
+// =============================================================================
+
+TEST(ActionProgramTest, NestedSequenceFollowsEdge) {
+    ActionProgramTable table;
+    uint32_t inner = table.addProgram({keyStep(&kKeyA), keyStep(&kKeyB)});
+    uint32_t outer = table.addProgram({controlStep(ActionOp::Sequence, static_cast<int32_t>(inner)),
+                                       keyStep(&kKeyC)});
+    int variable = 0;
+
+    // Outer step 1 is pressed and released: inner runs Part_down then Part_up
+    EXPECT_EQ(runToString(table, outer, ActionPart::All, variable), "+a -a +b -b +c -c");
+    EXPECT_EQ(runToString(table, outer, ActionPart::Up, variable), "-c");
+}
+
+TEST(ActionProgramTest, RepeatUsesVariable) {
+    ActionProgramTable table;
+    uint32_t body = table.addProgram({keyStep(&kKeyA)});
+    // &Variable(0, 3) &Repeat(body, 10)
+    uint32_t program = table.addProgram({controlStep(ActionOp::Variable, 0, 3, false),
+                                         controlStep(ActionOp::Repeat, static_cast<int32_t>(body), 10)});
+    int variable = 7;
+
+    // Press: variable becomes 3, body runs 2 full times and is left pressed
+    EXPECT_EQ(runToString(table, program, ActionPart::Down, variable), "+a -a +a -a +a");
+    EXPECT_EQ(variable, 3);
+
+    // Release: body is released once
+    EXPECT_EQ(runToString(table, program, ActionPart::Up, variable), "-a");
+}
+
+TEST(ActionProgramTest, RepeatIsCappedByMaximum) {
+    ActionProgramTable table;
+    uint32_t body = table.addProgram({keyStep(&kKeyB)});
+    uint32_t program = table.addProgram({controlStep(ActionOp::Repeat, static_cast<int32_t>(body), 2)});
+    int variable = 50;
+
+    EXPECT_EQ(runToString(table, program, ActionPart::All, variable), "+b -b +b -b");
+}
+
+TEST(ActionProgramTest, RepeatWithZeroVariableEmitsNothingOnPress) {
+    ActionProgramTable table;
+    uint32_t body = table.addProgram({keyStep(&kKeyB)});
+    uint32_t program = table.addProgram({controlStep(ActionOp::Repeat, static_cast<int32_t>(body), 10)});
+    int variable = 0;
+
+    EXPECT_EQ(runToString(table, program, ActionPart::Down, variable), "");
+}
+
+TEST(ActionProgramTest, EffectInstructionsKeepTheirOperands) {
+    ActionProgramTable table;
+    ActionStepCode step;
+    ActionInstr wait;
+    wait.op = ActionOp::Wait;
+    wait.arg0 = 25;
+    step.press.push_back(wait);
+    ActionInstr toggle;
+    toggle.op = ActionOp::Toggle;
+    toggle.isPressed = false;
+    toggle.arg0 = 4;
+    toggle.arg1 = 1;
+    step.release.push_back(toggle);
+    uint32_t program = table.addProgram({step});
+    int variable = 0;
+
+    ActionFrame frame;
+    ASSERT_TRUE(table.run(program, ActionPart::All, variable, frame));
+    ASSERT_EQ(frame.size(), 2u);
+    EXPECT_EQ(frame[0].op, ActionOp::Wait);
+    EXPECT_EQ(frame[0].arg0, 25);
+    EXPECT_EQ(frame[1].op, ActionOp::Toggle);
+    EXPECT_FALSE(frame[1].isPressed);
+    EXPECT_EQ(frame[1].arg0, 4);
+    EXPECT_EQ(frame[1].arg1, 1);
+}
+
+// =============================================================================
+// Limits
+// =============================================================================
+
+TEST(ActionProgramTest, SelfReferenceStopsAtMaxDepth) {
+    ActionProgramTable table;
+    // Program 0 runs itself; the compiler never emits this, but a bad table must not hang
+    uint32_t loop = table.addProgram({controlStep(ActionOp::Sequence, 0)});
+    ASSERT_EQ(loop, 0u);
+    int variable = 0;
+
+    ActionFrame frame;
+    EXPECT_FALSE(table.run(loop, ActionPart::All, variable, frame));
+}
+
+TEST(ActionProgramTest, FrameSizeIsBounded) {
+    ActionProgramTable table;
+    uint32_t body = table.addProgram({keyStep(&kKeyA)});
+    uint32_t inner = table.addProgram({controlStep(ActionOp::Repeat, static_cast<int32_t>(body), 1000)});
+    uint32_t outer = table.addProgram({controlStep(ActionOp::Repeat, static_cast<int32_t>(inner), 1000)});
+    int variable = 1000;
+
+    ActionFrame frame;
+    EXPECT_FALSE(table.run(outer, ActionPart::All, variable, frame));
+    EXPECT_EQ(frame.size(), ActionProgramTable::MAX_FRAME_SIZE);
+}
+
+TEST(ActionProgramTest, ClearRemovesPrograms) {
+    ActionProgramTable table;
+    table.addProgram({keyStep(&kKeyA), keyStep(&kKeyB)});
+    EXPECT_EQ(table.programCount(), 1u);
+    EXPECT_EQ(table.instructionCount(), 4u);
+
+    table.clear();
+    EXPECT_EQ(table.programCount(), 0u);
+    EXPECT_EQ(table.instructionCount(), 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,272 @@
+/**
+ * @file test_chord_detector.cpp
+ * @brief Tests for chord compilation and simultaneous-press detection
+ *
+ * Tests cover:
+ * - Trie nodes for chords and their prefixes
+ * - Chord completion in either key order, and its release
+ * - In-order replay when no chord completes
+ * - Window expiry by timer and by event timestamps
+ * - Overlapping chords (J+K and J+K+L)
+ * - Kernel repeats never opening a window
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/core/engine/chord_detector.h"
+
+using namespace yamy::engine;
+
+namespace {
+
+const uint16_t kJ = 0x24;
+const uint16_t kK = 0x25;
+const uint16_t kL = 0x26;
+const uint16_t kA = 0x1e;
+
+ChordKeyEvent press(uint16_t scan, uint64_t timeUs = 0) {
+    ChordKeyEvent e;
+    e.scan = scan;
+    e.isPressed = true;
+    e.timestampUs = timeUs;
+    return e;
+}
+
+ChordKeyEvent repeat(uint16_t scan, uint64_t timeUs = 0) {
+    ChordKeyEvent e = press(scan, timeUs);
+    e.isAutoRepeat = true;
+    return e;
+}
+
+ChordKeyEvent release(uint16_t scan, uint64_t timeUs = 0) {
+    ChordKeyEvent e = press(scan, timeUs);
+    e.isPressed = false;
+    return e;
+}
+
+char keyName(uint16_t scan) {
+    switch (scan) {
+        case kJ: return 'j';
+        case kK: return 'k';
+        case kL: return 'l';
+        case kA: return 'a';
+        default: return '?';
+    }
+}
+
+/// Render steps as "P+a R+j C1 U1-j K-k" for compact comparisons
+std::string render(const ChordSteps& steps) {
+    std::string out;
+    for (const auto& step : steps) {
+        if (!out.empty()) out += ' ';
+        switch (step.kind) {
+            case ChordStep::Kind::Pass: out += 'P'; break;
+            case ChordStep::Kind::Replay: out += 'R'; break;
+            case ChordStep::Kind::ChordPress: out += 'C' + std::to_string(step.chord); continue;
+            case ChordStep::Kind::ChordRelease: out += 'U' + std::to_string(step.chord); break;
+            case ChordStep::Kind::ChordKeyRelease: out += 'K'; break;
+        }
+        out += step.key.isPressed ? '+' : '-';
+        out += keyName(step.key.scan);
+    }
+    return out;
+}
+
+class ChordDetectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const uint16_t jk[] = {kJ, kK};
+        ASSERT_TRUE(table.addChord(jk, 2, 1));
+    }
+
+    std::string feed(const ChordKeyEvent& e) {
+        ChordSteps steps;
+        detector.onKey(e, steps);
+        return render(steps);
+    }
+
+    std::string timeout() {
+        ChordSteps steps;
+        detector.onTimeout(steps);
+        return render(steps);
+    }
+
+    ChordTable table;
+    ChordDetector detector{table, 50};
+};
+
+} // namespace
+
+// =============================================================================
+// ChordTable
+// =============================================================================
+
+TEST(ChordTableTest, SubsetsBecomePrefixNodes) {
+    ChordTable table;
+    const uint16_t jkl[] = {kJ, kK, kL};
+    ASSERT_TRUE(table.addChord(jkl, 3, 7));
+
+    EXPECT_TRUE(table.isChordKey(kJ));
+    EXPECT_FALSE(table.isChordKey(kA));
+    EXPECT_EQ(table.nodeCount(), 7u);
+
+    const auto* full = table.find(table.bitOf(kJ) | table.bitOf(kK) | table.bitOf(kL));
+    ASSERT_NE(full, nullptr);
+    EXPECT_EQ(full->chord, 7u);
+    EXPECT_FALSE(full->isPrefix);
+
+    const auto* jk = table.find(table.bitOf(kJ) | table.bitOf(kK));
+    ASSERT_NE(jk, nullptr);
+    EXPECT_EQ(jk->chord, ChordTable::NO_CHORD);
+    EXPECT_TRUE(jk->isPrefix);
+}
+
+TEST(ChordTableTest, RejectsInvalidChords) {
+    ChordTable table;
+    const uint16_t single[] = {kJ};
+    const uint16_t twice[] = {kJ, kJ};
+    const uint16_t jk[] = {kJ, kK};
+    const uint16_t kj[] = {kK, kJ};
+
+    EXPECT_FALSE(table.addChord(single, 1, 0));
+    EXPECT_FALSE(table.addChord(twice, 2, 0));
+    EXPECT_TRUE(table.addChord(jk, 2, 0));
+    EXPECT_FALSE(table.addChord(kj, 2, 1));
+    EXPECT_EQ(table.chordCount(), 1u);
+}
+
+TEST(ChordTableTest, KeyLimit) {
+    ChordTable table;
+    uint16_t scan = 0x100;
+    for (size_t i = 0; i < ChordTable::MAX_KEYS / 2; ++i, scan += 2) {
+        const uint16_t pair[] = {scan, static_cast<uint16_t>(scan + 1)};
+        ASSERT_TRUE(table.addChord(pair, 2, static_cast<uint32_t>(i)));
+    }
+    const uint16_t extra[] = {kJ, kK};
+    EXPECT_FALSE(table.addChord(extra, 2, 99));
+}
+
+// =============================================================================
+// Detection
+// =============================================================================
+
+TEST_F(ChordDetectorTest, NonChordKeysPassThrough) {
+    EXPECT_EQ(feed(press(kA)), "P+a");
+    EXPECT_EQ(feed(release(kA)), "P-a");
+    EXPECT_TRUE(detector.isIdle());
+}
+
+TEST_F(ChordDetectorTest, ChordCompletesInEitherOrder) {
+    EXPECT_EQ(feed(press(kK)), "");
+    EXPECT_TRUE(detector.isBuffering());
+    EXPECT_EQ(feed(press(kJ)), "C1");
+    EXPECT_FALSE(detector.isBuffering());
+
+    // First release ends the chord, the rest only update key state
+    EXPECT_EQ(feed(release(kJ)), "U1-j");
+    EXPECT_EQ(feed(release(kK)), "K-k");
+    EXPECT_TRUE(detector.isIdle());
+}
+
+TEST_F(ChordDetectorTest, RepeatsOfChordKeysAreSwallowed) {
+    feed(press(kJ));
+    feed(press(kK));
+    EXPECT_EQ(feed(press(kJ)), "");
+    EXPECT_EQ(feed(release(kK)), "U1-k");
+}
+
+TEST_F(ChordDetectorTest, RepeatOfReplayedKeyNeverOpensWindow) {
+    feed(press(kJ));
+    EXPECT_EQ(timeout(), "R+j");
+
+    // J is down as output; its repeats type J and K types on its own
+    EXPECT_EQ(feed(repeat(kJ)), "P+j");
+    EXPECT_FALSE(detector.isBuffering());
+    EXPECT_EQ(feed(press(kK)), "");
+    EXPECT_EQ(feed(repeat(kJ)), "R+k P+j");
+    EXPECT_EQ(feed(release(kJ)), "P-j");
+    EXPECT_EQ(feed(release(kK)), "P-k");
+    EXPECT_TRUE(detector.isIdle());
+}
+
+TEST_F(ChordDetectorTest, RepeatOfHeldKeyKeepsWindow) {
+    feed(press(kJ));
+    EXPECT_EQ(feed(repeat(kJ)), "");
+    EXPECT_TRUE(detector.isBuffering());
+    EXPECT_EQ(feed(press(kK)), "C1");
+}
+
+TEST_F(ChordDetectorTest, ReleaseBeforeChordReplaysInOrder) {
+    EXPECT_EQ(feed(press(kJ)), "");
+    EXPECT_EQ(feed(release(kJ)), "R+j P-j");
+    EXPECT_TRUE(detector.isIdle());
+}
+
+TEST_F(ChordDetectorTest, OtherKeyFlushesHeldKeysFirst) {
+    feed(press(kJ));
+    EXPECT_EQ(feed(press(kA)), "R+j P+a");
+    // K now starts its own window
+    EXPECT_EQ(feed(press(kK)), "");
+    EXPECT_EQ(timeout(), "R+k");
+}
+
+TEST_F(ChordDetectorTest, TimeoutReplaysIncompleteChord) {
+    const uint32_t window = detector.windowId();
+    feed(press(kJ));
+    EXPECT_NE(detector.windowId(), window);
+    EXPECT_EQ(timeout(), "R+j");
+    EXPECT_EQ(timeout(), "");
+    // Key now typed normally
+    EXPECT_EQ(feed(release(kJ)), "P-j");
+}
+
+TEST_F(ChordDetectorTest, LateEventClosesWindowBeforeItself) {
+    feed(press(kJ, 1000000));
+    // K arrives 60ms later; the 50ms window already closed
+    EXPECT_EQ(feed(press(kK, 1060000)), "R+j");
+    EXPECT_TRUE(detector.isBuffering());
+    EXPECT_EQ(timeout(), "R+k");
+}
+
+TEST_F(ChordDetectorTest, ResetDropsState) {
+    feed(press(kJ));
+    detector.reset();
+    EXPECT_TRUE(detector.isIdle());
+    EXPECT_EQ(timeout(), "");
+}
+
+TEST(ChordDetectorOverlapTest, LongerChordWaitsForWindow) {
+    ChordTable table;
+    const uint16_t jk[] = {kJ, kK};
+    const uint16_t jkl[] = {kJ, kK, kL};
+    ASSERT_TRUE(table.addChord(jk, 2, 1));
+    ASSERT_TRUE(table.addChord(jkl, 3, 2));
+    ChordDetector detector(table, 50);
+    ChordSteps steps;
+
+    // J+K could still become J+K+L
+    detector.onKey(press(kJ), steps);
+    detector.onKey(press(kK), steps);
+    EXPECT_TRUE(steps.empty());
+    detector.onKey(press(kL), steps);
+    EXPECT_EQ(render(steps), "C2");
+
+    steps.clear();
+    detector.onKey(release(kL), steps);
+    detector.onKey(release(kK), steps);
+    detector.onKey(release(kJ), steps);
+    EXPECT_EQ(render(steps), "U2-l K-k K-j");
+
+    // Window closing on J+K completes the shorter chord
+    steps.clear();
+    detector.onKey(press(kK), steps);
+    detector.onKey(press(kJ), steps);
+    detector.onTimeout(steps);
+    EXPECT_EQ(render(steps), "C1");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
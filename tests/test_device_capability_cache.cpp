@@ -0,0 +1,138 @@
+/**
+ * @file test_device_capability_cache.cpp
+ * @brief Tests for the device capability cache and parallel device work
+ *
+ * Tests cover:
+ * - A node whose sysfs entry is unchanged is not probed again
+ * - A new modification time (a replugged device) invalidates the entry
+ * - A node that cannot be opened is never cached
+ * - forEachParallel() runs every index once, on more than one thread
+ *
+ * There are no evdev nodes here, so a regular file stands in for both the
+ * device node and its sysfs entry: it opens, but reports no capabilities.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/platform/linux/device_manager_linux.h"
+
+using namespace yamy::platform;
+
+namespace {
+
+class TempNode {
+public:
+    TempNode() {
+        char path[] = "/tmp/yamy_capsXXXXXX";
+        const int fd = mkstemp(path);
+        EXPECT_GE(fd, 0);
+        close(fd);
+        m_path = path;
+    }
+    ~TempNode() { unlink(m_path.c_str()); }
+
+    const std::string& path() const { return m_path; }
+
+    void setMtime(time_t seconds) {
+        timespec times[2] = {{seconds, 0}, {seconds, 0}};
+        EXPECT_EQ(utimensat(AT_FDCWD, m_path.c_str(), times, 0), 0);
+    }
+
+private:
+    std::string m_path;
+};
+
+class DeviceCapabilityCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override { DeviceManager::clearCapabilityCache(); }
+    void TearDown() override { DeviceManager::clearCapabilityCache(); }
+};
+
+} // namespace
+
+TEST_F(DeviceCapabilityCacheTest, UnchangedNodeIsProbedOnce) {
+    TempNode node;
+    node.setMtime(1000);
+
+    const DeviceCapabilities first = DeviceManager::getCapabilities(node.path(), node.path());
+    const DeviceCapabilities second = DeviceManager::getCapabilities(node.path(), node.path());
+
+    EXPECT_TRUE(first.isReadable);
+    EXPECT_FALSE(first.isKeyboard);
+    EXPECT_FALSE(second.isMouse);
+    const DeviceManager::CacheStats stats = DeviceManager::cacheStats();
+    EXPECT_EQ(stats.probes, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+}
+
+TEST_F(DeviceCapabilityCacheTest, NewMtimeProbesAgain) {
+    TempNode node;
+    node.setMtime(1000);
+    DeviceManager::getCapabilities(node.path(), node.path());
+
+    node.setMtime(2000);
+    DeviceManager::getCapabilities(node.path(), node.path());
+    DeviceManager::getCapabilities(node.path(), node.path());
+
+    const DeviceManager::CacheStats stats = DeviceManager::cacheStats();
+    EXPECT_EQ(stats.probes, 2u);
+    EXPECT_EQ(stats.hits, 1u);
+}
+
+TEST_F(DeviceCapabilityCacheTest, UnreadableNodeIsNotCached) {
+    TempNode sysfs;
+    const std::string missing = sysfs.path() + "_missing";
+
+    const DeviceCapabilities caps = DeviceManager::getCapabilities(missing, sysfs.path());
+    DeviceManager::getCapabilities(missing, sysfs.path());
+
+    EXPECT_FALSE(caps.isReadable);
+    EXPECT_TRUE(caps.name.empty());
+    const DeviceManager::CacheStats stats = DeviceManager::cacheStats();
+    EXPECT_EQ(stats.probes, 2u);
+    EXPECT_EQ(stats.hits, 0u);
+}
+
+TEST(DeviceManagerParallelTest, EveryIndexRunsOnce) {
+    constexpr size_t COUNT = 40;
+    std::vector<std::atomic<int>> runs(COUNT);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    DeviceManager::forEachParallel(COUNT, [&](size_t i) {
+        ++runs[i];
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        // Long enough that one thread cannot take every index
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(runs[i], 1) << "index " << i;
+    }
+    EXPECT_GT(threads.size(), 1u);
+    EXPECT_LE(threads.size(), DeviceManager::PARALLEL_DEVICES);
+}
+
+TEST(DeviceManagerParallelTest, NothingToDo) {
+    int runs = 0;
+    DeviceManager::forEachParallel(0, [&runs](size_t) { ++runs; });
+    EXPECT_EQ(runs, 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
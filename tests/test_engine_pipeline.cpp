@@ -0,0 +1,339 @@
+/**
+ * @file test_engine_pipeline.cpp
+ * @brief Tests that drive a real Engine from the input hook to the injector
+ *
+ * Tests cover:
+ * - A D- assignment to a plain key presses and releases the target on press
+ * - Patching a mouse button mapping leaves the key of the same scan code alone
+ * - Kernel repeats dropped under engine autorepeat are never reported queued
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/core/engine/engine.h"
+#include "../src/core/settings/json_config_loader.h"
+#include "../src/utils/msgstream.h"
+#include "test_utils/null_platform.h"
+
+using namespace yamy::platform;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint16_t SCAN_ESCAPE = 0x01;
+constexpr uint16_t SCAN_A = 0x1e;
+constexpr uint16_t SCAN_B = 0x30;
+
+const std::string CONFIG_AB = R"({
+  "version": "2.0",
+  "keyboard": {
+    "keys": {
+      "A": "0x1e",
+      "B": "0x30"
+    }
+  },
+  "mappings": []
+})";
+
+// LButton (E1-0x01) shares its scan code with Escape (0x01)
+const std::string CONFIG_MOUSE = R"({
+  "version": "2.0",
+  "keyboard": {
+    "keys": {
+      "Escape": "0x01",
+      "C": "0x2e",
+      "LButton": "E1-0x01"
+    }
+  },
+  "mappings": []
+})";
+
+const std::string CONFIG_MOUSE_MAPPED = R"({
+  "version": "2.0",
+  "keyboard": {
+    "keys": {
+      "Escape": "0x01",
+      "C": "0x2e",
+      "LButton": "E1-0x01"
+    }
+  },
+  "mappings": [
+    { "from": "LButton", "to": "C" }
+  ]
+})";
+
+const std::string CONFIG_AUTOREPEAT = R"({
+  "version": "2.0",
+  "keyboard": {
+    "keys": {
+      "A": "0x1e"
+    }
+  },
+  "mappings": [],
+  "autoRepeat": {
+    "enabled": true,
+    "delayMs": 10000
+  }
+})";
+
+void writeFile(const std::string &path, const std::string &content) {
+    std::ofstream out(path);
+    out << content;
+}
+
+/// One injected key: YAMY scan code and edge
+struct Output {
+    uint16_t scan;
+    bool isPressed;
+
+    bool operator==(const Output &other) const {
+        return scan == other.scan && isPressed == other.isPressed;
+    }
+};
+
+std::ostream &operator<<(std::ostream &os, const Output &output) {
+    return os << "0x" << std::hex << output.scan << std::dec
+              << (output.isPressed ? " down" : " up");
+}
+
+/// Input hook that feeds events into the engine as the reader thread would,
+/// and counts the events the engine reports queued and processed
+class FeedingInputHook : public IInputHook {
+public:
+    FeedingInputHook()
+        : m_queued(0)
+        , m_processed(0) {}
+
+    bool install(KeyCallback keyCallback, MouseCallback) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keyCallback = keyCallback;
+        return true;
+    }
+
+    void uninstall() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keyCallback = nullptr;
+    }
+
+    bool isInstalled() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<bool>(m_keyCallback);
+    }
+
+    bool feed(const KeyEvent &event) {
+        KeyCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            callback = m_keyCallback;
+        }
+        if (!callback) {
+            return false;
+        }
+        callback(event);
+        return true;
+    }
+
+    void inputQueued() override { ++m_queued; }
+
+    void inputProcessed() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_processed;
+        m_cond.notify_all();
+    }
+
+    int queued() const { return m_queued; }
+
+    /// Wait until the handler has gone back for input count times
+    bool waitProcessed(int count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cond.wait_for(lock, 2s, [&] { return m_processed >= count; });
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    KeyCallback m_keyCallback;
+    std::atomic<int> m_queued;
+    int m_processed;
+};
+
+/// Input injector that records every injected key
+class RecordingInputInjector : public IInputInjector {
+public:
+    void inject(const KEYBOARD_INPUT_DATA *data, const InjectionContext &, const void *) override {
+        if (!data || (data->Flags & KEYBOARD_INPUT_DATA::E1)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_outputs.push_back({data->MakeCode, !(data->Flags & KEYBOARD_INPUT_DATA::BREAK)});
+        m_cond.notify_all();
+    }
+
+    void keyDown(KeyCode) override {}
+    void keyUp(KeyCode) override {}
+    void mouseMove(int32_t, int32_t) override {}
+    void mouseButton(MouseButton, bool) override {}
+    void mouseWheel(int32_t) override {}
+
+    /// Wait for count outputs, then until output goes quiet
+    std::vector<Output> waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait_for(lock, 2s, [&] { return m_outputs.size() >= count; });
+        size_t seen = m_outputs.size();
+        while (m_cond.wait_for(lock, 50ms, [&] { return m_outputs.size() != seen; })) {
+            seen = m_outputs.size();
+        }
+        return m_outputs;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<Output> m_outputs;
+};
+
+} // namespace
+
+class EnginePipelineTest : public ::testing::Test {
+protected:
+    EnginePipelineTest()
+        : m_log(0)
+        , m_timeUs(1000000) {}
+
+    void SetUp() override {
+        m_engine = std::make_unique<Engine>(m_log, &m_windowSystem, nullptr,
+                                            &m_injector, &m_hook, &m_driver);
+        m_engine->start();
+    }
+
+    void TearDown() override {
+        m_engine->stop();
+        m_engine.reset();
+    }
+
+    /// Load json, let edit add what JSON cannot express, then apply it
+    void applyConfig(const std::string &json,
+                     const std::function<void(Setting &)> &edit = nullptr) {
+        const std::string path = configPath();
+        writeFile(path, json);
+
+        auto setting = std::make_unique<Setting>();
+        yamy::settings::JsonConfigLoader loader;
+        ASSERT_TRUE(loader.load(setting.get(), path));
+        if (edit) {
+            edit(*setting);
+        }
+
+        // setSetting refuses while the engine is synchronizing; retry briefly
+        int retries = 100;
+        while (!m_engine->setSetting(setting.get())) {
+            ASSERT_GT(--retries, 0) << "engine did not accept the setting";
+            std::this_thread::sleep_for(10ms);
+        }
+        m_setting = std::move(setting);
+    }
+
+    static std::string configPath() {
+        return ::testing::TempDir() + "yamy_engine_pipeline.json";
+    }
+
+    void feed(uint16_t scan, bool isPressed, bool isAutoRepeat = false) {
+        m_timeUs += 10000;
+        KeyEvent event{};
+        event.key = KeyCode::Unknown;
+        event.scanCode = scan;
+        event.isKeyDown = isPressed;
+        event.isAutoRepeat = isAutoRepeat;
+        event.timestamp = static_cast<uint32_t>(m_timeUs / 1000);
+        event.timestampUs = m_timeUs;
+        event.flags = isPressed ? 0 : 1;
+        ASSERT_TRUE(m_hook.feed(event));
+    }
+
+    /// key <edge>-<from> = <to>, added to the global keymap
+    static void addEdgeAssignment(Setting &setting, const std::string &from,
+                                  Modifier::Type edge, const std::string &to) {
+        ModifiedKey fromKey(setting.m_keyboard.searchKey(from));
+        fromKey.m_modifier.on(edge);
+
+        KeySeq keySeq(from + " edge");
+        keySeq.setMode(Modifier::Type_ASSIGN);
+        keySeq.add(ActionKey(ModifiedKey(setting.m_keyboard.searchKey(to))));
+
+        setting.m_keymaps.searchByName("Global")->addAssignment(
+            fromKey, setting.m_keySeqs.add(keySeq));
+    }
+
+    tomsgstream m_log;
+    NullWindowSystem m_windowSystem;
+    NullInputDriver m_driver;
+    FeedingInputHook m_hook;
+    RecordingInputInjector m_injector;
+    std::unique_ptr<Setting> m_setting;
+    std::unique_ptr<Engine> m_engine;
+    uint64_t m_timeUs;
+};
+
+TEST_F(EnginePipelineTest, DownAssignmentPressesAndReleasesTargetOnPress) {
+    applyConfig(CONFIG_AB, [](Setting &setting) {
+        addEdgeAssignment(setting, "A", Modifier::Type_Down, "B");
+    });
+
+    feed(SCAN_A, true);
+    const std::vector<Output> pressed = m_injector.waitFor(2);
+    EXPECT_EQ(pressed, (std::vector<Output>{{SCAN_B, true}, {SCAN_B, false}}));
+
+    // The release of A has nothing left to output; B must not be left down
+    feed(SCAN_A, false);
+    const std::vector<Output> released = m_injector.waitFor(3);
+    EXPECT_EQ(released, pressed);
+}
+
+TEST_F(EnginePipelineTest, PatchedMouseMappingLeavesKeyOfSameScanCodeAlone) {
+    // switchConfiguration() hands the setting to the engine, so that
+    // reloadConfiguration() can patch it in place
+    const std::string path = configPath();
+    writeFile(path, CONFIG_MOUSE);
+    ASSERT_TRUE(m_engine->switchConfiguration(path));
+
+    writeFile(path, CONFIG_MOUSE_MAPPED);
+    ASSERT_TRUE(m_engine->reloadConfiguration(path));
+
+    // The LButton rule is not in the scan code lookup table, so Escape
+    // still has no rule
+    feed(SCAN_ESCAPE, true);
+    feed(SCAN_ESCAPE, false);
+    EXPECT_EQ(m_injector.waitFor(2),
+              (std::vector<Output>{{SCAN_ESCAPE, true}, {SCAN_ESCAPE, false}}));
+}
+
+TEST_F(EnginePipelineTest, KernelRepeatsUnderEngineAutoRepeatAreNotQueued) {
+    applyConfig(CONFIG_AUTOREPEAT);
+    const int queuedBefore = m_hook.queued();
+
+    // The engine repeats A itself, so the kernel repeats never reach the
+    // queue; a grab watchdog must not count them as input left unanswered
+    feed(SCAN_A, true);
+    for (int i = 0; i < 5; ++i) {
+        feed(SCAN_A, true, true);
+    }
+    feed(SCAN_A, false);
+
+    EXPECT_EQ(m_injector.waitFor(2),
+              (std::vector<Output>{{SCAN_A, true}, {SCAN_A, false}}));
+    EXPECT_EQ(m_hook.queued() - queuedBefore, 2);
+
+    // The handler reports processed once before its first event and once
+    // after each queued one
+    EXPECT_TRUE(m_hook.waitProcessed(m_hook.queued() + 1));
+}
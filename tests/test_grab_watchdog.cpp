@@ -0,0 +1,92 @@
+/**
+ * @file test_grab_watchdog.cpp
+ * @brief Tests for the watchdog that releases grabbed keyboards
+ *
+ * Tests cover:
+ * - Input the engine never takes releases the grab after the threshold
+ * - An engine that keeps up never triggers a release
+ * - No input at all is not a stall
+ * - The release runs once, and stop() before the threshold prevents it
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../src/platform/linux/grab_watchdog.h"
+
+using namespace yamy::platform;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::chrono::milliseconds STALL = 50ms;
+
+} // namespace
+
+TEST(GrabWatchdogTest, StalledEngineReleases) {
+    std::atomic<int> releases{0};
+    GrabWatchdog watchdog([&releases] { ++releases; });
+    ASSERT_TRUE(watchdog.start(STALL));
+
+    const auto delivered = std::chrono::steady_clock::now();
+    watchdog.inputDelivered();
+    while (!watchdog.hasReleased() && std::chrono::steady_clock::now() - delivered < 2s) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    ASSERT_TRUE(watchdog.hasReleased());
+    EXPECT_GE(std::chrono::steady_clock::now() - delivered, STALL);
+    watchdog.stop();
+    EXPECT_EQ(releases, 1);
+}
+
+TEST(GrabWatchdogTest, EngineKeepingUpDoesNotRelease) {
+    std::atomic<int> releases{0};
+    GrabWatchdog watchdog([&releases] { ++releases; });
+    ASSERT_TRUE(watchdog.start(STALL));
+
+    // Steady typing for four thresholds, each key answered promptly
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < 4 * STALL) {
+        watchdog.inputDelivered();
+        std::this_thread::sleep_for(5ms);
+        watchdog.inputProcessed();
+    }
+    watchdog.stop();
+
+    EXPECT_FALSE(watchdog.hasReleased());
+    EXPECT_EQ(releases, 0);
+}
+
+TEST(GrabWatchdogTest, IdleIsNotAStall) {
+    std::atomic<int> releases{0};
+    GrabWatchdog watchdog([&releases] { ++releases; });
+    ASSERT_TRUE(watchdog.start(STALL));
+
+    watchdog.inputDelivered();
+    watchdog.inputProcessed();
+    std::this_thread::sleep_for(4 * STALL);
+    watchdog.stop();
+
+    EXPECT_EQ(releases, 0);
+}
+
+TEST(GrabWatchdogTest, StopBeforeThresholdDoesNotRelease) {
+    std::atomic<int> releases{0};
+    GrabWatchdog watchdog([&releases] { ++releases; });
+    ASSERT_TRUE(watchdog.start(10s));
+
+    watchdog.inputDelivered();
+    std::this_thread::sleep_for(20ms);
+    watchdog.stop();
+
+    EXPECT_FALSE(watchdog.isRunning());
+    EXPECT_EQ(releases, 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_inotify_config_watcher.cpp
+ * @brief Tests for the Qt-free config file watcher
+ *
+ * Tests cover:
+ * - A burst of writes reported once after the debounce
+ * - Save by write-temp + rename over the config
+ * - Other files in the config directory are ignored
+ * - Edits to an included file in another directory
+ * - No report while the config is deleted
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "../src/core/settings/inotify_config_watcher.h"
+
+using namespace yamy::settings;
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t kDebounceMs = 30;
+
+void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+}
+
+class InotifyConfigWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = fs::temp_directory_path() / ("yamy_watch_test_" + std::to_string(::getpid()));
+        fs::remove_all(dir);
+        fs::create_directories(dir / "include");
+        config = dir / "config.json";
+        writeFile(config, "{}");
+
+        watcher.setDebounceMs(kDebounceMs);
+        watcher.setChangeCallback([this](const std::string& path) {
+            std::lock_guard<std::mutex> lock(mutex);
+            reported = path;
+            ++changes;
+        });
+    }
+
+    void TearDown() override {
+        watcher.stop();
+        fs::remove_all(dir);
+    }
+
+    /// Wait out the debounce and the callback
+    void settle() { sleepMs(kDebounceMs * 4); }
+
+    std::string lastPath() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return reported;
+    }
+
+    fs::path dir;
+    fs::path config;
+    InotifyConfigWatcher watcher;
+    std::atomic<int> changes{0};
+    std::mutex mutex;
+    std::string reported;
+};
+
+} // namespace
+
+TEST_F(InotifyConfigWatcherTest, StartRequiresConfigPath) {
+    EXPECT_FALSE(watcher.start());
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+    EXPECT_TRUE(watcher.isWatching());
+    EXPECT_EQ(watcher.watchedFiles().size(), 1u);
+}
+
+TEST_F(InotifyConfigWatcherTest, BurstOfWritesReportedOnce) {
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+
+    for (int i = 0; i < 5; ++i) {
+        writeFile(config, "{\"n\": " + std::to_string(i) + "}");
+        sleepMs(2);
+    }
+    settle();
+    EXPECT_EQ(changes.load(), 1);
+    EXPECT_EQ(lastPath(), config.string());
+}
+
+TEST_F(InotifyConfigWatcherTest, RenameOverConfigReported) {
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+
+    writeFile(dir / ".config.json.swp", "{\"saved\": true}");
+    fs::rename(dir / ".config.json.swp", config);
+    settle();
+    EXPECT_EQ(changes.load(), 1);
+
+    // The watch survives the inode change
+    writeFile(config, "{\"again\": true}");
+    settle();
+    EXPECT_EQ(changes.load(), 2);
+}
+
+TEST_F(InotifyConfigWatcherTest, OtherFilesIgnored) {
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+
+    writeFile(dir / "notes.txt", "hello");
+    settle();
+    EXPECT_EQ(changes.load(), 0);
+}
+
+TEST_F(InotifyConfigWatcherTest, IncludedFileReported) {
+    const fs::path included = dir / "include" / "common.mayu";
+    writeFile(included, "");
+    watcher.setDependencyResolver([&](const std::string&) {
+        return std::set<std::string>{included.string()};
+    });
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+    EXPECT_EQ(watcher.watchedFiles().size(), 2u);
+
+    writeFile(included, "key A = B");
+    settle();
+    EXPECT_EQ(changes.load(), 1);
+    EXPECT_EQ(lastPath(), config.string());
+}
+
+TEST_F(InotifyConfigWatcherTest, DeletedConfigNotReported) {
+    watcher.setConfigPath(config.string());
+    ASSERT_TRUE(watcher.start());
+
+    fs::remove(config);
+    settle();
+    EXPECT_EQ(changes.load(), 0);
+
+    // Restoring it is an edit
+    writeFile(config, "{}");
+    settle();
+    EXPECT_EQ(changes.load(), 1);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
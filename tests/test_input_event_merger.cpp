@@ -0,0 +1,193 @@
+/**
+ * @file test_input_event_merger.cpp
+ * @brief Tests for the kernel-timestamp merge of keyboard lanes
+ *
+ * Tests cover:
+ * - Events from a lane that was still reading are put before later ones
+ * - An idle lane (nothing waiting on its fd) does not hold others back
+ * - A lane with unread input holds events for at most the window
+ * - Events older than one already delivered are counted as late
+ * - stop() delivers what is queued, in timestamp order
+ *
+ * Each lane's fd is the read end of a pipe: writing a byte makes the lane
+ * look like a device with input its reader has not read yet.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+#include "../src/platform/linux/input_event_merger.h"
+
+using namespace yamy::platform;
+
+namespace {
+
+class Pipe {
+public:
+    Pipe() { EXPECT_EQ(pipe(m_fds), 0); }
+    ~Pipe() { close(m_fds[0]); close(m_fds[1]); }
+    int readEnd() const { return m_fds[0]; }
+    void makeReadable() { EXPECT_EQ(write(m_fds[1], "x", 1), 1); }
+
+private:
+    int m_fds[2];
+};
+
+class Collector {
+public:
+    KeyCallback callback() {
+        return [this](const KeyEvent& event) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_scans.push_back(event.scanCode);
+            m_cv.notify_all();
+            return false;
+        };
+    }
+
+    bool waitFor(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(2)) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, timeout, [&] { return m_scans.size() >= count; });
+    }
+
+    std::vector<uint32_t> scans() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_scans;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<uint32_t> m_scans;
+};
+
+KeyEvent makeKey(uint32_t scan, uint64_t timeUs) {
+    KeyEvent event{};
+    event.scanCode = scan;
+    event.isKeyDown = true;
+    event.timestampUs = timeUs;
+    return event;
+}
+
+constexpr uint64_t LONG_WINDOW_US = 10000000;
+
+} // namespace
+
+TEST(InputEventMergerTest, LaneStillReadingIsWaitedFor) {
+    Pipe a, b;
+    Collector collector;
+    InputEventMerger merger(collector.callback(), LONG_WINDOW_US);
+    const size_t laneA = merger.addLane(a.readEnd());
+    const size_t laneB = merger.addLane(b.readEnd());
+    ASSERT_TRUE(merger.start());
+
+    const uint64_t base = InputEventMerger::nowUs();
+    merger.beginRead(laneB);    // B has read a key and not pushed it yet
+    merger.beginRead(laneA);
+    merger.push(laneA, makeKey(0x1D, base + 200));  // Ctrl, pressed second
+    merger.endRead(laneA, base + 300);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(collector.scans().empty()) << "Ctrl must wait for lane B";
+
+    merger.push(laneB, makeKey(0x2E, base + 100));  // C, pressed first
+    merger.endRead(laneB, base + 300);
+    ASSERT_TRUE(collector.waitFor(2));
+
+    EXPECT_EQ(collector.scans(), (std::vector<uint32_t>{0x2E, 0x1D}));
+    const InputEventMerger::Stats stats = merger.stats();
+    EXPECT_EQ(stats.merged, 2u);
+    EXPECT_EQ(stats.reordered, 1u);
+    EXPECT_EQ(stats.late, 0u);
+    EXPECT_EQ(stats.expired, 0u);
+}
+
+TEST(InputEventMergerTest, IdleLaneDoesNotHoldBack) {
+    Pipe a, b;
+    Collector collector;
+    InputEventMerger merger(collector.callback(), LONG_WINDOW_US);
+    const size_t laneA = merger.addLane(a.readEnd());
+    merger.addLane(b.readEnd());
+    ASSERT_TRUE(merger.start());
+
+    const uint64_t now = InputEventMerger::nowUs();
+    merger.beginRead(laneA);
+    merger.push(laneA, makeKey(0x1E, now));
+    merger.endRead(laneA, now + 1);
+
+    ASSERT_TRUE(collector.waitFor(1, std::chrono::milliseconds(500)));
+    EXPECT_EQ(merger.stats().expired, 0u);
+}
+
+TEST(InputEventMergerTest, UnreadInputHoldsForTheWindow) {
+    Pipe a, b;
+    Collector collector;
+    InputEventMerger merger(collector.callback(), 20000);
+    const size_t laneA = merger.addLane(a.readEnd());
+    merger.addLane(b.readEnd());
+    ASSERT_TRUE(merger.start());
+
+    b.makeReadable();   // B's reader is not scheduled
+    const uint64_t now = InputEventMerger::nowUs();
+    merger.beginRead(laneA);
+    merger.push(laneA, makeKey(0x1E, now));
+    merger.endRead(laneA, now + 1);
+
+    ASSERT_TRUE(collector.waitFor(1));
+    EXPECT_GE(InputEventMerger::nowUs() - now, 20000u);
+    EXPECT_EQ(merger.stats().expired, 1u);
+}
+
+TEST(InputEventMergerTest, OlderThanDeliveredIsLate) {
+    Pipe a, b;
+    Collector collector;
+    InputEventMerger merger(collector.callback(), LONG_WINDOW_US);
+    const size_t laneA = merger.addLane(a.readEnd());
+    const size_t laneB = merger.addLane(b.readEnd());
+    ASSERT_TRUE(merger.start());
+
+    const uint64_t now = InputEventMerger::nowUs();
+    merger.beginRead(laneA);
+    merger.push(laneA, makeKey(0x1E, now));
+    merger.endRead(laneA, now + 1);
+    ASSERT_TRUE(collector.waitFor(1));
+
+    merger.beginRead(laneB);
+    merger.push(laneB, makeKey(0x30, now - 500));
+    merger.endRead(laneB, now + 1);
+    ASSERT_TRUE(collector.waitFor(2));
+
+    EXPECT_EQ(collector.scans(), (std::vector<uint32_t>{0x1E, 0x30}));
+    EXPECT_EQ(merger.stats().late, 1u);
+}
+
+TEST(InputEventMergerTest, StopDeliversQueuedInOrder) {
+    Pipe a, b;
+    Collector collector;
+    InputEventMerger merger(collector.callback(), LONG_WINDOW_US);
+    const size_t laneA = merger.addLane(a.readEnd());
+    const size_t laneB = merger.addLane(b.readEnd());
+    ASSERT_TRUE(merger.start());
+
+    const uint64_t base = InputEventMerger::nowUs();
+    merger.beginRead(laneB);    // Never finishes: holds everything back
+    merger.beginRead(laneA);
+    for (uint32_t i = 0; i < 300; ++i) {
+        merger.push(i % 2 ? laneA : laneB, makeKey(i, base + 1000 - i));
+    }
+    merger.stop();
+
+    const std::vector<uint32_t> scans = collector.scans();
+    ASSERT_EQ(scans.size(), 300u);
+    for (uint32_t i = 0; i < 300; ++i) {
+        EXPECT_EQ(scans[i], 299 - i);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
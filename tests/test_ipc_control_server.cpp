@@ -0,0 +1,257 @@
+/**
+ * @file test_ipc_control_server.cpp
+ * @brief Tests for the yamy-ctl control server
+ *
+ * Tests cover:
+ * - Several commands answered over one persistent connection
+ * - Pipelined commands sent in a single write
+ * - A client that sends half a command does not hold up other clients
+ * - Watch subscriptions: full first event, then only changed fields
+ * - Unchanged topics are not pushed; unsubscribe stops the stream
+ * - Unknown topics are rejected
+ *
+ * Each test starts a server on its own socket path and talks to it with
+ * blocking sockets, as yamy-ctl does.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../src/platform/linux/ipc_control_server.h"
+
+using namespace yamy::platform;
+
+namespace {
+
+enum : uint32_t {
+    CmdGetStatus = 0x2004,
+    CmdGetMetrics = 0x2007,
+    CmdSubscribe = 0x2008,
+    CmdUnsubscribe = 0x2009,
+    RspOk = 0x2100,
+    RspError = 0x2101,
+    RspStatus = 0x2102,
+    RspMetrics = 0x2105,
+    NtfWatchEvent = 0x2106
+};
+
+struct Header {
+    uint32_t type;
+    uint32_t dataSize;
+};
+
+std::string frame(uint32_t type, const std::string& data = "") {
+    Header header{type, static_cast<uint32_t>(data.size())};
+    return std::string(reinterpret_cast<const char*>(&header), sizeof(header)) + data;
+}
+
+int connectTo(const std::string& path) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendRaw(int fd, const std::string& bytes) {
+    return send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(bytes.size());
+}
+
+/// Read one message; false on timeout or EOF
+bool receive(int fd, uint32_t& type, std::string& data, int timeoutMs = 2000) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMs) <= 0) {
+        return false;
+    }
+    Header header;
+    if (recv(fd, &header, sizeof(header), MSG_WAITALL) != sizeof(header)) {
+        return false;
+    }
+    type = header.type;
+    data.assign(header.dataSize, '\0');
+    return header.dataSize == 0
+        || recv(fd, &data[0], header.dataSize, MSG_WAITALL) == static_cast<ssize_t>(header.dataSize);
+}
+
+class IPCControlServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "/tmp/yamy-control-test-" + std::to_string(::getpid()) + ".sock";
+        server = std::make_unique<IPCControlServer>(path);
+        server->setCommandCallback([](ControlCommand cmd, const std::string&) {
+            ControlResult result;
+            result.success = true;
+            result.message = cmd == ControlCommand::GetStatus ? "{\"state\":\"running\"}" : "{}";
+            return result;
+        });
+        server->setTopicCallback([this](const std::string& topic) -> std::string {
+            if (topic != "locks") {
+                return "";
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            return locks;
+        });
+        ASSERT_TRUE(server->start());
+    }
+
+    void TearDown() override {
+        server->stop();
+    }
+
+    void setLocks(const std::string& json) {
+        std::lock_guard<std::mutex> lock(mutex);
+        locks = json;
+    }
+
+    std::string path;
+    std::unique_ptr<IPCControlServer> server;
+    std::mutex mutex;
+    std::string locks = "{\"active\":[],\"count\":0}";
+};
+
+} // namespace
+
+TEST_F(IPCControlServerTest, PersistentConnectionAnswersEveryCommand) {
+    const int fd = connectTo(path);
+    ASSERT_GE(fd, 0);
+
+    uint32_t type = 0;
+    std::string data;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(sendRaw(fd, frame(CmdGetStatus)));
+        ASSERT_TRUE(receive(fd, type, data));
+        EXPECT_EQ(type, RspStatus);
+        EXPECT_EQ(data, "{\"state\":\"running\"}");
+    }
+    close(fd);
+}
+
+TEST_F(IPCControlServerTest, PipelinedCommandsAnsweredInOrder) {
+    const int fd = connectTo(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(sendRaw(fd, frame(CmdGetMetrics) + frame(CmdGetStatus) + frame(0x2fff)));
+
+    uint32_t type = 0;
+    std::string data;
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspMetrics);
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspStatus);
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspError);
+    EXPECT_EQ(data, "Unknown command");
+    close(fd);
+}
+
+TEST_F(IPCControlServerTest, StalledClientDoesNotBlockOthers) {
+    // Half a header: the old server blocked in recv() on this client
+    const int stalled = connectTo(path);
+    ASSERT_GE(stalled, 0);
+    ASSERT_TRUE(sendRaw(stalled, frame(CmdGetStatus).substr(0, 3)));
+
+    const int fd = connectTo(path);
+    ASSERT_GE(fd, 0);
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(sendRaw(fd, frame(CmdGetStatus)));
+    uint32_t type = 0;
+    std::string data;
+    ASSERT_TRUE(receive(fd, type, data, 500));
+    EXPECT_EQ(type, RspStatus);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    EXPECT_EQ(server->clientCount(), 2u);
+
+    // The stalled client finishes its command later and is answered too
+    ASSERT_TRUE(sendRaw(stalled, frame(CmdGetStatus).substr(3)));
+    ASSERT_TRUE(receive(stalled, type, data));
+    EXPECT_EQ(type, RspStatus);
+    close(stalled);
+    close(fd);
+}
+
+TEST_F(IPCControlServerTest, WatchPushesOnlyChangedFields) {
+    const int fd = connectTo(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(sendRaw(fd, frame(CmdSubscribe, "locks 50")));
+
+    uint32_t type = 0;
+    std::string data;
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspOk);
+
+    // First event: full state
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, NtfWatchEvent);
+    EXPECT_EQ(data, "{\"data\":{\"active\":[],\"count\":0},\"seq\":1,\"topic\":\"locks\"}");
+
+    // Nothing changes: nothing is pushed
+    EXPECT_FALSE(receive(fd, type, data, 200));
+
+    setLocks("{\"active\":[\"L01\"],\"count\":1}");
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(data, "{\"data\":{\"active\":[\"L01\"],\"count\":1},\"seq\":2,\"topic\":\"locks\"}");
+
+    setLocks("{\"active\":[\"L02\"],\"count\":1}");
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(data, "{\"data\":{\"active\":[\"L02\"]},\"seq\":3,\"topic\":\"locks\"}");
+
+    ASSERT_TRUE(sendRaw(fd, frame(CmdUnsubscribe, "locks")));
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspOk);
+    setLocks("{\"active\":[],\"count\":0}");
+    EXPECT_FALSE(receive(fd, type, data, 200));
+    close(fd);
+}
+
+TEST_F(IPCControlServerTest, WatchersOfOneTopicAreIndependent) {
+    const int first = connectTo(path);
+    const int second = connectTo(path);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+
+    uint32_t type = 0;
+    std::string data;
+    for (int fd : {first, second}) {
+        ASSERT_TRUE(sendRaw(fd, frame(CmdSubscribe, "locks 50")));
+        ASSERT_TRUE(receive(fd, type, data));
+        ASSERT_TRUE(receive(fd, type, data));
+        EXPECT_EQ(type, NtfWatchEvent);
+    }
+
+    // A watcher leaving does not stop the other one
+    close(first);
+    setLocks("{\"active\":[\"L10\"],\"count\":1}");
+    ASSERT_TRUE(receive(second, type, data));
+    EXPECT_EQ(data, "{\"data\":{\"active\":[\"L10\"],\"count\":1},\"seq\":2,\"topic\":\"locks\"}");
+    close(second);
+}
+
+TEST_F(IPCControlServerTest, UnknownTopicRejected) {
+    const int fd = connectTo(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(sendRaw(fd, frame(CmdSubscribe, "weather 100")));
+
+    uint32_t type = 0;
+    std::string data;
+    ASSERT_TRUE(receive(fd, type, data));
+    EXPECT_EQ(type, RspError);
+    EXPECT_EQ(data, "Unknown topic: weather");
+    close(fd);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -14,10 +14,13 @@
 
 #include "core/ipc_messages.h"
 #include "core/platform/ipc_defs.h"
+#include "core/platform/ipc_frame.h"
 #include "core/platform/linux/ipc_channel_qt.h"
 
 using yamy::ipc::InvestigateWindowRequest;
+using yamy::ipc::FrameReader;
 using yamy::ipc::KeyEventNotification;
+using yamy::ipc::LockStatusMessage;
 using yamy::ipc::Message;
 using yamy::ipc::MessageType;
 using yamy::platform::IPCChannelQt;
@@ -416,6 +419,108 @@ TEST_F(IPCProtocolTest, GuiConfigListResponseRoundTrip) {
     EXPECT_EQ("second.mayu", toString(receivedPayload.configs[1]));
 }
 
+TEST_F(IPCProtocolTest, LatestWinsMessagesAreCoalesced) {
+    std::vector<LockStatusMessage> received;
+    int keyEvents = 0;
+
+    auto conn = QObject::connect(
+        client, &IPCChannelQt::messageReceived,
+        [&](const Message& msg) {
+            if (msg.type == toWireType(GuiMessageType::LockStatusUpdate)) {
+                ASSERT_EQ(sizeof(LockStatusMessage), msg.size);
+                received.push_back(*static_cast<const LockStatusMessage*>(msg.data));
+            } else if (msg.type == MessageType::NtfKeyEvent) {
+                ++keyEvents;
+            }
+        });
+
+    // Three snapshots within one event loop turn collapse into the newest
+    for (uint32_t i = 1; i <= 3; ++i) {
+        LockStatusMessage status{};
+        status.lockBits[0] = i;
+        server->send(Message{toWireType(GuiMessageType::LockStatusUpdate), &status, sizeof(status)});
+
+        KeyEventNotification notification{};
+        server->send(Message{MessageType::NtfKeyEvent, &notification, sizeof(notification)});
+    }
+    QTest::qWait(50);
+
+    QObject::disconnect(conn);
+
+    ASSERT_EQ(1u, received.size());
+    EXPECT_EQ(3u, received[0].lockBits[0]);
+    EXPECT_EQ(3, keyEvents) << "Event notifications must not be coalesced";
+}
+
+// =============================================================================
+// FrameReader (in-place frame parsing)
+// =============================================================================
+
+namespace {
+std::vector<uint8_t> encodeFrame(uint32_t type, const std::string& payload) {
+    std::vector<uint8_t> frame(yamy::ipc::kFrameHeaderSize + payload.size());
+    yamy::ipc::encodeFrameHeader(type, static_cast<uint32_t>(payload.size()), frame.data());
+    std::copy(payload.begin(), payload.end(), frame.begin() + yamy::ipc::kFrameHeaderSize);
+    return frame;
+}
+} // namespace
+
+TEST(IPCFrameReaderTest, ReassemblesFramesSplitAcrossReads) {
+    std::vector<uint8_t> stream;
+    for (const std::string& payload : {"first", "", "third-payload"}) {
+        auto frame = encodeFrame(0x1234, payload);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    FrameReader reader(8);
+    std::vector<std::string> payloads;
+    for (uint8_t byte : stream) {
+        reader.append(&byte, 1);
+        reader.consume([&](uint32_t type, const void* data, size_t size) {
+            EXPECT_EQ(0x1234u, type);
+            payloads.emplace_back(static_cast<const char*>(data), size);
+        });
+    }
+
+    ASSERT_EQ(3u, payloads.size());
+    EXPECT_EQ("first", payloads[0]);
+    EXPECT_EQ("", payloads[1]);
+    EXPECT_EQ("third-payload", payloads[2]);
+    EXPECT_EQ(0u, reader.pending());
+}
+
+TEST(IPCFrameReaderTest, PayloadPointersAreAligned) {
+    // An odd-sized first payload leaves the second frame misaligned in the buffer
+    auto first = encodeFrame(1, "abc");
+    auto second = encodeFrame(2, std::string(sizeof(uint64_t) * 2, 'x'));
+
+    FrameReader reader;
+    reader.append(first.data(), first.size());
+    reader.append(second.data(), second.size());
+
+    size_t frames = 0;
+    auto result = reader.consume([&](uint32_t, const void* data, size_t) {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % alignof(uint64_t));
+        ++frames;
+    });
+
+    EXPECT_EQ(2u, result.frames);
+    EXPECT_EQ(2u, frames);
+}
+
+TEST(IPCFrameReaderTest, InvalidLengthResetsBuffer) {
+    const uint8_t bogus[] = {0x00, 0x00, 0x00, 0x02, 0xAA, 0xBB};
+
+    FrameReader reader;
+    reader.append(bogus, sizeof(bogus));
+    auto result = reader.consume([](uint32_t, const void*, size_t) {
+        FAIL() << "No frame should be delivered";
+    });
+
+    EXPECT_TRUE(result.corrupt);
+    EXPECT_EQ(0u, reader.pending());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,195 @@
+/**
+ * @file test_journey_feed.cpp
+ * @brief Tests for the batched investigate-mode journey feed
+ *
+ * Tests cover:
+ * - A JourneyRecord formats to the same line as the event it was made from
+ * - A full batch is flushed without waiting for the interval
+ * - A partial batch is flushed once the interval has passed
+ * - stop() flushes what is buffered and later events are ignored
+ * - Events are dropped and counted while the ring is full
+ */
+
+#include <gtest/gtest.h>
+#include <linux/input-event-codes.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../src/core/logger/journey_feed.h"
+
+using namespace yamy::logger;
+
+namespace {
+
+struct Batch {
+    std::string lines;
+    uint32_t count;
+    uint32_t dropped;
+};
+
+class BatchCollector {
+public:
+    JourneyFeed::BatchSink sink() {
+        return [this](const std::string& lines, uint32_t count, uint32_t dropped) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_batches.push_back(Batch{lines, count, dropped});
+            m_cv.notify_all();
+        };
+    }
+
+    /// Wait until `count` batches arrived; false on timeout
+    bool waitFor(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(2)) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, timeout, [&] { return m_batches.size() >= count; });
+    }
+
+    std::vector<Batch> batches() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_batches;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Batch> m_batches;
+};
+
+JourneyEvent makeEvent(uint16_t evdevIn, uint16_t evdevOut, bool down) {
+    JourneyEvent event;
+    event.device_event_number = 3;
+    event.evdev_input = evdevIn;
+    event.input_key_name = "A";
+    event.yamy_input = 0x1E;
+    event.yamy_output = 0x24;
+    event.output_key_name = "J";
+    event.was_substituted = true;
+    event.evdev_output = evdevOut;
+    event.latency_ns = 1500;
+    event.is_key_down = down;
+    event.valid = true;
+    return event;
+}
+
+size_t lineCount(const std::string& text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(JourneyFeedTest, RecordFormatsLikeEvent) {
+    const JourneyEvent event = makeEvent(KEY_A, KEY_J, true);
+    const JourneyRecord record = JourneyRecord::fromEvent(event);
+    EXPECT_EQ(sizeof(JourneyRecord), 16u);
+    EXPECT_EQ(JourneyLogger::formatJourneyLine(record.toEvent()),
+              JourneyLogger::formatJourneyLine(event));
+
+    JourneyEvent action = makeEvent(KEY_A, 0, false);
+    action.output_key_name = "(action)";
+    action.was_number_modifier = true;
+    action.modifier_action = "HOLD";
+    const JourneyEvent restored = JourneyRecord::fromEvent(action).toEvent();
+    EXPECT_EQ(restored.output_key_name, "(action)");
+    EXPECT_EQ(restored.modifier_action, "HOLD");
+    EXPECT_EQ(JourneyLogger::formatJourneyLine(restored),
+              JourneyLogger::formatJourneyLine(action));
+}
+
+TEST(JourneyFeedTest, FullBatchFlushesBeforeInterval) {
+    BatchCollector collector;
+    JourneyFeed feed(collector.sink(), std::chrono::seconds(30));
+    feed.start();
+
+    for (size_t i = 0; i < JourneyFeed::BATCH_SIZE; ++i) {
+        feed.push(makeEvent(KEY_A, KEY_J, i % 2 == 0));
+    }
+    ASSERT_TRUE(collector.waitFor(1));
+
+    const Batch batch = collector.batches().front();
+    EXPECT_EQ(batch.count, JourneyFeed::BATCH_SIZE);
+    EXPECT_EQ(lineCount(batch.lines), JourneyFeed::BATCH_SIZE);
+    EXPECT_EQ(batch.dropped, 0u);
+}
+
+TEST(JourneyFeedTest, PartialBatchFlushesAfterInterval) {
+    BatchCollector collector;
+    JourneyFeed feed(collector.sink(), std::chrono::milliseconds(16));
+    feed.start();
+
+    for (int i = 0; i < 3; ++i) {
+        feed.push(makeEvent(KEY_A, KEY_J, true));
+    }
+    ASSERT_TRUE(collector.waitFor(1));
+
+    const Batch batch = collector.batches().front();
+    EXPECT_EQ(batch.count, 3u);
+    EXPECT_EQ(batch.lines.substr(0, batch.lines.find('\n')),
+              JourneyLogger::formatJourneyLine(makeEvent(KEY_A, KEY_J, true)));
+}
+
+TEST(JourneyFeedTest, StopFlushesAndIgnoresLaterEvents) {
+    BatchCollector collector;
+    JourneyFeed feed(collector.sink(), std::chrono::seconds(30));
+    feed.start();
+
+    feed.push(makeEvent(KEY_A, KEY_J, true));
+    feed.push(makeEvent(KEY_A, KEY_J, false));
+    feed.stop();
+    EXPECT_FALSE(feed.isRunning());
+
+    feed.push(makeEvent(KEY_A, KEY_J, true));
+
+    const auto batches = collector.batches();
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].count, 2u);
+}
+
+TEST(JourneyFeedTest, FullRingDropsAndCounts) {
+    std::mutex gateMutex;
+    std::condition_variable gateCv;
+    bool inSink = false;
+    bool open = false;
+    uint32_t delivered = 0;
+    uint32_t dropped = 0;
+
+    // The first batch blocks the feed thread until the ring has overflowed
+    JourneyFeed feed([&](const std::string&, uint32_t count, uint32_t lost) {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        inSink = true;
+        gateCv.notify_all();
+        gateCv.wait(lock, [&] { return open; });
+        delivered += count;
+        dropped += lost;
+    }, std::chrono::milliseconds(1));
+    feed.start();
+
+    feed.push(makeEvent(KEY_A, KEY_J, true));
+    {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        ASSERT_TRUE(gateCv.wait_for(lock, std::chrono::seconds(2), [&] { return inSink; }));
+    }
+
+    for (size_t i = 0; i < JourneyFeed::CAPACITY + 10; ++i) {
+        feed.push(makeEvent(KEY_A, KEY_J, true));
+    }
+    {
+        std::lock_guard<std::mutex> lock(gateMutex);
+        open = true;
+    }
+    gateCv.notify_all();
+    feed.stop();
+
+    EXPECT_EQ(delivered, 1 + JourneyFeed::CAPACITY);
+    EXPECT_EQ(dropped, 10u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -6,6 +6,12 @@
 // - Error handling (syntax errors, missing fields, unknown keys)
 // - M00-MFF virtual modifier parsing
 // - Key sequence parsing
+// - Engine autorepeat section
+// - Chord mappings and chords section
+// - Mouse keys section and its profiles
+// - Heap and arena Setting allocation
+// - Patching an edited document into a loaded setting
+// - Full load fallback once patches reach their limit
 //
 // Part of task 1.10 in json-refactoring spec
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -14,6 +20,7 @@
 #include <sstream>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
 #include "../../src/core/settings/json_config_loader.h"
 #include "../../src/core/settings/setting.h"
 #include "../../src/core/input/keyboard.h"
@@ -54,6 +61,35 @@ protected:
         return logStream->str();
     }
 
+    /// Global keymap assignments in lookup order, as "S-A>Tab,B"
+    static std::vector<std::string> describeGlobal(Setting& s) {
+        std::vector<std::string> out;
+        s.m_keymaps.getGlobalKeymap()->forEachAssignment([&](const Keymap::KeyAssignment& ka) {
+            std::string line = ka.m_modifiedKey.m_modifier.isPressed(Modifier::Type_Shift) ? "S-" : "";
+            line += ka.m_modifiedKey.m_key->getName() + ">";
+            for (const auto& action : ka.m_keySeq->getActions()) {
+                const auto* key = dynamic_cast<const ActionKey*>(action.get());
+                line += (key ? key->m_modifiedKey.m_key->getName() : std::string("?")) + ",";
+            }
+            out.push_back(line);
+        });
+        return out;
+    }
+
+    /// Patch setting with the edited document, returning the changed key names
+    JsonConfigLoader::PatchResult patchWith(const std::string& json, std::vector<std::string>* keys = nullptr) {
+        nlohmann::json config;
+        EXPECT_TRUE(loader->read(createJsonFile("patch.json", json), config)) << getLog();
+        std::vector<Key*> changed;
+        auto result = loader->patch(setting, std::move(config), &changed);
+        if (keys) {
+            keys->clear();
+            for (const Key* key : changed) keys->push_back(key->getName());
+            std::sort(keys->begin(), keys->end());
+        }
+        return result;
+    }
+
     std::stringstream* logStream;
     JsonConfigLoader* loader;
     Setting* setting;
@@ -263,6 +299,29 @@ TEST_F(JsonConfigLoaderTest, LoadHexScanCodeVariants) {
     EXPECT_NE(setting->m_keyboard.searchKey("Right"), nullptr);
 }
 
+TEST_F(JsonConfigLoaderTest, LoadMouseButtonKeys) {
+    std::string json = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"Escape": "0x01", "LButton": "E1-0x01", "XButton1": "E1-0x06"}},
+        "mappings": [{"from": "XButton1", "to": "Escape"}]
+    })";
+
+    ASSERT_TRUE(loader->load(setting, createJsonFile("mousebuttons.json", json))) << getLog();
+
+    // Same scan code as Escape, told apart by the E1 flag
+    Key* lbutton = setting->m_keyboard.searchKey("LButton");
+    ASSERT_NE(lbutton, nullptr);
+    EXPECT_EQ(lbutton->getScanCodes()[0].m_scan, 0x01);
+    EXPECT_EQ(lbutton->getScanCodes()[0].m_flags, ScanCode::E1);
+
+    Key physical;
+    physical.addScanCode(ScanCode(0x01, ScanCode::E1));
+    EXPECT_EQ(setting->m_keyboard.searchKey(physical), lbutton);
+
+    std::string bad = R"({"version": "2.0", "keyboard": {"keys": {"LButton": "E2-0x01"}}, "mappings": []})";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badbutton.json", bad)));
+}
+
 TEST_F(JsonConfigLoaderTest, LoadEmptySections) {
     std::string json = R"({"version": "2.0", "keyboard": {"keys": {}}, "virtualModifiers": {}, "mappings": []})";
     EXPECT_TRUE(loader->load(setting, createJsonFile("empty.json", json)));
@@ -311,6 +370,337 @@ TEST_F(JsonConfigLoaderTest, LoadLargeModifierNumber) {
     EXPECT_EQ(triggerIt->second, 0xFF);
 }
 
+TEST_F(JsonConfigLoaderTest, AutoRepeatDisabledByDefault) {
+    std::string json = R"({"version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": []})";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("norepeat.json", json)));
+
+    EXPECT_FALSE(setting->m_engineAutoRepeat);
+    EXPECT_TRUE(setting->m_autoRepeatKeys.empty());
+}
+
+TEST_F(JsonConfigLoaderTest, LoadAutoRepeat) {
+    std::string json = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "Escape": "0x01", "Left": "0xe04b"}},
+        "mappings": [],
+        "autoRepeat": {
+            "enabled": true, "delayMs": 400, "intervalMs": 30,
+            "keys": {"Left": {"delayMs": 200}, "Escape": {"intervalMs": 0}}
+        }
+    })";
+
+    ASSERT_TRUE(loader->load(setting, createJsonFile("repeat.json", json))) << getLog();
+
+    EXPECT_TRUE(setting->m_engineAutoRepeat);
+    EXPECT_EQ(setting->m_autoRepeat.m_delay, 400u);
+    EXPECT_EQ(setting->m_autoRepeat.m_interval, 30u);
+
+    uint16_t leftScan = setting->m_keyboard.searchKey("Left")->getScanCodes()[0].m_scan;
+    auto left = setting->m_autoRepeatKeys.find(leftScan);
+    ASSERT_NE(left, setting->m_autoRepeatKeys.end());
+    EXPECT_EQ(left->second.m_delay, 200u);
+    EXPECT_EQ(left->second.m_interval, 30u);
+
+    uint16_t escScan = setting->m_keyboard.searchKey("Escape")->getScanCodes()[0].m_scan;
+    auto esc = setting->m_autoRepeatKeys.find(escScan);
+    ASSERT_NE(esc, setting->m_autoRepeatKeys.end());
+    EXPECT_EQ(esc->second.m_interval, 0u);
+}
+
+TEST_F(JsonConfigLoaderTest, ErrorInvalidAutoRepeat) {
+    std::string badTiming = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "autoRepeat": {"enabled": true, "intervalMs": -5}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badtiming.json", badTiming)));
+    EXPECT_NE(getLog().find("intervalMs"), std::string::npos);
+
+    std::string unknownKey = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "autoRepeat": {"keys": {"B": {"intervalMs": 10}}}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badkey.json", unknownKey)));
+}
+
+TEST_F(JsonConfigLoaderTest, LoadChordMapping) {
+    std::string json = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"J": "0x24", "K": "0x25", "L": "0x26", "Escape": "0x01"}},
+        "mappings": [
+            {"from": "J+K", "to": "Escape"},
+            {"from": "L", "to": "Escape"}
+        ],
+        "chords": {"timeoutMs": 40}
+    })";
+
+    ASSERT_TRUE(loader->load(setting, createJsonFile("chord.json", json))) << getLog();
+
+    EXPECT_EQ(setting->m_chordTimeout, 40u);
+    ASSERT_EQ(setting->m_chords.size(), 1u);
+    const Setting::Chord& chord = setting->m_chords[0];
+    ASSERT_EQ(chord.m_keys.size(), 2u);
+    EXPECT_EQ(chord.m_keys[0], setting->m_keyboard.searchKey("J"));
+    EXPECT_EQ(chord.m_keys[1], setting->m_keyboard.searchKey("K"));
+    ASSERT_NE(chord.m_keySeq, nullptr);
+}
+
+TEST_F(JsonConfigLoaderTest, ChordTimeoutDefault) {
+    std::string json = R"({"version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": []})";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("nochord.json", json)));
+
+    EXPECT_EQ(setting->m_chordTimeout, 50u);
+    EXPECT_TRUE(setting->m_chords.empty());
+}
+
+TEST_F(JsonConfigLoaderTest, ErrorInvalidChord) {
+    std::string twice = R"({
+        "version": "2.0", "keyboard": {"keys": {"J": "0x24", "Escape": "0x01"}},
+        "mappings": [{"from": "J+J", "to": "Escape"}]
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("twice.json", twice)));
+    EXPECT_NE(getLog().find("appears twice"), std::string::npos);
+
+    std::string unknownKey = R"({
+        "version": "2.0", "keyboard": {"keys": {"J": "0x24", "Escape": "0x01"}},
+        "mappings": [{"from": "J+Q", "to": "Escape"}]
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("unknown.json", unknownKey)));
+
+    std::string badTimeout = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "chords": {"timeoutMs": 0}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badtimeout.json", badTimeout)));
+    EXPECT_NE(getLog().find("timeoutMs"), std::string::npos);
+}
+
+TEST_F(JsonConfigLoaderTest, LoadMouseKeys) {
+    std::string json = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"H": "0x23", "J": "0x24", "U": "0x16", "S": "0x1f"}},
+        "mappings": [],
+        "mouseKeys": {
+            "rateHz": 250,
+            "profiles": {
+                "default": {"initialSpeed": 300, "accelerationMs": 400},
+                "precise": {"maxSpeed": 150}
+            },
+            "keys": {
+                "H": "left",
+                "J": {"action": "down"},
+                "U": "wheelUp",
+                "S": {"action": "none", "profile": "precise"}
+            }
+        }
+    })";
+
+    ASSERT_TRUE(loader->load(setting, createJsonFile("mousekeys.json", json))) << getLog();
+
+    EXPECT_EQ(setting->m_mouseKeysRate, 250u);
+    ASSERT_EQ(setting->m_mouseKeysProfiles.size(), 2u);
+    EXPECT_EQ(setting->m_mouseKeysProfiles[0].initialSpeed, 300.0);
+    EXPECT_EQ(setting->m_mouseKeysProfiles[0].accelerationMs, 400u);
+    // Unset fields inherit the default profile
+    EXPECT_EQ(setting->m_mouseKeysProfiles[1].initialSpeed, 300.0);
+    EXPECT_EQ(setting->m_mouseKeysProfiles[1].maxSpeed, 150.0);
+
+    ASSERT_EQ(setting->m_mouseKeys.size(), 4u);
+    for (const Setting::MouseKey& mouseKey : setting->m_mouseKeys) {
+        if (mouseKey.m_key == setting->m_keyboard.searchKey("H")) {
+            EXPECT_EQ(mouseKey.m_action, yamy::engine::MouseKeysAction::Left);
+            EXPECT_EQ(mouseKey.m_profile, 0u);
+        } else if (mouseKey.m_key == setting->m_keyboard.searchKey("S")) {
+            EXPECT_EQ(mouseKey.m_action, yamy::engine::MouseKeysAction::None);
+            EXPECT_EQ(mouseKey.m_profile, 1u);
+        }
+    }
+}
+
+TEST_F(JsonConfigLoaderTest, MouseKeysDisabledByDefault) {
+    std::string json = R"({"version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": []})";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("nomousekeys.json", json)));
+
+    EXPECT_TRUE(setting->m_mouseKeys.empty());
+    EXPECT_EQ(setting->m_mouseKeysProfiles.size(), 1u);
+    EXPECT_EQ(setting->m_mouseKeysRate, 500u);
+}
+
+TEST_F(JsonConfigLoaderTest, ErrorInvalidMouseKeys) {
+    std::string badRate = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "mouseKeys": {"rateHz": 5000}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badrate.json", badRate)));
+    EXPECT_NE(getLog().find("rateHz"), std::string::npos);
+
+    std::string badAction = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "mouseKeys": {"keys": {"A": "sideways"}}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badaction.json", badAction)));
+    EXPECT_NE(getLog().find("sideways"), std::string::npos);
+
+    std::string badProfile = R"({
+        "version": "2.0", "keyboard": {"keys": {"A": "0x1e"}}, "mappings": [],
+        "mouseKeys": {"keys": {"A": {"action": "left", "profile": "fast"}}}
+    })";
+    EXPECT_FALSE(loader->load(setting, createJsonFile("badprofile.json", badProfile)));
+    EXPECT_NE(getLog().find("fast"), std::string::npos);
+}
+
+TEST_F(JsonConfigLoaderTest, HeapAllocationLoadsSameConfig) {
+    std::string json = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "Tab": "0x0f"}},
+        "mappings": [{"from": "A", "to": "B"}, {"from": "Shift-A", "to": "Tab"}]
+    })";
+    std::string path = createJsonFile("heap.json", json);
+
+    Setting heapSetting(Setting::Allocation_heap);
+    ASSERT_TRUE(loader->load(setting, path)) << getLog();
+    ASSERT_TRUE(loader->load(&heapSetting, path)) << getLog();
+    EXPECT_NE(setting->getMemoryResource(), heapSetting.getMemoryResource());
+
+    size_t arenaCount = 0, heapCount = 0;
+    setting->m_keymaps.getGlobalKeymap()->forEachAssignment([&](const Keymap::KeyAssignment&) { ++arenaCount; });
+    heapSetting.m_keymaps.getGlobalKeymap()->forEachAssignment([&](const Keymap::KeyAssignment&) { ++heapCount; });
+    EXPECT_EQ(arenaCount, 2u);
+    EXPECT_EQ(heapCount, arenaCount);
+    EXPECT_NE(heapSetting.m_keyboard.searchKey("Tab"), nullptr);
+}
+
+// =============================================================================
+// patch()
+// =============================================================================
+
+TEST_F(JsonConfigLoaderTest, PatchMatchesFullLoad) {
+    std::string before = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "C": "0x2e", "Tab": "0x0f"}},
+        "mappings": [
+            {"from": "A", "to": "B"},
+            {"from": "Shift-A", "to": "Tab"},
+            {"from": "B", "to": "Tab"},
+            {"from": "C", "to": ["A", "B"]}
+        ]
+    })";
+    std::string after = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "C": "0x2e", "Tab": "0x0f"}},
+        "mappings": [
+            {"from": "A", "to": "Tab"},
+            {"from": "Shift-A", "to": "Tab"},
+            {"from": "C", "to": ["A", "B"]},
+            {"from": "Tab", "to": "A"},
+            {"from": "A", "to": "C", "description": "overrides the first A"}
+        ]
+    })";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("before.json", before))) << getLog();
+
+    std::vector<std::string> keys;
+    ASSERT_EQ(patchWith(after, &keys), JsonConfigLoader::PatchResult::Patched) << getLog();
+    EXPECT_EQ(keys, (std::vector<std::string>{"A", "B", "Tab"}));
+
+    Setting fresh;
+    JsonConfigLoader freshLoader;
+    ASSERT_TRUE(freshLoader.load(&fresh, createJsonFile("after.json", after)));
+    EXPECT_EQ(describeGlobal(*setting), describeGlobal(fresh));
+
+    // Patching the same document again changes nothing
+    ASSERT_EQ(patchWith(after, &keys), JsonConfigLoader::PatchResult::Patched);
+    EXPECT_TRUE(keys.empty());
+}
+
+TEST_F(JsonConfigLoaderTest, PatchNeedsFullLoad) {
+    std::string base = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "J": "0x24", "K": "0x25"}},
+        "mappings": [{"from": "A", "to": "B"}]
+    })";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("base.json", base))) << getLog();
+
+    // Keyboard edited
+    EXPECT_EQ(patchWith(R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x31", "J": "0x24", "K": "0x25"}},
+        "mappings": [{"from": "A", "to": "B"}]
+    })"), JsonConfigLoader::PatchResult::NeedsFullLoad);
+
+    // Chord added
+    EXPECT_EQ(patchWith(R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "J": "0x24", "K": "0x25"}},
+        "mappings": [{"from": "A", "to": "B"}, {"from": "J+K", "to": "B"}]
+    })"), JsonConfigLoader::PatchResult::NeedsFullLoad);
+
+    // Mapping without "from"
+    EXPECT_EQ(patchWith(R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "J": "0x24", "K": "0x25"}},
+        "mappings": [{"from": "A", "to": "B"}, {"to": "J"}]
+    })"), JsonConfigLoader::PatchResult::NeedsFullLoad);
+
+    // Another setting than the loaded one
+    Setting other;
+    nlohmann::json config;
+    ASSERT_TRUE(loader->read(createJsonFile("other.json", base), config));
+    std::vector<Key*> changed;
+    EXPECT_EQ(loader->patch(&other, config, &changed), JsonConfigLoader::PatchResult::NeedsFullLoad);
+}
+
+TEST_F(JsonConfigLoaderTest, PatchNeedsFullLoadAfterMaxPatches) {
+    const std::string toB = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "C": "0x2e"}},
+        "mappings": [{"from": "A", "to": "B"}]
+    })";
+    const std::string toC = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30", "C": "0x2e"}},
+        "mappings": [{"from": "A", "to": "C"}]
+    })";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("base.json", toB))) << getLog();
+
+    for (int i = 0; i < JsonConfigLoader::MAX_PATCHES; ++i) {
+        ASSERT_EQ(patchWith(i % 2 ? toB : toC), JsonConfigLoader::PatchResult::Patched) << i;
+    }
+    const auto patched = describeGlobal(*setting);
+    EXPECT_EQ(patchWith(JsonConfigLoader::MAX_PATCHES % 2 ? toB : toC),
+              JsonConfigLoader::PatchResult::NeedsFullLoad);
+    EXPECT_EQ(describeGlobal(*setting), patched);
+
+    // An unchanged document adds nothing, so it still patches
+    EXPECT_EQ(patchWith(JsonConfigLoader::MAX_PATCHES % 2 ? toC : toB),
+              JsonConfigLoader::PatchResult::Patched);
+
+    // A full load starts counting again
+    Setting fresh;
+    ASSERT_TRUE(loader->load(&fresh, createJsonFile("fresh.json", toB))) << getLog();
+    nlohmann::json config;
+    ASSERT_TRUE(loader->read(createJsonFile("patch.json", toC), config));
+    std::vector<Key*> changed;
+    EXPECT_EQ(loader->patch(&fresh, std::move(config), &changed),
+              JsonConfigLoader::PatchResult::Patched);
+}
+
+TEST_F(JsonConfigLoaderTest, PatchFailureKeepsSetting) {
+    std::string base = R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30"}},
+        "mappings": [{"from": "A", "to": "B"}]
+    })";
+    ASSERT_TRUE(loader->load(setting, createJsonFile("base.json", base))) << getLog();
+    const auto original = describeGlobal(*setting);
+
+    EXPECT_EQ(patchWith(R"({
+        "version": "2.0",
+        "keyboard": {"keys": {"A": "0x1e", "B": "0x30"}},
+        "mappings": [{"from": "A", "to": "Q"}, {"from": "B", "to": "A"}]
+    })"), JsonConfigLoader::PatchResult::Failed);
+    EXPECT_NE(getLog().find("Unknown key name 'Q'"), std::string::npos);
+    EXPECT_EQ(describeGlobal(*setting), original);
+}
+
 } // namespace yamy::settings::test
 
 int main(int argc, char** argv) {
@@ -0,0 +1,211 @@
+/**
+ * @file test_log_store.cpp
+ * @brief Tests for interned, columnar log storage
+ *
+ * Tests cover:
+ * - Dictionary ids are stable and shared by equal strings
+ * - Templates are formatted only when the text is asked for
+ * - The ring evicts oldest records when records, argument bytes or strings run out
+ * - Arguments decode intact after the argument ring wraps
+ * - Formatted messages fall back to string arguments past the template limit
+ * - Records copy between stores sharing dictionaries
+ * - Logger delivers record views and replays its history
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../src/core/logging/log_store.h"
+#include "../src/core/logging/logger.h"
+
+using namespace yamy::logging;
+
+namespace {
+
+class LogStoreTest : public ::testing::Test {
+protected:
+    LogDictionary categories;
+    LogDictionary templates;
+};
+
+} // namespace
+
+TEST_F(LogStoreTest, DictionaryInternsOnce) {
+    EXPECT_EQ(categories.text(0), "");
+    const uint32_t engine = categories.intern("Engine");
+    const uint32_t parser = categories.intern("Parser");
+    EXPECT_NE(engine, parser);
+    EXPECT_EQ(categories.intern(std::string("Engine")), engine);
+    EXPECT_EQ(categories.find("Parser"), parser);
+    EXPECT_EQ(categories.find("Input"), LogDictionary::NONE);
+    EXPECT_EQ(categories.text(engine), "Engine");
+    EXPECT_EQ(categories.text(12345), "");
+}
+
+TEST_F(LogStoreTest, TemplateArgumentsFormattedOnDemand) {
+    LogStore store(categories, templates, 16);
+    const std::string device = "kbd0";
+    const LogArg args[] = {toLogArg(30u), toLogArg(true), toLogArg(-2),
+                           toLogArg(device)};
+    const uint64_t seq = store.append(1000, LogLevel::Trace, "Input",
+                                      "code={} down={} delta={} on {}", args, 4);
+
+    const LogRecord record = store.record(seq);
+    EXPECT_EQ(record.level(), LogLevel::Trace);
+    EXPECT_EQ(record.category(), "Input");
+    EXPECT_EQ(record.messageTemplate(), "code={} down={} delta={} on {}");
+    EXPECT_EQ(record.argCount(), 4u);
+    EXPECT_EQ(record.message(), "code=30 down=1 delta=-2 on kbd0");
+    EXPECT_EQ(record.timeUs(), 1000);
+
+    // Equal templates share an id
+    const uint64_t next = store.append(2000, LogLevel::Trace, "Input",
+                                       "code={} down={} delta={} on {}", args, 4);
+    EXPECT_EQ(store.record(next).templateId(), record.templateId());
+}
+
+TEST_F(LogStoreTest, MissingArgumentsLeaveHoles) {
+    LogStore store(categories, templates, 4);
+    const LogArg args[] = {toLogArg(1)};
+    const uint64_t seq = store.append(0, LogLevel::Info, "Engine", "{} of {}", args, 1);
+    EXPECT_EQ(store.record(seq).message(), "1 of {}");
+}
+
+TEST_F(LogStoreTest, RingEvictsOldest) {
+    LogStore store(categories, templates, 3);
+    for (int i = 0; i < 5; ++i) {
+        const LogArg args[] = {toLogArg(i)};
+        store.append(i, LogLevel::Info, "Engine", "entry {}", args, 1);
+    }
+    EXPECT_EQ(store.size(), 3u);
+    EXPECT_EQ(store.firstSequence(), 2u);
+    EXPECT_EQ(store.endSequence(), 5u);
+    EXPECT_EQ(store.record(2).message(), "entry 2");
+    EXPECT_EQ(store.record(4).message(), "entry 4");
+
+    store.dropOldest(1);
+    EXPECT_EQ(store.record(store.firstSequence()).message(), "entry 3");
+
+    store.clear();
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(store.firstSequence(), 5u) << "Sequences keep counting";
+}
+
+TEST_F(LogStoreTest, ArgumentsSurviveRingWrap) {
+    LogStore store(categories, templates, 4);
+    for (int i = 0; i < 1000; ++i) {
+        const std::string name = "dev" + std::to_string(i);
+        const LogArg args[] = {toLogArg(int64_t(-1) - i), toLogArg(0.5),
+                               toLogArg(uint64_t(1) << 40), toLogArg(name), toLogArg(i % 2 == 0)};
+        store.append(i, LogLevel::Info, "Input", "{} {} {} {} {}", args, 5);
+    }
+    EXPECT_EQ(store.size(), 4u);
+    EXPECT_EQ(store.record(999).message(), "-1000 0.500000 1099511627776 dev999 0");
+    EXPECT_EQ(store.record(996).message(), "-997 0.500000 1099511627776 dev996 1");
+    EXPECT_EQ(store.record(996).arg(3).s, "dev996");
+}
+
+TEST_F(LogStoreTest, StringArgumentsEvictRecords) {
+    // Room for 16 strings: records holding 8 each fit two at a time
+    LogStore store(categories, templates, 4);
+    std::vector<std::string> values;
+    for (int i = 0; i < 8; ++i) {
+        values.push_back("long string argument number " + std::to_string(i));
+    }
+    std::vector<LogArg> args;
+    for (const auto& value : values) {
+        args.push_back(toLogArg(value));
+    }
+    for (int i = 0; i < 3; ++i) {
+        store.append(i, LogLevel::Info, "Engine", "{}{}{}{}{}{}{}{}", args.data(), args.size());
+    }
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.record(2).arg(7).s, values[7]);
+}
+
+TEST_F(LogStoreTest, TextFallsBackPastTemplateLimit) {
+    LogStore store(categories, templates, 8);
+    const uint64_t repeated = store.appendText(0, LogLevel::Info, "UI", "Engine started");
+    EXPECT_EQ(store.record(repeated).argCount(), 0u) << "Text becomes its own template";
+
+    while (templates.size() < LogStore::TEXT_TEMPLATE_LIMIT) {
+        templates.intern("filler " + std::to_string(templates.size()));
+    }
+    const uint64_t fresh = store.appendText(0, LogLevel::Info, "UI", "Unique message 42");
+    EXPECT_EQ(store.record(fresh).argCount(), 1u);
+    EXPECT_EQ(store.record(fresh).message(), "Unique message 42");
+    EXPECT_EQ(templates.find("Unique message 42"), LogDictionary::NONE);
+
+    // Known text still reuses its template
+    const uint64_t again = store.appendText(0, LogLevel::Info, "UI", "Engine started");
+    EXPECT_EQ(store.record(again).argCount(), 0u);
+}
+
+TEST_F(LogStoreTest, CopiesBetweenStores) {
+    LogStore source(categories, templates, 8);
+    const std::string name = "Parser";
+    for (int i = 0; i < 6; ++i) {
+        const LogArg args[] = {toLogArg(i), toLogArg(name)};
+        source.append(i, LogLevel::Warning, "Config", "{} from {}", args, 2);
+    }
+
+    LogStore target(categories, templates, 4);
+    const uint64_t from = target.fittingTail(source, source.firstSequence());
+    EXPECT_EQ(from, 2u);
+    EXPECT_EQ(target.evictionsToFit(source, from), 0u);
+    for (uint64_t seq = from; seq < source.endSequence(); ++seq) {
+        target.append(source.record(seq));
+    }
+    source.clear();
+
+    EXPECT_EQ(target.size(), 4u);
+    EXPECT_EQ(target.record(target.firstSequence()).message(), "2 from Parser");
+    EXPECT_EQ(target.record(target.firstSequence()).category(), "Config");
+}
+
+TEST_F(LogStoreTest, EvictionsToFitCountsOldest) {
+    LogStore batch(categories, templates, 8);
+    for (int i = 0; i < 3; ++i) {
+        batch.appendText(0, LogLevel::Info, "Engine", "batch");
+    }
+    LogStore target(categories, templates, 4);
+    for (int i = 0; i < 4; ++i) {
+        target.appendText(0, LogLevel::Info, "Engine", "old");
+    }
+    EXPECT_EQ(target.evictionsToFit(batch, batch.firstSequence()), 3u);
+    EXPECT_EQ(target.evictionsToFit(batch, batch.firstSequence() + 2), 1u);
+}
+
+TEST_F(LogStoreTest, RecordFormatMatchesLogEntry) {
+    LogStore store(categories, templates, 4);
+    LogEntry entry(LogLevel::Error, "Driver", "Failed to open device");
+    const int64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        entry.timestamp.time_since_epoch()).count();
+    const uint64_t seq = store.appendText(timeUs, entry.level, entry.category, entry.message);
+    EXPECT_EQ(store.record(seq).format(), entry.format());
+}
+
+TEST(LoggerTest, ListenersReceiveRecordsAndHistory) {
+    auto& logger = Logger::getInstance();
+    logger.logf(LogLevel::Trace, "Engine", "Processing key event: scancode={}, isKeyDown={}",
+                30u, true);
+    logger.log(LogLevel::Info, "Engine", "Engine started");
+
+    // Listeners live as long as the Logger singleton
+    static std::vector<std::string> replayed;
+    logger.addListener([](const LogRecord& record) {
+        replayed.push_back(record.message());
+    }, true);
+    ASSERT_GE(replayed.size(), 2u);
+    EXPECT_EQ(replayed[replayed.size() - 2], "Processing key event: scancode=30, isKeyDown=1");
+    EXPECT_EQ(replayed.back(), "Engine started");
+
+    logger.logf(LogLevel::Warning, "Config", "{} keymaps loaded", 3);
+    EXPECT_EQ(replayed.back(), "3 keymaps loaded");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,188 @@
+/**
+ * @file test_lookup_table.cpp
+ * @brief Tests for CompiledRule matching and RuleLookupTable ordering
+ *
+ * Tests cover:
+ * - "At least one of" groups for generic Shift/Ctrl/Alt/Win
+ * - Interaction of anyOf groups with requiredOn/requiredOff masks
+ * - First-match ordering in RuleLookupTable
+ * - D-/U- rules of one key matched by key edge
+ * - Scan code membership used for the passthrough map
+ */
+
+#include <gtest/gtest.h>
+
+#include "../src/core/engine/lookup_table.h"
+#include "../src/core/input/modifier_state.h"
+
+using namespace yamy;
+using input::ModifierState;
+using State = std::bitset<ModifierState::TOTAL_BITS>;
+
+namespace {
+
+uint16_t group(ModifierState::StdModifier left, ModifierState::StdModifier right) {
+    return static_cast<uint16_t>((1u << left) | (1u << right));
+}
+
+State stateWith(std::initializer_list<size_t> bits) {
+    State state;
+    for (size_t bit : bits) {
+        state.set(bit);
+    }
+    return state;
+}
+
+} // namespace
+
+// =============================================================================
+// CompiledRule anyOf groups
+// =============================================================================
+
+TEST(CompiledRuleTest, AnyOfGroupMatchesEitherSide) {
+    engine::CompiledRule rule;
+    ASSERT_TRUE(rule.addAnyOf(group(ModifierState::LSHIFT, ModifierState::RSHIFT)));
+
+    EXPECT_FALSE(rule.matches(stateWith({})));
+    EXPECT_TRUE(rule.matches(stateWith({ModifierState::LSHIFT})));
+    EXPECT_TRUE(rule.matches(stateWith({ModifierState::RSHIFT})));
+    EXPECT_TRUE(rule.matches(stateWith({ModifierState::LSHIFT, ModifierState::RSHIFT})));
+    EXPECT_FALSE(rule.matches(stateWith({ModifierState::LCTRL})));
+}
+
+TEST(CompiledRuleTest, EveryAnyOfGroupMustBeSatisfied) {
+    // C-A-S-W-x as a single rule
+    engine::CompiledRule rule;
+    ASSERT_TRUE(rule.addAnyOf(group(ModifierState::LSHIFT, ModifierState::RSHIFT)));
+    ASSERT_TRUE(rule.addAnyOf(group(ModifierState::LCTRL, ModifierState::RCTRL)));
+    ASSERT_TRUE(rule.addAnyOf(group(ModifierState::LALT, ModifierState::RALT)));
+    ASSERT_TRUE(rule.addAnyOf(group(ModifierState::LWIN, ModifierState::RWIN)));
+    EXPECT_FALSE(rule.addAnyOf(group(ModifierState::UP, ModifierState::DOWN)))
+        << "Only MAX_ANY_OF_GROUPS groups fit in a rule";
+
+    // All 16 left/right combinations match
+    const ModifierState::StdModifier sides[4][2] = {
+        {ModifierState::LSHIFT, ModifierState::RSHIFT},
+        {ModifierState::LCTRL, ModifierState::RCTRL},
+        {ModifierState::LALT, ModifierState::RALT},
+        {ModifierState::LWIN, ModifierState::RWIN},
+    };
+    for (unsigned combo = 0; combo < 16; ++combo) {
+        State state;
+        for (unsigned g = 0; g < 4; ++g) {
+            state.set(sides[g][(combo >> g) & 1]);
+        }
+        EXPECT_TRUE(rule.matches(state)) << "combination " << combo;
+    }
+
+    // Missing any one group fails
+    EXPECT_FALSE(rule.matches(stateWith({ModifierState::LSHIFT, ModifierState::LCTRL, ModifierState::LALT})));
+}
+
+TEST(CompiledRuleTest, AnyOfCombinesWithOnAndOffMasks) {
+    engine::CompiledRule rule;
+    rule.addAnyOf(group(ModifierState::LCTRL, ModifierState::RCTRL));
+    rule.requiredOn.set(ModifierState::VIRTUAL_OFFSET + 0);   // M00
+    rule.requiredOff.set(ModifierState::LSHIFT);
+    rule.requiredOff.set(ModifierState::RSHIFT);
+
+    EXPECT_TRUE(rule.matches(stateWith({ModifierState::RCTRL, ModifierState::VIRTUAL_OFFSET + 0})));
+    EXPECT_FALSE(rule.matches(stateWith({ModifierState::RCTRL})));
+    EXPECT_FALSE(rule.matches(stateWith({ModifierState::VIRTUAL_OFFSET + 0})));
+    EXPECT_FALSE(rule.matches(stateWith({ModifierState::RCTRL, ModifierState::VIRTUAL_OFFSET + 0,
+                                         ModifierState::LSHIFT})));
+}
+
+TEST(CompiledRuleTest, StdBitsPacksOnlyStandardModifiers) {
+    State state = stateWith({ModifierState::LSHIFT, ModifierState::RWIN,
+                             ModifierState::VIRTUAL_OFFSET + 3, ModifierState::LOCK_OFFSET + 1});
+    EXPECT_EQ(engine::CompiledRule::stdBits(state),
+              static_cast<uint16_t>((1u << ModifierState::LSHIFT) | (1u << ModifierState::RWIN)));
+}
+
+// =============================================================================
+// RuleLookupTable
+// =============================================================================
+
+TEST(RuleLookupTableTest, ReturnsFirstMatchingRule) {
+    engine::RuleLookupTable table;
+
+    engine::CompiledRule shifted;
+    shifted.addAnyOf(group(ModifierState::LSHIFT, ModifierState::RSHIFT));
+    shifted.outputScanCode = 0x10;
+    table.addRule(0x1e, shifted);
+
+    engine::CompiledRule plain;
+    plain.outputScanCode = 0x11;
+    table.addRule(0x1e, plain);
+
+    const auto* match = table.findMatch(0x1e, stateWith({ModifierState::RSHIFT}));
+    ASSERT_NE(match, nullptr);
+    EXPECT_EQ(match->outputScanCode, 0x10);
+
+    match = table.findMatch(0x1e, stateWith({}));
+    ASSERT_NE(match, nullptr);
+    EXPECT_EQ(match->outputScanCode, 0x11);
+
+    EXPECT_EQ(table.findMatch(0x1f, stateWith({})), nullptr);
+}
+
+TEST(RuleLookupTableTest, DownAndUpRulesOfOneKeyMatchTheirEdge) {
+    engine::RuleLookupTable table;
+
+    // key D-A = X, key U-A = Y: same modifiers, told apart by the edge only
+    engine::CompiledRule down;
+    down.edges = engine::CompiledRule::EDGE_PRESS;
+    down.outputScanCode = 0x2d;
+    table.addRule(0x1e, down);
+
+    engine::CompiledRule up;
+    up.edges = engine::CompiledRule::EDGE_RELEASE;
+    up.outputScanCode = 0x15;
+    table.addRule(0x1e, up);
+
+    const auto* match = table.findMatch(0x1e, stateWith({}), engine::CompiledRule::EDGE_PRESS);
+    ASSERT_NE(match, nullptr);
+    EXPECT_EQ(match->outputScanCode, 0x2d);
+
+    match = table.findMatch(0x1e, stateWith({}), engine::CompiledRule::EDGE_RELEASE);
+    ASSERT_NE(match, nullptr);
+    EXPECT_EQ(match->outputScanCode, 0x15);
+}
+
+TEST(RuleLookupTableTest, EdgeRuleFallsThroughOnOtherEdge) {
+    engine::RuleLookupTable table;
+
+    engine::CompiledRule down;
+    down.edges = engine::CompiledRule::EDGE_PRESS;
+    down.outputScanCode = 0x2d;
+    table.addRule(0x1e, down);
+
+    engine::CompiledRule plain;
+    plain.outputScanCode = 0x11;
+    table.addRule(0x1e, plain);
+
+    // The release skips the D- rule, as the legacy Up-state lookup did
+    const auto* match = table.findMatch(0x1e, stateWith({}), engine::CompiledRule::EDGE_RELEASE);
+    ASSERT_NE(match, nullptr);
+    EXPECT_EQ(match->outputScanCode, 0x11);
+}
+
+TEST(RuleLookupTableTest, HasRulesReportsOnlyBoundScanCodes) {
+    engine::RuleLookupTable table;
+    engine::CompiledRule shifted;
+    shifted.addAnyOf(group(ModifierState::LSHIFT, ModifierState::RSHIFT));
+    table.addRule(0x1e, shifted);
+
+    // A rule that only matches with Shift still means the key is not plain
+    EXPECT_TRUE(table.hasRules(0x1e));
+    EXPECT_FALSE(table.hasRules(0x1f));
+
+    table.clear();
+    EXPECT_FALSE(table.hasRules(0x1e));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
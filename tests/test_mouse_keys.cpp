@@ -0,0 +1,206 @@
+/**
+ * @file test_mouse_keys.cpp
+ * @brief Tests for pointer motion and scrolling from held keys
+ *
+ * Tests cover:
+ * - Acceleration ramp from initialSpeed to maxSpeed
+ * - Sub-pixel remainders carried across ticks
+ * - Diagonals at the same speed as straight lines
+ * - The most recently pressed binding selects the profile
+ * - Key repeat does not restart the ramp
+ * - Start/stop reporting for arming the tick timer
+ * - Wheel motion in 1/120 notch units
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../src/core/engine/mouse_keys.h"
+
+using namespace yamy::engine;
+
+namespace {
+
+const uint16_t kH = 0x23;
+const uint16_t kJ = 0x24;
+const uint16_t kK = 0x25;
+const uint16_t kL = 0x26;
+const uint16_t kU = 0x16;
+const uint16_t kD = 0x20;
+const uint16_t kSlow = 0x1f;
+
+/// Constant speed, so distance is speed * time
+MouseKeysProfile flat(double speed) {
+    MouseKeysProfile profile;
+    profile.initialSpeed = speed;
+    profile.maxSpeed = speed;
+    profile.accelerationMs = 0;
+    profile.wheelSpeed = 10.0;
+    return profile;
+}
+
+std::vector<MouseKeysBinding> vimBindings(uint8_t slowProfile = 0) {
+    return {
+        {kH, MouseKeysAction::Left, 0},
+        {kJ, MouseKeysAction::Down, 0},
+        {kK, MouseKeysAction::Up, 0},
+        {kL, MouseKeysAction::Right, 0},
+        {kU, MouseKeysAction::WheelUp, 0},
+        {kD, MouseKeysAction::WheelDown, 0},
+        {kSlow, MouseKeysAction::None, slowProfile},
+    };
+}
+
+} // namespace
+
+TEST(MouseKeysTest, SpeedRampsAlongCurve) {
+    MouseKeysProfile profile;
+    profile.initialSpeed = 100;
+    profile.maxSpeed = 1100;
+    profile.accelerationMs = 1000;
+    profile.curve = 2.0;
+
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 0), 100.0);
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 500000), 350.0);
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 1000000), 1100.0);
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 5000000), 1100.0);
+
+    profile.curve = 1.0;
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 500000), 600.0);
+
+    profile.accelerationMs = 0;
+    EXPECT_DOUBLE_EQ(MouseKeys::speedAt(profile, 0), 1100.0);
+}
+
+TEST(MouseKeysTest, OnKeyReportsStartAndStop) {
+    MouseKeys keys({flat(100)}, vimBindings());
+
+    EXPECT_FALSE(keys.isBound(0x1e));
+    EXPECT_FALSE(keys.onKey(0x1e, true, 0));
+
+    EXPECT_TRUE(keys.onKey(kL, true, 0));
+    EXPECT_TRUE(keys.isActive());
+    EXPECT_FALSE(keys.onKey(kJ, true, 0));     // Already moving
+    EXPECT_FALSE(keys.onKey(kL, false, 0));    // Still moving down
+    EXPECT_TRUE(keys.onKey(kJ, false, 0));
+    EXPECT_FALSE(keys.isActive());
+
+    // A profile-only key never starts motion
+    EXPECT_FALSE(keys.onKey(kSlow, true, 0));
+    EXPECT_FALSE(keys.isActive());
+}
+
+TEST(MouseKeysTest, SubPixelRemaindersCarryOver) {
+    // 100 px/s at 1 kHz is 0.1 px per tick
+    MouseKeys keys({flat(100)}, vimBindings());
+    keys.onKey(kL, true, 0);
+
+    int total = 0;
+    for (uint64_t t = 1000; t <= 100000; t += 1000) {
+        MouseKeysStep step = keys.tick(t);
+        EXPECT_LE(step.dx, 1);
+        EXPECT_EQ(step.dy, 0);
+        total += step.dx;
+    }
+    EXPECT_NEAR(total, 10, 1);
+}
+
+TEST(MouseKeysTest, DiagonalMatchesStraightSpeed) {
+    MouseKeys keys({flat(1000)}, vimBindings());
+    keys.onKey(kL, true, 0);
+    keys.onKey(kJ, true, 0);
+
+    MouseKeysStep step = keys.tick(1000000);
+    EXPECT_EQ(step.dx, 707);
+    EXPECT_EQ(step.dy, 707);
+    EXPECT_NEAR(std::hypot(step.dx, step.dy), 1000.0, 1.0);
+}
+
+TEST(MouseKeysTest, OpposingKeysCancel) {
+    MouseKeys keys({flat(1000)}, vimBindings());
+    keys.onKey(kH, true, 0);
+    keys.onKey(kL, true, 0);
+
+    MouseKeysStep step = keys.tick(100000);
+    EXPECT_EQ(step.dx, 0);
+    EXPECT_EQ(step.dy, 0);
+}
+
+TEST(MouseKeysTest, LatestPressSelectsProfile) {
+    MouseKeys keys({flat(1000), flat(100)}, vimBindings(1));
+    keys.onKey(kL, true, 0);
+    EXPECT_EQ(keys.tick(100000).dx, 100);
+
+    // Holding the precision key slows the pointer down...
+    keys.onKey(kSlow, true, 100000);
+    EXPECT_EQ(keys.tick(200000).dx, 10);
+
+    // ...and releasing it restores the normal speed
+    keys.onKey(kSlow, false, 200000);
+    EXPECT_EQ(keys.tick(300000).dx, 100);
+}
+
+TEST(MouseKeysTest, KeyRepeatKeepsAccelerating) {
+    MouseKeysProfile profile;
+    profile.initialSpeed = 100;
+    profile.maxSpeed = 1100;
+    profile.accelerationMs = 1000;
+    profile.curve = 1.0;
+    MouseKeys keys({profile}, vimBindings());
+
+    keys.onKey(kL, true, 0);
+    keys.tick(900000);
+    // Autorepeat presses arrive while the key is held
+    EXPECT_FALSE(keys.onKey(kL, true, 900000));
+
+    // 100 ms at the ramp's end, not at initialSpeed
+    MouseKeysStep step = keys.tick(1000000);
+    EXPECT_EQ(step.dx, 110);
+}
+
+TEST(MouseKeysTest, WheelUsesNotchUnits) {
+    MouseKeys keys({flat(100)}, vimBindings());
+    keys.onKey(kU, true, 0);
+
+    // 10 notches/s for 100 ms is one notch up
+    MouseKeysStep step = keys.tick(100000);
+    EXPECT_EQ(step.wheel, MouseKeys::WHEEL_NOTCH);
+    EXPECT_EQ(step.dx, 0);
+
+    keys.onKey(kU, false, 100000);
+    keys.onKey(kD, true, 100000);
+    step = keys.tick(150000);
+    EXPECT_EQ(step.wheel, -MouseKeys::WHEEL_NOTCH / 2);
+}
+
+TEST(MouseKeysTest, ResetReleasesEverything) {
+    MouseKeys keys({flat(1000)}, vimBindings());
+    keys.onKey(kL, true, 0);
+    keys.reset();
+    EXPECT_FALSE(keys.isActive());
+    EXPECT_EQ(keys.tick(100000).dx, 0);
+
+    // Pressing again after reset starts fresh
+    EXPECT_TRUE(keys.onKey(kL, true, 200000));
+    EXPECT_EQ(keys.tick(300000).dx, 100);
+}
+
+TEST(MouseKeysTest, InvalidBindingsDropped) {
+    MouseKeys keys({flat(1000)}, {
+        {kL, MouseKeysAction::Right, 0},
+        {kL, MouseKeysAction::Left, 0},         // Duplicate scan code
+        {kJ, MouseKeysAction::Down, 3},         // Unknown profile
+        {0x400, MouseKeysAction::Up, 0},        // Scan code out of range
+    });
+    EXPECT_TRUE(keys.isBound(kL));
+    EXPECT_FALSE(keys.isBound(kJ));
+    EXPECT_FALSE(keys.isBound(0x400));
+
+    keys.onKey(kL, true, 0);
+    EXPECT_EQ(keys.tick(100000).dx, 100);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
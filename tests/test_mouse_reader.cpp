@@ -0,0 +1,194 @@
+/**
+ * @file test_mouse_reader.cpp
+ * @brief Tests for the evdev mouse lane
+ *
+ * Tests cover:
+ * - Motion frames read together are injected as one summed event
+ * - Buttons become marked key events, after the motion before them
+ * - Hi-res wheel events replace REL_WHEEL of the same frame
+ * - Events after SYN_DROPPED are discarded up to the next SYN_REPORT
+ * - Only remappable buttons reach the button callback
+ *
+ * The reader runs on one end of a pipe; each test writes its frames in a
+ * single write(), so the reader sees them in one read().
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+#include "../src/platform/linux/mouse_reader_linux.h"
+
+using namespace yamy::platform;
+
+namespace {
+
+input_event make(uint16_t type, uint16_t code, int32_t value, uint64_t timeUs = 0) {
+    input_event ev{};
+    ev.input_event_sec = static_cast<decltype(ev.input_event_sec)>(timeUs / 1000000);
+    ev.input_event_usec = static_cast<decltype(ev.input_event_usec)>(timeUs % 1000000);
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+input_event syn(uint64_t timeUs = 0) {
+    return make(EV_SYN, SYN_REPORT, 0, timeUs);
+}
+
+/// What the lane delivered, in order: 'M' motion, 'B' button
+struct Delivery {
+    char kind;
+    MouseEvent motion;
+    KeyEvent button;
+};
+
+class MouseReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(pipe(fds), 0);
+        reader = std::make_unique<MouseReaderThread>(fds[0], "test-mouse",
+            [this](const KeyEvent& event) {
+                std::lock_guard<std::mutex> lock(mutex);
+                deliveries.push_back(Delivery{'B', MouseEvent{}, event});
+                cv.notify_all();
+                return true;
+            },
+            [this](const MouseEvent& event) {
+                std::lock_guard<std::mutex> lock(mutex);
+                deliveries.push_back(Delivery{'M', event, KeyEvent{}});
+                cv.notify_all();
+                return true;
+            });
+        ASSERT_TRUE(reader->start());
+    }
+
+    void TearDown() override {
+        close(fds[1]);
+        reader->stop();
+        close(fds[0]);
+    }
+
+    void send(const std::vector<input_event>& events) {
+        const ssize_t size = static_cast<ssize_t>(events.size() * sizeof(input_event));
+        ASSERT_EQ(write(fds[1], events.data(), size), size);
+    }
+
+    /// Wait until count deliveries arrived, then a little longer for extras
+    std::vector<Delivery> waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::seconds(2), [&] { return deliveries.size() >= count; });
+        cv.wait_for(lock, std::chrono::milliseconds(50), [&] { return deliveries.size() > count; });
+        return deliveries;
+    }
+
+    int fds[2];
+    std::unique_ptr<MouseReaderThread> reader;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Delivery> deliveries;
+};
+
+} // namespace
+
+TEST_F(MouseReaderTest, FramesReadTogetherAreSummed) {
+    std::vector<input_event> events;
+    for (int i = 0; i < 10; ++i) {
+        events.push_back(make(EV_REL, REL_X, 2));
+        events.push_back(make(EV_REL, REL_Y, -1));
+        events.push_back(syn(1000 + i * 125));
+    }
+    send(events);
+
+    auto got = waitFor(1);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].kind, 'M');
+    EXPECT_EQ(got[0].motion.dx, 20);
+    EXPECT_EQ(got[0].motion.dy, -10);
+    EXPECT_EQ(got[0].motion.wheel, 0);
+    EXPECT_EQ(got[0].motion.timestampUs, 1000u + 9 * 125);
+}
+
+TEST_F(MouseReaderTest, ButtonFollowsTheMotionBeforeIt) {
+    send({
+        make(EV_REL, REL_X, 5), syn(10),
+        make(EV_REL, REL_X, 3), make(EV_KEY, BTN_LEFT, 1), syn(20),
+        make(EV_REL, REL_X, 7), syn(30),
+        make(EV_KEY, BTN_LEFT, 0), syn(40),
+    });
+
+    auto got = waitFor(4);
+    ASSERT_EQ(got.size(), 4u);
+    EXPECT_EQ(got[0].kind, 'M');
+    EXPECT_EQ(got[0].motion.dx, 8);
+    EXPECT_EQ(got[1].kind, 'B');
+    EXPECT_EQ(got[1].button.scanCode, 0x01u);
+    EXPECT_TRUE(got[1].button.isKeyDown);
+    EXPECT_EQ(got[1].button.extraInfo, MOUSE_EVENT_MARKER);
+    EXPECT_EQ(got[1].button.timestampUs, 20u);
+    EXPECT_EQ(got[2].kind, 'M');
+    EXPECT_EQ(got[2].motion.dx, 7);
+    EXPECT_EQ(got[3].kind, 'B');
+    EXPECT_FALSE(got[3].button.isKeyDown);
+}
+
+TEST_F(MouseReaderTest, WheelInNotchUnits) {
+    send({
+        make(EV_REL, REL_WHEEL, -1), make(EV_REL, REL_HWHEEL, 2), syn(),
+#ifdef REL_WHEEL_HI_RES
+        // A hi-res mouse reports both; the hi-res value wins
+        make(EV_REL, REL_WHEEL, 1), make(EV_REL, REL_WHEEL_HI_RES, 30), syn(),
+#endif
+    });
+
+    auto got = waitFor(1);
+    ASSERT_EQ(got.size(), 1u);
+#ifdef REL_WHEEL_HI_RES
+    EXPECT_EQ(got[0].motion.wheel, -120 + 30);
+#else
+    EXPECT_EQ(got[0].motion.wheel, -120);
+#endif
+    EXPECT_EQ(got[0].motion.hwheel, 240);
+}
+
+TEST_F(MouseReaderTest, DroppedEventsDiscardedUntilReport) {
+    send({
+        make(EV_REL, REL_X, 100),
+        make(EV_SYN, SYN_DROPPED, 0),
+        make(EV_REL, REL_X, 50), make(EV_KEY, BTN_RIGHT, 1), syn(),
+        make(EV_REL, REL_X, 4), syn(),
+    });
+
+    auto got = waitFor(1);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].kind, 'M');
+    EXPECT_EQ(got[0].motion.dx, 4);
+}
+
+TEST_F(MouseReaderTest, OnlyRemappableButtons) {
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(BTN_RIGHT), 0x02);
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(BTN_MIDDLE), 0x03);
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(BTN_SIDE), 0x06);
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(BTN_EXTRA), 0x07);
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(BTN_TASK), 0);
+    EXPECT_EQ(MouseReaderThread::buttonScanCode(KEY_A), 0);
+
+    send({
+        make(EV_KEY, BTN_TASK, 1), make(EV_MSC, MSC_SCAN, 0x90004), syn(),
+        make(EV_KEY, BTN_EXTRA, 1), syn(),
+    });
+
+    auto got = waitFor(1);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].kind, 'B');
+    EXPECT_EQ(got[0].button.scanCode, 0x07u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
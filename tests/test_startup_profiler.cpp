@@ -0,0 +1,129 @@
+/**
+ * @file test_startup_profiler.cpp
+ * @brief Tests for the daemon startup trace
+ *
+ * Tests cover:
+ * - Phase wall and CPU time
+ * - Milestones recorded once, first key noted once
+ * - Phases after the hook went live marked as deferred
+ * - No phases recorded after startup completed
+ *
+ * The profiler is a process-wide singleton, so the tests run in order and
+ * each one only looks at the names it recorded.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "../src/utils/startup_profiler.h"
+
+using namespace yamy::metrics;
+
+namespace {
+
+const StartupPhase* findPhase(const std::vector<StartupPhase>& phases, const std::string& name) {
+    for (const auto& phase : phases) {
+        if (phase.name == name) return &phase;
+    }
+    return nullptr;
+}
+
+size_t countMilestones(const std::string& name) {
+    size_t count = 0;
+    for (const auto& milestone : StartupProfiler::instance().milestones()) {
+        if (milestone.name == name) ++count;
+    }
+    return count;
+}
+
+void spin(std::chrono::milliseconds duration) {
+    const auto end = std::chrono::steady_clock::now() + duration;
+    volatile uint64_t sink = 0;
+    while (std::chrono::steady_clock::now() < end) ++sink;
+}
+
+} // namespace
+
+TEST(StartupProfilerTest, PhaseMeasuresWallAndCpuTime) {
+    {
+        STARTUP_PHASE("test_busy");
+        spin(std::chrono::milliseconds(20));
+    }
+    {
+        STARTUP_PHASE("test_sleep");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    const auto phases = StartupProfiler::instance().phases();
+    const StartupPhase* busy = findPhase(phases, "test_busy");
+    const StartupPhase* sleep = findPhase(phases, "test_sleep");
+    ASSERT_NE(busy, nullptr);
+    ASSERT_NE(sleep, nullptr);
+
+    EXPECT_GE(busy->wallUs, 20000u);
+    EXPECT_GE(busy->cpuUs, 10000u);
+    EXPECT_GE(sleep->wallUs, 20000u);
+    EXPECT_LT(sleep->cpuUs, 10000u);
+    EXPECT_GE(sleep->startUs, busy->startUs + busy->wallUs);
+    EXPECT_FALSE(busy->isDeferred);
+}
+
+TEST(StartupProfilerTest, PhasesReportedInStartOrder) {
+    {
+        STARTUP_PHASE("test_outer");
+        STARTUP_PHASE("test_inner");
+    }
+
+    // The inner phase ends first but started later
+    const auto phases = StartupProfiler::instance().phases();
+    size_t outer = phases.size();
+    size_t inner = phases.size();
+    for (size_t i = 0; i < phases.size(); ++i) {
+        if (phases[i].name == "test_outer") outer = i;
+        if (phases[i].name == "test_inner") inner = i;
+    }
+    ASSERT_LT(outer, phases.size());
+    ASSERT_LT(inner, phases.size());
+    EXPECT_LT(outer, inner);
+}
+
+TEST(StartupProfilerTest, MilestonesRecordedOnce) {
+    StartupProfiler& profiler = StartupProfiler::instance();
+    profiler.mark(Milestones::HOOK_LIVE);
+    profiler.mark(Milestones::HOOK_LIVE);
+    EXPECT_EQ(countMilestones(Milestones::HOOK_LIVE), 1u);
+
+    EXPECT_EQ(countMilestones(Milestones::FIRST_KEY), 0u);
+    for (int i = 0; i < 3; ++i) {
+        profiler.noteFirstKey();
+    }
+    EXPECT_EQ(countMilestones(Milestones::FIRST_KEY), 1u);
+}
+
+TEST(StartupProfilerTest, PhasesAfterHookLiveAreDeferred) {
+    // HOOK_LIVE was marked by the previous test
+    {
+        STARTUP_PHASE("test_deferred");
+    }
+    const auto phases = StartupProfiler::instance().phases();
+    const StartupPhase* deferred = findPhase(phases, "test_deferred");
+    ASSERT_NE(deferred, nullptr);
+    EXPECT_TRUE(deferred->isDeferred);
+    EXPECT_FALSE(findPhase(phases, "test_busy")->isDeferred);
+}
+
+TEST(StartupProfilerTest, TraceEndsAtStartupComplete) {
+    StartupProfiler& profiler = StartupProfiler::instance();
+    profiler.mark(Milestones::STARTUP_COMPLETE);
+    {
+        STARTUP_PHASE("test_after_complete");
+    }
+    EXPECT_EQ(findPhase(profiler.phases(), "test_after_complete"), nullptr);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
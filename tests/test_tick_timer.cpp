@@ -0,0 +1,102 @@
+/**
+ * @file test_tick_timer.cpp
+ * @brief Tests for the engine tick timer thread
+ *
+ * Tests cover:
+ * - Ticks after the delay and then at the interval
+ * - One-shot arming
+ * - disarm() and re-arming
+ * - Clean stop with the timer armed
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../src/core/engine/tick_timer.h"
+
+using namespace yamy::engine;
+
+namespace {
+
+void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+} // namespace
+
+TEST(TickTimerTest, NoTicksUntilArmed) {
+    std::atomic<int> ticks{0};
+    TickTimer timer([&]() { ++ticks; });
+    ASSERT_TRUE(timer.start());
+    EXPECT_TRUE(timer.isRunning());
+
+    sleepMs(50);
+    EXPECT_EQ(ticks.load(), 0);
+}
+
+TEST(TickTimerTest, TicksAfterDelayThenAtInterval) {
+    std::atomic<int> ticks{0};
+    TickTimer timer([&]() { ++ticks; });
+    ASSERT_TRUE(timer.start());
+
+    timer.arm(100, 10);
+    sleepMs(50);
+    EXPECT_EQ(ticks.load(), 0);
+
+    sleepMs(150);
+    // ~10 repeats after the delay; loose bounds for loaded machines
+    EXPECT_GE(ticks.load(), 3);
+    EXPECT_LE(ticks.load(), 12);
+}
+
+TEST(TickTimerTest, ZeroIntervalFiresOnce) {
+    std::atomic<int> ticks{0};
+    TickTimer timer([&]() { ++ticks; });
+    ASSERT_TRUE(timer.start());
+
+    timer.arm(10, 0);
+    sleepMs(80);
+    EXPECT_EQ(ticks.load(), 1);
+}
+
+TEST(TickTimerTest, DisarmStopsTicks) {
+    std::atomic<int> ticks{0};
+    TickTimer timer([&]() { ++ticks; });
+    ASSERT_TRUE(timer.start());
+
+    timer.arm(1, 5);
+    sleepMs(40);
+    timer.disarm();
+    sleepMs(10);
+    const int afterDisarm = ticks.load();
+    EXPECT_GT(afterDisarm, 0);
+
+    sleepMs(50);
+    EXPECT_EQ(ticks.load(), afterDisarm);
+
+    timer.arm(1, 5);
+    sleepMs(40);
+    EXPECT_GT(ticks.load(), afterDisarm);
+}
+
+TEST(TickTimerTest, StopWhileArmed) {
+    std::atomic<int> ticks{0};
+    TickTimer timer([&]() { ++ticks; });
+    ASSERT_TRUE(timer.start());
+
+    timer.arm(1, 1);
+    sleepMs(20);
+    timer.stop();
+    EXPECT_FALSE(timer.isRunning());
+
+    const int afterStop = ticks.load();
+    sleepMs(20);
+    EXPECT_EQ(ticks.load(), afterStop);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Null platform backends for tests and benchmarks that run a real Engine.
+// The engine never touches windows or the driver there, it only needs valid
+// objects to talk to.
+
+#include "../../src/core/platform/window_system_interface.h"
+#include "../../src/core/platform/input_hook_interface.h"
+#include "../../src/core/platform/input_injector_interface.h"
+#include "../../src/core/platform/input_driver_interface.h"
+
+#include <string>
+
+namespace yamy::platform {
+
+class NullWindowSystem : public IWindowSystem {
+public:
+    WindowHandle getForegroundWindow() override { return nullptr; }
+    WindowHandle windowFromPoint(const Point&) override { return nullptr; }
+    bool getWindowRect(WindowHandle, Rect*) override { return false; }
+    std::string getWindowText(WindowHandle) override { return ""; }
+    std::string getClassName(WindowHandle) override { return "MockWindowClass"; }
+    std::string getTitleName(WindowHandle) override { return "MockTitle"; }
+    uint32_t getWindowThreadId(WindowHandle) override { return 1; }
+    uint32_t getWindowProcessId(WindowHandle) override { return 1; }
+    bool setForegroundWindow(WindowHandle) override { return true; }
+    bool moveWindow(WindowHandle, const Rect&) override { return true; }
+    bool showWindow(WindowHandle, int) override { return true; }
+    bool closeWindow(WindowHandle) override { return true; }
+    WindowHandle getParent(WindowHandle) override { return nullptr; }
+    bool isMDIChild(WindowHandle) override { return false; }
+    bool isChild(WindowHandle) override { return false; }
+    WindowShowCmd getShowCommand(WindowHandle) override { return WindowShowCmd::Normal; }
+    bool isConsoleWindow(WindowHandle) override { return false; }
+    void getCursorPos(Point*) override {}
+    void setCursorPos(const Point&) override {}
+    int getMonitorCount() override { return 1; }
+    bool getMonitorRect(int, Rect*) override { return false; }
+    bool getMonitorWorkArea(int, Rect*) override { return false; }
+    int getMonitorIndex(WindowHandle) override { return 0; }
+    int getSystemMetrics(SystemMetric) override { return 0; }
+    bool getWorkArea(Rect*) override { return false; }
+    std::string getClipboardText() override { return ""; }
+    bool setClipboardText(const std::string&) override { return true; }
+    bool getClientRect(WindowHandle, Rect*) override { return false; }
+    bool getChildWindowRect(WindowHandle, Rect*) override { return false; }
+    unsigned int mapVirtualKey(unsigned int) override { return 0; }
+    bool postMessage(WindowHandle, unsigned int, uintptr_t, intptr_t) override { return true; }
+    unsigned int registerWindowMessage(const std::string&) override { return 0; }
+    bool sendMessageTimeout(WindowHandle, unsigned int, uintptr_t, intptr_t, unsigned int, unsigned int, uintptr_t*) override { return true; }
+    bool sendCopyData(WindowHandle, WindowHandle, const CopyData&, uint32_t, uint32_t, uintptr_t*) override { return true; }
+    bool setWindowZOrder(WindowHandle, ZOrder) override { return true; }
+    bool isWindowTopMost(WindowHandle) override { return false; }
+    bool isWindowLayered(WindowHandle) override { return false; }
+    bool setWindowLayered(WindowHandle, bool) override { return true; }
+    bool setLayeredWindowAttributes(WindowHandle, unsigned long, unsigned char, unsigned long) override { return true; }
+    bool redrawWindow(WindowHandle) override { return true; }
+    bool enumerateWindows(WindowEnumCallback) override { return true; }
+    int shellExecute(const std::string&, const std::string&, const std::string&, const std::string&, int) override { return 0; }
+    bool disconnectNamedPipe(void*) override { return true; }
+    bool connectNamedPipe(void*, void*) override { return true; }
+    bool writeFile(void*, const void*, unsigned int, unsigned int*, void*) override { return true; }
+    void* openMutex(const std::string&) override { return nullptr; }
+    void* openFileMapping(const std::string&) override { return nullptr; }
+    void* mapViewOfFile(void*) override { return nullptr; }
+    bool unmapViewOfFile(void*) override { return true; }
+    void closeHandle(void*) override {}
+    void* loadLibrary(const std::string&) override { return nullptr; }
+    void* getProcAddress(void*, const std::string&) override { return nullptr; }
+    bool freeLibrary(void*) override { return true; }
+    WindowHandle getToplevelWindow(WindowHandle, bool*) override { return nullptr; }
+    bool changeMessageFilter(uint32_t, uint32_t) override { return true; }
+};
+
+class NullInputInjector : public IInputInjector {
+public:
+    void inject(const KEYBOARD_INPUT_DATA*, const InjectionContext&, const void*) override {}
+    void keyDown(KeyCode) override {}
+    void keyUp(KeyCode) override {}
+    void mouseMove(int32_t, int32_t) override {}
+    void mouseButton(MouseButton, bool) override {}
+    void mouseWheel(int32_t) override {}
+};
+
+class NullInputHook : public IInputHook {
+public:
+    bool install(KeyCallback, MouseCallback) override { return true; }
+    void uninstall() override {}
+    bool isInstalled() const override { return true; }
+};
+
+class NullInputDriver : public IInputDriver {
+public:
+    bool open(void*) override { return true; }
+    void close() override {}
+    void manageExtension(const std::string&, const std::string&, bool, void**) override {}
+};
+
+} // namespace yamy::platform
@@ -5,6 +5,7 @@
  * Tests cover:
  * - Logger singleton, listeners, filtering, thread-safety
  * - DialogLogQt UI controls and features
+ * - LogViewModel batching, trimming, filtering and search index
  * - Performance benchmarks (10000 entries, memory, threading)
  * - Error cases (export failure, invalid font, etc.)
  *
@@ -15,16 +16,17 @@
 #include <gtest/gtest.h>
 #include <QApplication>
 #include <QCheckBox>
+#include <QColor>
 #include <QComboBox>
 #include <QFile>
 #include <QFontComboBox>
 #include <QLabel>
 #include <QLineEdit>
+#include <QListView>
 #include <QPushButton>
 #include <QSettings>
 #include <QSpinBox>
 #include <QTemporaryFile>
-#include <QTextEdit>
 #include <QThread>
 #include <atomic>
 #include <chrono>
@@ -36,6 +38,7 @@
 #include "core/logging/log_entry.h"
 #include "ui/qt/dialog_log_qt.h"
 #include "ui/qt/log_stats_panel.h"
+#include "ui/qt/log_view_model.h"
 
 using namespace yamy::logging;
 using namespace yamy::ui;
@@ -70,6 +73,21 @@ protected:
 
 QApplication* LogDialogTest::app = nullptr;
 
+QListView* logViewOf(DialogLogQt& dialog) {
+    return dialog.findChild<QListView*>("logView");
+}
+
+/// Text of the log view rows, after appending the entries queued for the next frame
+QString viewText(DialogLogQt& dialog) {
+    dialog.flushPendingEntries();
+    QStringList lines;
+    QAbstractItemModel* model = logViewOf(dialog)->model();
+    for (int row = 0; row < model->rowCount(); ++row) {
+        lines << model->index(row, 0).data().toString();
+    }
+    return lines.join('\n');
+}
+
 // =============================================================================
 // Logger Tests
 // =============================================================================
@@ -136,10 +154,10 @@ TEST_F(DialogLogQtTest, AppendsLogCorrectly) {
     dialog.onLogEntry(entry);
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
+    QListView* logView = logViewOf(dialog);
     ASSERT_NE(logView, nullptr) << "Should have a log view widget";
 
-    QString content = logView->toPlainText();
+    QString content = viewText(dialog);
     EXPECT_TRUE(content.contains("Test engine message"))
         << "Log view should contain the appended message";
 }
@@ -163,8 +181,7 @@ TEST_F(DialogLogQtTest, LevelFilterWorks) {
     dialog.onLogEntry(LogEntry(LogLevel::Error, "Engine", "Error message"));
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    QString content = logView->toPlainText();
+    QString content = viewText(dialog);
 
     // With Warning filter, Trace and Info should be filtered out
     EXPECT_FALSE(content.contains("Trace message")) << "Trace should be filtered out";
@@ -191,8 +208,7 @@ TEST_F(DialogLogQtTest, CategoryFiltersWork) {
     dialog.onLogEntry(LogEntry(LogLevel::Info, "Parser", "Parser message"));
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    QString content = logView->toPlainText();
+    QString content = viewText(dialog);
 
     EXPECT_TRUE(content.contains("Engine message")) << "Engine message should be visible initially";
     EXPECT_TRUE(content.contains("Parser message")) << "Parser message should be visible";
@@ -201,7 +217,7 @@ TEST_F(DialogLogQtTest, CategoryFiltersWork) {
     engineFilter->setChecked(false);
     QApplication::processEvents();
 
-    content = logView->toPlainText();
+    content = viewText(dialog);
     EXPECT_FALSE(content.contains("Engine message")) << "Engine message should be filtered out";
     EXPECT_TRUE(content.contains("Parser message")) << "Parser message should still be visible";
 }
@@ -221,7 +237,7 @@ TEST_F(DialogLogQtTest, FontChangesApply) {
     ASSERT_NE(fontCombo, nullptr) << "Should have font combo box";
     ASSERT_NE(fontSizeSpinner, nullptr) << "Should have font size spinner";
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
+    QListView* logView = logViewOf(dialog);
 
     // Change font size
     int newSize = 14;
@@ -238,12 +254,15 @@ TEST_F(DialogLogQtTest, SyntaxHighlightingWorks) {
     dialog.onLogEntry(LogEntry(LogLevel::Info, "Input", "Key DOWN event HANDLED"));
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    QString html = logView->toHtml();
-
-    // Keywords like DOWN, UP, HANDLED should have formatting
-    EXPECT_TRUE(html.contains("<b>DOWN</b>") || html.contains("DOWN"))
+    dialog.onLogEntry(LogEntry(LogLevel::Warning, "Input", "Key repeat dropped"));
+    EXPECT_TRUE(viewText(dialog).contains("DOWN"))
         << "DOWN keyword should be present in formatted output";
+
+    // Rows are colored by level
+    QAbstractItemModel* model = logViewOf(dialog)->model();
+    ASSERT_EQ(model->rowCount(), 2);
+    EXPECT_FALSE(model->index(0, 0).data(Qt::ForegroundRole).isValid());
+    EXPECT_EQ(model->index(1, 0).data(Qt::ForegroundRole).value<QColor>(), QColor(0xFF, 0xA5, 0x00));
 }
 
 TEST_F(DialogLogQtTest, ClearButtonWorks) {
@@ -255,14 +274,13 @@ TEST_F(DialogLogQtTest, ClearButtonWorks) {
     }
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    EXPECT_FALSE(logView->toPlainText().isEmpty()) << "Should have log content before clear";
+    EXPECT_FALSE(viewText(dialog).isEmpty()) << "Should have log content before clear";
 
     // Call clearLog directly (since clear button may show confirmation dialog)
     dialog.clearLog();
     QApplication::processEvents();
 
-    EXPECT_TRUE(logView->toPlainText().isEmpty()) << "Log view should be empty after clear";
+    EXPECT_TRUE(viewText(dialog).isEmpty()) << "Log view should be empty after clear";
 }
 
 TEST_F(DialogLogQtTest, PauseResumeWorks) {
@@ -377,6 +395,7 @@ TEST_F(DialogLogQtTest, BufferLimitEnforced) {
     // The exact count depends on trimming policy (removes 10% when limit exceeded)
     // We just verify it's not significantly over the limit
     // Access internal count via stats panel
+    dialog.flushPendingEntries();
     LogStatsPanel* statsPanel = dialog.findChild<LogStatsPanel*>();
     if (statsPanel) {
         // Total count should be roughly around buffer limit
@@ -398,6 +417,7 @@ TEST_F(DialogLogQtTest, StatisticsAccurate) {
     dialog.onLogEntry(LogEntry(LogLevel::Error, "Config", "Error 2"));
     QApplication::processEvents();
 
+    dialog.flushPendingEntries();
     LogStatsPanel* statsPanel = dialog.findChild<LogStatsPanel*>();
     ASSERT_NE(statsPanel, nullptr) << "Should have stats panel";
 
@@ -420,22 +440,20 @@ TEST_F(DialogLogQtTest, TimestampFormatsWork) {
     dialog.onLogEntry(LogEntry(LogLevel::Info, "Test", "Test message"));
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-
     // Test Absolute format (default)
-    QString content = logView->toPlainText();
+    QString content = viewText(dialog);
     EXPECT_TRUE(content.contains(":")) << "Absolute format should contain time separators";
 
     // Switch to Relative format
     timestampCombo->setCurrentIndex(1); // Relative
     QApplication::processEvents();
-    content = logView->toPlainText();
+    content = viewText(dialog);
     EXPECT_TRUE(content.contains("+")) << "Relative format should contain + prefix";
 
     // Switch to None format
     timestampCombo->setCurrentIndex(2); // None
     QApplication::processEvents();
-    content = logView->toPlainText();
+    content = viewText(dialog);
     // With no timestamp, the format should be more compact
     // Note: Level is padded to 5 chars, so "INFO " not "INFO"
     EXPECT_TRUE(content.contains("[INFO") || content.contains("[TRACE") ||
@@ -506,6 +524,7 @@ TEST_F(LogDialogPerformanceTest, TenThousandEntriesInLessThanFiveSeconds) {
         << "Adding 10000 entries should complete in less than 5 seconds";
 
     // Verify entries were added
+    dialog.flushPendingEntries();
     LogStatsPanel* statsPanel = dialog.findChild<LogStatsPanel*>();
     if (statsPanel) {
         EXPECT_EQ(statsPanel->totalCount(), 10000) << "Should have 10000 entries";
@@ -582,7 +601,7 @@ TEST_F(LogDialogErrorTest, InvalidFontHandled) {
     QFontComboBox* fontCombo = dialog.findChild<QFontComboBox*>();
     ASSERT_NE(fontCombo, nullptr);
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
+    QListView* logView = logViewOf(dialog);
     ASSERT_NE(logView, nullptr);
 
     // Try setting an invalid font (should fallback gracefully)
@@ -594,7 +613,7 @@ TEST_F(LogDialogErrorTest, InvalidFontHandled) {
     dialog.onLogEntry(LogEntry(LogLevel::Info, "Test", "After invalid font"));
     QApplication::processEvents();
 
-    EXPECT_FALSE(logView->toPlainText().isEmpty())
+    EXPECT_FALSE(viewText(dialog).isEmpty())
         << "Dialog should still work after invalid font attempt";
 }
 
@@ -646,8 +665,7 @@ TEST_F(LogDialogErrorTest, ExtremeBufferLimitHandled) {
     }
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    EXPECT_FALSE(logView->toPlainText().isEmpty())
+    EXPECT_FALSE(viewText(dialog).isEmpty())
         << "Dialog should still function with minimum buffer limit";
 }
 
@@ -674,7 +692,7 @@ TEST_F(LogDialogErrorTest, RapidFilterChangesHandled) {
     }
 
     // Dialog should still be responsive
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
+    QListView* logView = logViewOf(dialog);
     EXPECT_NE(logView, nullptr) << "Log view should still exist after rapid filter changes";
 }
 
@@ -685,13 +703,170 @@ TEST_F(LogDialogErrorTest, UnknownCategoryHandled) {
     dialog.onLogEntry(LogEntry(LogLevel::Info, "UnknownCategory", "Unknown category message"));
     QApplication::processEvents();
 
-    QTextEdit* logView = dialog.findChild<QTextEdit*>();
-    QString content = logView->toPlainText();
+    QString content = viewText(dialog);
 
     EXPECT_TRUE(content.contains("Unknown category message"))
         << "Unknown categories should be displayed by default";
 }
 
+// =============================================================================
+// LogViewModel Tests
+// =============================================================================
+
+class LogViewModelTest : public LogDialogTest {
+protected:
+    LogViewModelTest() : batch(categories, templates, 100) {}
+
+    void add(LogLevel level, const char* category, const char* message) {
+        batch.appendText(0, level, category, message);
+    }
+
+    /// Append and empty the batch, as DialogLogQt's flush does
+    int flush(LogViewModel& model) {
+        const int shown = model.append(batch, batch.firstSequence());
+        batch.clear();
+        return shown;
+    }
+
+    static QString rows(const LogViewModel& model) {
+        QStringList lines;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            lines << model.rowText(row);
+        }
+        return lines.join('|');
+    }
+
+    yamy::logging::LogDictionary categories;
+    yamy::logging::LogDictionary templates;
+    yamy::logging::LogStore batch;
+};
+
+TEST_F(LogViewModelTest, BatchInsertsOnlyVisibleRows) {
+    LogViewModel model(categories, templates, 1000);
+    model.setTimestampFormat(TimestampFormat::None);
+    model.setFilter(LogLevel::Info, {});
+
+    int inserts = 0;
+    QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&inserts]() { ++inserts; });
+
+    add(LogLevel::Trace, "Engine", "hidden");
+    add(LogLevel::Info, "Engine", "first");
+    add(LogLevel::Error, "Parser", "second");
+    EXPECT_EQ(flush(model), 2);
+
+    EXPECT_EQ(inserts, 1) << "A batch is one insertion";
+    EXPECT_EQ(model.entryCount(), 3u);
+    EXPECT_EQ(model.rowText(0), "[INFO ] [Engine  ] first");
+    EXPECT_EQ(model.rowText(1), "[ERROR] [Parser  ] second");
+}
+
+TEST_F(LogViewModelTest, TemplatesAreFormattedOnDisplay) {
+    LogViewModel model(categories, templates, 1000);
+    model.setTimestampFormat(TimestampFormat::None);
+
+    const yamy::logging::LogArg args[] = {
+        yamy::logging::toLogArg(30), yamy::logging::toLogArg(true)};
+    batch.append(0, LogLevel::Trace, "Engine", "scancode={}, isKeyDown={}", args, 2);
+    flush(model);
+
+    EXPECT_EQ(model.rowText(0), "[TRACE] [Engine  ] scancode=30, isKeyDown=1");
+    EXPECT_EQ(model.setSearch("isKeyDown=1", Qt::CaseSensitive), 1);
+}
+
+TEST_F(LogViewModelTest, FilterNarrowsAndWidens) {
+    LogViewModel model(categories, templates, 1000);
+    model.setTimestampFormat(TimestampFormat::None);
+    add(LogLevel::Info, "Engine", "a");
+    add(LogLevel::Warning, "Parser", "b");
+    add(LogLevel::Info, "Parser", "c");
+    flush(model);
+
+    model.setFilter(LogLevel::Trace, {"Parser"});
+    EXPECT_EQ(rows(model), "[INFO ] [Engine  ] a");
+
+    model.setFilter(LogLevel::Warning, {});
+    EXPECT_EQ(rows(model), "[WARN ] [Parser  ] b");
+
+    model.setFilter(LogLevel::Trace, {});
+    EXPECT_EQ(model.rowCount(), 3);
+}
+
+TEST_F(LogViewModelTest, DropOldestRemovesRowsAndMatches) {
+    LogViewModel model(categories, templates, 1000);
+    for (int i = 0; i < 10; ++i) {
+        add(LogLevel::Info, "Engine", i % 2 ? "odd" : "even");
+    }
+    flush(model);
+    EXPECT_EQ(model.setSearch("odd", Qt::CaseSensitive), 5);
+
+    model.dropOldest(4);
+    EXPECT_EQ(model.entryCount(), 6u);
+    EXPECT_EQ(model.rowCount(), 6);
+    EXPECT_EQ(model.matchCount(), 3);
+    EXPECT_EQ(model.matchRow(0), 1);
+    EXPECT_EQ(model.index(1).data(Qt::BackgroundRole).value<QColor>(), QColor(255, 255, 0));
+    EXPECT_FALSE(model.index(0).data(Qt::BackgroundRole).isValid());
+}
+
+TEST_F(LogViewModelTest, CapacityDropsOldestRows) {
+    LogViewModel model(categories, templates, 4);
+    model.setTimestampFormat(TimestampFormat::None);
+    for (int i = 0; i < 3; ++i) {
+        add(LogLevel::Info, "Engine", "old");
+    }
+    flush(model);
+
+    int removed = 0;
+    QObject::connect(&model, &QAbstractItemModel::rowsRemoved, [&removed]() { ++removed; });
+    for (int i = 0; i < 3; ++i) {
+        add(LogLevel::Info, "Engine", "new");
+    }
+    EXPECT_EQ(flush(model), 3);
+
+    EXPECT_EQ(removed, 1) << "Rows are removed before their entries are dropped";
+    EXPECT_EQ(model.entryCount(), 4u);
+    EXPECT_EQ(rows(model), "[INFO ] [Engine  ] old|[INFO ] [Engine  ] new|"
+                           "[INFO ] [Engine  ] new|[INFO ] [Engine  ] new");
+}
+
+TEST_F(LogViewModelTest, SearchIndexFollowsAppendsAndRefinement) {
+    LogViewModel model(categories, templates, 1000);
+    add(LogLevel::Info, "Engine", "Starting engine");
+    add(LogLevel::Info, "Parser", "Parsing config");
+    flush(model);
+
+    // Category and message are both searched
+    EXPECT_EQ(model.setSearch("engine", Qt::CaseInsensitive), 1);
+    EXPECT_EQ(model.setSearch("ENGINE", Qt::CaseSensitive), 0);
+    EXPECT_EQ(model.setSearch("pars", Qt::CaseInsensitive), 1);
+    EXPECT_EQ(model.setSearch("parsing", Qt::CaseInsensitive), 1);
+
+    // New entries are matched as they arrive
+    add(LogLevel::Info, "Config", "Parsing done");
+    flush(model);
+    EXPECT_EQ(model.matchCount(), 2);
+    EXPECT_EQ(model.matchRow(1), 2);
+}
+
+TEST_F(LogViewModelTest, WriteTextHonorsFilter) {
+    LogViewModel model(categories, templates, 1000);
+    model.setTimestampFormat(TimestampFormat::None);
+    add(LogLevel::Trace, "Engine", "trace");
+    add(LogLevel::Error, "Engine", "error");
+    flush(model);
+    model.setFilter(LogLevel::Error, {});
+
+    QString all;
+    QTextStream allOut(&all);
+    EXPECT_EQ(model.writeText(allOut, false), 2);
+
+    QString filtered;
+    QTextStream filteredOut(&filtered);
+    EXPECT_EQ(model.writeText(filteredOut, true), 1);
+    filteredOut.flush();
+    EXPECT_EQ(filtered, "[ERROR] [Engine  ] error\n");
+}
+
 // =============================================================================
 // LogStatsPanel Tests
 // =============================================================================
@@ -841,6 +1016,7 @@ TEST_F(ThreadSafetyTest, DialogConcurrentUpdates) {
         QThread::msleep(10);
     }
 
+    dialog.flushPendingEntries();
     LogStatsPanel* statsPanel = dialog.findChild<LogStatsPanel*>();
     if (statsPanel) {
         EXPECT_GE(statsPanel->totalCount(), 1)